@@ -8,10 +8,17 @@
  */
 
 #include <stddef.h>
+#include <time.h>
 
+#include <errno.h>
+#include <unistd.h>
 #include <sys/fcntl.h>
+#include <sys/wait.h>
 
 #include <fstream>
+#include <limits>
+#include <memory>
+#include <vector>
 
 #include <RandomLib/RandomSeed.hpp>
 
@@ -22,11 +29,21 @@
 
 #include <boost/iostreams/device/file_descriptor.hpp>
 #include <boost/iostreams/stream_buffer.hpp>
+
+#include <boost/thread.hpp>
     
 #include "mactierra.h"
 
 #include "options.h"
 
+#include "MT_Archipelago.h"
+#include "MT_DataLogSinks.h"
+#include "MT_Ensemble.h"
+#include "MT_EventLog.h"
+#include "MT_GenotypeProbe.h"
+#include "MT_GenotypeRegistry.h"
+#include "MT_InteractionMatrix.h"
+#include "MT_MigrationTransport.h"
 #include "MT_World.h"
 #include "MT_WorldArchiver.h"
 #include "MT_Settings.h"
@@ -40,6 +57,9 @@ namespace io = boost::iostreams;
 
 const int32_t kDefaultSoupSize = 1024 * 256;
 
+// How many instructions soups run between checks for an interrupt or the end of the run.
+const u_int64_t kRunChunkLength = 50000;
+
 // cheesy ostream subclass which holds onto the streambuf
 class fileDescStream : public ostream
 {
@@ -65,6 +85,33 @@ static const char * const kOptionsList[] = {
     "f:in-soup-file",
     "o:out-soup-file",
     "x:xml-format",
+    "e:event-log <file>",
+    "z|compress-event-log",
+    "l:data-log <prefix>",
+    "i:data-interval <instructions>",
+    "y:data-cycles <cycles>",
+    "g:top-genotypes <number>",
+    "C|csv",
+    "b:heatmap-block <cells>",
+    "p:heatmap-sampling <interval>",
+    "m:interactions <file>",
+    "O|opcode-census",
+    "a:islands <number>",
+    "t:topology <ring|grid|full>",
+    "M:migration-interval <instructions>",
+    "n:migrants <number>",
+    "j:threads <number>",
+    "P:shards <number>",
+    "L:listen <address>",
+    "N:peer <address>",
+    "E:ensemble <configuration list>",
+    "R:replicates <number>",
+    "S:sweep-sizes <size,...>",
+    "U:sweep-mutation <scale,...>",
+    "F:fork <replicates>",
+    "G|shared-genotypes",                   // names depend on thread timing
+    "Q:probe <genotypes>",
+    "T:to-csv <data log>",
     NULL
 };
 
@@ -80,10 +127,41 @@ string      gConfigFilePath;
 
 bool        gUseXMLFormat = false;
 
+string      gEventLogFilePath;
+bool        gCompressEventLog = false;
+
+string      gDataLogPrefix;
+u_int64_t   gDataInterval = 0;          // instructions
+u_int64_t   gDataCycles = 0;            // slicer cycles; collect by cycles rather than instructions
+u_int32_t   gNumTopGenotypes = 5;
+bool        gWriteCSV = false;
+u_int32_t   gHeatmapBlockSize = 0;      // 0 for no heatmap
+u_int32_t   gHeatmapSampling = SoupHeatmap::kDefaultSampleInterval;
+string      gInteractionsFilePath;
+bool        gOpcodeCensus = false;
+
+u_int32_t   gNumIslands = 1;
+Archipelago::ETopology gTopology = Archipelago::kRing;
+u_int64_t   gMigrationInterval = 1000000;
+u_int32_t   gMigrantsPerIsland = 1;
+u_int32_t   gNumThreads = 0;            // one per processor
+u_int32_t   gNumShards = 0;             // 0 to keep the soup's setting
+string      gListenAddress;             // for migrants from other processes
+vector<string> gPeerAddresses;          // to send migrants to
+
+string      gEnsembleListPath;          // configuration files, one per line
+u_int32_t   gNumReplicates = 1;
+vector<u_int32_t> gSweepSoupSizes;
+vector<double> gSweepMutationScales;
+
+u_int32_t   gNumForks = 0;              // replicates per mutation scale, forked from one loaded soup
+bool        gShareGenotypes = false;    // islands or ensemble runs share a genotype registry
+u_int32_t   gNumProbes = 0;             // most common genotypes of the loaded soup to probe
+
 bool        gInterrupted = false;
 Settings    gSoupSettings;
 
-static bool readConfigurationFile(const std::string filePath)
+static bool readConfigurationFile(const std::string filePath, SoupConfiguration& outConfig)
 {
     std::ifstream fileStream(filePath.c_str());
 
@@ -105,6 +183,16 @@ static bool readConfigurationFile(const std::string filePath)
         return false;
     }
     
+    outConfig = config;
+    return true;
+}
+
+static bool readConfigurationFile(const std::string filePath)
+{
+    SoupConfiguration config;
+    if (!readConfigurationFile(filePath, config))
+        return false;
+
     gSoupSize = config.soupSize();
     gRandomSeed = config.randomSeed();
     gSoupSettings = config.settings();
@@ -113,6 +201,29 @@ static bool readConfigurationFile(const std::string filePath)
     return true;
 }
 
+// Comma-separated numbers; false if any aren't.
+template<typename T>
+static bool parseNumberList(const char* inString, vector<T>& outNumbers)
+{
+    std::istringstream listStream(inString);
+    string item;
+    while (getline(listStream, item, ','))
+    {
+        std::istringstream itemStream(item);
+        T value;
+        if (!(itemStream >> value) || !itemStream.eof())
+            return false;
+        outNumbers.push_back(value);
+    }
+    return !outNumbers.empty();
+}
+
+static bool isEnsemble()
+{
+    // forked runs take their mutation scales from the sweep list too
+    return gNumForks == 0 && (!gEnsembleListPath.empty() || !gSweepSoupSizes.empty() || !gSweepMutationScales.empty());
+}
+
 static bool sanityCheckOptions()
 {
     if (!gInputSoupFilePath.empty() && !gConfigFilePath.empty())
@@ -125,6 +236,95 @@ static bool sanityCheckOptions()
     {
         // warn if -s or -r are specified
     }
+
+    if (gCompressEventLog && gEventLogFilePath.empty())
+    {
+        cerr << "Event log compression needs an event log path." << endl;
+        return false;
+    }
+
+    if ((gDataInterval > 0 || gDataCycles > 0 || gWriteCSV || gHeatmapBlockSize > 0 || gOpcodeCensus) && gDataLogPrefix.empty())
+    {
+        cerr << "Data collection options need a data log prefix." << endl;
+        return false;
+    }
+
+    if (gNumIslands > 1 && (!gInputSoupFilePath.empty() || !gEventLogFilePath.empty() || !gDataLogPrefix.empty() || !gInteractionsFilePath.empty()))
+    {
+        cerr << "Islands can't be loaded from a soup file, or have event or data logs." << endl;
+        return false;
+    }
+
+    if (isEnsemble())
+    {
+        if (gNumIslands > 1 || !gInputSoupFilePath.empty() || !gEventLogFilePath.empty() || !gInteractionsFilePath.empty()
+            || gDataCycles > 0 || gHeatmapBlockSize > 0 || gOpcodeCensus || gWriteCSV)
+        {
+            cerr << "Ensembles only support population data logs, collected every N instructions." << endl;
+            return false;
+        }
+
+        if (gRunDuration == 0)
+        {
+            cerr << "Ensembles need a duration." << endl;
+            return false;
+        }
+    }
+
+    if (gNumForks > 0)
+    {
+        if (gNumIslands > 1 || !gEnsembleListPath.empty() || !gSweepSoupSizes.empty() || gNumShards > 1
+            || !gEventLogFilePath.empty() || !gInteractionsFilePath.empty() || !gListenAddress.empty() || !gPeerAddresses.empty())
+        {
+            cerr << "Forked runs can only vary the random seed and mutation rates, and only keep data logs." << endl;
+            return false;
+        }
+
+        if (gRunDuration == 0)
+        {
+            cerr << "Forked runs need a duration." << endl;
+            return false;
+        }
+    }
+
+    if (gNumProbes > 0)
+    {
+        if (gInputSoupFilePath.empty() || gNumIslands > 1 || isEnsemble() || gNumForks > 0)
+        {
+            cerr << "Probes need a soup file to take genotypes from, and don't run it." << endl;
+            return false;
+        }
+
+        if (gRunDuration > std::numeric_limits<u_int32_t>::max())
+        {
+            cerr << "Probes can run for at most " << std::numeric_limits<u_int32_t>::max() << " instructions." << endl;
+            return false;
+        }
+    }
+
+    if (gNumShards > 1 && (gNumIslands > 1 || isEnsemble()))
+    {
+        cerr << "Only a single soup can be sharded." << endl;
+        return false;
+    }
+
+    if ((!gListenAddress.empty() || !gPeerAddresses.empty()) && (gNumIslands > 1 || isEnsemble()))
+    {
+        cerr << "Only a single soup can exchange migrants with other processes." << endl;
+        return false;
+    }
+
+    if (gShareGenotypes && gNumIslands == 1 && !isEnsemble())
+    {
+        cerr << "Only islands or ensembles can share genotypes." << endl;
+        return false;
+    }
+
+    if (gDataInterval > 0 && gDataCycles > 0)
+    {
+        cerr << "Collect data every N instructions, or every N cycles, but not both." << endl;
+        return false;
+    }
     
     return true;
 }
@@ -183,9 +383,30 @@ static World* createWorld()
         theWorld->insertCreature(gSoupSize / 2, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
     }
 
+    if (gNumShards > 0)
+    {
+        Settings shardSettings = theWorld->settings();
+        shardSettings.setNumShards(gNumShards);
+        theWorld->setSettings(shardSettings);
+    }
+    theWorld->setShardThreads(gNumThreads);
+
     return theWorld;
 }
 
+// The output soup path without its extension, or inDefaultName if none was given.
+static string outputSoupBaseName(const string& inDefaultName, const string& inExtension)
+{
+    if (gOutputSoupFilePath.empty())
+        return inDefaultName;
+
+    string fileSuffix = "." + inExtension;
+    if (gOutputSoupFilePath.compare(gOutputSoupFilePath.length() - fileSuffix.length(), fileSuffix.length(), fileSuffix) == 0)
+        return string(gOutputSoupFilePath, 0, gOutputSoupFilePath.length() - fileSuffix.length());
+
+    return gOutputSoupFilePath;
+}
+
 static ostream* uniqueOutputStream(const string& inPrefix, const string& inExtension)
 {
     for (u_int32_t counter = 0; counter < 10000; ++counter)
@@ -213,6 +434,709 @@ static ostream* uniqueOutputStream(const string& inPrefix, const string& inExten
 }
 
 
+static bool convertDataLog(const string& inLogPath)
+{
+    const string logSuffix = ".mtcols";
+    string csvPath = inLogPath;
+    if (csvPath.length() > logSuffix.length() && csvPath.compare(csvPath.length() - logSuffix.length(), logSuffix.length(), logSuffix) == 0)
+        csvPath.erase(csvPath.length() - logSuffix.length());
+    csvPath += ".csv";
+
+    if (!convertColumnarLogToCSV(inLogPath, csvPath))
+    {
+        cerr << "Failed to convert data log " << inLogPath << endl;
+        return false;
+    }
+
+    cout << "Wrote " << csvPath << endl;
+    return true;
+}
+
+// Runs gNumIslands soups in parallel, with migration between them, until interrupted or for
+// gRunDuration instructions each, and saves each one.
+static int runArchipelago()
+{
+    if (!gSeedSet)
+        gRandomSeed = RandomLib::RandomSeed::SeedWord();
+
+    // outlives the islands
+    auto_ptr<GenotypeRegistry> genotypeRegistry;
+    if (gShareGenotypes)
+        genotypeRegistry.reset(new GenotypeRegistry);
+
+    Archipelago archipelago(gNumIslands, gSoupSize, gSoupSettings, gRandomSeed, gTopology, gNumThreads);
+    archipelago.setMigrationInterval(gMigrationInterval);
+    archipelago.setMigrantsPerIsland(gMigrantsPerIsland);
+    if (genotypeRegistry.get())
+        archipelago.setGenotypeRegistry(genotypeRegistry.get());
+    archipelago.seedIslands(kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+
+    const string outFileExtension(gUseXMLFormat ? "mactierra_xml" : "mactierra");
+
+    std::ostringstream nameStream;
+    nameStream << "output_islands_" << gRandomSeed;
+    const string outputBaseName = outputSoupBaseName(nameStream.str(), outFileExtension);
+
+    cout << "Islands: " << archipelago.numIslands() << " (" << Archipelago::nameForTopology(gTopology) << "), on "
+         << archipelago.numThreads() << " threads" << endl;
+    cout << "Soup size: " << gSoupSize << endl;
+    cout << "Master random seed: " << gRandomSeed << endl;
+    if (genotypeRegistry.get() && archipelago.numThreads() > 1)
+        cout << "Shared genotype names depend on thread timing, and may differ between runs with the same seed" << endl;
+    if (gMigrationInterval > 0)
+        cout << "Migration: " << gMigrantsPerIsland << " creatures from each island every " << gMigrationInterval << " instructions" << endl;
+    else
+        cout << "No migration" << endl;
+    if (gRunDuration > 0)
+        cout << "Duration: " << gRunDuration << " instructions on each island" << endl;
+    else
+        cout << "No duration specified. Will run until killed" << endl;
+    if (!gConfigFilePath.empty())
+        cout << "Configuration read from " << gConfigFilePath << endl;
+
+    const u_int64_t endInstructions = archipelago.instructionsRun() + gRunDuration;
+    while (!gInterrupted)
+    {
+        const u_int64_t instructions = archipelago.instructionsRun();
+        if (gRunDuration > 0 && instructions >= endInstructions)
+            break;
+
+        u_int64_t runLength = kRunChunkLength;
+        if (gRunDuration > 0)
+            runLength = min(runLength, endInstructions - instructions);
+
+        archipelago.run(runLength);
+    }
+
+    cout << "Ran " << archipelago.instructionsRun() << " instructions on each island; " << archipelago.numMigrants()
+         << " creatures migrated, " << archipelago.numMigrantsLost() << " found no space" << endl;
+    if (genotypeRegistry.get())
+        cout << "Shared genotypes: " << genotypeRegistry->numGenotypes() << endl;
+
+    int result = 0;
+    for (u_int32_t i = 0; i < archipelago.numIslands(); ++i)
+    {
+        std::ostringstream islandNameStream;
+        islandNameStream << outputBaseName << "_island" << i;
+
+        ostream* outputStream = uniqueOutputStream(islandNameStream.str(), outFileExtension);
+        if (!outputStream)
+        {
+            cerr << "Failed to create output file " << islandNameStream.str() << "." << outFileExtension << endl;
+            result = 1;
+            continue;
+        }
+
+        {
+            WorldExporter exporter(*outputStream, gUseXMLFormat ? WorldArchiver::kXML : WorldArchiver::kBinary);
+            exporter.saveWorld(archipelago.island(i));
+        }
+        delete outputStream;
+
+        cout << "Output soup file: " << gOutputSoupFilePath << "." << outFileExtension << endl;
+    }
+
+    return result;
+}
+
+// Adds a run of each configuration file listed in gEnsembleListPath, named after the file.
+static bool addEnsembleConfigurations(Ensemble& ioEnsemble)
+{
+    std::ifstream listStream(gEnsembleListPath.c_str());
+    if (!listStream)
+    {
+        cerr << "Failed to open ensemble list " << gEnsembleListPath << endl;
+        return false;
+    }
+
+    string configPath;
+    while (getline(listStream, configPath))
+    {
+        if (configPath.empty() || configPath[0] == '#')
+            continue;
+
+        SoupConfiguration config;
+        if (!readConfigurationFile(configPath, config))
+            return false;
+
+        string runName = configPath.substr(configPath.find_last_of('/') + 1);
+        runName = runName.substr(0, runName.find('.'));
+        ioEnsemble.addConfiguration(runName, config, gNumReplicates);
+    }
+    return true;
+}
+
+// Runs replicates of a list of configurations, and/or a grid of soup sizes and mutation
+// rates, to the same duration on a pool of threads.
+static int runEnsemble()
+{
+    if (!gSeedSet)
+        gRandomSeed = RandomLib::RandomSeed::SeedWord();
+
+    // outlives the worlds
+    auto_ptr<GenotypeRegistry> genotypeRegistry;
+    if (gShareGenotypes)
+        genotypeRegistry.reset(new GenotypeRegistry);
+
+    Ensemble ensemble(gRandomSeed, gNumThreads);
+    if (!gEnsembleListPath.empty() && !addEnsembleConfigurations(ensemble))
+        return 1;
+
+    if (genotypeRegistry.get())
+        ensemble.setGenotypeRegistry(genotypeRegistry.get());
+
+    if (!gSweepSoupSizes.empty() || !gSweepMutationScales.empty())
+    {
+        vector<u_int32_t> soupSizes(gSweepSoupSizes);
+        if (soupSizes.empty())
+            soupSizes.push_back(gSoupSize);
+
+        vector<double> mutationScales(gSweepMutationScales);
+        if (mutationScales.empty())
+            mutationScales.push_back(1.0);
+
+        ensemble.addGrid("grid", gSoupSettings, soupSizes, mutationScales, gNumReplicates);
+    }
+
+    ensemble.setRunLength(gRunDuration);
+    if (!gDataLogPrefix.empty())
+        ensemble.setDataLogging(gDataLogPrefix + "_", gDataInterval);
+
+    const string outFileExtension(gUseXMLFormat ? "mactierra_xml" : "mactierra");
+    std::ostringstream nameStream;
+    nameStream << "ensemble_" << gRandomSeed;
+    const string outputPrefix = outputSoupBaseName(nameStream.str(), outFileExtension) + "_";
+
+    cout << "Ensemble: " << ensemble.numRuns() << " runs of " << gRunDuration << " instructions, on " << ensemble.numThreads() << " threads" << endl;
+    cout << "Master random seed: " << gRandomSeed << endl;
+    cout << "Output soup files: " << outputPrefix << "*." << outFileExtension << endl;
+    if (genotypeRegistry.get() && ensemble.numThreads() > 1)
+        cout << "Shared genotype names depend on thread timing, and may differ between runs with the same seed" << endl;
+    if (!gDataLogPrefix.empty())
+        cout << "Data logs: " << gDataLogPrefix << "_*_population.mtcols" << endl;
+
+    if (!ensemble.start())
+    {
+        cerr << "Failed to create data logs " << gDataLogPrefix << "_*_population.mtcols" << endl;
+        return 1;
+    }
+
+    const time_t startTime = time(NULL);
+    time_t lastReportTime = startTime;
+    while (!gInterrupted && ensemble.runRound())
+    {
+        const time_t now = time(NULL);
+        if (now - lastReportTime >= 5)
+        {
+            cout << static_cast<int>(ensemble.fractionComplete() * 100) << "% complete, "
+                 << static_cast<u_int64_t>(ensemble.instructionsRun() / max<double>(now - startTime, 1)) << " instructions per second" << endl;
+            lastReportTime = now;
+        }
+    }
+
+    for (size_t i = 0; i < ensemble.numRuns(); ++i)
+    {
+        const Ensemble::Run& curRun = ensemble.run(i);
+        cout << curRun.mName << ": " << curRun.mInstructionsRun << " instructions, "
+             << static_cast<u_int64_t>(curRun.instructionsPerSecond()) << " per second" << endl;
+    }
+    if (genotypeRegistry.get())
+        cout << "Shared genotypes: " << genotypeRegistry->numGenotypes() << endl;
+
+    int result = 0;
+    if (!ensemble.saveWorlds(outputPrefix, gUseXMLFormat ? WorldArchiver::kXML : WorldArchiver::kBinary))
+    {
+        cerr << "Failed to save some soups to " << outputPrefix << "*." << outFileExtension << endl;
+        result = 1;
+    }
+
+    const string summaryPath = outputPrefix + "summary.tsv";
+    std::ofstream summaryStream(summaryPath.c_str());
+    ensemble.writeSummary(summaryStream);
+    if (!summaryStream)
+    {
+        cerr << "Failed to write ensemble summary " << summaryPath << endl;
+        result = 1;
+    }
+    else
+        cout << "Wrote " << summaryPath << endl;
+
+    return result;
+}
+
+// Runs one soup until interrupted, or for gRunDuration instructions, then saves it.
+static int runWorld(World* theWorld)
+{
+    const string outFileExtension(gUseXMLFormat ? "mactierra_xml" : "mactierra");
+
+    ostream* outputStream = NULL;
+
+    std::ostringstream nameStream;
+    nameStream << "output_soup_" << gRandomSeed;
+    gOutputSoupFilePath = outputSoupBaseName(nameStream.str(), outFileExtension);
+
+    if (!(outputStream = uniqueOutputStream(gOutputSoupFilePath, outFileExtension)))
+    {
+        cout << "Failed to create output file " << gOutputSoupFilePath << "." << outFileExtension;
+        exit(1);
+    }
+    
+    cout << "Soup size: " << gSoupSize << endl;
+    cout << "Random seed: " << gRandomSeed << endl;
+    if (theWorld->settings().numShards() > 1)
+        cout << "Shards: " << theWorld->settings().numShards() << endl;
+    if (gRunDuration > 0)
+        cout << "Duration: " << gRunDuration << endl;
+    else
+        cout << "No duration specified. Will run until killed" << endl;
+
+    if (!gConfigFilePath.empty())
+        cout << "Configuration read from " << gConfigFilePath << endl;
+    if (!gInputSoupFilePath.empty())
+        cout << "Input soup file: " << gInputSoupFilePath << endl;
+    cout << "Output soup file: " << gOutputSoupFilePath << "." << outFileExtension << endl;
+
+    EventLogWriter eventLog;
+    if (!gEventLogFilePath.empty())
+    {
+        if (!eventLog.open(gEventLogFilePath, gCompressEventLog))
+        {
+            cerr << "Failed to create event log " << gEventLogFilePath << endl;
+            exit(1);
+        }
+        theWorld->addEventListener(&eventLog, eventLog.eventMask());
+        cout << "Event log: " << gEventLogFilePath << (gCompressEventLog ? " (compressed)" : "") << endl;
+    }
+
+    PopulationLogSink populationLog(gDataCycles > 0 ? DataLogger::kCollectionSlicerCycle : DataLogger::kCollectionPeriodic);
+    GenotypeLogSink genotypeLog(gNumTopGenotypes);
+
+    auto_ptr<SoupHeatmap> heatmap;
+    if (gHeatmapBlockSize > 0)
+        heatmap.reset(new SoupHeatmap(theWorld->soupSize(), gHeatmapBlockSize, gHeatmapSampling));
+    HeatmapLogSink heatmapLog(heatmap.get());
+    OpcodeCensusLogSink censusLog;
+
+    vector<ColumnarLogSink*> dataLogs;
+    if (!gDataLogPrefix.empty())
+    {
+        if (!populationLog.open(gDataLogPrefix + "_population.mtcols") || !genotypeLog.open(gDataLogPrefix + "_genotypes.mtcols")
+            || (heatmap.get() && !heatmapLog.open(gDataLogPrefix + "_heatmap.mtcols"))
+            || (gOpcodeCensus && !censusLog.open(gDataLogPrefix + "_opcodes.mtcols")))
+        {
+            cerr << "Failed to create data logs " << gDataLogPrefix << "_*.mtcols" << endl;
+            exit(1);
+        }
+
+        dataLogs.push_back(&genotypeLog);
+        if (heatmap.get())
+        {
+            theWorld->setHeatmap(heatmap.get());
+            dataLogs.push_back(&heatmapLog);
+        }
+        if (gOpcodeCensus)
+            dataLogs.push_back(&censusLog);
+
+        DataCollector* collector = theWorld->dataCollector();
+        collector->addRecordRing(populationLog.recordRing());
+        if (gDataCycles > 0)
+        {
+            collector->setCollectionCycles(gDataCycles, theWorld->timeSlicer().cycleCount());
+            for (size_t i = 0; i < dataLogs.size(); ++i)
+                collector->addCyclicalLogger(dataLogs[i]);
+            cout << "Data log: " << gDataLogPrefix << "_*.mtcols every " << gDataCycles << " cycles" << endl;
+        }
+        else
+        {
+            if (gDataInterval > 0)
+                collector->setCollectionInterval(gDataInterval, theWorld->timeSlicer().instructionsExecuted());
+            for (size_t i = 0; i < dataLogs.size(); ++i)
+                collector->addPeriodicLogger(dataLogs[i]);
+            cout << "Data log: " << gDataLogPrefix << "_*.mtcols every " << collector->collectionInterval() << " instructions" << endl;
+        }
+
+        if (heatmap.get())
+            cout << "Soup heatmap: blocks of " << heatmap->blockSize() << " cells, sampling 1 in " << heatmap->sampleInterval() << endl;
+    }
+
+    InteractionMatrix interactions;
+    if (!gInteractionsFilePath.empty())
+    {
+        theWorld->setInteractionMatrix(&interactions);
+        cout << "Interaction matrix: " << gInteractionsFilePath << endl;
+    }
+
+    // migrants from other processes
+    auto_ptr<MigrationTransport> transport;
+    RandomLib::Random migrationRNG(gRandomSeed);
+    if (!gListenAddress.empty() || !gPeerAddresses.empty())
+    {
+        transport.reset(new MigrationTransport(gRandomSeed));
+        if (!gListenAddress.empty() && !transport->listen(gListenAddress))
+        {
+            cerr << "Failed to listen for migrants at " << gListenAddress << endl;
+            exit(1);
+        }
+        for (size_t i = 0; i < gPeerAddresses.size(); ++i)
+            transport->addPeer(gPeerAddresses[i]);
+        transport->start();
+
+        if (!gListenAddress.empty())
+            cout << "Listening for migrants at " << transport->listenAddress() << endl;
+        if (!gPeerAddresses.empty())
+            cout << "Migration: " << gMigrantsPerIsland << " creatures to " << gPeerAddresses.size() << " peers every " << gMigrationInterval << " instructions" << endl;
+    }
+
+    const u_int64_t endInstructions = theWorld->timeSlicer().instructionsExecuted() + gRunDuration;
+    u_int64_t nextMigration = theWorld->timeSlicer().instructionsExecuted() + gMigrationInterval;
+    while (!gInterrupted)
+    {
+        const u_int64_t instructions = theWorld->timeSlicer().instructionsExecuted();
+        if (gRunDuration > 0 && instructions >= endInstructions)
+            break;
+
+        u_int64_t runLength = kRunChunkLength;
+        if (gRunDuration > 0)
+            runLength = min(runLength, endInstructions - instructions);
+
+        if (transport.get() && gMigrationInterval > 0)
+        {
+            theWorld->iterate(static_cast<u_int32_t>(min(runLength, nextMigration - instructions)));
+
+            if (theWorld->timeSlicer().instructionsExecuted() >= nextMigration)
+            {
+                transport->exchange(*theWorld, gMigrantsPerIsland, migrationRNG);
+                nextMigration += gMigrationInterval;
+            }
+        }
+        else
+            theWorld->iterate(static_cast<u_int32_t>(runLength));
+    }
+
+    if (transport.get())
+    {
+        cout << "Sent " << transport->numMigrantsSent() << " migrants; received " << transport->numMigrantsReceived() << ", of which "
+             << transport->numMigrantsLost() << " found no space" << endl;
+        transport.reset();
+    }
+
+    if (eventLog.isOpen())
+    {
+        theWorld->removeEventListener(&eventLog);
+        eventLog.close();
+        cout << "Logged " << eventLog.numRecords() << " births and deaths" << endl;
+    }
+
+    if (populationLog.isOpen())
+    {
+        DataCollector* collector = theWorld->dataCollector();
+        collector->removeRecordRing(populationLog.recordRing());
+        populationLog.close();
+        for (size_t i = 0; i < dataLogs.size(); ++i)
+        {
+            if (gDataCycles > 0)
+                collector->removeCyclicalLogger(dataLogs[i]);
+            else
+                collector->removePeriodicLogger(dataLogs[i]);
+            dataLogs[i]->close();
+        }
+        theWorld->setHeatmap(NULL);
+
+        cout << "Logged " << populationLog.numRows() << " data collections" << endl;
+        if (populationLog.numDropped() > 0)
+            cerr << populationLog.numDropped() << " collections were dropped from the population log" << endl;
+
+        if (gWriteCSV)
+        {
+            convertDataLog(gDataLogPrefix + "_population.mtcols");
+            convertDataLog(gDataLogPrefix + "_genotypes.mtcols");
+            if (heatmap.get())
+                convertDataLog(gDataLogPrefix + "_heatmap.mtcols");
+            if (gOpcodeCensus)
+                convertDataLog(gDataLogPrefix + "_opcodes.mtcols");
+        }
+    }
+    
+    if (!gInteractionsFilePath.empty())
+    {
+        theWorld->setInteractionMatrix(NULL);
+
+        std::ofstream interactionsStream(gInteractionsFilePath.c_str());
+        interactions.write(interactionsStream);
+        if (!interactionsStream)
+            cerr << "Failed to write interaction matrix " << gInteractionsFilePath << endl;
+        else
+            cout << "Wrote " << interactions.numEntries() << " genotype interactions to " << gInteractionsFilePath << endl;
+    }
+
+    if (outputStream) {
+        WorldExporter exporter(*outputStream, gUseXMLFormat ? WorldArchiver::kXML : WorldArchiver::kBinary);
+        exporter.saveWorld(theWorld);
+    }
+    
+    delete outputStream;
+    delete theWorld;
+    
+    return 0;
+}
+
+// A run forked from the loaded soup.
+struct ForkedRun
+{
+    ForkedRun(const string& inName, u_int32_t inSeed, double inMutationScale)
+    : mName(inName)
+    , mSeed(inSeed)
+    , mMutationScale(inMutationScale)
+    , mPid(-1)
+    , mReportFD(-1)
+    , mStatus(0)
+    {
+    }
+
+    string      mName;
+    u_int32_t   mSeed;
+    double      mMutationScale;
+    pid_t       mPid;
+    int         mReportFD;      // the child writes its output paths here
+    string      mOutputPaths;
+    int         mStatus;        // from waitpid()
+};
+
+// In the child: reseeds and rescales the inherited soup, runs it, and reports where it was saved.
+static void runForkedChild(World* inWorld, const ForkedRun& inRun, const string& inOutputBaseName, int inReportFD)
+{
+    Settings settings = inWorld->settings();
+    settings.scaleMutationRates(inRun.mMutationScale, inWorld->soupSize());
+
+    inWorld->setInitialRandomSeed(inRun.mSeed);
+    // after reseeding, so that the next mutation times are drawn afresh
+    inWorld->setSettings(settings);
+
+    gRandomSeed = inRun.mSeed;
+    gOutputSoupFilePath = inOutputBaseName + "_" + inRun.mName;
+    if (!gDataLogPrefix.empty())
+        gDataLogPrefix += "_" + inRun.mName;
+
+    int result = runWorld(inWorld);
+
+    string report = gOutputSoupFilePath + (gUseXMLFormat ? ".mactierra_xml" : ".mactierra");
+    if (!gDataLogPrefix.empty())
+        report += " " + gDataLogPrefix + "_*.mtcols";
+    if (write(inReportFD, report.data(), report.length()) != static_cast<ssize_t>(report.length()))
+        result = 1;
+
+    cout.flush();
+    cerr.flush();
+    _exit(result);
+}
+
+// Reads the child's report, then closes the pipe.
+static void readForkedRunReport(ForkedRun& ioRun)
+{
+    char buffer[1024];
+    ssize_t numRead;
+    while ((numRead = read(ioRun.mReportFD, buffer, sizeof(buffer))) != 0)
+    {
+        if (numRead < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        ioRun.mOutputPaths.append(buffer, numRead);
+    }
+    close(ioRun.mReportFD);
+    ioRun.mReportFD = -1;
+}
+
+static string forkedRunStatus(const ForkedRun& inRun)
+{
+    std::ostringstream statusStream;
+    if (inRun.mPid == -1)
+        statusStream << "not run";
+    else if (WIFSIGNALED(inRun.mStatus))
+        statusStream << "killed by signal " << WTERMSIG(inRun.mStatus);
+    else
+        statusStream << "exit " << WEXITSTATUS(inRun.mStatus);
+    return statusStream.str();
+}
+
+// Loads or creates the soup once, then forks gNumForks children for each mutation scale,
+// each reseeded, so that the children share the soup's pages until they write to them.
+// No more than gNumThreads children (one per processor by default) run at a time.
+static int runForks()
+{
+    // loading a soup replaces gRandomSeed with the soup's own
+    const bool seedSet = gSeedSet;
+    const u_int32_t requestedSeed = gRandomSeed;
+
+    World* theWorld = createWorld();
+    const u_int32_t masterSeed = seedSet ? requestedSeed : gRandomSeed;
+
+    vector<double> mutationScales(gSweepMutationScales);
+    if (mutationScales.empty())
+        mutationScales.push_back(1.0);
+
+    vector<ForkedRun> runs;
+    for (size_t i = 0; i < mutationScales.size(); ++i)
+    {
+        for (u_int32_t j = 0; j < gNumForks; ++j)
+        {
+            std::ostringstream nameStream;
+            nameStream << "fork_m" << mutationScales[i] << "_r" << j;
+            runs.push_back(ForkedRun(nameStream.str(), Ensemble::seedForRun(masterSeed, runs.size()), mutationScales[i]));
+        }
+    }
+
+    const u_int32_t maxRunning = gNumThreads > 0 ? gNumThreads : max(boost::thread::hardware_concurrency(), 1U);
+
+    const string outFileExtension(gUseXMLFormat ? "mactierra_xml" : "mactierra");
+    std::ostringstream nameStream;
+    nameStream << "output_" << masterSeed;
+    const string outputBaseName = outputSoupBaseName(nameStream.str(), outFileExtension);
+
+    cout << "Forking " << runs.size() << " runs of " << gRunDuration << " instructions, " << maxRunning << " at a time" << endl;
+    if (!gInputSoupFilePath.empty())
+        cout << "Input soup file: " << gInputSoupFilePath << endl;
+    cout << "Master random seed: " << masterSeed << endl;
+    cout << "Output soup files: " << outputBaseName << "_fork_*." << outFileExtension << endl;
+
+    size_t nextRun = 0;
+    u_int32_t numRunning = 0;
+    while (nextRun < runs.size() || numRunning > 0)
+    {
+        while (!gInterrupted && numRunning < maxRunning && nextRun < runs.size())
+        {
+            ForkedRun& curRun = runs[nextRun];
+
+            int reportPipe[2];
+            if (pipe(reportPipe) != 0)
+            {
+                cerr << "Failed to create a pipe for " << curRun.mName << endl;
+                gInterrupted = true;
+                break;
+            }
+
+            // don't let the child inherit unwritten output
+            cout.flush();
+            cerr.flush();
+
+            pid_t pid = fork();
+            if (pid == 0)
+            {
+                close(reportPipe[0]);
+                for (size_t i = 0; i < nextRun; ++i)
+                    if (runs[i].mReportFD != -1)
+                        close(runs[i].mReportFD);
+
+                runForkedChild(theWorld, curRun, outputBaseName, reportPipe[1]);
+            }
+
+            close(reportPipe[1]);
+            if (pid == -1)
+            {
+                cerr << "Failed to fork " << curRun.mName << endl;
+                close(reportPipe[0]);
+                gInterrupted = true;
+                break;
+            }
+
+            curRun.mPid = pid;
+            curRun.mReportFD = reportPipe[0];
+            ++nextRun;
+            ++numRunning;
+        }
+
+        if (numRunning == 0)
+            break;
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        for (size_t i = 0; i < nextRun; ++i)
+        {
+            if (runs[i].mPid == pid)
+            {
+                runs[i].mStatus = status;
+                readForkedRunReport(runs[i]);
+                --numRunning;
+
+                cout << runs[i].mName << " (seed " << runs[i].mSeed << "): " << forkedRunStatus(runs[i]);
+                if (!runs[i].mOutputPaths.empty())
+                    cout << ", wrote " << runs[i].mOutputPaths;
+                cout << endl;
+                break;
+            }
+        }
+    }
+
+    delete theWorld;
+
+    int result = 0;
+    const string summaryPath = outputBaseName + "_fork_summary.tsv";
+    std::ofstream summaryStream(summaryPath.c_str());
+    summaryStream << "name\tseed\tmutation_scale\tstatus\toutput" << endl;
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const ForkedRun& curRun = runs[i];
+        summaryStream << curRun.mName << "\t" << curRun.mSeed << "\t" << curRun.mMutationScale << "\t"
+                      << forkedRunStatus(curRun) << "\t" << curRun.mOutputPaths << endl;
+
+        if (curRun.mPid == -1 || !WIFEXITED(curRun.mStatus) || WEXITSTATUS(curRun.mStatus) != 0)
+            result = 1;
+    }
+
+    if (!summaryStream)
+    {
+        cerr << "Failed to write fork summary " << summaryPath << endl;
+        result = 1;
+    }
+    else
+        cout << "Wrote " << summaryPath << endl;
+
+    return result;
+}
+
+// Runs each of the most common genotypes of the loaded soup alone in a small soup, with the
+// loaded soup's settings, and prints how well it replicates.
+static int runProbes()
+{
+    World* theWorld = createWorld();
+
+    // sanityCheckOptions() limits the duration to 32 bits
+    const u_int32_t probeInstructions = gRunDuration > 0 ? static_cast<u_int32_t>(gRunDuration)
+                                                         : static_cast<u_int32_t>(GenotypeProber::kDefaultInstructions);
+    GenotypeProber prober(GenotypeProber::kDefaultSoupSize, theWorld->settings(), probeInstructions, gNumThreads);
+    prober.setRandomSeed(gRandomSeed);
+
+    cout << "Input soup file: " << gInputSoupFilePath << endl;
+    cout << "Probe soup size: " << prober.soupSize() << endl;
+    cout << "Probe duration: " << prober.instructions() << endl;
+    cout << "Random seed: " << gRandomSeed << endl;
+
+    Inventory::GenotypeVector genotypes;
+    vector<ProbeResult> results;
+    prober.probeTopGenotypes(*theWorld->inventory(), gNumProbes, genotypes, results);
+
+    cout << "genotype\talive\tbirths\texact_births\taccuracy\tbirths_per_million\tfinal_population" << endl;
+    for (u_int32_t i = 0; i < genotypes.size(); ++i)
+    {
+        const ProbeResult& result = results[i];
+        cout << genotypes[i]->name() << "\t" << genotypes[i]->numberAlive() << "\t" << result.mBirths << "\t"
+             << result.mExactBirths << "\t" << result.accuracy() << "\t" << result.replicationRate() << "\t"
+             << result.mFinalPopulation << endl;
+    }
+
+    delete theWorld;
+    return 0;
+}
+
 extern "C" void interruptSignalHandler(int inSignal)
 {
     cerr << "Interrupted; saving soup" << endl;
@@ -292,6 +1216,177 @@ extern "C" int main(int argc, char* argv[])
                 gUseXMLFormat = true;
                 break;
 
+            case 'e':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gEventLogFilePath = optarg;
+                break;
+
+            case 'z':
+                gCompressEventLog = true;
+                break;
+
+            case 'l':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gDataLogPrefix = optarg;
+                break;
+
+            case 'i':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gDataInterval = strtoull(optarg, NULL, 0);
+                break;
+
+            case 'y':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gDataCycles = strtoull(optarg, NULL, 0);
+                break;
+
+            case 'g':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gNumTopGenotypes = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'C':
+                gWriteCSV = true;
+                break;
+
+            case 'b':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gHeatmapBlockSize = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'p':
+                if (!optarg || strtoul(optarg, NULL, 0) == 0) 
+                    ++errors;
+                else
+                    gHeatmapSampling = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'O':
+                gOpcodeCensus = true;
+                break;
+
+            case 'm':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gInteractionsFilePath = optarg;
+                break;
+
+            case 'a':
+                if (!optarg || strtoul(optarg, NULL, 0) == 0) 
+                    ++errors;
+                else
+                    gNumIslands = strtoul(optarg, NULL, 0);
+                break;
+
+            case 't':
+                if (!optarg || !Archipelago::topologyFromName(optarg, gTopology)) 
+                    ++errors;
+                break;
+
+            case 'M':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gMigrationInterval = strtoull(optarg, NULL, 0);
+                break;
+
+            case 'n':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gMigrantsPerIsland = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'j':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gNumThreads = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'P':
+                if (!optarg || strtoul(optarg, NULL, 0) == 0) 
+                    ++errors;
+                else
+                    gNumShards = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'L':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gListenAddress = optarg;
+                break;
+
+            case 'N':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gPeerAddresses.push_back(optarg);
+                break;
+
+            case 'E':
+                if (!optarg) 
+                    ++errors;
+                else
+                    gEnsembleListPath = optarg;
+                break;
+
+            case 'R':
+                if (!optarg || strtoul(optarg, NULL, 0) == 0) 
+                    ++errors;
+                else
+                    gNumReplicates = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'S':
+                if (!optarg || !parseNumberList(optarg, gSweepSoupSizes)) 
+                    ++errors;
+                break;
+
+            case 'U':
+                if (!optarg || !parseNumberList(optarg, gSweepMutationScales)) 
+                    ++errors;
+                break;
+
+            case 'F':
+                if (!optarg || strtoul(optarg, NULL, 0) == 0) 
+                    ++errors;
+                else
+                    gNumForks = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'G':
+                gShareGenotypes = true;
+                break;
+
+            case 'Q':
+                if (!optarg || strtoul(optarg, NULL, 0) == 0) 
+                    ++errors;
+                else
+                    gNumProbes = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'T':
+                if (!optarg) 
+                    ++errors;
+                else
+                    exit(convertDataLog(optarg) ? 0 : 1);
+                break;
+
             default: 
                 ++errors;
                 break;
@@ -310,57 +1405,17 @@ extern "C" int main(int argc, char* argv[])
     signal(SIGINT, interruptSignalHandler);
     signal(SIGTERM, interruptSignalHandler);
     
-    World*  theWorld = createWorld();
-
-    const string outFileExtension(gUseXMLFormat ? "mactierra_xml" : "mactierra");
-
-    ostream* outputStream = NULL;
+    if (gNumProbes > 0)
+        return runProbes();
 
-    if (gOutputSoupFilePath.empty())
-    {
-        std::ostringstream nameStream;
-        nameStream << "output_soup_" << gRandomSeed;
-        gOutputSoupFilePath = nameStream.str();
-    }
-    else
-    {
-        string fileSuffix = "." + outFileExtension;
-        if (gOutputSoupFilePath.compare(gOutputSoupFilePath.length() - fileSuffix.length(), fileSuffix.length(), fileSuffix) == 0)
-            gOutputSoupFilePath = string(gOutputSoupFilePath, 0, gOutputSoupFilePath.length() - fileSuffix.length());
-    }
+    if (gNumIslands > 1)
+        return runArchipelago();
 
-    if (!(outputStream = uniqueOutputStream(gOutputSoupFilePath, outFileExtension)))
-    {
-        cout << "Failed to create output file " << gOutputSoupFilePath << "." << outFileExtension;
-        exit(1);
-    }
-    
-    cout << "Soup size: " << gSoupSize << endl;
-    cout << "Random seed: " << gRandomSeed << endl;
-    if (gRunDuration > 0)
-        cout << "Duration: " << gRunDuration << endl;
-    else
-        cout << "No duration specified. Will run until killed" << endl;
+    if (isEnsemble())
+        return runEnsemble();
 
-    if (!gConfigFilePath.empty())
-        cout << "Configuration read from " << gConfigFilePath << endl;
-    if (!gInputSoupFilePath.empty())
-        cout << "Input soup file: " << gInputSoupFilePath << endl;
-    cout << "Output soup file: " << gOutputSoupFilePath << "." << outFileExtension << endl;
+    if (gNumForks > 0)
+        return runForks();
 
-    const u_int32_t cycleLength = gRunDuration > 0 ? gRunDuration : 50000;
-    while (!gInterrupted)
-    {
-        theWorld->iterate(cycleLength);
-    }
-    
-    if (outputStream) {
-        WorldExporter exporter(*outputStream, gUseXMLFormat ? WorldArchiver::kXML : WorldArchiver::kBinary);
-        exporter.saveWorld(theWorld);
-    }
-    
-    delete outputStream;
-    delete theWorld;
-    
-    return 0;
+    return runWorld(createWorld());
 }
@@ -0,0 +1,242 @@
+/*
+ *  mactierra_events.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+// Queries the event logs written by "mactierra --event-log". The first run over a log builds
+// an index next to it, which later runs reuse.
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <iostream>
+
+#include "options.h"
+
+#include "MT_EventLogIndex.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static const char * const kOptionsList[] = {
+    "?|?",
+    "H|help",
+    "g:genotype <name>",
+    "i:interval <number>",
+    "l:lifespans <from:to>",
+    "d:descendants <creature id>",
+    "j:threads <number>",
+    "n|no-save-index",
+    NULL
+};
+
+string      gGenotypeName;
+u_int64_t   gSampleInterval = 0;
+
+bool        gShowLifespans = false;
+u_int64_t   gLifespansFrom = 0;
+u_int64_t   gLifespansTo = ULLONG_MAX;
+
+bool        gShowDescendants = false;
+creature_id gAncestorID = 0;
+
+u_int32_t   gNumThreads = 0;
+bool        gSaveIndex = true;
+
+static bool parseRange(const char* inRange, u_int64_t& outFrom, u_int64_t& outTo)
+{
+    char* rangeEnd = NULL;
+    outFrom = strtoull(inRange, &rangeEnd, 0);
+    if (*rangeEnd != ':')
+        return false;
+
+    // "from:" runs to the end of the log
+    const char* toStart = rangeEnd + 1;
+    if (*toStart == '\0')
+    {
+        outTo = ULLONG_MAX;
+        return true;
+    }
+
+    outTo = strtoull(toStart, &rangeEnd, 0);
+    return *rangeEnd == '\0' && outFrom <= outTo;
+}
+
+static void printSummary(const EventLogIndex& inIndex, const string& inLogPath)
+{
+    cout << "Event log: " << inLogPath << endl;
+    cout << "Blocks: " << inIndex.numBlocks() << (inIndex.indexWasCurrent() ? "" : " (index updated)") << endl;
+    cout << "Records: " << inIndex.numRecords() << endl;
+    cout << "Instructions: " << inIndex.firstInstructions() << " to " << inIndex.lastInstructions() << endl;
+    if (inIndex.isCorrupt())
+        cout << "Warning: the log is damaged after instruction " << inIndex.lastInstructions() << endl;
+}
+
+static void printPopulation(const EventLogIndex& inIndex)
+{
+    EventLogIndex::PopulationSeries series;
+    if (!inIndex.genotypePopulation(gGenotypeName, gSampleInterval, series))
+    {
+        cerr << "Not a genotype name: " << gGenotypeName << endl;
+        exit(1);
+    }
+
+    cout << "# population of " << gGenotypeName << endl;
+    cout << "instructions\tpopulation" << endl;
+    for (EventLogIndex::PopulationSeries::const_iterator it = series.begin(); it != series.end(); ++it)
+        cout << it->first << "\t" << it->second << endl;
+}
+
+static void printLifespans(const EventLogIndex& inIndex)
+{
+    vector<u_int64_t> ages;
+    inIndex.lifespans(gLifespansFrom, gLifespansTo, ages);
+
+    cout << "# lifespans of " << ages.size() << " creatures" << endl;
+    if (ages.empty())
+        return;
+
+    sort(ages.begin(), ages.end());
+
+    double total = 0;
+    for (vector<u_int64_t>::const_iterator it = ages.begin(); it != ages.end(); ++it)
+        total += *it;
+
+    cout << "mean\t" << total / ages.size() << endl;
+    cout << "min\t" << ages.front() << endl;
+    cout << "median\t" << ages[ages.size() / 2] << endl;
+    cout << "90%\t" << ages[ages.size() * 9 / 10] << endl;
+    cout << "max\t" << ages.back() << endl;
+
+    // power-of-two buckets, since lifespans span several orders of magnitude
+    cout << "age <\tcount" << endl;
+    u_int64_t bucketLimit = 1;
+    size_t bucketStart = 0;
+    while (bucketStart < ages.size())
+    {
+        size_t bucketEnd = lower_bound(ages.begin() + bucketStart, ages.end(), bucketLimit) - ages.begin();
+        if (bucketEnd > bucketStart)
+            cout << bucketLimit << "\t" << (bucketEnd - bucketStart) << endl;
+
+        bucketStart = bucketEnd;
+        if (bucketLimit > ULLONG_MAX / 2)
+            bucketLimit = ULLONG_MAX;
+        else
+            bucketLimit *= 2;
+    }
+}
+
+static void printDescendants(const EventLogIndex& inIndex)
+{
+    vector<EventLogRecord> births;
+    inIndex.descendants(gAncestorID, births);
+
+    cout << "# " << births.size() << " descendants of creature " << gAncestorID << endl;
+    cout << "creature\tparent\tborn\tgeneration\tgenotype" << endl;
+    for (vector<EventLogRecord>::const_iterator it = births.begin(); it != births.end(); ++it)
+    {
+        const string genotypeName = it->genotypeName();
+        cout << it->mCreatureID << "\t" << it->mParentID << "\t" << it->mInstructions << "\t" << it->mGeneration << "\t"
+             << (genotypeName.empty() ? "-" : genotypeName) << endl;
+    }
+}
+
+extern "C" int main(int argc, char* argv[])
+{
+    Options opts(*argv, kOptionsList);
+
+    int  optchar;
+    const char * optarg;
+    int  errors = 0;
+
+    OptArgvIter  iter(--argc, ++argv);
+    while ((optchar = opts(iter, optarg)))
+    {
+        switch (optchar)
+        {
+            case '?':
+            case 'H':
+                opts.usage(cout, "event-log");
+                exit(0);
+
+            case 'g':
+                if (!optarg)
+                    ++errors;
+                else
+                    gGenotypeName = optarg;
+                break;
+
+            case 'i':
+                if (!optarg)
+                    ++errors;
+                else
+                    gSampleInterval = strtoull(optarg, NULL, 0);
+                break;
+
+            case 'l':
+                if (!optarg || !parseRange(optarg, gLifespansFrom, gLifespansTo))
+                    ++errors;
+                else
+                    gShowLifespans = true;
+                break;
+
+            case 'd':
+                if (!optarg)
+                    ++errors;
+                else
+                {
+                    gAncestorID = strtoul(optarg, NULL, 0);
+                    gShowDescendants = true;
+                }
+                break;
+
+            case 'j':
+                if (!optarg)
+                    ++errors;
+                else
+                    gNumThreads = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'n':
+                gSaveIndex = false;
+                break;
+
+            default:
+                ++errors;
+                break;
+        }
+    }
+
+    const char* logPath = iter();
+    if (!logPath || errors)
+    {
+        opts.usage(cerr, "event-log");
+        exit(1);
+    }
+
+    EventLogIndex index;
+    index.setNumThreads(gNumThreads);
+    if (!index.open(logPath, gSaveIndex))
+    {
+        cerr << "Failed to read event log " << logPath << endl;
+        exit(1);
+    }
+
+    printSummary(index, logPath);
+
+    if (!gGenotypeName.empty())
+        printPopulation(index);
+
+    if (gShowLifespans)
+        printLifespans(index);
+
+    if (gShowDescendants)
+        printDescendants(index);
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ *  MT_AnalysisPool.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <algorithm>
+
+#include "MT_AnalysisPool.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+AnalysisPool::AnalysisPool(u_int32_t inNumThreads)
+: mNextQueue(0)
+, mNumQueued(0)
+, mNumRunning(0)
+, mStopping(false)
+{
+    u_int32_t numThreads = inNumThreads;
+    if (numThreads == 0)
+        numThreads = max(boost::thread::hardware_concurrency(), 1U);
+
+    for (u_int32_t i = 0; i < numThreads; ++i)
+        mQueues.push_back(new WorkerQueue);
+
+    for (u_int32_t i = 0; i < numThreads; ++i)
+        mThreads.create_thread(WorkerThreadEntry(this, i));
+}
+
+AnalysisPool::~AnalysisPool()
+{
+    {
+        boost::mutex::scoped_lock lock(mStateLock);
+        mStopping = true;
+        mWorkAvailable.notify_all();
+    }
+
+    mThreads.join_all();
+
+    for (u_int32_t i = 0; i < mQueues.size(); ++i)
+        delete mQueues[i];
+}
+
+void
+AnalysisPool::submit(Task* inTask)
+{
+    WorkerQueue* queue = mQueues[mNextQueue];
+    mNextQueue = (mNextQueue + 1) % mQueues.size();
+
+    {
+        boost::mutex::scoped_lock lock(queue->mLock);
+        queue->mTasks.push_back(inTask);
+    }
+
+    boost::mutex::scoped_lock lock(mStateLock);
+    ++mNumQueued;
+    mWorkAvailable.notify_one();
+}
+
+void
+AnalysisPool::waitFor(const Task* inTask)
+{
+    boost::mutex::scoped_lock lock(mStateLock);
+    while (!inTask->isDone())
+        mTaskFinished.wait(lock);
+}
+
+void
+AnalysisPool::waitForAll()
+{
+    boost::mutex::scoped_lock lock(mStateLock);
+    while (mNumQueued > 0 || mNumRunning > 0)
+        mTaskFinished.wait(lock);
+}
+
+void
+AnalysisPool::runWorker(u_int32_t inIndex)
+{
+    while (true)
+    {
+        {
+            boost::mutex::scoped_lock lock(mStateLock);
+            while (mNumQueued == 0 && !mStopping)
+                mWorkAvailable.wait(lock);
+
+            if (mNumQueued == 0)
+                return;
+
+            // claiming one here guarantees that there is a task in some queue for us
+            --mNumQueued;
+            ++mNumRunning;
+        }
+
+        Task* task = takeTask(inIndex);
+        task->run();
+        __sync_lock_test_and_set(&task->mDone, 1);
+
+        boost::mutex::scoped_lock lock(mStateLock);
+        --mNumRunning;
+        mTaskFinished.notify_all();
+    }
+}
+
+AnalysisPool::Task*
+AnalysisPool::takeTask(u_int32_t inIndex)
+{
+    while (true)
+    {
+        {
+            WorkerQueue* ownQueue = mQueues[inIndex];
+            boost::mutex::scoped_lock lock(ownQueue->mLock);
+            if (!ownQueue->mTasks.empty())
+            {
+                Task* task = ownQueue->mTasks.front();
+                ownQueue->mTasks.pop_front();
+                return task;
+            }
+        }
+
+        for (u_int32_t i = 1; i < mQueues.size(); ++i)
+        {
+            WorkerQueue* victim = mQueues[(inIndex + i) % mQueues.size()];
+            boost::mutex::scoped_lock lock(victim->mLock);
+            if (!victim->mTasks.empty())
+            {
+                Task* task = victim->mTasks.back();
+                victim->mTasks.pop_back();
+                return task;
+            }
+        }
+
+        // Tasks are queued before they are counted, so there is always one for each claim;
+        // we can only get here if another worker took ours while we were looking.
+        boost::this_thread::yield();
+    }
+}
+
+} // namespace MacTierra
@@ -0,0 +1,99 @@
+/*
+ *  MT_AnalysisPool.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_AnalysisPool_h
+#define MT_AnalysisPool_h
+
+#include <deque>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+
+namespace MacTierra {
+
+// A pool of worker threads for analyses that are too slow to run on the engine thread.
+//
+// Each worker has its own queue. Tasks are handed out to the queues in turn; a worker takes
+// tasks from the front of its own queue, and when that is empty, steals from the back of
+// the others, so that one long analysis doesn't hold up the tasks queued behind it.
+class AnalysisPool : Noncopyable
+{
+public:
+
+    class Task
+    {
+    public:
+        Task() : mDone(0) {}
+        virtual ~Task() {}
+
+        // called on a worker thread
+        virtual void    run() = 0;
+
+        // True once run() has returned; everything it wrote is then visible to the caller.
+        bool            isDone() const      { return __sync_fetch_and_add(const_cast<volatile u_int32_t*>(&mDone), 0) != 0; }
+
+    private:
+        friend class AnalysisPool;
+        volatile u_int32_t  mDone;
+    };
+
+    // 0 means one per processor
+    AnalysisPool(u_int32_t inNumThreads = 0);
+    // Runs the tasks still queued, then stops the workers.
+    ~AnalysisPool();
+
+    u_int32_t       numThreads() const      { return mQueues.size(); }
+
+    // Tasks are not owned, and must stay alive until they are done.
+    void            submit(Task* inTask);
+
+    void            waitFor(const Task* inTask);
+    void            waitForAll();
+
+protected:
+
+    struct WorkerQueue
+    {
+        boost::mutex        mLock;
+        std::deque<Task*>   mTasks;
+    };
+
+    struct WorkerThreadEntry
+    {
+        WorkerThreadEntry(AnalysisPool* inPool, u_int32_t inIndex) : mPool(inPool), mIndex(inIndex) {}
+        void operator()()   { mPool->runWorker(mIndex); }
+        AnalysisPool*   mPool;
+        u_int32_t       mIndex;
+    };
+    friend struct WorkerThreadEntry;
+
+    void            runWorker(u_int32_t inIndex);
+    Task*           takeTask(u_int32_t inIndex);
+
+protected:
+
+    std::vector<WorkerQueue*>   mQueues;
+    boost::thread_group         mThreads;
+    u_int32_t                   mNextQueue;
+
+    boost::mutex                mStateLock;
+    boost::condition_variable   mWorkAvailable;
+    boost::condition_variable   mTaskFinished;
+    u_int32_t                   mNumQueued;         // submitted, but not yet claimed by a worker
+    u_int32_t                   mNumRunning;
+    bool                        mStopping;
+};
+
+} // namespace MacTierra
+
+#endif // MT_AnalysisPool_h
@@ -0,0 +1,310 @@
+/*
+ *  MT_Archipelago.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <algorithm>
+#include <set>
+
+#include <boost/thread.hpp>
+
+#include "MT_Archipelago.h"
+
+#include "MT_AnalysisPool.h"
+#include "MT_CellMap.h"
+#include "MT_Creature.h"
+#include "MT_Genotype.h"
+#include "MT_Inventory.h"
+#include "MT_World.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+const u_int64_t kDefaultMigrationInterval = 1000000;
+
+// Runs one island up to the end of an epoch.
+class IslandTask : public AnalysisPool::Task
+{
+public:
+    IslandTask(World* inWorld, u_int64_t inInstructions)
+    : mWorld(inWorld)
+    , mInstructions(inInstructions)
+    {
+    }
+
+    virtual void run()
+    {
+        const u_int64_t kMaxIterateCycles = 1U << 30;
+
+        u_int64_t remaining = mInstructions;
+        while (remaining > 0)
+        {
+            const u_int32_t cycles = min(remaining, kMaxIterateCycles);
+            mWorld->iterate(cycles);
+            remaining -= cycles;
+        }
+    }
+
+protected:
+    World*      mWorld;
+    u_int64_t   mInstructions;
+};
+
+struct Migrant
+{
+    Migrant(u_int32_t inDestination, const GenomeData& inGenome)
+    : mDestination(inDestination)
+    , mGenome(inGenome)
+    {
+    }
+
+    u_int32_t   mDestination;
+    GenomeData  mGenome;
+};
+
+Archipelago::Archipelago(u_int32_t inNumIslands, u_int32_t inSoupSize, const Settings& inSettings, u_int32_t inMasterSeed,
+                         ETopology inTopology, u_int32_t inNumThreads)
+: mPool(NULL)
+, mMasterSeed(inMasterSeed)
+, mTopology(inTopology)
+, mMigrationInterval(kDefaultMigrationInterval)
+, mMigrantsPerIsland(1)
+, mInstructionsRun(0)
+, mNumMigrations(0)
+, mNumMigrants(0)
+, mNumMigrantsLost(0)
+{
+    BOOST_ASSERT(inNumIslands > 0);
+
+    // Island seeds come from the master seed in island order, then the migration seed.
+    RandomLib::Random seeder(inMasterSeed);
+    for (u_int32_t i = 0; i < inNumIslands; ++i)
+    {
+        World* island = new World();
+        island->initializeSoup(inSoupSize);
+        island->setSettings(inSettings);
+        island->setInitialRandomSeed(seeder.Integer<u_int32_t>());
+        mIslands.push_back(island);
+    }
+    mMigrationRNG.Reseed(seeder.Integer<u_int32_t>());
+
+    u_int32_t numThreads = inNumThreads;
+    if (numThreads == 0)
+        numThreads = max(boost::thread::hardware_concurrency(), 1U);
+    mPool = new AnalysisPool(min(numThreads, inNumIslands));
+}
+
+Archipelago::~Archipelago()
+{
+    delete mPool;
+
+    for (u_int32_t i = 0; i < mIslands.size(); ++i)
+        delete mIslands[i];
+}
+
+void
+Archipelago::setGenotypeRegistry(GenotypeRegistry* inRegistry)
+{
+    for (u_int32_t i = 0; i < mIslands.size(); ++i)
+        mIslands[i]->inventory()->setGenotypeRegistry(inRegistry);
+}
+
+u_int32_t
+Archipelago::numThreads() const
+{
+    return mPool->numThreads();
+}
+
+void
+Archipelago::seedIslands(const instruction_t* inInstructions, u_int32_t inLength)
+{
+    for (u_int32_t i = 0; i < mIslands.size(); ++i)
+        mIslands[i]->insertCreature(mIslands[i]->soupSize() / 2, inInstructions, inLength);
+}
+
+void
+Archipelago::run(u_int64_t inInstructions)
+{
+    u_int64_t remaining = inInstructions;
+    while (remaining > 0)
+    {
+        u_int64_t epochLength = remaining;
+        if (mMigrationInterval > 0)
+            epochLength = min(epochLength, mMigrationInterval - mInstructionsRun % mMigrationInterval);
+
+        runIslands(epochLength);
+        mInstructionsRun += epochLength;
+        remaining -= epochLength;
+
+        if (mMigrationInterval > 0 && mInstructionsRun % mMigrationInterval == 0)
+            migrate();
+    }
+}
+
+void
+Archipelago::neighbors(u_int32_t inIndex, std::vector<u_int32_t>& outNeighbors) const
+{
+    const u_int32_t numIslands = mIslands.size();
+    set<u_int32_t> neighborSet;
+
+    switch (mTopology)
+    {
+        case kRing:
+            neighborSet.insert((inIndex + numIslands - 1) % numIslands);
+            neighborSet.insert((inIndex + 1) % numIslands);
+            break;
+
+        case kGrid:
+            {
+                const u_int32_t columns = gridColumns();
+                const u_int32_t rows = numIslands / columns;
+                const u_int32_t row = inIndex / columns;
+                const u_int32_t column = inIndex % columns;
+
+                neighborSet.insert(((row + rows - 1) % rows) * columns + column);
+                neighborSet.insert(((row + 1) % rows) * columns + column);
+                neighborSet.insert(row * columns + (column + columns - 1) % columns);
+                neighborSet.insert(row * columns + (column + 1) % columns);
+            }
+            break;
+
+        case kFullyConnected:
+            for (u_int32_t i = 0; i < numIslands; ++i)
+                neighborSet.insert(i);
+            break;
+    }
+
+    neighborSet.erase(inIndex);
+    outNeighbors.assign(neighborSet.begin(), neighborSet.end());
+}
+
+bool
+Archipelago::topologyFromName(const std::string& inName, ETopology& outTopology)
+{
+    if (inName == "ring")
+        outTopology = kRing;
+    else if (inName == "grid")
+        outTopology = kGrid;
+    else if (inName == "full")
+        outTopology = kFullyConnected;
+    else
+        return false;
+
+    return true;
+}
+
+const char*
+Archipelago::nameForTopology(ETopology inTopology)
+{
+    switch (inTopology)
+    {
+        case kRing:             return "ring";
+        case kGrid:             return "grid";
+        case kFullyConnected:   return "full";
+    }
+    return "";
+}
+
+void
+Archipelago::runIslands(u_int64_t inInstructions)
+{
+    vector<IslandTask*> tasks;
+    for (u_int32_t i = 0; i < mIslands.size(); ++i)
+    {
+        tasks.push_back(new IslandTask(mIslands[i], inInstructions));
+        mPool->submit(tasks.back());
+    }
+
+    mPool->waitForAll();
+
+    for (u_int32_t i = 0; i < tasks.size(); ++i)
+        delete tasks[i];
+}
+
+// Runs on the calling thread, with all the islands stopped, so the order of choices
+// depends only on the migration seed.
+void
+Archipelago::migrate()
+{
+    ++mNumMigrations;
+
+    // Choose all the migrants before placing any, so that new arrivals don't move on again.
+    vector<Migrant> migrants;
+    vector<u_int32_t> destinations;
+    vector<const Creature*> candidates;
+
+    for (u_int32_t i = 0; i < mIslands.size(); ++i)
+    {
+        neighbors(i, destinations);
+        if (destinations.empty())
+            continue;
+
+        migrantCandidates(*mIslands[i], candidates);
+        if (candidates.empty())
+            continue;
+
+        for (u_int32_t j = 0; j < mMigrantsPerIsland; ++j)
+        {
+            const Creature* emigrant = candidates[mMigrationRNG.Integer<size_t>(candidates.size())];
+            const u_int32_t destination = destinations[mMigrationRNG.Integer<size_t>(destinations.size())];
+            migrants.push_back(Migrant(destination, emigrant->genomeData()));
+        }
+    }
+
+    for (size_t i = 0; i < migrants.size(); ++i)
+    {
+        if (placeMigrant(*mIslands[migrants[i].mDestination], migrants[i].mGenome.dataString(), mMigrationRNG))
+            ++mNumMigrants;
+        else
+            ++mNumMigrantsLost;
+    }
+}
+
+void
+Archipelago::migrantCandidates(const World& inWorld, vector<const Creature*>& outCandidates)
+{
+    outCandidates.clear();
+    const CellMap::CreatureList& cells = inWorld.cellMap()->cells();
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        if (!cells[i].mData->isEmbryo())
+            outCandidates.push_back(cells[i].mData);
+    }
+}
+
+bool
+Archipelago::placeMigrant(World& ioWorld, const string& inGenome, RandomLib::Random& inRNG)
+{
+    for (int32_t attempt = 0; attempt < kMaxMalAttempts; ++attempt)
+    {
+        address_t location = inRNG.Integer<u_int32_t>(ioWorld.soupSize());
+        if (ioWorld.cellMap()->spaceAtAddress(location, inGenome.length()))
+        {
+            ioWorld.insertCreature(location, reinterpret_cast<const instruction_t*>(inGenome.data()), inGenome.length());
+            return true;
+        }
+    }
+    return false;
+}
+
+// Lays the islands out in the squarest grid that holds them exactly. A prime number of
+// islands makes a single row, which is a ring.
+u_int32_t
+Archipelago::gridColumns() const
+{
+    const u_int32_t numIslands = mIslands.size();
+    u_int32_t rows = 1;
+    for (u_int32_t i = 1; i * i <= numIslands; ++i)
+    {
+        if (numIslands % i == 0)
+            rows = i;
+    }
+    return numIslands / rows;
+}
+
+} // namespace MacTierra
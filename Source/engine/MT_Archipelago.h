@@ -0,0 +1,126 @@
+/*
+ *  MT_Archipelago.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_Archipelago_h
+#define MT_Archipelago_h
+
+#include <string>
+#include <vector>
+
+#include <wtf/Noncopyable.h>
+
+#define HAVE_BOOST_SERIALIZATION 1
+#include <RandomLib/Random.hpp>
+
+#include "MT_Engine.h"
+#include "MT_Settings.h"
+
+namespace MacTierra {
+
+class AnalysisPool;
+class Creature;
+class GenotypeRegistry;
+class World;
+
+// An island model: a set of worlds that run in parallel, one per thread, and now and
+// then exchange creatures.
+//
+// The islands run in epochs of the migration interval. At the end of each epoch, once
+// every island has stopped, each island sends copies of a few of its creatures to its
+// neighbors. Each island has its own random number generator, and migration has another,
+// all seeded from the master seed, so a run is the same whatever the threads do.
+class Archipelago : Noncopyable
+{
+public:
+
+    enum ETopology {
+        kRing,              // each island has the two either side
+        kGrid,              // islands on a torus, as square as the number of islands allows
+        kFullyConnected
+    };
+
+    // 0 threads means one per processor, but no more than the number of islands.
+    Archipelago(u_int32_t inNumIslands, u_int32_t inSoupSize, const Settings& inSettings, u_int32_t inMasterSeed,
+                ETopology inTopology = kRing, u_int32_t inNumThreads = 0);
+    ~Archipelago();
+
+    u_int32_t       numIslands() const      { return mIslands.size(); }
+    World*          island(u_int32_t inIndex) const     { return mIslands[inIndex]; }
+
+    u_int32_t       masterSeed() const      { return mMasterSeed; }
+    ETopology       topology() const        { return mTopology; }
+    u_int32_t       numThreads() const;
+
+    // Instructions each island runs between migrations. 0 turns migration off.
+    void            setMigrationInterval(u_int64_t inInstructions)  { mMigrationInterval = inInstructions; }
+    u_int64_t       migrationInterval() const       { return mMigrationInterval; }
+
+    // Creatures each island sends out at each migration.
+    void            setMigrantsPerIsland(u_int32_t inNumMigrants)   { mMigrantsPerIsland = inNumMigrants; }
+    u_int32_t       migrantsPerIsland() const       { return mMigrantsPerIsland; }
+
+    // Has the islands share one set of genotype names and genomes; see Inventory::setGenotypeRegistry().
+    // On more than one thread, the names then depend on thread timing; see GenotypeRegistry.
+    void            setGenotypeRegistry(GenotypeRegistry* inRegistry);
+
+    // Puts a creature in the middle of each island's soup.
+    void            seedIslands(const instruction_t* inInstructions, u_int32_t inLength);
+
+    // Runs each island for this many more instructions, migrating at each interval boundary.
+    void            run(u_int64_t inInstructions);
+
+    // Instructions run by each island so far.
+    u_int64_t       instructionsRun() const     { return mInstructionsRun; }
+
+    // The islands that inIndex sends migrants to, in ascending order.
+    void            neighbors(u_int32_t inIndex, std::vector<u_int32_t>& outNeighbors) const;
+
+    u_int64_t       numMigrations() const       { return mNumMigrations; }
+    u_int64_t       numMigrants() const         { return mNumMigrants; }
+    // migrants that found no space in their destination soup
+    u_int64_t       numMigrantsLost() const     { return mNumMigrantsLost; }
+
+    // The creatures of inWorld that can migrate, which is all but embryos, in cell map order.
+    static void     migrantCandidates(const World& inWorld, std::vector<const Creature*>& outCandidates);
+    // Inserts inGenome at a random place in ioWorld with room for it, or returns false if
+    // kMaxMalAttempts tries find none.
+    static bool     placeMigrant(World& ioWorld, const std::string& inGenome, RandomLib::Random& inRNG);
+
+    static bool     topologyFromName(const std::string& inName, ETopology& outTopology);
+    static const char* nameForTopology(ETopology inTopology);
+
+protected:
+
+    void            runIslands(u_int64_t inInstructions);
+    void            migrate();
+
+    u_int32_t       gridColumns() const;
+
+protected:
+
+    std::vector<World*>     mIslands;
+    AnalysisPool*           mPool;
+
+    u_int32_t               mMasterSeed;
+    ETopology               mTopology;
+
+    RandomLib::Random       mMigrationRNG;
+
+    u_int64_t               mMigrationInterval;
+    u_int32_t               mMigrantsPerIsland;
+
+    u_int64_t               mInstructionsRun;
+    u_int64_t               mNumMigrations;
+    u_int64_t               mNumMigrants;
+    u_int64_t               mNumMigrantsLost;
+};
+
+} // namespace MacTierra
+
+#endif // MT_Archipelago_h
@@ -150,6 +150,17 @@ CellMap::removeCreature(Creature* inCreature)
     //BOOST_ASSERT(0);
 }
 
+void
+CellMap::copyCells(const CellMap& inCellMap, const CreatureCopyMap& inCreatures)
+{
+    BOOST_ASSERT(inCellMap.size() == mSize);
+
+    mSpaceUsed = inCellMap.mSpaceUsed;
+    mCells = inCellMap.mCells;
+    for (size_t i = 0; i < mCells.size(); ++i)
+        mCells[i].mData = inCreatures.find(mCells[i].mData)->second;
+}
+
 // distance between start and end going forward (maybe wrapping)
 static inline u_int32_t forwardDelta(address_t inStart, address_t inEnd, u_int32_t inSize)
 {
@@ -192,7 +203,8 @@ CellMap::searchForSpace(address_t& ioAddress, u_int32_t inLength, u_int32_t inMa
                     u_int32_t   forwardOffset  = forwardDelta(startAddress, mCells[forwardIndex].wrappedEnd(mSize), mSize);
                     u_int32_t   backwardOffset = backwardDelta(startAddress, (mCells[backIndex].start() - inLength + mSize) % mSize, mSize);
                 
-                    if (!forwardWrapped && forwardOffset <= backwardOffset)
+                    // once one direction has wrapped, keep going in the other
+                    if (!forwardWrapped && (forwardOffset <= backwardOffset || backwardsWrapped))
                     {
                         if (gapAfterIndex(forwardIndex) >= inLength)
                         {
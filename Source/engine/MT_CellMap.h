@@ -95,6 +95,9 @@ public:
     bool        insertCreature(Creature* inCreature);
     void        removeCreature(Creature* inCreature);
 
+    // Copies the cells of a map of the same size, with each creature replaced by its copy.
+    void        copyCells(const CellMap& inCellMap, const CreatureCopyMap& inCreatures);
+
     const CreatureList& cells() const { return mCells; }
     
     enum ESearchDirection { kBothways, kBackwards, kForwards };
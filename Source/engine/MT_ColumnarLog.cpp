@@ -0,0 +1,541 @@
+/*
+ *  MT_ColumnarLog.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <string.h>
+
+#include <algorithm>
+#include <ostream>
+
+#include <boost/assert.hpp>
+
+#include "MT_ColumnarLog.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+static const char kFileMagic[8] = { 'M', 'T', 'C', 'O', 'L', 'L', 'O', 'G' };
+static const char kGroupMagic[4] = { 'M', 'T', 'R', 'G' };
+static const u_int32_t kFileVersion = 1;
+
+static const size_t kGroupHeaderSize = 8;      // magic, rows; followed by the length of each column
+
+static void pushUInt16(std::vector<u_int8_t>& ioData, u_int16_t inValue)
+{
+    ioData.push_back(inValue & 0xFF);
+    ioData.push_back(inValue >> 8);
+}
+
+static void pushUInt32(std::vector<u_int8_t>& ioData, u_int32_t inValue)
+{
+    for (u_int32_t i = 0; i < 4; ++i)
+        ioData.push_back((inValue >> (8 * i)) & 0xFF);
+}
+
+static void pushUInt64(std::vector<u_int8_t>& ioData, u_int64_t inValue)
+{
+    for (u_int32_t i = 0; i < 8; ++i)
+        ioData.push_back((inValue >> (8 * i)) & 0xFF);
+}
+
+static u_int16_t readUInt16(const u_int8_t*& ioData)
+{
+    u_int16_t value = ioData[0] | (ioData[1] << 8);
+    ioData += 2;
+    return value;
+}
+
+static u_int32_t readUInt32(const u_int8_t*& ioData)
+{
+    u_int32_t value = 0;
+    for (u_int32_t i = 0; i < 4; ++i)
+        value |= static_cast<u_int32_t>(ioData[i]) << (8 * i);
+    ioData += 4;
+    return value;
+}
+
+static u_int64_t readUInt64(const u_int8_t*& ioData)
+{
+    u_int64_t value = 0;
+    for (u_int32_t i = 0; i < 8; ++i)
+        value |= static_cast<u_int64_t>(ioData[i]) << (8 * i);
+    ioData += 8;
+    return value;
+}
+
+static void writeCSVString(std::ostream& inStream, const std::string& inValue)
+{
+    if (inValue.find_first_of(",\"\n") == std::string::npos)
+    {
+        inStream << inValue;
+        return;
+    }
+
+    inStream << '"';
+    for (size_t i = 0; i < inValue.length(); ++i)
+    {
+        if (inValue[i] == '"')
+            inStream << '"';
+        inStream << inValue[i];
+    }
+    inStream << '"';
+}
+
+#pragma mark -
+
+void
+ColumnarLogSchema::addColumn(const std::string& inName, EColumnType inType)
+{
+    Column newColumn;
+    newColumn.mName = inName;
+    newColumn.mType = inType;
+    mColumns.push_back(newColumn);
+}
+
+int32_t
+ColumnarLogSchema::columnIndex(const std::string& inName) const
+{
+    for (size_t i = 0; i < mColumns.size(); ++i)
+    {
+        if (mColumns[i].mName == inName)
+            return i;
+    }
+    return -1;
+}
+
+#pragma mark -
+
+ColumnarLogWriter::ColumnarLogWriter(u_int32_t inRowsPerGroup)
+: mRowsPerGroup(max(inRowsPerGroup, 1U))
+, mMaxGroupAge(kDefaultMaxGroupAge)
+, mNumRows(0)
+, mCurGroup(NULL)
+, mCurColumn(0)
+, mGroupStartTime(0)
+, mWriterThread(NULL)
+, mClosing(false)
+{
+}
+
+ColumnarLogWriter::~ColumnarLogWriter()
+{
+    close();
+
+    for (vector<RowGroup*>::iterator it = mFreeGroups.begin(); it != mFreeGroups.end(); ++it)
+        delete *it;
+}
+
+bool
+ColumnarLogWriter::open(const std::string& inPath)
+{
+    BOOST_ASSERT(!isOpen() && mSchema.numColumns() > 0);
+
+    mFile.open(inPath.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!mFile)
+        return false;
+
+    std::vector<u_int8_t> header(kFileMagic, kFileMagic + sizeof(kFileMagic));
+    pushUInt32(header, kFileVersion);
+    pushUInt32(header, mSchema.numColumns());
+    for (size_t i = 0; i < mSchema.numColumns(); ++i)
+    {
+        const ColumnarLogSchema::Column& curColumn = mSchema.column(i);
+        header.push_back(curColumn.mType);
+        pushUInt16(header, curColumn.mName.length());
+        header.insert(header.end(), curColumn.mName.begin(), curColumn.mName.end());
+    }
+    mFile.write(reinterpret_cast<const char*>(&header[0]), header.size());
+    mFile.flush();
+
+    mNumRows = 0;
+    mClosing = false;
+
+    mCurGroup = new RowGroup;
+    mCurGroup->mColumnData.resize(mSchema.numColumns());
+    mCurGroup->mNumRows = 0;
+    mCurColumn = 0;
+
+    mWriterThread = new boost::thread(WriterThreadEntry(this));
+    return true;
+}
+
+void
+ColumnarLogWriter::close()
+{
+    if (!isOpen())
+        return;
+
+    flush();
+
+    {
+        boost::mutex::scoped_lock lock(mQueueLock);
+        mClosing = true;
+        mQueueChanged.notify_all();
+    }
+
+    mWriterThread->join();
+    delete mWriterThread;
+    mWriterThread = NULL;
+
+    delete mCurGroup;
+    mCurGroup = NULL;
+
+    mFile.close();
+}
+
+std::vector<u_int8_t>&
+ColumnarLogWriter::nextColumnData(ColumnarLogSchema::EColumnType inType)
+{
+    BOOST_ASSERT(isOpen() && mCurColumn < mSchema.numColumns() && mSchema.column(mCurColumn).mType == inType);
+    return mCurGroup->mColumnData[mCurColumn++];
+}
+
+void
+ColumnarLogWriter::appendUInt64(u_int64_t inValue)
+{
+    pushUInt64(nextColumnData(ColumnarLogSchema::kUInt64Column), inValue);
+}
+
+void
+ColumnarLogWriter::appendDouble(double inValue)
+{
+    u_int64_t bits;
+    memcpy(&bits, &inValue, sizeof(bits));
+    pushUInt64(nextColumnData(ColumnarLogSchema::kDoubleColumn), bits);
+}
+
+void
+ColumnarLogWriter::appendString(const std::string& inValue)
+{
+    std::vector<u_int8_t>& columnData = nextColumnData(ColumnarLogSchema::kStringColumn);
+
+    u_int16_t length = min<size_t>(inValue.length(), 0xFFFF);
+    pushUInt16(columnData, length);
+    columnData.insert(columnData.end(), inValue.begin(), inValue.begin() + length);
+}
+
+void
+ColumnarLogWriter::finishRow()
+{
+    BOOST_ASSERT(mCurColumn == mSchema.numColumns());
+    mCurColumn = 0;
+
+    if (mCurGroup->mNumRows == 0)
+        mGroupStartTime = time(NULL);
+
+    ++mCurGroup->mNumRows;
+    ++mNumRows;
+
+    if (mCurGroup->mNumRows >= mRowsPerGroup || time(NULL) - mGroupStartTime >= (time_t)mMaxGroupAge)
+        queueCurrentGroup();
+}
+
+void
+ColumnarLogWriter::flush()
+{
+    BOOST_ASSERT(mCurColumn == 0);
+    if (isOpen() && mCurGroup->mNumRows > 0)
+        queueCurrentGroup();
+}
+
+void
+ColumnarLogWriter::queueCurrentGroup()
+{
+    boost::mutex::scoped_lock lock(mQueueLock);
+
+    // if the disk can't keep up, make the engine wait rather than using unbounded memory
+    while (mFullGroups.size() >= kMaxPendingGroups)
+        mQueueChanged.wait(lock);
+
+    mFullGroups.push_back(mCurGroup);
+
+    if (mFreeGroups.empty())
+    {
+        mCurGroup = new RowGroup;
+        mCurGroup->mColumnData.resize(mSchema.numColumns());
+    }
+    else
+    {
+        mCurGroup = mFreeGroups.back();
+        mFreeGroups.pop_back();
+    }
+
+    for (size_t i = 0; i < mCurGroup->mColumnData.size(); ++i)
+        mCurGroup->mColumnData[i].clear();
+    mCurGroup->mNumRows = 0;
+
+    mQueueChanged.notify_all();
+}
+
+void
+ColumnarLogWriter::writeGroups()
+{
+    while (true)
+    {
+        RowGroup* group = NULL;
+        {
+            boost::mutex::scoped_lock lock(mQueueLock);
+            while (mFullGroups.empty() && !mClosing)
+                mQueueChanged.wait(lock);
+
+            if (mFullGroups.empty())
+                break;
+
+            group = mFullGroups.front();
+            mFullGroups.pop_front();
+            mQueueChanged.notify_all();
+        }
+
+        writeGroup(*group);
+
+        {
+            boost::mutex::scoped_lock lock(mQueueLock);
+            mFreeGroups.push_back(group);
+        }
+    }
+}
+
+void
+ColumnarLogWriter::writeGroup(const RowGroup& inGroup)
+{
+    std::vector<u_int8_t> header(kGroupMagic, kGroupMagic + sizeof(kGroupMagic));
+    pushUInt32(header, inGroup.mNumRows);
+    for (size_t i = 0; i < inGroup.mColumnData.size(); ++i)
+        pushUInt32(header, inGroup.mColumnData[i].size());
+
+    mFile.write(reinterpret_cast<const char*>(&header[0]), header.size());
+    for (size_t i = 0; i < inGroup.mColumnData.size(); ++i)
+    {
+        const std::vector<u_int8_t>& columnData = inGroup.mColumnData[i];
+        if (!columnData.empty())
+            mFile.write(reinterpret_cast<const char*>(&columnData[0]), columnData.size());
+    }
+
+    // each group is complete on disk before the next is started
+    mFile.flush();
+}
+
+#pragma mark -
+
+ColumnarLogReader::ColumnarLogReader()
+: mTruncated(false)
+, mGroupRows(0)
+{
+}
+
+bool
+ColumnarLogReader::open(const std::string& inPath)
+{
+    mFile.open(inPath.c_str(), ios::in | ios::binary);
+    if (!mFile)
+        return false;
+
+    u_int8_t header[sizeof(kFileMagic) + 8];
+    mFile.read(reinterpret_cast<char*>(header), sizeof(header));
+
+    const u_int8_t* headerPtr = header + sizeof(kFileMagic);
+    if (mFile.gcount() != (streamsize)sizeof(header) || memcmp(header, kFileMagic, sizeof(kFileMagic)) != 0 ||
+        readUInt32(headerPtr) != kFileVersion)
+    {
+        mFile.close();
+        return false;
+    }
+
+    u_int32_t numColumns = readUInt32(headerPtr);
+    mSchema = ColumnarLogSchema();
+    for (u_int32_t i = 0; i < numColumns; ++i)
+    {
+        u_int8_t columnHeader[3];
+        mFile.read(reinterpret_cast<char*>(columnHeader), sizeof(columnHeader));
+
+        const u_int8_t* columnPtr = columnHeader + 1;
+        std::string name(readUInt16(columnPtr), '\0');
+        if (!name.empty())
+            mFile.read(&name[0], name.length());
+
+        u_int8_t type = columnHeader[0];
+        if (!mFile || type < ColumnarLogSchema::kUInt64Column || type > ColumnarLogSchema::kStringColumn)
+        {
+            mFile.close();
+            return false;
+        }
+        mSchema.addColumn(name, static_cast<ColumnarLogSchema::EColumnType>(type));
+    }
+
+    mColumns.resize(numColumns);
+    mTruncated = false;
+    mGroupRows = 0;
+    return true;
+}
+
+bool
+ColumnarLogReader::nextGroup()
+{
+    mGroupRows = 0;
+    for (size_t i = 0; i < mColumns.size(); ++i)
+        mColumns[i] = ColumnValues();
+
+    if (mTruncated)
+        return false;
+
+    std::vector<u_int8_t> header(kGroupHeaderSize + 4 * mSchema.numColumns());
+    mFile.read(reinterpret_cast<char*>(&header[0]), header.size());
+    if (mFile.gcount() == 0)
+        return false;       // the end
+
+    const u_int8_t* headerPtr = &header[0] + sizeof(kGroupMagic);
+    if (mFile.gcount() != (streamsize)header.size() || memcmp(&header[0], kGroupMagic, sizeof(kGroupMagic)) != 0)
+    {
+        mTruncated = true;
+        return false;
+    }
+
+    u_int32_t numRows = readUInt32(headerPtr);
+    std::vector<u_int32_t> columnLengths(mSchema.numColumns());
+    size_t groupLength = 0;
+    for (size_t i = 0; i < columnLengths.size(); ++i)
+    {
+        columnLengths[i] = readUInt32(headerPtr);
+        groupLength += columnLengths[i];
+    }
+
+    mGroupData.resize(groupLength);
+    if (groupLength > 0)
+        mFile.read(reinterpret_cast<char*>(&mGroupData[0]), groupLength);
+
+    if (mFile.gcount() != (streamsize)groupLength)
+    {
+        mTruncated = true;
+        return false;
+    }
+
+    size_t columnOffset = 0;
+    for (size_t i = 0; i < columnLengths.size(); ++i)
+    {
+        const u_int8_t* columnData = groupLength > 0 ? &mGroupData[columnOffset] : NULL;
+        if (!decodeColumn(mSchema.column(i).mType, columnData, columnLengths[i], mColumns[i]))
+        {
+            mTruncated = true;
+            return false;
+        }
+        columnOffset += columnLengths[i];
+    }
+
+    // every column must have a value for every row
+    for (size_t i = 0; i < mColumns.size(); ++i)
+    {
+        const ColumnValues& values = mColumns[i];
+        if (values.mUInt64Values.size() + values.mDoubleValues.size() + values.mStringValues.size() != numRows)
+        {
+            mTruncated = true;
+            return false;
+        }
+    }
+
+    mGroupRows = numRows;
+    return true;
+}
+
+bool
+ColumnarLogReader::decodeColumn(ColumnarLogSchema::EColumnType inType, const u_int8_t* inData, size_t inLength, ColumnValues& outValues)
+{
+    const u_int8_t* dataEnd = inData + inLength;
+
+    switch (inType)
+    {
+        case ColumnarLogSchema::kUInt64Column:
+            if (inLength % 8 != 0)
+                return false;
+            while (inData < dataEnd)
+                outValues.mUInt64Values.push_back(readUInt64(inData));
+            break;
+
+        case ColumnarLogSchema::kDoubleColumn:
+            if (inLength % 8 != 0)
+                return false;
+            while (inData < dataEnd)
+            {
+                u_int64_t bits = readUInt64(inData);
+                double value;
+                memcpy(&value, &bits, sizeof(value));
+                outValues.mDoubleValues.push_back(value);
+            }
+            break;
+
+        case ColumnarLogSchema::kStringColumn:
+            while (inData < dataEnd)
+            {
+                if (dataEnd - inData < 2)
+                    return false;
+                u_int16_t length = readUInt16(inData);
+                if (dataEnd - inData < length)
+                    return false;
+                outValues.mStringValues.push_back(std::string(inData, inData + length));
+                inData += length;
+            }
+            break;
+    }
+    return true;
+}
+
+u_int64_t
+ColumnarLogReader::writeCSV(std::ostream& inStream)
+{
+    const std::streamsize oldPrecision = inStream.precision(12);
+
+    for (size_t i = 0; i < mSchema.numColumns(); ++i)
+    {
+        if (i > 0)
+            inStream << ",";
+        writeCSVString(inStream, mSchema.column(i).mName);
+    }
+    inStream << "\n";
+
+    u_int64_t numRows = 0;
+    while (nextGroup())
+    {
+        for (u_int32_t row = 0; row < mGroupRows; ++row)
+        {
+            for (size_t i = 0; i < mSchema.numColumns(); ++i)
+            {
+                if (i > 0)
+                    inStream << ",";
+
+                switch (mSchema.column(i).mType)
+                {
+                    case ColumnarLogSchema::kUInt64Column:  inStream << mColumns[i].mUInt64Values[row]; break;
+                    case ColumnarLogSchema::kDoubleColumn:  inStream << mColumns[i].mDoubleValues[row]; break;
+                    case ColumnarLogSchema::kStringColumn:  writeCSVString(inStream, mColumns[i].mStringValues[row]); break;
+                }
+            }
+            inStream << "\n";
+        }
+        numRows += mGroupRows;
+    }
+
+    inStream.precision(oldPrecision);
+    return numRows;
+}
+
+bool
+convertColumnarLogToCSV(const std::string& inLogPath, const std::string& inCSVPath)
+{
+    ColumnarLogReader reader;
+    if (!reader.open(inLogPath))
+        return false;
+
+    std::ofstream csvStream(inCSVPath.c_str(), ios::out | ios::trunc);
+    if (!csvStream)
+        return false;
+
+    reader.writeCSV(csvStream);
+    return csvStream.good();
+}
+
+} // namespace MacTierra
@@ -0,0 +1,199 @@
+/*
+ *  MT_ColumnarLog.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_ColumnarLog_h
+#define MT_ColumnarLog_h
+
+#include <time.h>
+
+#include <deque>
+#include <fstream>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+
+namespace MacTierra {
+
+// An append-only table, stored by column, for time series from long runs.
+//
+// The file is a header describing the columns, followed by row groups. Each group holds the
+// values of every column for a run of rows, one column after another, with the length of each
+// column in the group header so that readers can skip the columns they don't want. Groups are
+// written whole and flushed, so a file cut off by a crash or an interrupt is still readable up
+// to its last complete group. Integers are little-endian.
+
+class ColumnarLogSchema
+{
+public:
+    enum EColumnType {
+        kUInt64Column   = 1,
+        kDoubleColumn   = 2,
+        kStringColumn   = 3
+    };
+
+    struct Column
+    {
+        std::string     mName;
+        EColumnType     mType;
+    };
+
+    void            addColumn(const std::string& inName, EColumnType inType);
+
+    size_t          numColumns() const                  { return mColumns.size(); }
+    const Column&   column(size_t inIndex) const        { return mColumns[inIndex]; }
+    // -1 if there is no such column
+    int32_t         columnIndex(const std::string& inName) const;
+
+protected:
+    std::vector<Column> mColumns;
+};
+
+// Writes rows from the engine thread; full groups are written to disk on a background thread.
+// Add the columns, open, then for each row append a value for each column in order, and
+// finish the row.
+class ColumnarLogWriter : Noncopyable
+{
+public:
+    enum {
+        kDefaultRowsPerGroup    = 256,
+        kDefaultMaxGroupAge     = 10,       // seconds
+        kMaxPendingGroups       = 16
+    };
+
+    ColumnarLogWriter(u_int32_t inRowsPerGroup = kDefaultRowsPerGroup);
+    ~ColumnarLogWriter();
+
+    ColumnarLogSchema&          schema()        { return mSchema; }
+    const ColumnarLogSchema&    schema() const  { return mSchema; }
+
+    // A partly filled group is written out once its first row is this old, so that a
+    // slow trickle of rows still reaches the disk.
+    void            setMaxGroupAge(u_int32_t inSeconds)     { mMaxGroupAge = inSeconds; }
+
+    bool            open(const std::string& inPath);
+    // Writes out any buffered rows and waits for the writer thread.
+    void            close();
+    bool            isOpen() const          { return mWriterThread != NULL; }
+
+    void            appendUInt64(u_int64_t inValue);
+    void            appendDouble(double inValue);
+    void            appendString(const std::string& inValue);
+    void            finishRow();
+
+    // Hands the rows so far to the writer thread without waiting for a full group.
+    void            flush();
+
+    u_int64_t       numRows() const         { return mNumRows; }
+
+protected:
+
+    struct RowGroup
+    {
+        std::vector<std::vector<u_int8_t> > mColumnData;
+        u_int32_t                           mNumRows;
+    };
+
+    struct WriterThreadEntry
+    {
+        WriterThreadEntry(ColumnarLogWriter* inWriter) : mWriter(inWriter) {}
+        void operator()()   { mWriter->writeGroups(); }
+        ColumnarLogWriter*  mWriter;
+    };
+    friend struct WriterThreadEntry;
+
+    std::vector<u_int8_t>& nextColumnData(ColumnarLogSchema::EColumnType inType);
+
+    // engine thread
+    void            queueCurrentGroup();
+    // writer thread
+    void            writeGroups();
+    void            writeGroup(const RowGroup& inGroup);
+
+protected:
+
+    ColumnarLogSchema   mSchema;
+
+    u_int32_t           mRowsPerGroup;
+    u_int32_t           mMaxGroupAge;
+    u_int64_t           mNumRows;
+
+    RowGroup*           mCurGroup;
+    size_t              mCurColumn;
+    time_t              mGroupStartTime;
+
+    std::ofstream       mFile;
+    boost::thread*      mWriterThread;
+
+    // shared with the writer thread
+    boost::mutex        mQueueLock;
+    boost::condition_variable mQueueChanged;
+    std::deque<RowGroup*> mFullGroups;
+    std::vector<RowGroup*> mFreeGroups;
+    bool                mClosing;
+};
+
+// Reads a log written by ColumnarLogWriter, a group at a time.
+class ColumnarLogReader : Noncopyable
+{
+public:
+    ColumnarLogReader();
+
+    bool            open(const std::string& inPath);
+    bool            isOpen() const          { return mFile.is_open(); }
+    // True if reading stopped at a damaged or incomplete group, rather than at the end.
+    bool            isTruncated() const     { return mTruncated; }
+
+    const ColumnarLogSchema&    schema() const  { return mSchema; }
+
+    // Returns false at the end of the log.
+    bool            nextGroup();
+
+    // Values in the current group. Only the accessor matching the column type returns values.
+    u_int32_t       groupRows() const       { return mGroupRows; }
+    const std::vector<u_int64_t>&   uint64Column(size_t inColumn) const     { return mColumns[inColumn].mUInt64Values; }
+    const std::vector<double>&      doubleColumn(size_t inColumn) const     { return mColumns[inColumn].mDoubleValues; }
+    const std::vector<std::string>& stringColumn(size_t inColumn) const     { return mColumns[inColumn].mStringValues; }
+
+    // Writes the rest of the log as CSV, with a header line of column names. Returns the number of rows.
+    u_int64_t       writeCSV(std::ostream& inStream);
+
+protected:
+
+    struct ColumnValues
+    {
+        std::vector<u_int64_t>      mUInt64Values;
+        std::vector<double>         mDoubleValues;
+        std::vector<std::string>    mStringValues;
+    };
+
+    bool            decodeColumn(ColumnarLogSchema::EColumnType inType, const u_int8_t* inData, size_t inLength, ColumnValues& outValues);
+
+protected:
+
+    std::ifstream               mFile;
+    ColumnarLogSchema           mSchema;
+    bool                        mTruncated;
+
+    u_int32_t                   mGroupRows;
+    std::vector<ColumnValues>   mColumns;
+    std::vector<u_int8_t>       mGroupData;
+};
+
+// Converts a whole columnar log to CSV. Returns false if the log can't be read.
+bool    convertColumnarLogToCSV(const std::string& inLogPath, const std::string& inCSVPath);
+
+} // namespace MacTierra
+
+#endif // MT_ColumnarLog_h
@@ -199,4 +199,44 @@ Creature::noteMoveToOffspring(address_t inTargetAddress)
     ++mMovesToLastOffspring;
 }
 
+PassRefPtr<Creature>
+Creature::copyInSoup(Soup* inSoup) const
+{
+    RefPtr<Creature> copy = adoptRef(new Creature(mID, mLength, inSoup));
+
+    copy->mBirthGenome = mBirthGenome;
+    copy->mGenotypeDivergence = mGenotypeDivergence;
+    copy->mCPU = mCPU;
+    copy->mExecutedBits = mExecutedBits;
+
+    copy->mDividing = mDividing;
+    copy->mBorn = mBorn;
+    copy->mDead = mDead;
+
+    copy->mLocation = mLocation;
+    copy->mMeanSliceSize = mMeanSliceSize;
+    copy->mLeanness = mLeanness;
+    copy->mLastInstruction = mLastInstruction;
+
+    copy->mInstructionsToLastOffspring = mInstructionsToLastOffspring;
+    copy->mTotalInstructionsExecuted = mTotalInstructionsExecuted;
+    copy->mBirthInstructions = mBirthInstructions;
+
+    copy->mNumErrors = mNumErrors;
+    copy->mMovesToLastOffspring = mMovesToLastOffspring;
+    copy->mNumOffspring = mNumOffspring;
+    copy->mNumIdenticalOffspring = mNumIdenticalOffspring;
+    copy->mGeneration = mGeneration;
+
+    return copy.release();
+}
+
+void
+Creature::copyLinks(const Creature& inOriginal, const CreatureCopyMap& inCreatures, const GenotypeCopyMap& inGenotypes)
+{
+    mGenotype = inOriginal.mGenotype ? inGenotypes.find(inOriginal.mGenotype)->second : NULL;
+    mParentalGenotype = inOriginal.mParentalGenotype ? inGenotypes.find(inOriginal.mParentalGenotype)->second : NULL;
+    mDaughter = inOriginal.mDaughter ? inCreatures.find(inOriginal.mDaughter.get())->second : NULL;
+}
+
 } // namespace MacTierra
@@ -10,6 +10,7 @@
 #ifndef MT_Creature_h
 #define MT_Creature_h
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -31,17 +32,24 @@
 
 typedef boost::intrusive::list_member_hook<> ReaperListHook;
 typedef boost::intrusive::list_member_hook<> SlicerListHook;
+typedef boost::intrusive::list_member_hook<> GenotypeListHook;
 
 namespace MacTierra {
 
+class Creature;
 class InventoryGenotype;
 class World;
 
+// Originals to their copies, when cloning a world.
+typedef std::map<const Creature*, Creature*> CreatureCopyMap;
+typedef std::map<const InventoryGenotype*, InventoryGenotype*> GenotypeCopyMap;
+
 class Creature : public RefCounted<Creature>
 {
 public:
     ReaperListHook  mReaperListHook;
     SlicerListHook  mSlicerListHook;
+    GenotypeListHook mGenotypeListHook;
     
 public:
     
@@ -150,7 +158,20 @@ public:
                         ++mTotalInstructionsExecuted;
                     }
 
+    // for a run of instructions executed in one go (see ExecutionUnit0::executeCopyLoop())
+    void            executedInstructions(instruction_t inLastInst, u_int32_t inCount)
+                    {
+                        mLastInstruction = inLastInst;
+                        mTotalInstructionsExecuted += inCount;
+                    }
+
     instruction_t   lastInstruction() const     { return mLastInstruction; }
+    u_int64_t       totalInstructionsExecuted() const   { return mTotalInstructionsExecuted; }
+
+    // For World::clone(): a copy of this creature in inSoup, in no lists, with no daughter or
+    // genotypes. copyLinks() fills those in once every creature and genotype has been copied.
+    PassRefPtr<Creature> copyInSoup(Soup* inSoup) const;
+    void            copyLinks(const Creature& inOriginal, const CreatureCopyMap& inCreatures, const GenotypeCopyMap& inGenotypes);
 
     bool            genomeIdenticalToCreature(const Creature& inOther) const;
     
@@ -175,6 +196,7 @@ public:
 
     bool            isInSlicerList() const { return mSlicerListHook.is_linked(); }
     bool            isInReaperList() const { return mReaperListHook.is_linked(); }
+    bool            isInGenotypeList() const { return mGenotypeListHook.is_linked(); }
 
     bool            operator==(const Creature& inRHS)
                     {
@@ -212,6 +234,7 @@ private:
     template<class Archive> void save(Archive& ar, const unsigned int version) const
     {
         // mReaperListHook and mSlicerListHook are saved by the slicer and reaper lists
+        // mGenotypeListHook is not saved; the world rebuilds the genotype lists after loading
 
         ar << MT_BOOST_MEMBER_SERIALIZATION_NVP("id", mID);
         ar << MT_BOOST_MEMBER_SERIALIZATION_NVP("birth_genome", mBirthGenome);
@@ -254,6 +277,7 @@ private:
     template<class Archive> void load(Archive& ar, const unsigned int version)
     {
         // mReaperListHook and mSlicerListHook are filled in when the slicer and reaper lists load
+        // mGenotypeListHook is filled in by World::wasDeserialized()
 
         ar >> MT_BOOST_MEMBER_SERIALIZATION_NVP("id", mID);
         ar >> MT_BOOST_MEMBER_SERIALIZATION_NVP("birth_genome", mBirthGenome);
@@ -7,9 +7,13 @@
  *
  */
 
+#include <boost/shared_ptr.hpp>
+
 #include "MT_DataCollection.h"
 
+#include "MT_AnalysisPool.h"
 #include "MT_World.h"
+#include "MT_WorldSnapshot.h"
 
 namespace MacTierra {
 
@@ -23,6 +27,41 @@ DataLogger::collect(ECollectionType inCollectionType, u_int64_t inInstructionCou
     collectData(inCollectionType, inInstructionCount, inSlicerCycles, inWorld);
 }
 
+const PopulationSample*
+DataLogger::sampledData() const
+{
+    if (dataRequirement() == kExactData || !mOwningCollector)
+        return NULL;
+
+    return mOwningCollector->currentSample();
+}
+
+#pragma mark -
+
+struct DataCollector::AnalysisJob : public AnalysisPool::Task
+{
+    AnalysisJob(SnapshotAnalysis* inAnalysis, const boost::shared_ptr<WorldSnapshot>& inSnapshot)
+    : mAnalysis(inAnalysis)
+    , mSnapshot(inSnapshot)
+    , mResult(NULL)
+    {
+    }
+
+    ~AnalysisJob()
+    {
+        delete mResult;
+    }
+
+    virtual void run()
+    {
+        mResult = mAnalysis->analyze(*mSnapshot);
+    }
+
+    SnapshotAnalysis*                   mAnalysis;
+    boost::shared_ptr<WorldSnapshot>    mSnapshot;      // shared by the analyses of one collection
+    AnalysisResult*                     mResult;
+};
+
 #pragma mark -
 
 DataCollector::DataCollector()
@@ -30,11 +69,22 @@ DataCollector::DataCollector()
 , mNextCollectionInstructions(0)
 , mCollectionCycles(20)
 , mNextCollectionCycle(0)
+, mSampleValid(false)
+, mAnalysisPool(NULL)
+, mNumAnalysisThreads(0)
 {
 }
 
 DataCollector::~DataCollector()
 {
+    // the analyses may be gone, so don't deliver anything
+    if (mAnalysisPool)
+        mAnalysisPool->waitForAll();
+
+    for (deque<AnalysisJob*>::const_iterator it = mPendingAnalyses.begin(); it != mPendingAnalyses.end(); ++it)
+        delete *it;
+
+    delete mAnalysisPool;
 }
 
 void
@@ -47,31 +97,179 @@ DataCollector::setCollectionInterval(u_int64_t inInterval, u_int64_t inCurrentIn
 void
 DataCollector::collectPeriodicData(u_int64_t inInstructionCount, u_int64_t inCycleCount, const World* inWorld)
 {
-    DataLoggerList::const_iterator it;
-    DataLoggerList::const_iterator end = mPeriodicLoggers.end();
-    for (it = mPeriodicLoggers.begin(); it != end; ++it)
-    {
-        DataLogger* curLogger = *it;
-        curLogger->collect(DataLogger::kCollectionPeriodic, inInstructionCount, inCycleCount, inWorld);
-    }
-    
+    collectWithLoggers(mPeriodicLoggers, DataLogger::kCollectionPeriodic, inInstructionCount, inCycleCount, inWorld);
     computeNextCollectionTime(inInstructionCount);
 }
 
 void
 DataCollector::collectCyclicalData(u_int64_t inInstructionCount, u_int64_t inCycleCount, const World* inWorld)
+{
+    collectWithLoggers(mCyclicalLoggers, DataLogger::kCollectionSlicerCycle, inInstructionCount, inCycleCount, inWorld);
+    computeNextCollectionCycles(inCycleCount);
+}
+
+void
+DataCollector::collectWithLoggers(const DataLoggerList& inLoggers, DataLogger::ECollectionType inCollectionType,
+                                  u_int64_t inInstructionCount, u_int64_t inCycleCount, const World* inWorld)
 {
     DataLoggerList::const_iterator it;
-    DataLoggerList::const_iterator end = mCyclicalLoggers.end();
-    for (it = mCyclicalLoggers.begin(); it != end; ++it)
+    DataLoggerList::const_iterator end = inLoggers.end();
+
+    // only take a sample if some logger is going to use it
+    mSampleValid = false;
+    if (mSample.sampleSize() > 0)
+    {
+        for (it = inLoggers.begin(); it != end; ++it)
+        {
+            if ((*it)->dataRequirement() == DataLogger::kSampledDataAllowed)
+            {
+                mSample.takeSample(*inWorld);
+                mSampleValid = true;
+                break;
+            }
+        }
+    }
+
+    for (it = inLoggers.begin(); it != end; ++it)
     {
         DataLogger* curLogger = *it;
-        curLogger->collect(DataLogger::kCollectionSlicerCycle, inInstructionCount, inCycleCount, inWorld);
+        curLogger->collect(inCollectionType, inInstructionCount, inCycleCount, inWorld);
     }
-    
-    computeNextCollectionCycles(inCycleCount);
+
+    mSampleValid = false;
+
+    publishRecord(inCollectionType, inInstructionCount, inCycleCount, inWorld);
+
+    if (!mAnalyses.empty())
+    {
+        deliverAnalysisResults();
+        startAnalyses(inCollectionType, inInstructionCount, inCycleCount, inWorld);
+    }
+}
+
+void
+DataCollector::publishRecord(DataLogger::ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inCycleCount, const World* inWorld)
+{
+    if (mRecordRings.empty())
+        return;
+
+    const PopulationStatistics& stats = inWorld->statistics();
+
+    CollectionRecord record;
+    record.mCollectionType      = inCollectionType;
+    record.mInstructions        = inInstructionCount;
+    record.mSlicerCycles        = inCycleCount;
+    record.mNumCreatures        = inWorld->cellMap()->numCreatures();
+    record.mNumAdults           = stats.numAdults();
+    record.mGenotypeRichness    = stats.genotypeRichness();
+    record.mFullness            = inWorld->cellMap()->fullness();
+    record.mMeanSize            = stats.meanSize();
+    record.mMeanGeneration      = stats.meanGeneration();
+    record.mShannonDiversity    = stats.shannonDiversity();
+
+    for (RecordRingList::const_iterator it = mRecordRings.begin(); it != mRecordRings.end(); ++it)
+        (*it)->push(record);
+}
+
+void
+DataCollector::addRecordRing(CollectionRecordRing* inRing)
+{
+    mRecordRings.push_back(inRing);
 }
 
+bool
+DataCollector::removeRecordRing(CollectionRecordRing* inRing)
+{
+    RecordRingList::iterator findIter = find(mRecordRings.begin(), mRecordRings.end(), inRing);
+    if (findIter != mRecordRings.end())
+    {
+        mRecordRings.erase(findIter);
+        return true;
+    }
+    return false;
+}
+
+#pragma mark -
+
+void
+DataCollector::addAnalysis(SnapshotAnalysis* inAnalysis, DataLogger::ECollectionType inCollectionType)
+{
+    if (!mAnalysisPool)
+        mAnalysisPool = new AnalysisPool(mNumAnalysisThreads);
+
+    mAnalyses.push_back(make_pair(inAnalysis, inCollectionType));
+}
+
+bool
+DataCollector::removeAnalysis(SnapshotAnalysis* inAnalysis)
+{
+    for (AnalysisList::iterator it = mAnalyses.begin(); it != mAnalyses.end(); ++it)
+    {
+        if (it->first == inAnalysis)
+        {
+            finishAnalyses();
+            mAnalyses.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+DataCollector::deliverAnalysisResults()
+{
+    while (!mPendingAnalyses.empty() && mPendingAnalyses.front()->isDone())
+        deliverNextAnalysisResult();
+}
+
+void
+DataCollector::finishAnalyses()
+{
+    while (!mPendingAnalyses.empty())
+    {
+        mAnalysisPool->waitFor(mPendingAnalyses.front());
+        deliverNextAnalysisResult();
+    }
+}
+
+void
+DataCollector::startAnalyses(DataLogger::ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inCycleCount, const World* inWorld)
+{
+    boost::shared_ptr<WorldSnapshot> snapshot;
+
+    for (AnalysisList::const_iterator it = mAnalyses.begin(); it != mAnalyses.end(); ++it)
+    {
+        if (it->second != inCollectionType)
+            continue;
+
+        // only take the snapshot if some analysis is going to use it
+        if (!snapshot)
+            snapshot.reset(new WorldSnapshot(*inWorld, inInstructionCount, inCycleCount));
+
+        while (mPendingAnalyses.size() >= kMaxPendingAnalyses)
+        {
+            mAnalysisPool->waitFor(mPendingAnalyses.front());
+            deliverNextAnalysisResult();
+        }
+
+        AnalysisJob* job = new AnalysisJob(it->first, snapshot);
+        mPendingAnalyses.push_back(job);
+        mAnalysisPool->submit(job);
+    }
+}
+
+void
+DataCollector::deliverNextAnalysisResult()
+{
+    AnalysisJob* job = mPendingAnalyses.front();
+    mPendingAnalyses.pop_front();
+
+    job->mAnalysis->resultReady(*job->mSnapshot, job->mResult);
+    delete job;
+}
+
+#pragma mark -
+
 void
 DataCollector::computeNextCollectionTime(u_int64_t inInstructionCount)
 {
@@ -10,14 +10,20 @@
 #ifndef MT_DataCollection_h
 #define MT_DataCollection_h
 
+#include <deque>
 #include <vector>
 #include <string.h>
 
 #include "MT_Engine.h"
+#include "MT_PopulationSample.h"
+#include "MT_RingBuffer.h"
+#include "MT_WorldEvents.h"
 
 namespace MacTierra {
 
+class AnalysisPool;
 class DataCollector;
+class SnapshotAnalysis;
 class World;
 
 // generic data logging class
@@ -29,6 +35,11 @@ public:
         kCollectionPeriodic,
         kCollectionSlicerCycle
     };
+
+    enum EDataRequirement {
+        kExactData,                 // always computes from the whole population
+        kSampledDataAllowed         // can use the collector's population sample, when it has one
+    };
     
     DataLogger()
     : mLastCollectionInstructions(0)
@@ -43,6 +54,8 @@ public:
     u_int64_t       lastCollectionInstructions() const  { return mLastCollectionInstructions; }
     u_int64_t       lastCollectionCycles() const        { return mLastCollectionCycles; }
 
+    virtual EDataRequirement dataRequirement() const    { return kExactData; }
+
 protected:
 
     // subclasses should override to collect their type of data
@@ -57,6 +70,10 @@ protected:
     }
     DataCollector*  collector() const { return mOwningCollector; }
 
+    // For loggers that allow sampled data; NULL if the collector isn't sampling,
+    // in which case the logger should compute exact values.
+    const PopulationSample* sampledData() const;
+
     virtual void    collectorChanged() {}
 
 protected:
@@ -68,17 +85,40 @@ protected:
 
 
 
-// logger for "events" (like creature birth and death)
-class EventLogger : public DataLogger
+// logger for "events" (like creature birth and death). Unlike the other loggers these are
+// not driven by the collector; register them with World::addEventListener().
+class EventLogger : public WorldEventListener
 {
 public:
 
+    // the events this logger wants, as WorldEventListener::EEventMask values
+    virtual u_int32_t   eventMask() const = 0;
+
+};
 
 
+// Summary of the world at one collection, published to record rings so that other threads
+// can read it without locking the engine.
+struct CollectionRecord
+{
+    u_int32_t   mCollectionType;        // DataLogger::ECollectionType
+    u_int64_t   mInstructions;
+    u_int64_t   mSlicerCycles;
+
+    u_int32_t   mNumCreatures;
+    u_int32_t   mNumAdults;
+    u_int32_t   mGenotypeRichness;
+    double      mFullness;
+    double      mMeanSize;
+    double      mMeanGeneration;
+    double      mShannonDiversity;
 };
 
+typedef RingBuffer<CollectionRecord> CollectionRecordRing;
 
 // The DataCollector runs all of the installed loggers at the given collection interval.
+// If a sample size is set, loggers that allow sampled data are given a random sample of
+// the population, taken once per collection.
 class DataCollector
 {
 public:
@@ -109,16 +149,58 @@ public:
 
     u_int64_t       nextCollectionCycle() const { return mNextCollectionCycle; }
     void            setNextCollectionCycle(u_int64_t inCycleCount) { mNextCollectionCycle = inCycleCount; }
-    
+
+    // Sampled collection. A sample size of zero (the default) means that all loggers get exact data.
+    u_int32_t       sampleSize() const                  { return mSample.sampleSize(); }
+    void            setSampleSize(u_int32_t inSize)     { mSample.setSampleSize(inSize); }
+    void            setSamplingSeed(u_int32_t inSeed)   { mSample.setRandomSeed(inSeed); }
+
+    // Valid while loggers are collecting; NULL if not sampling.
+    const PopulationSample* currentSample() const       { return mSampleValid ? &mSample : NULL; }
+
+    // A CollectionRecord is pushed onto each ring at every collection. Each consumer owns
+    // its ring, and drains it from its own thread; add and remove rings with the engine stopped.
+    void            addRecordRing(CollectionRecordRing* inRing);
+    bool            removeRecordRing(CollectionRecordRing* inRing);
+
+    // Analyses too slow for the engine thread. At each collection of the given type, the collector
+    // takes a WorldSnapshot, and runs each analysis against it on a pool of worker threads while
+    // the engine carries on. Results are handed back to the analyses on the engine thread at
+    // later collections, or by deliverAnalysisResults(). If too many snapshots are still being
+    // analyzed, the engine waits for the oldest. Remove analyses before the collector is deleted.
+    enum { kMaxPendingAnalyses = 64 };
+
+    void            addAnalysis(SnapshotAnalysis* inAnalysis, DataLogger::ECollectionType inCollectionType);
+    // Waits for outstanding analyses, and delivers their results, first.
+    bool            removeAnalysis(SnapshotAnalysis* inAnalysis);
+
+    // Takes effect when the first analysis is added. 0 (the default) means one per processor.
+    void            setNumAnalysisThreads(u_int32_t inNumThreads)   { mNumAnalysisThreads = inNumThreads; }
+
+    // Hands finished results to their analyses, in order, stopping at the first that isn't done.
+    void            deliverAnalysisResults();
+    // Waits for all outstanding analyses, and delivers their results.
+    void            finishAnalyses();
+
+    u_int32_t       numPendingAnalyses() const          { return mPendingAnalyses.size(); }
+
 protected:
+
+    typedef std::vector<DataLogger*> DataLoggerList;
     
+    void            collectWithLoggers(const DataLoggerList& inLoggers, DataLogger::ECollectionType inCollectionType,
+                                       u_int64_t inInstructionCount, u_int64_t inCycleCount, const World* inWorld);
+
+    void            publishRecord(DataLogger::ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inCycleCount, const World* inWorld);
+
+    void            startAnalyses(DataLogger::ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inCycleCount, const World* inWorld);
+    void            deliverNextAnalysisResult();
+
     void            computeNextCollectionTime(u_int64_t inInstructionCount);
     void            computeNextCollectionCycles(u_int64_t inCurrentCycleCount);
 
 protected:
 
-    typedef std::vector<DataLogger*> DataLoggerList;
-
     u_int64_t       mCollectionInterval;
     u_int64_t       mNextCollectionInstructions;
     DataLoggerList  mPeriodicLoggers;
@@ -126,6 +208,19 @@ protected:
     u_int64_t       mCollectionCycles;
     u_int64_t       mNextCollectionCycle;
     DataLoggerList  mCyclicalLoggers;
+
+    PopulationSample    mSample;
+    bool                mSampleValid;
+
+    typedef std::vector<CollectionRecordRing*> RecordRingList;
+    RecordRingList      mRecordRings;
+
+    struct AnalysisJob;
+    typedef std::vector<std::pair<SnapshotAnalysis*, DataLogger::ECollectionType> > AnalysisList;
+    AnalysisList        mAnalyses;
+    AnalysisPool*       mAnalysisPool;          // created with the first analysis
+    u_int32_t           mNumAnalysisThreads;
+    std::deque<AnalysisJob*> mPendingAnalyses;  // in the order they were started
 };
 
 
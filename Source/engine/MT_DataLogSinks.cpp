@@ -0,0 +1,280 @@
+/*
+ *  MT_DataLogSinks.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <sstream>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "MT_DataLogSinks.h"
+
+#include "MT_CellMap.h"
+#include "MT_InstructionSet.h"
+#include "MT_Inventory.h"
+#include "MT_World.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+ColumnarLogSink::ColumnarLogSink()
+{
+}
+
+ColumnarLogSink::~ColumnarLogSink()
+{
+    close();
+}
+
+bool
+ColumnarLogSink::open(const std::string& inPath)
+{
+    ColumnarLogSchema& schema = mWriter.schema();
+    if (schema.numColumns() == 0)
+    {
+        schema.addColumn("instructions", ColumnarLogSchema::kUInt64Column);
+        schema.addColumn("cycles", ColumnarLogSchema::kUInt64Column);
+        addColumns(schema);
+    }
+
+    return mWriter.open(inPath);
+}
+
+void
+ColumnarLogSink::close()
+{
+    mWriter.close();
+}
+
+void
+ColumnarLogSink::collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const World* inWorld)
+{
+    if (!mWriter.isOpen())
+        return;
+
+    appendRow(inInstructionCount, inSlicerCycles, inWorld);
+}
+
+void
+ColumnarLogSink::appendRow(u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const World* inWorld)
+{
+    mWriter.appendUInt64(inInstructionCount);
+    mWriter.appendUInt64(inSlicerCycles);
+    appendValues(mWriter, inWorld);
+    mWriter.finishRow();
+}
+
+#pragma mark -
+
+PopulationLogSink::PopulationLogSink(DataLogger::ECollectionType inCollectionType)
+: mCollectionType(inCollectionType)
+, mRing(kRingCapacity)
+, mDrainThread(NULL)
+, mClosing(false)
+{
+}
+
+PopulationLogSink::~PopulationLogSink()
+{
+    close();
+}
+
+bool
+PopulationLogSink::open(const std::string& inPath)
+{
+    ColumnarLogSchema& schema = mWriter.schema();
+    if (schema.numColumns() == 0)
+    {
+        schema.addColumn("instructions", ColumnarLogSchema::kUInt64Column);
+        schema.addColumn("cycles", ColumnarLogSchema::kUInt64Column);
+        schema.addColumn("population", ColumnarLogSchema::kUInt64Column);
+        schema.addColumn("adults", ColumnarLogSchema::kUInt64Column);
+        schema.addColumn("mean_size", ColumnarLogSchema::kDoubleColumn);
+        schema.addColumn("mean_generation", ColumnarLogSchema::kDoubleColumn);
+        schema.addColumn("genotype_richness", ColumnarLogSchema::kUInt64Column);
+        schema.addColumn("shannon_diversity", ColumnarLogSchema::kDoubleColumn);
+        schema.addColumn("fullness", ColumnarLogSchema::kDoubleColumn);
+    }
+
+    if (!mWriter.open(inPath))
+        return false;
+
+    mClosing = false;
+    mDrainThread = new boost::thread(DrainThreadEntry(this));
+    return true;
+}
+
+void
+PopulationLogSink::close()
+{
+    if (!mDrainThread)
+        return;
+
+    {
+        boost::mutex::scoped_lock lock(mDrainLock);
+        mClosing = true;
+        mDrainWakeup.notify_one();
+    }
+
+    mDrainThread->join();
+    delete mDrainThread;
+    mDrainThread = NULL;
+
+    mWriter.close();
+}
+
+void
+PopulationLogSink::drainRing()
+{
+    boost::mutex::scoped_lock lock(mDrainLock);
+    while (true)
+    {
+        // anything pushed before close() was called is on the ring by now
+        const bool closing = mClosing;
+        writeRecords();
+        if (closing)
+            break;
+
+        mDrainWakeup.timed_wait(lock, boost::posix_time::milliseconds(static_cast<long>(kDrainInterval)));
+    }
+}
+
+void
+PopulationLogSink::writeRecords()
+{
+    CollectionRecord record;
+    while (mRing.pop(record))
+    {
+        if (record.mCollectionType != static_cast<u_int32_t>(mCollectionType))
+            continue;
+
+        mWriter.appendUInt64(record.mInstructions);
+        mWriter.appendUInt64(record.mSlicerCycles);
+        mWriter.appendUInt64(record.mNumCreatures);
+        mWriter.appendUInt64(record.mNumAdults);
+        mWriter.appendDouble(record.mMeanSize);
+        mWriter.appendDouble(record.mMeanGeneration);
+        mWriter.appendUInt64(record.mGenotypeRichness);
+        mWriter.appendDouble(record.mShannonDiversity);
+        mWriter.appendDouble(record.mFullness);
+        mWriter.finishRow();
+    }
+}
+
+#pragma mark -
+
+GenotypeLogSink::GenotypeLogSink(u_int32_t inNumGenotypes)
+: mNumGenotypes(inNumGenotypes)
+{
+}
+
+void
+GenotypeLogSink::addColumns(ColumnarLogSchema& ioSchema)
+{
+    ioSchema.addColumn("alive_genotypes", ColumnarLogSchema::kUInt64Column);
+
+    for (u_int32_t i = 1; i <= mNumGenotypes; ++i)
+    {
+        std::ostringstream genotypeName, countName;
+        genotypeName << "genotype_" << i;
+        countName << "count_" << i;
+
+        ioSchema.addColumn(genotypeName.str(), ColumnarLogSchema::kStringColumn);
+        ioSchema.addColumn(countName.str(), ColumnarLogSchema::kUInt64Column);
+    }
+}
+
+void
+GenotypeLogSink::appendValues(ColumnarLogWriter& inWriter, const World* inWorld)
+{
+    const Inventory* inventory = inWorld->inventory();
+    inWriter.appendUInt64(inventory->numAliveGenotypes());
+
+    Inventory::GenotypeVector genotypes;
+    inventory->topGenotypes(mNumGenotypes, genotypes);
+
+    for (u_int32_t i = 0; i < mNumGenotypes; ++i)
+    {
+        if (i < genotypes.size())
+        {
+            inWriter.appendString(genotypes[i]->name());
+            inWriter.appendUInt64(genotypes[i]->numberAlive());
+        }
+        else
+        {
+            inWriter.appendString(std::string());
+            inWriter.appendUInt64(0);
+        }
+    }
+}
+
+#pragma mark -
+
+void
+OpcodeCensusLogSink::addColumns(ColumnarLogSchema& ioSchema)
+{
+    for (int32_t i = 0; i < kInstructionSetSize; ++i)
+        ioSchema.addColumn(nameForInstruction(i), ColumnarLogSchema::kUInt64Column);
+
+    ioSchema.addColumn("templates", ColumnarLogSchema::kUInt64Column);
+    ioSchema.addColumn("nop_fraction", ColumnarLogSchema::kDoubleColumn);
+    ioSchema.addColumn("template_density", ColumnarLogSchema::kDoubleColumn);
+}
+
+void
+OpcodeCensusLogSink::appendValues(ColumnarLogWriter& inWriter, const World* inWorld)
+{
+    mCensus.update(*inWorld->soup());
+
+    const OpcodeCensus::Counts& totals = mCensus.totals();
+    for (int32_t i = 0; i < kInstructionSetSize; ++i)
+        inWriter.appendUInt64(totals.mInstructions[i]);
+
+    inWriter.appendUInt64(totals.mTemplates);
+    inWriter.appendDouble(mCensus.nopFraction());
+    inWriter.appendDouble(mCensus.templateDensity());
+}
+
+#pragma mark -
+
+HeatmapLogSink::HeatmapLogSink(SoupHeatmap* inHeatmap)
+: mHeatmap(inHeatmap)
+, mCurBlock(0)
+{
+}
+
+void
+HeatmapLogSink::collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const World* inWorld)
+{
+    if (!mWriter.isOpen() || !mHeatmap)
+        return;
+
+    mHeatmap->takeSnapshot(mSnapshot);
+    for (mCurBlock = 0; mCurBlock < mSnapshot.mFetches.size(); ++mCurBlock)
+        appendRow(inInstructionCount, inSlicerCycles, inWorld);
+}
+
+void
+HeatmapLogSink::addColumns(ColumnarLogSchema& ioSchema)
+{
+    ioSchema.addColumn("address", ColumnarLogSchema::kUInt64Column);
+    ioSchema.addColumn("fetches", ColumnarLogSchema::kDoubleColumn);
+    ioSchema.addColumn("foreign_fetches", ColumnarLogSchema::kDoubleColumn);
+    ioSchema.addColumn("writes", ColumnarLogSchema::kDoubleColumn);
+}
+
+void
+HeatmapLogSink::appendValues(ColumnarLogWriter& inWriter, const World* inWorld)
+{
+    inWriter.appendUInt64(static_cast<u_int64_t>(mCurBlock) * mSnapshot.mBlockSize);
+    inWriter.appendDouble(mSnapshot.mFetches[mCurBlock]);
+    inWriter.appendDouble(mSnapshot.mForeignFetches[mCurBlock]);
+    inWriter.appendDouble(mSnapshot.mWrites[mCurBlock]);
+}
+
+} // namespace MacTierra
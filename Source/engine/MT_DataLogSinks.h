@@ -0,0 +1,162 @@
+/*
+ *  MT_DataLogSinks.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_DataLogSinks_h
+#define MT_DataLogSinks_h
+
+#include <string>
+
+#include "MT_Engine.h"
+#include "MT_ColumnarLog.h"
+#include "MT_DataCollection.h"
+#include "MT_OpcodeCensus.h"
+#include "MT_SoupHeatmap.h"
+
+namespace MacTierra {
+
+// DataLoggers for headless runs. Rather than keeping their data in memory for display, they
+// write a row per collection to a columnar log. Every row starts with the instruction and
+// slicer cycle counts.
+class ColumnarLogSink : public DataLogger
+{
+public:
+    ColumnarLogSink();
+    virtual ~ColumnarLogSink();
+
+    bool            open(const std::string& inPath);
+    void            close();
+    bool            isOpen() const          { return mWriter.isOpen(); }
+
+    void            flush()                 { mWriter.flush(); }
+    u_int64_t       numRows() const         { return mWriter.numRows(); }
+
+protected:
+
+    virtual void    collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const World* inWorld);
+
+    // subclasses describe and fill in their own columns
+    virtual void    addColumns(ColumnarLogSchema& ioSchema) = 0;
+    virtual void    appendValues(ColumnarLogWriter& inWriter, const World* inWorld) = 0;
+
+    void            appendRow(u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const World* inWorld);
+
+protected:
+
+    ColumnarLogWriter   mWriter;
+};
+
+// Population size, mean size and generation, and diversity, with the same leading columns as
+// the sinks above. Rather than being a logger, this reads the CollectionRecords of one type of
+// collection from its own ring, on a thread of its own, so all the engine does for it is copy
+// a record. Add the ring to the world's collector after opening, and remove it before closing.
+class PopulationLogSink : Noncopyable
+{
+public:
+    enum {
+        kRingCapacity   = 8192,
+        kDrainInterval  = 50        // milliseconds
+    };
+
+    PopulationLogSink(DataLogger::ECollectionType inCollectionType = DataLogger::kCollectionPeriodic);
+    ~PopulationLogSink();
+
+    bool            open(const std::string& inPath);
+    // Writes the records left on the ring, and stops the drain thread.
+    void            close();
+    bool            isOpen() const          { return mWriter.isOpen(); }
+
+    CollectionRecordRing*   recordRing()    { return &mRing; }
+
+    // Only reliable once the log is closed.
+    u_int64_t       numRows() const         { return mWriter.numRows(); }
+    // Records the drain thread fell too far behind to write.
+    u_int32_t       numDropped() const      { return mRing.numDropped(); }
+
+protected:
+
+    struct DrainThreadEntry
+    {
+        DrainThreadEntry(PopulationLogSink* inSink) : mSink(inSink) {}
+        void operator()()   { mSink->drainRing(); }
+        PopulationLogSink*  mSink;
+    };
+    friend struct DrainThreadEntry;
+
+    // drain thread
+    void            drainRing();
+    void            writeRecords();
+
+protected:
+
+    DataLogger::ECollectionType mCollectionType;
+    CollectionRecordRing        mRing;
+    ColumnarLogWriter           mWriter;
+
+    boost::thread*              mDrainThread;
+    boost::mutex                mDrainLock;
+    boost::condition_variable   mDrainWakeup;
+    bool                        mClosing;
+};
+
+// The most common genotypes and their populations, most common first. Ranks that aren't
+// filled have an empty name and a count of 0.
+class GenotypeLogSink : public ColumnarLogSink
+{
+public:
+    GenotypeLogSink(u_int32_t inNumGenotypes = 5);
+
+protected:
+    virtual void    addColumns(ColumnarLogSchema& ioSchema);
+    virtual void    appendValues(ColumnarLogWriter& inWriter, const World* inWorld);
+
+protected:
+
+    u_int32_t       mNumGenotypes;
+};
+
+// The number of each instruction in the soup, the number of nop templates, and the fraction
+// of nops and density of templates. Only the parts of the soup that changed are recounted.
+class OpcodeCensusLogSink : public ColumnarLogSink
+{
+public:
+    const OpcodeCensus& census() const      { return mCensus; }
+
+protected:
+    virtual void    addColumns(ColumnarLogSchema& ioSchema);
+    virtual void    appendValues(ColumnarLogWriter& inWriter, const World* inWorld);
+
+protected:
+
+    OpcodeCensus    mCensus;
+};
+
+// Snapshots of a SoupHeatmap, one row per block of the soup at each collection, with the
+// address of the block's first cell and its decayed fetch, foreign fetch and write counts.
+// Taking the snapshot is what decays the heatmap, so only one logger should use it.
+class HeatmapLogSink : public ColumnarLogSink
+{
+public:
+    HeatmapLogSink(SoupHeatmap* inHeatmap);
+
+protected:
+    virtual void    collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const World* inWorld);
+
+    virtual void    addColumns(ColumnarLogSchema& ioSchema);
+    virtual void    appendValues(ColumnarLogWriter& inWriter, const World* inWorld);
+
+protected:
+
+    SoupHeatmap*            mHeatmap;       // not owned
+    SoupHeatmap::Snapshot   mSnapshot;
+    u_int32_t               mCurBlock;
+};
+
+} // namespace MacTierra
+
+#endif // MT_DataLogSinks_h
@@ -0,0 +1,333 @@
+/*
+ *  MT_Ensemble.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread.hpp>
+
+#define HAVE_BOOST_SERIALIZATION 1
+#include <RandomLib/Random.hpp>
+
+#include "MT_Ensemble.h"
+
+#include "MT_Ancestor.h"
+#include "MT_AnalysisPool.h"
+#include "MT_CellMap.h"
+#include "MT_DataLogSinks.h"
+#include "MT_Inventory.h"
+#include "MT_World.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+const u_int64_t kDefaultQuantum = 1000000;
+
+// Runs one world for a quantum, timing it.
+class EnsembleRunTask : public AnalysisPool::Task
+{
+public:
+    EnsembleRunTask(Ensemble::Run& inRun, u_int64_t inInstructions)
+    : mRun(inRun)
+    , mInstructions(inInstructions)
+    {
+    }
+
+    virtual void run()
+    {
+        const u_int64_t kMaxIterateCycles = 1U << 30;
+        boost::posix_time::ptime startTime = boost::posix_time::microsec_clock::universal_time();
+
+        u_int64_t remaining = mInstructions;
+        while (remaining > 0)
+        {
+            const u_int32_t cycles = min(remaining, kMaxIterateCycles);
+            mRun.mWorld->iterate(cycles);
+            remaining -= cycles;
+        }
+
+        boost::posix_time::time_duration elapsed = boost::posix_time::microsec_clock::universal_time() - startTime;
+        mRun.mSeconds += elapsed.total_microseconds() / 1.0e6;
+        mRun.mInstructionsRun += mInstructions;
+    }
+
+protected:
+    Ensemble::Run&  mRun;
+    u_int64_t       mInstructions;
+};
+
+Ensemble::Run::Run(const std::string& inName, const SoupConfiguration& inConfiguration)
+: mName(inName)
+, mConfiguration(inConfiguration)
+, mWorld(NULL)
+, mDataLog(NULL)
+, mInstructionsRun(0)
+, mSeconds(0.0)
+{
+}
+
+double
+Ensemble::Run::instructionsPerSecond() const
+{
+    return mSeconds > 0.0 ? mInstructionsRun / mSeconds : 0.0;
+}
+
+#pragma mark -
+
+Ensemble::Ensemble(u_int32_t inMasterSeed, u_int32_t inNumThreads)
+: mMasterSeed(inMasterSeed)
+, mPool(new AnalysisPool(inNumThreads))
+, mRunLength(0)
+, mQuantum(kDefaultQuantum)
+, mDataInterval(0)
+, mGenotypeRegistry(NULL)
+, mStarted(false)
+{
+}
+
+Ensemble::~Ensemble()
+{
+    delete mPool;
+
+    closeDataLogs();
+    for (size_t i = 0; i < mRuns.size(); ++i)
+        delete mRuns[i].mWorld;
+}
+
+u_int32_t
+Ensemble::numThreads() const
+{
+    return mPool->numThreads();
+}
+
+void
+Ensemble::addConfiguration(const std::string& inName, const SoupConfiguration& inConfiguration, u_int32_t inNumReplicates)
+{
+    BOOST_ASSERT(!mStarted);
+    for (u_int32_t i = 0; i < inNumReplicates; ++i)
+    {
+        std::ostringstream nameStream;
+        nameStream << inName << "_r" << i;
+
+        const u_int32_t runSeed = seedForRun(mMasterSeed, mRuns.size());
+        mRuns.push_back(Run(nameStream.str(), SoupConfiguration(inConfiguration.soupSize(), runSeed, inConfiguration.settings())));
+    }
+}
+
+void
+Ensemble::addGrid(const std::string& inNamePrefix, const Settings& inSettings, const std::vector<u_int32_t>& inSoupSizes,
+                  const std::vector<double>& inMutationScales, u_int32_t inNumReplicates)
+{
+    for (size_t i = 0; i < inSoupSizes.size(); ++i)
+    {
+        for (size_t j = 0; j < inMutationScales.size(); ++j)
+        {
+            const u_int32_t soupSize = inSoupSizes[i];
+            const double scale = inMutationScales[j];
+
+            Settings settings(inSettings);
+            settings.scaleMutationRates(scale, soupSize);
+
+            std::ostringstream nameStream;
+            nameStream << inNamePrefix << "_s" << soupSize << "_m" << scale;
+            addConfiguration(nameStream.str(), SoupConfiguration(soupSize, 0, settings), inNumReplicates);
+        }
+    }
+}
+
+void
+Ensemble::setDataLogging(const std::string& inPrefix, u_int64_t inInterval)
+{
+    BOOST_ASSERT(!mStarted);
+    mDataLogPrefix = inPrefix;
+    mDataInterval = inInterval;
+}
+
+void
+Ensemble::setGenotypeRegistry(GenotypeRegistry* inRegistry)
+{
+    BOOST_ASSERT(!mStarted);
+    mGenotypeRegistry = inRegistry;
+}
+
+bool
+Ensemble::runRound()
+{
+    start();
+
+    vector<EnsembleRunTask*> tasks;
+    for (size_t i = 0; i < mRuns.size(); ++i)
+    {
+        Run& curRun = mRuns[i];
+        if (curRun.mInstructionsRun >= mRunLength)
+            continue;
+
+        tasks.push_back(new EnsembleRunTask(curRun, min(mQuantum, mRunLength - curRun.mInstructionsRun)));
+        mPool->submit(tasks.back());
+    }
+
+    mPool->waitForAll();
+
+    for (size_t i = 0; i < tasks.size(); ++i)
+        delete tasks[i];
+
+    if (finished())
+    {
+        closeDataLogs();
+        return false;
+    }
+
+    return true;
+}
+
+bool
+Ensemble::finished() const
+{
+    for (size_t i = 0; i < mRuns.size(); ++i)
+    {
+        if (mRuns[i].mInstructionsRun < mRunLength)
+            return false;
+    }
+    return true;
+}
+
+u_int64_t
+Ensemble::instructionsRun() const
+{
+    u_int64_t total = 0;
+    for (size_t i = 0; i < mRuns.size(); ++i)
+        total += mRuns[i].mInstructionsRun;
+    return total;
+}
+
+double
+Ensemble::fractionComplete() const
+{
+    const u_int64_t totalInstructions = mRunLength * mRuns.size();
+    return totalInstructions > 0 ? static_cast<double>(instructionsRun()) / totalInstructions : 1.0;
+}
+
+// A separate stream per run, keyed by both seeds, so adding runs doesn't change the others.
+u_int32_t
+Ensemble::seedForRun(u_int32_t inMasterSeed, u_int32_t inRunIndex)
+{
+    vector<u_int32_t> seedVector(2);
+    seedVector[0] = inMasterSeed;
+    seedVector[1] = inRunIndex;
+
+    RandomLib::Random seeder(seedVector);
+    return seeder.Integer<u_int32_t>();
+}
+
+bool
+Ensemble::saveWorlds(const std::string& inPrefix, WorldArchiver::EWorldSerializationFormat inFormat) const
+{
+    bool allSaved = true;
+    for (size_t i = 0; i < mRuns.size(); ++i)
+    {
+        if (!mRuns[i].mWorld)
+            continue;
+
+        const string fileName = worldFileName(inPrefix, mRuns[i], inFormat);
+        std::ofstream fileStream(fileName.c_str(), ios::out | ios::binary);
+        {
+            WorldExporter exporter(fileStream, inFormat);
+            exporter.saveWorld(mRuns[i].mWorld);
+        }
+
+        if (!fileStream)
+            allSaved = false;
+    }
+    return allSaved;
+}
+
+std::string
+Ensemble::worldFileName(const std::string& inPrefix, const Run& inRun, WorldArchiver::EWorldSerializationFormat inFormat)
+{
+    return inPrefix + inRun.mName + (inFormat == WorldArchiver::kXML ? ".mactierra_xml" : ".mactierra");
+}
+
+void
+Ensemble::writeSummary(std::ostream& inStream) const
+{
+    inStream << "name\tseed\tsoup_size\tinstructions\tseconds\tinstructions_per_second\tcreatures\tgenotypes" << endl;
+    for (size_t i = 0; i < mRuns.size(); ++i)
+    {
+        const Run& curRun = mRuns[i];
+        inStream << curRun.mName << "\t" << curRun.mConfiguration.randomSeed() << "\t" << curRun.mConfiguration.soupSize()
+                 << "\t" << curRun.mInstructionsRun << "\t" << curRun.mSeconds << "\t" << static_cast<u_int64_t>(curRun.instructionsPerSecond())
+                 << "\t" << (curRun.mWorld ? curRun.mWorld->cellMap()->numCreatures() : 0)
+                 << "\t" << (curRun.mWorld ? curRun.mWorld->inventory()->numAliveGenotypes() : 0) << endl;
+    }
+}
+
+bool
+Ensemble::start()
+{
+    if (mStarted)
+        return true;
+
+    mStarted = true;
+    bool logsOpened = true;
+
+    for (size_t i = 0; i < mRuns.size(); ++i)
+    {
+        Run& curRun = mRuns[i];
+        const SoupConfiguration& config = curRun.mConfiguration;
+
+        World* world = new World();
+        world->initializeSoup(config.soupSize());
+        world->setSettings(config.settings());
+        world->setInitialRandomSeed(config.randomSeed());
+        if (mGenotypeRegistry)
+            world->inventory()->setGenotypeRegistry(mGenotypeRegistry);
+        world->insertCreature(config.soupSize() / 2, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+        curRun.mWorld = world;
+
+        if (!mDataLogPrefix.empty())
+        {
+            curRun.mDataLog = new PopulationLogSink;
+            if (curRun.mDataLog->open(mDataLogPrefix + curRun.mName + "_population.mtcols"))
+            {
+                if (mDataInterval > 0)
+                    world->dataCollector()->setCollectionInterval(mDataInterval, 0);
+                world->dataCollector()->addRecordRing(curRun.mDataLog->recordRing());
+            }
+            else
+            {
+                delete curRun.mDataLog;
+                curRun.mDataLog = NULL;
+                logsOpened = false;
+            }
+        }
+    }
+
+    return logsOpened;
+}
+
+void
+Ensemble::closeDataLogs()
+{
+    for (size_t i = 0; i < mRuns.size(); ++i)
+    {
+        Run& curRun = mRuns[i];
+        if (!curRun.mDataLog)
+            continue;
+
+        curRun.mWorld->dataCollector()->removeRecordRing(curRun.mDataLog->recordRing());
+        curRun.mDataLog->close();
+        delete curRun.mDataLog;
+        curRun.mDataLog = NULL;
+    }
+}
+
+} // namespace MacTierra
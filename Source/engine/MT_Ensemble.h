@@ -0,0 +1,141 @@
+/*
+ *  MT_Ensemble.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_Ensemble_h
+#define MT_Ensemble_h
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+#include "MT_SoupConfiguration.h"
+#include "MT_WorldArchiver.h"
+
+namespace MacTierra {
+
+class AnalysisPool;
+class GenotypeRegistry;
+class PopulationLogSink;
+class World;
+
+// Many independent worlds, run to the same length on a pool of threads: replicates of some
+// configurations, or a grid of settings.
+//
+// The worlds are run in rounds. In each round, every unfinished world runs for one quantum
+// of instructions as a task on the pool, so any number of small soups can share a few
+// threads. Each run's seed is derived from the master seed and the run's index, whatever
+// seed its configuration had.
+class Ensemble : Noncopyable
+{
+public:
+
+    struct Run
+    {
+        Run(const std::string& inName, const SoupConfiguration& inConfiguration);
+
+        std::string         mName;              // used in file names
+        SoupConfiguration   mConfiguration;
+
+        World*              mWorld;
+        PopulationLogSink*  mDataLog;
+
+        u_int64_t           mInstructionsRun;
+        double              mSeconds;           // running time, not counting time waiting for a thread
+
+        double              instructionsPerSecond() const;
+    };
+
+    // 0 threads means one per processor.
+    Ensemble(u_int32_t inMasterSeed, u_int32_t inNumThreads = 0);
+    ~Ensemble();
+
+    u_int32_t       masterSeed() const      { return mMasterSeed; }
+    u_int32_t       numThreads() const;
+
+    // Adds inNumReplicates runs of the configuration, named <name>_r<replicate>.
+    void            addConfiguration(const std::string& inName, const SoupConfiguration& inConfiguration, u_int32_t inNumReplicates = 1);
+
+    // Adds replicates of every combination of soup size and mutation scale. The scale
+    // multiplies the flaw, cosmic ray and copy error rates of inSettings. Runs are named
+    // <prefix>_s<size>_m<scale>_r<replicate>.
+    void            addGrid(const std::string& inNamePrefix, const Settings& inSettings, const std::vector<u_int32_t>& inSoupSizes,
+                            const std::vector<double>& inMutationScales, u_int32_t inNumReplicates = 1);
+
+    size_t          numRuns() const         { return mRuns.size(); }
+    const Run&      run(size_t inIndex) const   { return mRuns[inIndex]; }
+
+    // Instructions each world runs in total; must be set before the first round.
+    void            setRunLength(u_int64_t inInstructions)  { mRunLength = inInstructions; }
+    u_int64_t       runLength() const       { return mRunLength; }
+
+    // Instructions each world runs per round.
+    void            setQuantum(u_int64_t inInstructions)    { mQuantum = inInstructions; }
+    u_int64_t       quantum() const         { return mQuantum; }
+
+    // If set, each world logs its population every inInterval instructions (or the data
+    // collector's default interval, for 0) to <prefix><name>_population.mtcols. Must be set
+    // before the first round.
+    void            setDataLogging(const std::string& inPrefix, u_int64_t inInterval);
+
+    // If set, the worlds share one set of genotype names and genomes; see
+    // Inventory::setGenotypeRegistry(). Must be set before the first round. On more than one
+    // thread, the names then depend on thread timing; see GenotypeRegistry.
+    void            setGenotypeRegistry(GenotypeRegistry* inRegistry);
+
+    // Creates the worlds and opens their data logs, if the first round hasn't already.
+    // Returns false if a data log couldn't be created.
+    bool            start();
+
+    // Runs every unfinished world for a quantum. Returns false once every world has run
+    // for the run length.
+    bool            runRound();
+    bool            finished() const;
+
+    // Over all the runs.
+    u_int64_t       instructionsRun() const;
+    double          fractionComplete() const;
+
+    static u_int32_t seedForRun(u_int32_t inMasterSeed, u_int32_t inRunIndex);
+
+    // Writes each world to <prefix><name>.mactierra (or .mactierra_xml).
+    bool            saveWorlds(const std::string& inPrefix, WorldArchiver::EWorldSerializationFormat inFormat) const;
+    static std::string worldFileName(const std::string& inPrefix, const Run& inRun, WorldArchiver::EWorldSerializationFormat inFormat);
+
+    // One tab-separated line per run: name, seed, soup size, instructions, seconds,
+    // instructions per second, creatures and genotypes alive.
+    void            writeSummary(std::ostream& inStream) const;
+
+protected:
+
+    void            closeDataLogs();
+
+protected:
+
+    u_int32_t           mMasterSeed;
+    AnalysisPool*       mPool;
+
+    std::vector<Run>    mRuns;
+
+    u_int64_t           mRunLength;
+    u_int64_t           mQuantum;
+
+    std::string         mDataLogPrefix;
+    u_int64_t           mDataInterval;
+
+    GenotypeRegistry*   mGenotypeRegistry;
+
+    bool                mStarted;
+};
+
+} // namespace MacTierra
+
+#endif // MT_Ensemble_h
@@ -0,0 +1,719 @@
+/*
+ *  MT_EventLog.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include <boost/assert.hpp>
+
+#include "MT_EventLog.h"
+
+#include "MT_Inventory.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+static const char kFileMagic[8] = { 'M', 'T', 'E', 'V', 'T', 'L', 'O', 'G' };
+static const char kBlockMagic[4] = { 'M', 'T', 'E', 'B' };
+static const u_int32_t kFileVersion = 1;
+
+// file header: magic, version, reserved
+// block header: magic, stored length, raw length, records, first and last instructions, flags
+static const size_t kFileHeaderSize = kEventLogFileHeaderSize;
+static const size_t kBlockHeaderSize = kEventLogBlockHeaderSize;
+
+enum {
+    kBlockCompressed = 1 << 0
+};
+
+// the record tag holds the type in the low two bits, and a type-specific value above that
+static const u_int8_t kRecordTypeMask = 0x3;
+static const u_int8_t kBredTrueFlag = 0x4;
+static const u_int32_t kDeathReasonShift = 2;
+
+static void appendUInt32(u_int8_t*& ioPtr, u_int32_t inValue)
+{
+    for (u_int32_t i = 0; i < 4; ++i)
+        *ioPtr++ = static_cast<u_int8_t>(inValue >> (8 * i));
+}
+
+static void appendUInt64(u_int8_t*& ioPtr, u_int64_t inValue)
+{
+    for (u_int32_t i = 0; i < 8; ++i)
+        *ioPtr++ = static_cast<u_int8_t>(inValue >> (8 * i));
+}
+
+static u_int32_t readUInt32(const u_int8_t*& ioPtr)
+{
+    u_int32_t value = 0;
+    for (u_int32_t i = 0; i < 4; ++i)
+        value |= static_cast<u_int32_t>(*ioPtr++) << (8 * i);
+    return value;
+}
+
+static u_int64_t readUInt64(const u_int8_t*& ioPtr)
+{
+    u_int64_t value = 0;
+    for (u_int32_t i = 0; i < 8; ++i)
+        value |= static_cast<u_int64_t>(*ioPtr++) << (8 * i);
+    return value;
+}
+
+// Genotype identifiers ("aaaaa") are stored as bijective base-26 numbers.
+static u_int64_t codeFromIdentifier(const std::string& inIdentifier)
+{
+    u_int64_t code = 0;
+    for (size_t i = 0; i < inIdentifier.length(); ++i)
+        code = code * 26 + (inIdentifier[i] - 'a' + 1);
+    return code;
+}
+
+static std::string identifierFromCode(u_int64_t inCode)
+{
+    std::string identifier;
+    while (inCode > 0)
+    {
+        --inCode;
+        identifier.insert(identifier.begin(), static_cast<char>('a' + inCode % 26));
+        inCode /= 26;
+    }
+    return identifier;
+}
+
+std::string
+EventLogRecord::genotypeName() const
+{
+    if (mGenotypeLength == 0)
+        return std::string();
+
+    std::ostringstream formatter;
+    formatter << mGenotypeLength << identifierFromCode(mGenotypeCode);
+    return formatter.str();
+}
+
+bool
+EventLogRecord::parseGenotypeName(const std::string& inName, u_int32_t& outLength, u_int64_t& outCode)
+{
+    size_t letterStart = inName.find_first_not_of("0123456789");
+    if (letterStart == 0 || letterStart == std::string::npos || letterStart > 9)
+        return false;
+
+    const std::string identifier = inName.substr(letterStart);
+    if (identifier.length() > 12 || identifier.find_first_not_of("abcdefghijklmnopqrstuvwxyz") != std::string::npos)
+        return false;
+
+    outLength = strtoul(inName.c_str(), NULL, 10);
+    outCode = codeFromIdentifier(identifier);
+    return outLength > 0;
+}
+
+#pragma mark -
+
+EventLogWriter::EventLogWriter(u_int32_t inBlockSize)
+: mBlockSize(max(inBlockSize, 1024U))
+, mCompress(false)
+, mNumRecords(0)
+, mCurBlock(NULL)
+, mWriterThread(NULL)
+, mClosing(false)
+{
+}
+
+EventLogWriter::~EventLogWriter()
+{
+    close();
+
+    for (vector<Block*>::iterator it = mFreeBlocks.begin(); it != mFreeBlocks.end(); ++it)
+        delete *it;
+}
+
+bool
+EventLogWriter::open(const std::string& inPath, bool inCompress)
+{
+    BOOST_ASSERT(!isOpen());
+
+    mFile.open(inPath.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!mFile)
+        return false;
+
+    u_int8_t header[kFileHeaderSize];
+    u_int8_t* headerPtr = header;
+    memcpy(headerPtr, kFileMagic, sizeof(kFileMagic));
+    headerPtr += sizeof(kFileMagic);
+    appendUInt32(headerPtr, kFileVersion);
+    appendUInt32(headerPtr, 0);
+    mFile.write(reinterpret_cast<const char*>(header), kFileHeaderSize);
+
+    mCompress = inCompress;
+    mNumRecords = 0;
+    mClosing = false;
+
+    mCurBlock = new Block;
+    mCurBlock->mData.reserve(mBlockSize + 64);
+    mCurBlock->mNumRecords = 0;
+
+    mWriterThread = new boost::thread(WriterThreadEntry(this));
+    return true;
+}
+
+void
+EventLogWriter::close()
+{
+    if (!isOpen())
+        return;
+
+    if (mCurBlock->mNumRecords > 0)
+        queueCurrentBlock();
+
+    {
+        boost::mutex::scoped_lock lock(mQueueLock);
+        mClosing = true;
+        mQueueChanged.notify_all();
+    }
+
+    mWriterThread->join();
+    delete mWriterThread;
+    mWriterThread = NULL;
+
+    delete mCurBlock;
+    mCurBlock = NULL;
+
+    mFile.close();
+}
+
+void
+EventLogWriter::creatureBorn(const BirthEvent& inEvent)
+{
+    BOOST_ASSERT(isOpen());
+
+    mCurBlock->mData.push_back(EventLogRecord::kBirth | (inEvent.mBredTrue ? kBredTrueFlag : 0));
+    startRecord(inEvent.mInstructions);
+
+    appendVarint(inEvent.mChildID);
+    // parents are always older than their children, so this is never 0 unless there is no parent
+    appendVarint(inEvent.mParentID ? inEvent.mChildID - inEvent.mParentID : 0);
+    appendVarint(inEvent.mLocation);
+    appendVarint(inEvent.mLength);
+    appendVarint(inEvent.mGeneration);
+    appendGenotype(inEvent.mGenotype);
+
+    finishRecord();
+}
+
+void
+EventLogWriter::creatureDied(const DeathEvent& inEvent)
+{
+    BOOST_ASSERT(isOpen());
+
+    mCurBlock->mData.push_back(EventLogRecord::kDeath | (inEvent.mReason << kDeathReasonShift));
+    startRecord(inEvent.mInstructions);
+
+    appendVarint(inEvent.mCreatureID);
+    appendVarint(inEvent.mInstructions - inEvent.mBirthInstructions);
+    appendVarint(inEvent.mLocation);
+    appendVarint(inEvent.mLength);
+    appendVarint(inEvent.mNumOffspring);
+    appendGenotype(inEvent.mGenotype);
+
+    finishRecord();
+}
+
+void
+EventLogWriter::appendGenotype(const InventoryGenotype* inGenotype)
+{
+    if (!inGenotype)
+    {
+        appendVarint(0);
+        return;
+    }
+
+    appendVarint(inGenotype->length());
+    appendVarint(codeFromIdentifier(inGenotype->identifier()));
+}
+
+void
+EventLogWriter::queueCurrentBlock()
+{
+    boost::mutex::scoped_lock lock(mQueueLock);
+
+    // if the disk can't keep up, make the engine wait rather than using unbounded memory
+    while (mFullBlocks.size() >= kMaxPendingBlocks)
+        mQueueChanged.wait(lock);
+
+    mFullBlocks.push_back(mCurBlock);
+
+    if (mFreeBlocks.empty())
+    {
+        mCurBlock = new Block;
+        mCurBlock->mData.reserve(mBlockSize + 64);
+    }
+    else
+    {
+        mCurBlock = mFreeBlocks.back();
+        mFreeBlocks.pop_back();
+    }
+    mCurBlock->mData.clear();
+    mCurBlock->mNumRecords = 0;
+
+    mQueueChanged.notify_all();
+}
+
+void
+EventLogWriter::writeBlocks()
+{
+    while (true)
+    {
+        Block* block = NULL;
+        {
+            boost::mutex::scoped_lock lock(mQueueLock);
+            while (mFullBlocks.empty() && !mClosing)
+                mQueueChanged.wait(lock);
+
+            if (mFullBlocks.empty())
+                break;
+
+            block = mFullBlocks.front();
+            mFullBlocks.pop_front();
+            mQueueChanged.notify_all();
+        }
+
+        writeBlock(*block);
+
+        {
+            boost::mutex::scoped_lock lock(mQueueLock);
+            mFreeBlocks.push_back(block);
+        }
+    }
+    mFile.flush();
+}
+
+void
+EventLogWriter::writeBlock(const Block& inBlock)
+{
+    const u_int8_t* payload = &inBlock.mData[0];
+    u_int32_t storedLength = inBlock.mData.size();
+    u_int32_t flags = 0;
+
+    if (mCompress && compressEventBlock(&inBlock.mData[0], inBlock.mData.size(), mCompressionBuffer))
+    {
+        payload = &mCompressionBuffer[0];
+        storedLength = mCompressionBuffer.size();
+        flags |= kBlockCompressed;
+    }
+
+    u_int8_t header[kBlockHeaderSize];
+    u_int8_t* headerPtr = header;
+    memcpy(headerPtr, kBlockMagic, sizeof(kBlockMagic));
+    headerPtr += sizeof(kBlockMagic);
+    appendUInt32(headerPtr, storedLength);
+    appendUInt32(headerPtr, inBlock.mData.size());
+    appendUInt32(headerPtr, inBlock.mNumRecords);
+    appendUInt64(headerPtr, inBlock.mFirstInstructions);
+    appendUInt64(headerPtr, inBlock.mLastInstructions);
+    appendUInt32(headerPtr, flags);
+
+    mFile.write(reinterpret_cast<const char*>(header), kBlockHeaderSize);
+    mFile.write(reinterpret_cast<const char*>(payload), storedLength);
+}
+
+#pragma mark -
+
+bool
+parseEventLogFileHeader(const u_int8_t* inData, size_t inLength)
+{
+    if (inLength < kFileHeaderSize || memcmp(inData, kFileMagic, sizeof(kFileMagic)) != 0)
+        return false;
+
+    const u_int8_t* headerPtr = inData + sizeof(kFileMagic);
+    return readUInt32(headerPtr) == kFileVersion;
+}
+
+bool
+parseEventBlockHeader(const u_int8_t* inData, size_t inLength, EventLogBlockInfo& outInfo)
+{
+    if (inLength < kBlockHeaderSize || memcmp(inData, kBlockMagic, sizeof(kBlockMagic)) != 0)
+        return false;
+
+    const u_int8_t* headerPtr = inData + sizeof(kBlockMagic);
+    outInfo.mStoredLength       = readUInt32(headerPtr);
+    outInfo.mRawLength          = readUInt32(headerPtr);
+    outInfo.mNumRecords         = readUInt32(headerPtr);
+    outInfo.mFirstInstructions  = readUInt64(headerPtr);
+    outInfo.mLastInstructions   = readUInt64(headerPtr);
+    outInfo.mFlags              = readUInt32(headerPtr);
+    return true;
+}
+
+const u_int8_t*
+eventBlockPayload(const EventLogBlockInfo& inInfo, const u_int8_t* inStoredPayload, std::vector<u_int8_t>& ioBuffer)
+{
+    if (!(inInfo.mFlags & kBlockCompressed))
+        return (inInfo.mStoredLength == inInfo.mRawLength) ? inStoredPayload : NULL;
+
+    if (!decompressEventBlock(inStoredPayload, inInfo.mStoredLength, inInfo.mRawLength, ioBuffer))
+        return NULL;
+
+    return ioBuffer.empty() ? inStoredPayload : &ioBuffer[0];
+}
+
+#pragma mark -
+
+EventBlockDecoder::EventBlockDecoder()
+: mData(NULL)
+, mLength(0)
+, mOffset(0)
+, mRecordsLeft(0)
+, mFirstInstructions(0)
+{
+}
+
+void
+EventBlockDecoder::setBlock(const EventLogBlockInfo& inInfo, const u_int8_t* inPayload)
+{
+    mData = inPayload;
+    mLength = inInfo.mRawLength;
+    mOffset = 0;
+    mRecordsLeft = inInfo.mNumRecords;
+    mFirstInstructions = inInfo.mFirstInstructions;
+}
+
+bool
+EventBlockDecoder::readVarint(u_int64_t& outValue)
+{
+    outValue = 0;
+    for (u_int32_t shift = 0; shift < 64; shift += 7)
+    {
+        if (mOffset >= mLength)
+            return false;
+
+        u_int8_t curByte = mData[mOffset++];
+        outValue |= static_cast<u_int64_t>(curByte & 0x7F) << shift;
+        if (!(curByte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool
+EventBlockDecoder::nextRecord(EventLogRecord& outRecord)
+{
+    if (mRecordsLeft == 0 || mOffset >= mLength)
+        return false;
+
+    u_int8_t tag = mData[mOffset++];
+
+    u_int64_t timeDelta, creatureID, location, length;
+    if (!readVarint(timeDelta) || !readVarint(creatureID))
+        return false;
+
+    outRecord.mInstructions = mFirstInstructions + timeDelta;
+    outRecord.mCreatureID = creatureID;
+
+    switch (tag & kRecordTypeMask)
+    {
+        case EventLogRecord::kBirth:
+            {
+                u_int64_t parentDelta, generation;
+                if (!readVarint(parentDelta) || !readVarint(location) || !readVarint(length) || !readVarint(generation))
+                    return false;
+
+                outRecord.mType = EventLogRecord::kBirth;
+                outRecord.mParentID = parentDelta ? creatureID - parentDelta : 0;
+                outRecord.mGeneration = generation;
+                outRecord.mBredTrue = (tag & kBredTrueFlag) != 0;
+
+                outRecord.mReason = DeathEvent::kReaped;
+                outRecord.mAge = 0;
+                outRecord.mNumOffspring = 0;
+            }
+            break;
+
+        case EventLogRecord::kDeath:
+            {
+                u_int64_t age, numOffspring;
+                if (!readVarint(age) || !readVarint(location) || !readVarint(length) || !readVarint(numOffspring))
+                    return false;
+
+                outRecord.mType = EventLogRecord::kDeath;
+                outRecord.mReason = static_cast<DeathEvent::EReason>(tag >> kDeathReasonShift);
+                outRecord.mAge = age;
+                outRecord.mNumOffspring = numOffspring;
+
+                outRecord.mParentID = 0;
+                outRecord.mGeneration = 0;
+                outRecord.mBredTrue = false;
+            }
+            break;
+
+        default:
+            return false;
+    }
+
+    outRecord.mLocation = location;
+    outRecord.mLength = length;
+
+    u_int64_t genotypeLength;
+    if (!readVarint(genotypeLength))
+        return false;
+
+    outRecord.mGenotypeLength = genotypeLength;
+    outRecord.mGenotypeCode = 0;
+    if (genotypeLength > 0 && !readVarint(outRecord.mGenotypeCode))
+        return false;
+
+    --mRecordsLeft;
+    return true;
+}
+
+#pragma mark -
+
+EventLogReader::EventLogReader()
+: mCorrupt(false)
+{
+}
+
+bool
+EventLogReader::open(const std::string& inPath)
+{
+    mFile.open(inPath.c_str(), ios::in | ios::binary);
+    if (!mFile)
+        return false;
+
+    u_int8_t header[kFileHeaderSize];
+    mFile.read(reinterpret_cast<char*>(header), kFileHeaderSize);
+    if (mFile.gcount() != (streamsize)kFileHeaderSize || !parseEventLogFileHeader(header, kFileHeaderSize))
+    {
+        mFile.close();
+        return false;
+    }
+
+    mCorrupt = false;
+    mDecoder = EventBlockDecoder();
+    return true;
+}
+
+bool
+EventLogReader::nextRecord(EventLogRecord& outRecord)
+{
+    while (mDecoder.recordsLeft() == 0)
+    {
+        EventLogBlockInfo blockInfo;
+        if (!nextBlockInfo(blockInfo))
+            return false;
+
+        if (!readBlock(blockInfo))
+            return false;
+    }
+
+    if (!mDecoder.nextRecord(outRecord))
+    {
+        mCorrupt = true;
+        mDecoder = EventBlockDecoder();
+        return false;
+    }
+
+    return true;
+}
+
+bool
+EventLogReader::nextBlockInfo(EventLogBlockInfo& outInfo)
+{
+    if (mCorrupt)
+        return false;
+
+    outInfo.mFileOffset = mFile.tellg();
+
+    u_int8_t header[kBlockHeaderSize];
+    mFile.read(reinterpret_cast<char*>(header), kBlockHeaderSize);
+    if (mFile.gcount() == 0)
+        return false;       // the end
+
+    if (mFile.gcount() != (streamsize)kBlockHeaderSize || !parseEventBlockHeader(header, kBlockHeaderSize, outInfo))
+    {
+        mCorrupt = true;
+        return false;
+    }
+    return true;
+}
+
+void
+EventLogReader::skipBlock(const EventLogBlockInfo& inInfo)
+{
+    mFile.seekg(inInfo.mFileOffset + kBlockHeaderSize + inInfo.mStoredLength);
+    mDecoder = EventBlockDecoder();
+}
+
+bool
+EventLogReader::readBlock(const EventLogBlockInfo& inInfo)
+{
+    mFile.seekg(inInfo.mFileOffset + kBlockHeaderSize);
+
+    mStoredData.resize(inInfo.mStoredLength);
+    if (inInfo.mStoredLength > 0)
+        mFile.read(reinterpret_cast<char*>(&mStoredData[0]), inInfo.mStoredLength);
+
+    const u_int8_t* payload = NULL;
+    if (mFile.gcount() == (streamsize)inInfo.mStoredLength && !mStoredData.empty())
+        payload = eventBlockPayload(inInfo, &mStoredData[0], mDecompressedData);
+
+    if (!payload)
+    {
+        mCorrupt = true;
+        mDecoder = EventBlockDecoder();
+        return false;
+    }
+
+    mDecoder.setBlock(inInfo, payload);
+    return true;
+}
+
+bool
+EventLogReader::seekToBlock(u_int64_t inFileOffset)
+{
+    mFile.clear();
+    mFile.seekg(inFileOffset);
+    mDecoder = EventBlockDecoder();
+    mCorrupt = false;
+    return mFile.good();
+}
+
+#pragma mark -
+
+// The compressed format is that of LZF: a control byte below 32 introduces a run of
+// (control + 1) literal bytes; otherwise the top three bits are a match length (7 meaning
+// "add the next byte"), and the bottom five bits plus the next byte are a back offset.
+
+static const size_t kHashBits = 14;
+static const size_t kMaxLiteralRun = 32;
+static const size_t kMaxOffset = 1 << 13;
+static const size_t kMaxMatchLength = 7 + 255 + 2;
+
+static inline u_int32_t hashThreeBytes(const u_int8_t* inData)
+{
+    u_int32_t value = (inData[0] << 16) | (inData[1] << 8) | inData[2];
+    return ((value * 2654435761U) >> (32 - kHashBits)) & ((1 << kHashBits) - 1);
+}
+
+static void appendLiterals(const u_int8_t* inData, size_t inLength, std::vector<u_int8_t>& outData)
+{
+    while (inLength > 0)
+    {
+        size_t runLength = min(inLength, kMaxLiteralRun);
+        outData.push_back(static_cast<u_int8_t>(runLength - 1));
+        outData.insert(outData.end(), inData, inData + runLength);
+        inData += runLength;
+        inLength -= runLength;
+    }
+}
+
+bool
+compressEventBlock(const u_int8_t* inData, size_t inLength, std::vector<u_int8_t>& outData)
+{
+    outData.clear();
+    outData.reserve(inLength);
+
+    // positions are stored + 1, so 0 means empty
+    std::vector<u_int32_t> hashTable(1 << kHashBits, 0);
+
+    size_t curPos = 0;
+    size_t literalStart = 0;
+    while (curPos + 2 < inLength)
+    {
+        u_int32_t hash = hashThreeBytes(inData + curPos);
+        size_t candidate = hashTable[hash];
+        hashTable[hash] = curPos + 1;
+
+        if (candidate > 0 && curPos - candidate < kMaxOffset && memcmp(inData + candidate - 1, inData + curPos, 3) == 0)
+        {
+            const size_t matchPos = candidate - 1;
+            const size_t offset = curPos - matchPos - 1;
+            const size_t maxLength = min(inLength - curPos, kMaxMatchLength);
+
+            size_t matchLength = 3;
+            while (matchLength < maxLength && inData[matchPos + matchLength] == inData[curPos + matchLength])
+                ++matchLength;
+
+            appendLiterals(inData + literalStart, curPos - literalStart, outData);
+
+            size_t lengthCode = matchLength - 2;
+            if (lengthCode < 7)
+                outData.push_back(static_cast<u_int8_t>((lengthCode << 5) | (offset >> 8)));
+            else
+            {
+                outData.push_back(static_cast<u_int8_t>((7 << 5) | (offset >> 8)));
+                outData.push_back(static_cast<u_int8_t>(lengthCode - 7));
+            }
+            outData.push_back(static_cast<u_int8_t>(offset & 0xFF));
+
+            curPos += matchLength;
+            literalStart = curPos;
+        }
+        else
+            ++curPos;
+
+        if (outData.size() >= inLength)
+            return false;
+    }
+
+    appendLiterals(inData + literalStart, inLength - literalStart, outData);
+    return outData.size() < inLength;
+}
+
+bool
+decompressEventBlock(const u_int8_t* inData, size_t inLength, size_t inRawLength, std::vector<u_int8_t>& outData)
+{
+    outData.clear();
+    outData.reserve(inRawLength);
+
+    size_t curPos = 0;
+    while (curPos < inLength)
+    {
+        u_int8_t control = inData[curPos++];
+        if (control < kMaxLiteralRun)
+        {
+            size_t runLength = control + 1;
+            if (curPos + runLength > inLength || outData.size() + runLength > inRawLength)
+                return false;
+
+            outData.insert(outData.end(), inData + curPos, inData + curPos + runLength);
+            curPos += runLength;
+        }
+        else
+        {
+            size_t lengthCode = control >> 5;
+            if (lengthCode == 7)
+            {
+                if (curPos >= inLength)
+                    return false;
+                lengthCode += inData[curPos++];
+            }
+
+            if (curPos >= inLength)
+                return false;
+
+            size_t offset = ((control & 0x1F) << 8) | inData[curPos++];
+            size_t matchLength = lengthCode + 2;
+            if (offset + 1 > outData.size() || outData.size() + matchLength > inRawLength)
+                return false;
+
+            // byte by byte, because the match may overlap what it produces
+            size_t matchPos = outData.size() - offset - 1;
+            for (size_t i = 0; i < matchLength; ++i)
+                outData.push_back(outData[matchPos + i]);
+        }
+    }
+
+    return outData.size() == inRawLength;
+}
+
+} // namespace MacTierra
@@ -0,0 +1,258 @@
+/*
+ *  MT_EventLog.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_EventLog_h
+#define MT_EventLog_h
+
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+#include "MT_DataCollection.h"
+#include "MT_WorldEvents.h"
+
+namespace MacTierra {
+
+// A binary log of every birth and death in a run.
+//
+// The file is a header followed by blocks. Each block has a fixed-size header (see
+// EventLogBlockInfo) and a payload of variable-length records, optionally compressed. Times
+// within a block are stored as deltas from the block's first instruction count, so every
+// block can be decoded on its own. Integers are little-endian; payload integers are varints.
+
+// One birth or death, as read back from the log.
+struct EventLogRecord
+{
+    enum EType {
+        kBirth = 1,
+        kDeath = 2
+    };
+
+    EType           mType;
+    u_int64_t       mInstructions;
+    creature_id     mCreatureID;        // the child, for births
+    address_t       mLocation;
+    u_int32_t       mLength;
+
+    // genotype of the creature, if it is counted in the inventory
+    u_int32_t       mGenotypeLength;    // 0 if none
+    u_int64_t       mGenotypeCode;      // identifier letters; see genotypeName()
+
+    // births
+    creature_id     mParentID;          // 0 for creatures inserted into the soup
+    u_int32_t       mGeneration;
+    bool            mBredTrue;
+
+    // deaths
+    DeathEvent::EReason mReason;
+    u_int64_t       mAge;               // instructions since birth
+    u_int32_t       mNumOffspring;
+
+    // like "80aaaaa", or empty
+    std::string     genotypeName() const;
+
+    // The inverse of genotypeName(), for matching records against a name. Returns false if
+    // inName is not a genotype name.
+    static bool     parseGenotypeName(const std::string& inName, u_int32_t& outLength, u_int64_t& outCode);
+};
+
+enum {
+    kEventLogFileHeaderSize     = 16,
+    kEventLogBlockHeaderSize    = 36
+};
+
+struct EventLogBlockInfo
+{
+    u_int64_t       mFileOffset;        // of the block header
+    u_int32_t       mStoredLength;      // of the payload on disk
+    u_int32_t       mRawLength;         // of the payload when decompressed
+    u_int32_t       mNumRecords;
+    u_int64_t       mFirstInstructions;
+    u_int64_t       mLastInstructions;
+    u_int32_t       mFlags;
+};
+
+bool    parseEventLogFileHeader(const u_int8_t* inData, size_t inLength);
+// Fills in everything but mFileOffset.
+bool    parseEventBlockHeader(const u_int8_t* inData, size_t inLength, EventLogBlockInfo& outInfo);
+
+// Returns the raw payload of a block given its stored payload, decompressing into ioBuffer
+// if necessary. Returns NULL if the payload is damaged.
+const u_int8_t* eventBlockPayload(const EventLogBlockInfo& inInfo, const u_int8_t* inStoredPayload, std::vector<u_int8_t>& ioBuffer);
+
+// Decodes the records of one raw block payload. Used by the reader and the index, so that
+// there is only one definition of the record format.
+class EventBlockDecoder
+{
+public:
+    EventBlockDecoder();
+
+    void            setBlock(const EventLogBlockInfo& inInfo, const u_int8_t* inPayload);
+
+    u_int32_t       recordsLeft() const     { return mRecordsLeft; }
+    // Returns false at the end of the block, or if it is damaged (in which case recordsLeft() is not 0).
+    bool            nextRecord(EventLogRecord& outRecord);
+
+protected:
+
+    bool            readVarint(u_int64_t& outValue);
+
+protected:
+
+    const u_int8_t* mData;
+    size_t          mLength;
+    size_t          mOffset;
+    u_int32_t       mRecordsLeft;
+    u_int64_t       mFirstInstructions;
+};
+
+// Writes the log from the engine thread; records are encoded into large buffers which
+// are compressed and written to disk on a background thread.
+class EventLogWriter : public EventLogger, Noncopyable
+{
+public:
+    enum {
+        kDefaultBlockSize   = 256 * 1024,
+        kMaxPendingBlocks   = 16        // the engine waits for the disk beyond this
+    };
+
+    EventLogWriter(u_int32_t inBlockSize = kDefaultBlockSize);
+    ~EventLogWriter();
+
+    bool            open(const std::string& inPath, bool inCompress);
+    // Writes out any buffered records and waits for the writer thread.
+    void            close();
+    bool            isOpen() const          { return mWriterThread != NULL; }
+
+    u_int64_t       numRecords() const      { return mNumRecords; }
+
+    virtual u_int32_t eventMask() const     { return WorldEventListener::kBirthEvents | WorldEventListener::kDeathEvents; }
+
+    virtual void    creatureBorn(const BirthEvent& inEvent);
+    virtual void    creatureDied(const DeathEvent& inEvent);
+
+protected:
+
+    struct Block
+    {
+        std::vector<u_int8_t>   mData;
+        u_int32_t               mNumRecords;
+        u_int64_t               mFirstInstructions;
+        u_int64_t               mLastInstructions;
+    };
+
+    struct WriterThreadEntry
+    {
+        WriterThreadEntry(EventLogWriter* inWriter) : mWriter(inWriter) {}
+        void operator()()   { mWriter->writeBlocks(); }
+        EventLogWriter*     mWriter;
+    };
+    friend struct WriterThreadEntry;
+
+    void            startRecord(u_int64_t inInstructions)
+    {
+        if (mCurBlock->mNumRecords == 0)
+            mCurBlock->mFirstInstructions = inInstructions;
+        appendVarint(inInstructions - mCurBlock->mFirstInstructions);
+        mCurBlock->mLastInstructions = inInstructions;
+    }
+
+    void            finishRecord()
+    {
+        ++mCurBlock->mNumRecords;
+        ++mNumRecords;
+        if (mCurBlock->mData.size() >= mBlockSize)
+            queueCurrentBlock();
+    }
+
+    void            appendVarint(u_int64_t inValue)
+    {
+        while (inValue >= 0x80)
+        {
+            mCurBlock->mData.push_back(static_cast<u_int8_t>(inValue | 0x80));
+            inValue >>= 7;
+        }
+        mCurBlock->mData.push_back(static_cast<u_int8_t>(inValue));
+    }
+
+    void            appendGenotype(const InventoryGenotype* inGenotype);
+
+    // engine thread
+    void            queueCurrentBlock();
+    // writer thread
+    void            writeBlocks();
+    void            writeBlock(const Block& inBlock);
+
+protected:
+
+    u_int32_t           mBlockSize;
+    bool                mCompress;
+    u_int64_t           mNumRecords;
+
+    Block*              mCurBlock;
+
+    std::ofstream       mFile;
+    boost::thread*      mWriterThread;
+
+    // shared with the writer thread
+    boost::mutex        mQueueLock;
+    boost::condition_variable mQueueChanged;
+    std::deque<Block*>  mFullBlocks;
+    std::vector<Block*> mFreeBlocks;
+    bool                mClosing;
+
+    std::vector<u_int8_t> mCompressionBuffer;     // writer thread only
+};
+
+// Reads a log written by EventLogWriter.
+class EventLogReader : Noncopyable
+{
+public:
+    EventLogReader();
+
+    bool            open(const std::string& inPath);
+    bool            isOpen() const          { return mFile.is_open(); }
+    // True if reading stopped because the file was damaged, rather than at the end.
+    bool            isCorrupt() const       { return mCorrupt; }
+
+    // Returns false at the end of the log.
+    bool            nextRecord(EventLogRecord& outRecord);
+
+    // Reads the header of the next block without decoding it. Follow with skipBlock() or readBlock().
+    bool            nextBlockInfo(EventLogBlockInfo& outInfo);
+    void            skipBlock(const EventLogBlockInfo& inInfo);
+    bool            readBlock(const EventLogBlockInfo& inInfo);
+
+    // Move to a block found by nextBlockInfo(), perhaps in an earlier pass over the file.
+    bool            seekToBlock(u_int64_t inFileOffset);
+
+protected:
+
+    std::ifstream           mFile;
+    bool                    mCorrupt;
+
+    std::vector<u_int8_t>   mStoredData;
+    std::vector<u_int8_t>   mDecompressedData;
+    EventBlockDecoder       mDecoder;
+};
+
+// Fast LZ77 compression used for log blocks. compressEventBlock() returns false if the data
+// doesn't compress.
+bool    compressEventBlock(const u_int8_t* inData, size_t inLength, std::vector<u_int8_t>& outData);
+bool    decompressEventBlock(const u_int8_t* inData, size_t inLength, size_t inRawLength, std::vector<u_int8_t>& outData);
+
+} // namespace MacTierra
+
+#endif // MT_EventLog_h
@@ -0,0 +1,602 @@
+/*
+ *  MT_EventLogIndex.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/thread.hpp>
+
+#include "MT_EventLogIndex.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+static const char* const kIndexMagic = "MTEVTIDX";
+static const u_int32_t kIndexVersion = 1;
+
+bool
+EventLogIndex::BlockEntry::mentionsGenotype(const genotype_key& inGenotype) const
+{
+    return binary_search(mGenotypes.begin(), mGenotypes.end(), inGenotype);
+}
+
+#pragma mark -
+
+// Summarizes newly found blocks for the index.
+class IndexBlockTask : public EventLogIndex::BlockTask
+{
+public:
+    IndexBlockTask(size_t inNumBlocks)
+    : mSummaries(inNumBlocks)
+    , mValid(inNumBlocks, 0)
+    {
+    }
+
+    virtual void    processBlock(size_t inCandidate, const EventLogIndex::BlockEntry& inEntry, EventBlockDecoder& inDecoder)
+    {
+        EventLogIndex::BlockEntry& summary = mSummaries[inCandidate];
+        summary.mInfo = inEntry.mInfo;
+        summary.mMinCreatureID = UINT_MAX;
+        summary.mMaxCreatureID = 0;
+        summary.mMaxParentID = 0;
+        summary.mNumBirths = 0;
+        summary.mNumDeaths = 0;
+
+        EventLogRecord record;
+        while (inDecoder.nextRecord(record))
+        {
+            summary.mMinCreatureID = min(summary.mMinCreatureID, record.mCreatureID);
+            summary.mMaxCreatureID = max(summary.mMaxCreatureID, record.mCreatureID);
+
+            if (record.mType == EventLogRecord::kBirth)
+            {
+                ++summary.mNumBirths;
+                summary.mMaxParentID = max(summary.mMaxParentID, record.mParentID);
+            }
+            else
+                ++summary.mNumDeaths;
+
+            if (record.mGenotypeLength > 0)
+                summary.mGenotypes.push_back(EventLogIndex::genotype_key(record.mGenotypeLength, record.mGenotypeCode));
+        }
+
+        sort(summary.mGenotypes.begin(), summary.mGenotypes.end());
+        summary.mGenotypes.erase(unique(summary.mGenotypes.begin(), summary.mGenotypes.end()), summary.mGenotypes.end());
+
+        mValid[inCandidate] = (inDecoder.recordsLeft() == 0);
+    }
+
+    vector<EventLogIndex::BlockEntry>   mSummaries;
+    vector<u_int8_t>                    mValid;     // not vector<bool>, which can't be written from several threads
+};
+
+// Collects the records that might change the population of a genotype. As well as births and
+// deaths, a creature joins a genotype when it first breeds true; that shows up as a bred-true
+// birth of the genotype by a parent which wasn't yet a member.
+class PopulationTask : public EventLogIndex::BlockTask
+{
+public:
+    enum EChange {
+        kBorn,
+        kDied,
+        kParentBredTrue
+    };
+
+    struct Change
+    {
+        u_int64_t   mInstructions;
+        creature_id mCreatureID;
+        EChange     mChange;
+    };
+    typedef vector<Change> ChangeVector;
+
+    PopulationTask(const EventLogIndex::genotype_key& inGenotype, size_t inNumCandidates)
+    : mGenotype(inGenotype)
+    , mChanges(inNumCandidates)
+    {
+    }
+
+    virtual void    processBlock(size_t inCandidate, const EventLogIndex::BlockEntry& inEntry, EventBlockDecoder& inDecoder)
+    {
+        ChangeVector& changes = mChanges[inCandidate];
+
+        EventLogRecord record;
+        while (inDecoder.nextRecord(record))
+        {
+            if (record.mGenotypeLength != mGenotype.first || record.mGenotypeCode != mGenotype.second)
+                continue;
+
+            Change change;
+            change.mInstructions = record.mInstructions;
+            change.mCreatureID = record.mCreatureID;
+            change.mChange = (record.mType == EventLogRecord::kBirth) ? kBorn : kDied;
+            changes.push_back(change);
+
+            if (record.mType == EventLogRecord::kBirth && record.mBredTrue && record.mParentID != 0)
+            {
+                change.mCreatureID = record.mParentID;
+                change.mChange = kParentBredTrue;
+                changes.push_back(change);
+            }
+        }
+    }
+
+    EventLogIndex::genotype_key mGenotype;
+    vector<ChangeVector>        mChanges;
+};
+
+class LifespanTask : public EventLogIndex::BlockTask
+{
+public:
+    LifespanTask(u_int64_t inFromInstructions, u_int64_t inToInstructions, size_t inNumCandidates)
+    : mFromInstructions(inFromInstructions)
+    , mToInstructions(inToInstructions)
+    , mAges(inNumCandidates)
+    {
+    }
+
+    virtual void    processBlock(size_t inCandidate, const EventLogIndex::BlockEntry& inEntry, EventBlockDecoder& inDecoder)
+    {
+        vector<u_int64_t>& ages = mAges[inCandidate];
+
+        EventLogRecord record;
+        while (inDecoder.nextRecord(record))
+        {
+            if (record.mType == EventLogRecord::kDeath && record.mInstructions >= mFromInstructions && record.mInstructions <= mToInstructions)
+                ages.push_back(record.mAge);
+        }
+    }
+
+    u_int64_t                   mFromInstructions;
+    u_int64_t                   mToInstructions;
+    vector<vector<u_int64_t> >  mAges;
+};
+
+// Collects births whose parent could be a descendant; which ones really are is worked out
+// afterwards, in log order.
+class LineageTask : public EventLogIndex::BlockTask
+{
+public:
+    LineageTask(creature_id inAncestorID, size_t inNumCandidates)
+    : mAncestorID(inAncestorID)
+    , mBirths(inNumCandidates)
+    {
+    }
+
+    virtual void    processBlock(size_t inCandidate, const EventLogIndex::BlockEntry& inEntry, EventBlockDecoder& inDecoder)
+    {
+        vector<EventLogRecord>& births = mBirths[inCandidate];
+
+        EventLogRecord record;
+        while (inDecoder.nextRecord(record))
+        {
+            if (record.mType == EventLogRecord::kBirth && record.mParentID >= mAncestorID)
+                births.push_back(record);
+        }
+    }
+
+    creature_id                     mAncestorID;
+    vector<vector<EventLogRecord> > mBirths;
+};
+
+#pragma mark -
+
+EventLogIndex::EventLogIndex()
+: mIndexedLength(0)
+, mNumThreads(0)
+, mCorrupt(false)
+, mIndexWasCurrent(false)
+{
+}
+
+EventLogIndex::~EventLogIndex()
+{
+    close();
+}
+
+std::string
+EventLogIndex::indexPathForLog(const std::string& inLogPath)
+{
+    return inLogPath + ".index";
+}
+
+bool
+EventLogIndex::open(const std::string& inLogPath, bool inSaveIndex)
+{
+    close();
+
+    try
+    {
+        mLogFile.open(inLogPath);
+    }
+    catch (std::exception const& e)
+    {
+        return false;
+    }
+
+    if (!mLogFile.is_open() || !parseEventLogFileHeader(logData(), mLogFile.size()))
+    {
+        close();
+        return false;
+    }
+
+    const std::string indexPath = indexPathForLog(inLogPath);
+    if (!loadIndex(indexPath))
+    {
+        mBlocks.clear();
+        mIndexedLength = kEventLogFileHeaderSize;
+    }
+
+    bool indexChanged = extendIndex();
+    mIndexWasCurrent = !indexChanged && !mBlocks.empty();
+
+    if (indexChanged && inSaveIndex)
+        saveIndex(indexPath);
+
+    return true;
+}
+
+void
+EventLogIndex::close()
+{
+    if (mLogFile.is_open())
+        mLogFile.close();
+
+    mBlocks.clear();
+    mIndexedLength = 0;
+    mCorrupt = false;
+    mIndexWasCurrent = false;
+}
+
+u_int32_t
+EventLogIndex::numThreads() const
+{
+    if (mNumThreads > 0)
+        return mNumThreads;
+
+    return max(boost::thread::hardware_concurrency(), 1U);
+}
+
+u_int64_t
+EventLogIndex::numRecords() const
+{
+    u_int64_t numRecords = 0;
+    for (vector<BlockEntry>::const_iterator it = mBlocks.begin(); it != mBlocks.end(); ++it)
+        numRecords += it->mInfo.mNumRecords;
+    return numRecords;
+}
+
+u_int64_t
+EventLogIndex::firstInstructions() const
+{
+    return mBlocks.empty() ? 0 : mBlocks.front().mInfo.mFirstInstructions;
+}
+
+u_int64_t
+EventLogIndex::lastInstructions() const
+{
+    return mBlocks.empty() ? 0 : mBlocks.back().mInfo.mLastInstructions;
+}
+
+#pragma mark -
+
+bool
+EventLogIndex::loadIndex(const std::string& inIndexPath)
+{
+    std::ifstream fileStream(inIndexPath.c_str(), ios::in | ios::binary);
+    if (!fileStream)
+        return false;
+
+    try
+    {
+        boost::archive::binary_iarchive archive(fileStream);
+
+        std::string magic;
+        u_int32_t version;
+        archive >> MT_BOOST_MEMBER_SERIALIZATION_NVP("magic", magic);
+        archive >> MT_BOOST_MEMBER_SERIALIZATION_NVP("version", version);
+        if (magic != kIndexMagic || version != kIndexVersion)
+            return false;
+
+        archive >> MT_BOOST_MEMBER_SERIALIZATION_NVP("indexed_length", mIndexedLength);
+        archive >> MT_BOOST_MEMBER_SERIALIZATION_NVP("blocks", mBlocks);
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    // An index for a log that has since been replaced is no use; the last indexed block must
+    // still be where the index says.
+    if (mIndexedLength < kEventLogFileHeaderSize || mIndexedLength > mLogFile.size())
+        return false;
+
+    if (!mBlocks.empty())
+    {
+        const EventLogBlockInfo& lastInfo = mBlocks.back().mInfo;
+        EventLogBlockInfo diskInfo;
+        if (!parseEventBlockHeader(logData() + lastInfo.mFileOffset, mLogFile.size() - lastInfo.mFileOffset, diskInfo) ||
+            diskInfo.mStoredLength != lastInfo.mStoredLength || diskInfo.mFirstInstructions != lastInfo.mFirstInstructions ||
+            lastInfo.mFileOffset + kEventLogBlockHeaderSize + lastInfo.mStoredLength != mIndexedLength)
+            return false;
+    }
+
+    return true;
+}
+
+bool
+EventLogIndex::saveIndex(const std::string& inIndexPath) const
+{
+    std::ofstream fileStream(inIndexPath.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!fileStream)
+        return false;
+
+    try
+    {
+        boost::archive::binary_oarchive archive(fileStream);
+
+        const std::string magic(kIndexMagic);
+        archive << MT_BOOST_MEMBER_SERIALIZATION_NVP("magic", magic);
+        archive << MT_BOOST_MEMBER_SERIALIZATION_NVP("version", kIndexVersion);
+        archive << MT_BOOST_MEMBER_SERIALIZATION_NVP("indexed_length", mIndexedLength);
+        archive << MT_BOOST_MEMBER_SERIALIZATION_NVP("blocks", mBlocks);
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    return fileStream.good();
+}
+
+bool
+EventLogIndex::extendIndex()
+{
+    const u_int64_t logLength = mLogFile.size();
+
+    // Walking the headers is cheap; decoding the blocks is done in parallel.
+    vector<BlockEntry> newBlocks;
+    u_int64_t offset = mIndexedLength;
+    while (offset < logLength)
+    {
+        BlockEntry entry;
+        if (logLength - offset < kEventLogBlockHeaderSize)
+            break;      // the writer may still be writing this block
+
+        if (!parseEventBlockHeader(logData() + offset, logLength - offset, entry.mInfo))
+        {
+            mCorrupt = true;
+            break;
+        }
+
+        entry.mInfo.mFileOffset = offset;
+        if (logLength - offset - kEventLogBlockHeaderSize < entry.mInfo.mStoredLength)
+            break;
+
+        offset += kEventLogBlockHeaderSize + entry.mInfo.mStoredLength;
+        newBlocks.push_back(entry);
+    }
+
+    if (newBlocks.empty())
+        return false;
+
+    // processBlocks() works on indexed blocks, so add them now and replace them with the summaries.
+    const size_t firstNewBlock = mBlocks.size();
+    mBlocks.insert(mBlocks.end(), newBlocks.begin(), newBlocks.end());
+
+    vector<size_t> candidates;
+    for (size_t i = firstNewBlock; i < mBlocks.size(); ++i)
+        candidates.push_back(i);
+
+    IndexBlockTask indexTask(candidates.size());
+    processBlocks(candidates, indexTask);
+
+    mBlocks.resize(firstNewBlock);
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        if (!indexTask.mValid[i])
+        {
+            mCorrupt = true;
+            break;
+        }
+
+        const BlockEntry& summary = indexTask.mSummaries[i];
+        mBlocks.push_back(summary);
+        mIndexedLength = summary.mInfo.mFileOffset + kEventLogBlockHeaderSize + summary.mInfo.mStoredLength;
+    }
+
+    return mBlocks.size() > firstNewBlock;
+}
+
+#pragma mark -
+
+void
+EventLogIndex::processBlocks(const std::vector<size_t>& inBlocks, BlockTask& inTask) const
+{
+    volatile u_int32_t nextCandidate = 0;
+
+    u_int32_t numWorkers = min<u_int32_t>(numThreads(), inBlocks.size());
+    if (numWorkers <= 1)
+    {
+        processCandidates(inBlocks, inTask, &nextCandidate);
+        return;
+    }
+
+    boost::thread_group workers;
+    for (u_int32_t i = 0; i < numWorkers; ++i)
+        workers.create_thread(WorkerThreadEntry(this, &inBlocks, &inTask, &nextCandidate));
+
+    workers.join_all();
+}
+
+void
+EventLogIndex::processCandidates(const std::vector<size_t>& inBlocks, BlockTask& inTask, volatile u_int32_t* ioNextCandidate) const
+{
+    EventBlockDecoder decoder;
+    vector<u_int8_t> decompressedData;
+
+    // Blocks are handed out one at a time, so that large and small blocks even out.
+    while (true)
+    {
+        u_int32_t candidate = __sync_fetch_and_add(ioNextCandidate, 1);
+        if (candidate >= inBlocks.size())
+            break;
+
+        const BlockEntry& entry = mBlocks[inBlocks[candidate]];
+        const u_int8_t* payload = eventBlockPayload(entry.mInfo, logData() + entry.mInfo.mFileOffset + kEventLogBlockHeaderSize, decompressedData);
+        if (!payload)
+            continue;   // the task never hears about it; indexing treats that as damage
+
+        decoder.setBlock(entry.mInfo, payload);
+        inTask.processBlock(candidate, entry, decoder);
+    }
+}
+
+#pragma mark -
+
+bool
+EventLogIndex::genotypePopulation(const std::string& inGenotypeName, u_int64_t inInterval, PopulationSeries& outSeries) const
+{
+    outSeries.clear();
+
+    genotype_key genotype;
+    if (!EventLogRecord::parseGenotypeName(inGenotypeName, genotype.first, genotype.second))
+        return false;
+
+    vector<size_t> candidates;
+    for (size_t i = 0; i < mBlocks.size(); ++i)
+    {
+        if (mBlocks[i].mentionsGenotype(genotype))
+            candidates.push_back(i);
+    }
+
+    PopulationTask populationTask(genotype, candidates.size());
+    processBlocks(candidates, populationTask);
+
+    // The candidates are in log order, so the changes can be applied in turn.
+    std::set<creature_id> members;
+    int64_t population = 0;
+    u_int64_t nextSample = 0;
+    bool started = false;
+
+    for (size_t i = 0; i < populationTask.mChanges.size(); ++i)
+    {
+        const PopulationTask::ChangeVector& changes = populationTask.mChanges[i];
+        for (PopulationTask::ChangeVector::const_iterator it = changes.begin(); it != changes.end(); ++it)
+        {
+            int32_t delta = 0;
+            switch (it->mChange)
+            {
+                case PopulationTask::kBorn:
+                case PopulationTask::kParentBredTrue:
+                    // parents that are already members don't count again
+                    delta = members.insert(it->mCreatureID).second ? 1 : 0;
+                    break;
+                case PopulationTask::kDied:
+                    members.erase(it->mCreatureID);
+                    delta = -1;
+                    break;
+            }
+
+            if (delta == 0)
+                continue;
+
+            const u_int64_t instructions = it->mInstructions;
+            if (inInterval > 0)
+            {
+                if (!started)
+                {
+                    nextSample = (instructions + inInterval - 1) / inInterval * inInterval;
+                    started = true;
+                }
+
+                while (nextSample < instructions)
+                {
+                    outSeries.push_back(make_pair(nextSample, population));
+                    nextSample += inInterval;
+                }
+                population += delta;
+            }
+            else
+            {
+                population += delta;
+                if (!outSeries.empty() && outSeries.back().first == instructions)
+                    outSeries.back().second = population;
+                else
+                    outSeries.push_back(make_pair(instructions, population));
+            }
+        }
+    }
+
+    if (inInterval > 0 && started)
+        outSeries.push_back(make_pair(nextSample, population));
+
+    return true;
+}
+
+void
+EventLogIndex::lifespans(u_int64_t inFromInstructions, u_int64_t inToInstructions, std::vector<u_int64_t>& outAges) const
+{
+    outAges.clear();
+
+    vector<size_t> candidates;
+    for (size_t i = 0; i < mBlocks.size(); ++i)
+    {
+        const BlockEntry& entry = mBlocks[i];
+        if (entry.mNumDeaths > 0 && entry.mInfo.mLastInstructions >= inFromInstructions && entry.mInfo.mFirstInstructions <= inToInstructions)
+            candidates.push_back(i);
+    }
+
+    LifespanTask lifespanTask(inFromInstructions, inToInstructions, candidates.size());
+    processBlocks(candidates, lifespanTask);
+
+    for (size_t i = 0; i < lifespanTask.mAges.size(); ++i)
+        outAges.insert(outAges.end(), lifespanTask.mAges[i].begin(), lifespanTask.mAges[i].end());
+}
+
+void
+EventLogIndex::descendants(creature_id inAncestorID, std::vector<EventLogRecord>& outBirths) const
+{
+    outBirths.clear();
+
+    // Creature IDs are handed out in increasing order, so descendants have higher IDs than
+    // their ancestor, and a parent is always born before its offspring.
+    vector<size_t> candidates;
+    for (size_t i = 0; i < mBlocks.size(); ++i)
+    {
+        const BlockEntry& entry = mBlocks[i];
+        if (entry.mNumBirths > 0 && entry.mMaxCreatureID > inAncestorID && entry.mMaxParentID >= inAncestorID)
+            candidates.push_back(i);
+    }
+
+    LineageTask lineageTask(inAncestorID, candidates.size());
+    processBlocks(candidates, lineageTask);
+
+    std::set<creature_id> lineage;
+    lineage.insert(inAncestorID);
+
+    for (size_t i = 0; i < lineageTask.mBirths.size(); ++i)
+    {
+        const vector<EventLogRecord>& births = lineageTask.mBirths[i];
+        for (vector<EventLogRecord>::const_iterator it = births.begin(); it != births.end(); ++it)
+        {
+            if (lineage.find(it->mParentID) == lineage.end())
+                continue;
+
+            lineage.insert(it->mCreatureID);
+            outBirths.push_back(*it);
+        }
+    }
+}
+
+} // namespace MacTierra
@@ -0,0 +1,174 @@
+/*
+ *  MT_EventLogIndex.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_EventLogIndex_h
+#define MT_EventLogIndex_h
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+#include "MT_EventLog.h"
+
+namespace MacTierra {
+
+// Answers questions about a (possibly very large) event log without decoding all of it.
+//
+// The index holds a summary of each block: its time range, the range of creature IDs in it,
+// and the genotypes it mentions. A query uses the summaries to pick the blocks it needs, then
+// decodes those from the memory-mapped log on several threads at once. The index is saved
+// next to the log (as <log>.index), and is extended rather than rebuilt when the log grows.
+//
+// Only creatures born while the log was being written are known, so for runs that start from
+// a saved soup, populations are only approximate.
+class EventLogIndex : Noncopyable
+{
+public:
+    // genotype length and identifier code, as in EventLogRecord
+    typedef std::pair<u_int32_t, u_int64_t> genotype_key;
+
+    struct BlockEntry
+    {
+        EventLogBlockInfo           mInfo;
+
+        creature_id                 mMinCreatureID;     // of any record
+        creature_id                 mMaxCreatureID;
+        creature_id                 mMaxParentID;       // 0 if no births have parents
+        u_int32_t                   mNumBirths;
+        u_int32_t                   mNumDeaths;
+
+        std::vector<genotype_key>   mGenotypes;         // sorted
+
+        bool        mentionsGenotype(const genotype_key& inGenotype) const;
+
+    private:
+        friend class ::boost::serialization::access;
+        template<class Archive> void serialize(Archive& ar, const unsigned int version)
+        {
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("offset", mInfo.mFileOffset);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("stored_length", mInfo.mStoredLength);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("raw_length", mInfo.mRawLength);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("records", mInfo.mNumRecords);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("first_instructions", mInfo.mFirstInstructions);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("last_instructions", mInfo.mLastInstructions);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("flags", mInfo.mFlags);
+
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("min_creature", mMinCreatureID);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("max_creature", mMaxCreatureID);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("max_parent", mMaxParentID);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("births", mNumBirths);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("deaths", mNumDeaths);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("genotypes", mGenotypes);
+        }
+    };
+
+    // (instructions, population) pairs
+    typedef std::vector<std::pair<u_int64_t, int64_t> > PopulationSeries;
+
+    EventLogIndex();
+    ~EventLogIndex();
+
+    // Maps the log and loads or builds its index. If inSaveIndex is true, a new or extended
+    // index is written back next to the log.
+    bool            open(const std::string& inLogPath, bool inSaveIndex = true);
+    void            close();
+    bool            isOpen() const          { return mLogFile.is_open(); }
+
+    // True if indexing stopped at a damaged block; queries only see the blocks before it.
+    bool            isCorrupt() const       { return mCorrupt; }
+    // True if the last open() read the index from disk without building any of it.
+    bool            indexWasCurrent() const { return mIndexWasCurrent; }
+
+    // 0 means one per processor
+    void            setNumThreads(u_int32_t inNumThreads)   { mNumThreads = inNumThreads; }
+    u_int32_t       numThreads() const;
+
+    size_t          numBlocks() const       { return mBlocks.size(); }
+    const BlockEntry& block(size_t inIndex) const   { return mBlocks[inIndex]; }
+
+    u_int64_t       numRecords() const;
+    u_int64_t       firstInstructions() const;
+    u_int64_t       lastInstructions() const;
+
+    // Population of a genotype (named like "80aaaaa"), counted the way the inventory counts it,
+    // after each birth or death that changed it,
+    // or if inInterval is non-zero, at each multiple of inInterval instructions. Returns false
+    // if the name is not valid.
+    bool            genotypePopulation(const std::string& inGenotypeName, u_int64_t inInterval, PopulationSeries& outSeries) const;
+
+    // Ages of the creatures that died between inFromInstructions and inToInstructions, inclusive,
+    // in log order.
+    void            lifespans(u_int64_t inFromInstructions, u_int64_t inToInstructions, std::vector<u_int64_t>& outAges) const;
+
+    // Birth records of every descendant of the given creature, in order of birth.
+    void            descendants(creature_id inAncestorID, std::vector<EventLogRecord>& outBirths) const;
+
+    static std::string  indexPathForLog(const std::string& inLogPath);
+
+    // For writing queries: processBlock() is called on worker threads, once for each of the
+    // candidate blocks, and should store its results by inCandidate so that no locking is needed.
+    class BlockTask
+    {
+    public:
+        virtual ~BlockTask() {}
+        virtual void    processBlock(size_t inCandidate, const BlockEntry& inEntry, EventBlockDecoder& inDecoder) = 0;
+    };
+
+    // Runs inTask over the given blocks (indices into the index, in any order) on several threads.
+    void            processBlocks(const std::vector<size_t>& inBlocks, BlockTask& inTask) const;
+
+protected:
+
+    struct WorkerThreadEntry
+    {
+        WorkerThreadEntry(const EventLogIndex* inIndex, const std::vector<size_t>* inBlocks, BlockTask* inTask, volatile u_int32_t* inNextCandidate)
+        : mIndex(inIndex), mBlocks(inBlocks), mTask(inTask), mNextCandidate(inNextCandidate)
+        {}
+        void operator()()   { mIndex->processCandidates(*mBlocks, *mTask, mNextCandidate); }
+
+        const EventLogIndex*        mIndex;
+        const std::vector<size_t>*  mBlocks;
+        BlockTask*                  mTask;
+        volatile u_int32_t*         mNextCandidate;
+    };
+    friend struct WorkerThreadEntry;
+
+    void            processCandidates(const std::vector<size_t>& inBlocks, BlockTask& inTask, volatile u_int32_t* ioNextCandidate) const;
+
+    bool            loadIndex(const std::string& inIndexPath);
+    bool            saveIndex(const std::string& inIndexPath) const;
+
+    // Scans the block headers after the last indexed block, then summarizes the new blocks.
+    bool            extendIndex();
+
+    const u_int8_t* logData() const         { return reinterpret_cast<const u_int8_t*>(mLogFile.data()); }
+
+protected:
+
+    boost::iostreams::mapped_file_source    mLogFile;
+
+    std::vector<BlockEntry> mBlocks;
+    u_int64_t               mIndexedLength;     // of the log, up to the end of the last indexed block
+
+    u_int32_t               mNumThreads;
+    bool                    mCorrupt;
+    bool                    mIndexWasCurrent;
+};
+
+} // namespace MacTierra
+
+#endif // MT_EventLogIndex_h
@@ -34,6 +34,16 @@ public:
     // Returns new creature on divide instruction
     virtual PassRefPtr<Creature> execute(Creature& inCreature, World& inWorld, int32_t inFlaw) = 0;
 
+    // Runs the instructions of a copy loop the creature is in, if it recognizes one, with just the
+    // results of running them one at a time, stopping after inMaxInstructions or at any it can't
+    // run that way. There must be no flaw, cosmic ray or data collection due in that time. Counts
+    // the instructions against the creature, but not the world, and returns how many there were:
+    // 0 if there was no loop to run.
+    virtual u_int32_t executeCopyLoop(Creature& inCreature, World& inWorld, u_int32_t inMaxInstructions)
+                        {
+                            return 0;
+                        }
+
 private:
     friend class ::boost::serialization::access;
     template<class Archive> void serialize(Archive& ar, const unsigned int version)
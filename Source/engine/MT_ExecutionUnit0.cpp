@@ -13,7 +13,10 @@
 #include "MT_Cpu.h"
 #include "MT_Isa.h"
 #include "MT_InstructionSet.h"
+#include "MT_InteractionMatrix.h"
+#include "MT_ShardedExecution.h"
 #include "MT_Soup.h"
+#include "MT_SoupHeatmap.h"
 #include "MT_World.h"
 
 namespace MacTierra {
@@ -30,6 +33,13 @@ ExecutionUnit0::~ExecutionUnit0()
 
 PassRefPtr<Creature>
 ExecutionUnit0::execute(Creature& inCreature, World& inWorld, int32_t inFlaw)
+{
+    return executeInstruction(inCreature, inWorld, inFlaw);
+}
+
+template<class WorldContext>
+PassRefPtr<Creature>
+ExecutionUnit0::executeInstruction(Creature& inCreature, WorldContext& inWorld, int32_t inFlaw)
 {
     PassRefPtr<Creature> resultCreature;
 
@@ -43,7 +53,17 @@ ExecutionUnit0::execute(Creature& inCreature, World& inWorld, int32_t inFlaw)
             inCreature.setExecutedBit(ip);
     }
     
-    instruction_t   theInst = inCreature.getSoupInstruction(cpu.mInstructionPointer);
+    // read through the world, since a shard has its own copy of the soup
+    instruction_t   theInst = inWorld.soup()->instructionAtAddress(inCreature.addressFromOffset(cpu.mInstructionPointer));
+    if (inWorld.heatmap() || inWorld.interactionMatrix())
+    {
+        const address_t fetchAddress = inCreature.addressFromOffset(cpu.mInstructionPointer);
+        if (inWorld.heatmap())
+            inWorld.heatmap()->noteFetch(fetchAddress, inCreature);
+
+        if (inWorld.interactionMatrix() && !inCreature.containsAddress(fetchAddress, inWorld.soupSize()))
+            inWorld.interactionMatrix()->noteForeignExecution(inCreature, fetchAddress, *inWorld.cellMap());
+    }
     
     //cout << "Executing instruction " << (int32_t)theInst << endl;
     
@@ -181,10 +201,12 @@ ExecutionUnit0::execute(Creature& inCreature, World& inWorld, int32_t inFlaw)
             
         case k_mov_iab: // Copy inst at address in bx to address in ax
             {
-                instruction_t   inst = inCreature.getSoupInstruction(cpu.mRegisters[k_bx]);
+                instruction_t   inst = inWorld.soup()->instructionAtAddress(inCreature.addressFromOffset(cpu.mRegisters[k_bx]));
                 u_int32_t       soupSize = inWorld.soupSize();
                 address_t       targetAddress = inCreature.addressFromOffset(cpu.mRegisters[k_ax]);
                 
+                instruction_t   sourceInst = inst;
+                
                 if (inWorld.copyErrorPending())
                     inst = inWorld.mutateInstruction(inst, inWorld.settings().mutationType());
                 
@@ -192,7 +214,16 @@ ExecutionUnit0::execute(Creature& inCreature, World& inWorld, int32_t inFlaw)
                     inCreature.containsAddress(targetAddress, soupSize) || 
                     (inCreature.isDividing() && inCreature.daughterCreature()->containsAddress(targetAddress, soupSize)))
                 {
-                    inWorld.soup()->setInstructionAtAddress(targetAddress, inst);
+                    inWorld.writeInstruction(targetAddress, inst);
+                    if (inWorld.heatmap())
+                        inWorld.heatmap()->noteWrite(targetAddress);
+                    // only global writes can land in another creature; most writes are copies into the daughter
+                    if (inWorld.interactionMatrix() && inWorld.settings().globalWritesAllowed() &&
+                        !(inCreature.isDividing() && inCreature.daughterCreature()->containsAddress(targetAddress, soupSize)) &&
+                        !inCreature.containsAddress(targetAddress, soupSize))
+                        inWorld.interactionMatrix()->noteForeignWrite(inCreature, targetAddress, *inWorld.cellMap());
+                    if (inWorld.copyErrorPending() && inWorld.events().wantsMutations())
+                        inWorld.sendMutationEvent(MutationEvent::kCopyError, &inCreature, targetAddress, sourceInst, inst);
                     if (inCreature.isDividing())
                         inCreature.noteMoveToOffspring(targetAddress);
                 }
@@ -218,7 +249,7 @@ ExecutionUnit0::execute(Creature& inCreature, World& inWorld, int32_t inFlaw)
             break;
             
         case k_divide:  // Divide
-            resultCreature = inCreature.divide(inWorld);
+            resultCreature = divide(inCreature, inWorld);
             break;
     }
 
@@ -231,8 +262,157 @@ ExecutionUnit0::execute(Creature& inCreature, World& inWorld, int32_t inFlaw)
     return resultCreature;
 }
 
+template PassRefPtr<Creature> ExecutionUnit0::executeInstruction<World>(Creature&, World&, int32_t);
+template PassRefPtr<Creature> ExecutionUnit0::executeInstruction<Shard>(Creature&, Shard&, int32_t);
+
 #pragma mark -
 
+// The ancestor's copy loop, and any like it:
+//
+//      mov_iab
+//      dec_c
+//      if_cz
+//      jmp         (out of the loop, once cx reaches zero)
+//      nop ...     (its template, run as nops until then)
+//      inc_a
+//      inc_b
+//      jmp         (back to the mov_iab)
+//
+// Each time round, while cx stays above zero, copies an instruction and moves ax, bx and cx on
+// by one. The creature may be anywhere in the loop, other than at the jmp out, and it stops at
+// whatever instruction it reaches.
+u_int32_t
+ExecutionUnit0::executeCopyLoop(Creature& inCreature, World& inWorld, u_int32_t inMaxInstructions)
+{
+    // as in Soup::seachForTemplate()
+    const int32_t kMaxTemplateLength = 10;
+    // mov_iab, dec_c, if_cz, jmp, the template, inc_a and inc_b
+    const int32_t kMaxLoopOffset = 4 + kMaxTemplateLength + 2;
+
+    Cpu& cpu = inCreature.cpu();
+    Soup& soup = *inWorld.soup();
+    const u_int32_t soupSize = inWorld.soupSize();
+
+    const int32_t ip = cpu.mInstructionPointer;
+    if (ip < 0 || ip >= static_cast<int32_t>(soupSize))
+        return 0;
+
+    // the start of the loop is at most kMaxLoopOffset back
+    int32_t offset = 0;
+    while (offset <= kMaxLoopOffset && inCreature.getSoupInstruction(ip - offset) != k_mov_iab)
+        ++offset;
+
+    const int32_t loopIP = (ip - offset + soupSize) % soupSize;
+    if (offset > kMaxLoopOffset ||
+        inCreature.getSoupInstruction(loopIP + 1) != k_dec_c ||
+        inCreature.getSoupInstruction(loopIP + 2) != k_if_cz ||
+        inCreature.getSoupInstruction(loopIP + 3) != k_jmp)
+        return 0;
+
+    int32_t incOffset = 4;
+    while (incOffset < 4 + kMaxTemplateLength && inCreature.getSoupInstruction(loopIP + incOffset) <= k_nop_1)
+        ++incOffset;
+
+    const int32_t jumpOffset = incOffset + 2;
+    if (inCreature.getSoupInstruction(loopIP + incOffset) != k_inc_a ||
+        inCreature.getSoupInstruction(loopIP + incOffset + 1) != k_inc_b ||
+        inCreature.getSoupInstruction(loopIP + jumpOffset) != k_jmp ||
+        offset == 3 || offset > jumpOffset)
+        return 0;
+
+    // The jump back, as jump() and the increment after it would do it. Nothing may be written
+    // anywhere the search looked while the loop runs. Having found the template searchDistance
+    // back, it read as far forward as searchDistance + templateLength, which also covers the
+    // template and the instruction ending it.
+    address_t templateAddress = inCreature.addressFromOffset(loopIP + jumpOffset) + 1;
+    const address_t searchStart = templateAddress % soupSize;
+    u_int32_t templateLength = 0;
+    if (!soup.seachForTemplate(Soup::kBothways, templateAddress, templateLength))
+        return 0;
+
+    const int32_t targetIP = (inCreature.offsetFromAddress((templateAddress + templateLength + soupSize - 1) % soupSize) + 1) % soupSize;
+    if (targetIP != loopIP)
+        return 0;
+
+    const u_int32_t searchDistance = (searchStart + soupSize - templateAddress) % soupSize;
+    const address_t searchedStart = templateAddress;
+    const u_int32_t searchedLength = 2 * searchDistance + templateLength;
+    if (searchedLength >= soupSize)
+        return 0;
+
+    int32_t& ax = cpu.mRegisters[k_ax];
+    int32_t& bx = cpu.mRegisters[k_bx];
+    int32_t& cx = cpu.mRegisters[k_cx];
+
+    // a copy error, a write that would fail or could change the loop, and leaving the loop are
+    // left to the world's own step
+    u_int32_t instructions = 0;
+    int32_t lastOffset = offset;
+    while (instructions < inMaxInstructions)
+    {
+        if (offset == 0)
+        {
+            if (inWorld.copyErrorPending())
+                break;
+
+            const address_t targetAddress = inCreature.addressFromOffset(ax);
+            if (!(inWorld.settings().globalWritesAllowed() ||
+                  inCreature.containsAddress(targetAddress, soupSize) ||
+                  (inCreature.isDividing() && inCreature.daughterCreature()->containsAddress(targetAddress, soupSize))))
+                break;
+
+            if ((targetAddress + soupSize - searchedStart) % soupSize < searchedLength)
+                break;
+
+            inWorld.writeInstruction(targetAddress, soup.instructionAtAddress(inCreature.addressFromOffset(bx)));
+            if (inCreature.isDividing())
+                inCreature.noteMoveToOffspring(targetAddress);
+
+            if (inWorld.settings().copyErrorRate() > 0.0)
+                inWorld.noteInstructionCopy();
+        }
+        else if (offset == 1)
+            cx = cx - 1;
+        else if (offset == 2)
+        {
+            if (cx == 0)
+                break;
+            // skip the jmp out
+            ++offset;
+        }
+        else if (offset == incOffset)
+            ax = ax + 1;
+        else if (offset == incOffset + 1)
+            bx = bx + 1;
+        // the template, run as nops
+
+        lastOffset = offset;
+        if (offset == jumpOffset)
+            offset = 0;
+        else
+            ++offset;
+
+        ++instructions;
+    }
+
+    if (instructions == 0)
+        return 0;
+
+    cpu.mInstructionPointer = (loopIP + offset) % soupSize;
+    cpu.clearFlag();
+
+    // the if_cz took the place of the jmp out it skipped
+    const int32_t lastInstructionOffset = (lastOffset == 3) ? 2 : lastOffset;
+    inCreature.executedInstructions(inCreature.getSoupInstruction(loopIP + lastInstructionOffset), instructions);
+    return instructions;
+}
+
+PassRefPtr<Creature>
+ExecutionUnit0::divide(Creature& inCreature, World& inWorld)
+{
+    return inCreature.divide(inWorld);
+}
+
 void
 ExecutionUnit0::memoryAllocate(Creature& inCreature, World& inWorld)
 {
@@ -243,6 +423,9 @@ ExecutionUnit0::memoryAllocate(Creature& inCreature, World& inWorld)
         daughterLength < kMinCreatureSize ||
         (daughterLength > inCreature.length() * kMaxDaughterSizeMultiple))
     {
+        if (inWorld.events().wantsAllocationFailures())
+            inWorld.sendAllocationFailureEvent(inCreature, inCreature.isDividing() ? AllocationFailureEvent::kAlreadyDividing : AllocationFailureEvent::kBadLength, daughterLength);
+
         cpu.setFlag();
         return;
     }
@@ -258,6 +441,9 @@ ExecutionUnit0::memoryAllocate(Creature& inCreature, World& inWorld)
     }
     else
     {
+        if (inWorld.events().wantsAllocationFailures())
+            inWorld.sendAllocationFailureEvent(inCreature, AllocationFailureEvent::kNoSpace, daughterLength);
+
         cpu.setFlag();
     }
 
@@ -24,6 +24,7 @@ namespace MacTierra {
 
 class Creature;
 class Cpu;
+class Shard;
 
 // Execution unit for instruction set 0
 class ExecutionUnit0 : public ExecutionUnit
@@ -34,11 +35,21 @@ public:
     ~ExecutionUnit0();
     
     virtual PassRefPtr<Creature> execute(Creature& inCreature, World& inWorld, int32_t inFlaw);
+    virtual u_int32_t executeCopyLoop(Creature& inCreature, World& inWorld, u_int32_t inMaxInstructions);
 
+    // Instantiated for World, and for Shard, which stands in for the world while a sharded
+    // world's shards run on their own threads.
+    template<class WorldContext>
+    PassRefPtr<Creature> executeInstruction(Creature& inCreature, WorldContext& inWorld, int32_t inFlaw);
 
 protected:
 
     void memoryAllocate(Creature& inCreature, World& inWorld);
+    PassRefPtr<Creature> divide(Creature& inCreature, World& inWorld);
+
+    // Shards stop a creature before mal or divide, which the world runs at the next barrier.
+    void memoryAllocate(Creature& inCreature, Shard& inShard)               { BOOST_ASSERT(false); }
+    PassRefPtr<Creature> divide(Creature& inCreature, Shard& inShard)       { BOOST_ASSERT(false); return NULL; }
 
     void jump(Creature& inCreature, Soup& inSoup, Soup::ESearchDirection inDirection);
     void call(Creature& inCreature, Soup& inSoup);
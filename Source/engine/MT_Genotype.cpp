@@ -77,6 +77,13 @@ GenomeData::setFromPrintableGenome(const std::string& inString)
 Genotype::Genotype(const std::string& inIdentifier, const GenomeData& inGenome)
 : mIdentifier(inIdentifier)
 , mGenome(inGenome)
+, mSharedGenome(NULL)
+{
+}
+
+Genotype::Genotype(const std::string& inIdentifier, const GenomeData* inSharedGenome)
+: mIdentifier(inIdentifier)
+, mSharedGenome(inSharedGenome)
 {
 }
 
@@ -88,7 +95,7 @@ std::string
 Genotype::name() const
 {
     std::ostringstream formatter;
-    formatter << mGenome.length() << mIdentifier;
+    formatter << length() << mIdentifier;
     return formatter.str();
 }
 
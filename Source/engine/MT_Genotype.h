@@ -80,6 +80,15 @@ protected:
     std::string     mData;
 };
 
+// For maps keyed on genomes stored elsewhere.
+struct GenomeDataPointerLess
+{
+    bool operator()(const GenomeData* inLHS, const GenomeData* inRHS) const
+    {
+        return *inLHS < *inRHS;
+    }
+};
+
 
 // Represents a set of creatures with the same instructions. Used for
 // book-keeping in the inventory and genebank.
@@ -88,38 +97,53 @@ class Genotype
 public:
 
     Genotype(const std::string& inIdentifier, const GenomeData& inGenome);
+    // For a genome kept by a GenotypeRegistry, which outlives the genotype.
+    Genotype(const std::string& inIdentifier, const GenomeData* inSharedGenome);
     ~Genotype();
         
-    u_int32_t           length() const      { return mGenome.length(); }
+    u_int32_t           length() const      { return genome().length(); }
     
     // like "80aaa"
     std::string         name() const;
     // like "aaa"
     const std::string&  identifier() const  { return mIdentifier; }
 
-    const GenomeData&   genome() const    { return mGenome; }
+    const GenomeData&   genome() const    { return mSharedGenome ? *mSharedGenome : mGenome; }
 
     bool operator < (const Genotype& inRHS)
     {
-        return mGenome < inRHS.genome();
+        return genome() < inRHS.genome();
     }
 
 private:
 
     friend class InventoryGenotype;
-    Genotype() {}   // default ctor for serialization
+    Genotype() : mSharedGenome(NULL) {}   // default ctor for serialization
 
     friend class ::boost::serialization::access;
-    template<class Archive> void serialize(Archive& ar, const unsigned int version)
+    template<class Archive> void save(Archive& ar, const unsigned int version) const
     {
-        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("identifier", mIdentifier);
-        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("genome", mGenome);
+        ar << MT_BOOST_MEMBER_SERIALIZATION_NVP("identifier", mIdentifier);
+        ar << MT_BOOST_MEMBER_SERIALIZATION_NVP("genome", genome());
+    }
+
+    template<class Archive> void load(Archive& ar, const unsigned int version)
+    {
+        ar >> MT_BOOST_MEMBER_SERIALIZATION_NVP("identifier", mIdentifier);
+        ar >> MT_BOOST_MEMBER_SERIALIZATION_NVP("genome", mGenome);
+        mSharedGenome = NULL;
+    }
+
+    template<class Archive> void serialize(Archive& ar, const unsigned int file_version)
+    {
+        ::boost::serialization::split_member(ar, *this, file_version);
     }
 
 protected:
 
     std::string         mIdentifier;      // just the letters part
-    GenomeData          mGenome;
+    GenomeData          mGenome;          // empty if the genome is shared
+    const GenomeData*   mSharedGenome;
 
 };
 
@@ -0,0 +1,309 @@
+/*
+ *  MT_GenotypeProbe.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <algorithm>
+
+#include <boost/assert.hpp>
+#include <boost/thread.hpp>
+
+#include "MT_GenotypeProbe.h"
+
+#include "MT_AnalysisPool.h"
+#include "MT_Creature.h"
+#include "MT_Genotype.h"
+#include "MT_World.h"
+#include "MT_WorldEvents.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+ProbeResult::ProbeResult()
+: mInstructions(0)
+, mBirths(0)
+, mExactBirths(0)
+, mFinalPopulation(0)
+, mCompetitorBirths(0)
+, mCompetitorFinalPopulation(0)
+{
+}
+
+double
+ProbeResult::replicationRate() const
+{
+    return (mInstructions > 0) ? 1.0e6 * mBirths / mInstructions : 0.0;
+}
+
+double
+ProbeResult::competitorReplicationRate() const
+{
+    return (mInstructions > 0) ? 1.0e6 * mCompetitorBirths / mInstructions : 0.0;
+}
+
+double
+ProbeResult::accuracy() const
+{
+    return (mBirths > 0) ? static_cast<double>(mExactBirths) / mBirths : 0.0;
+}
+
+#pragma mark -
+
+// A world kept for probes, and the listener that counts births and deaths by lineage in it.
+class ProbeSoup : public WorldEventListener
+{
+public:
+    enum ELineage {
+        kNoLineage = 0,
+        kProbeLineage,
+        kCompetitorLineage,
+        kNumLineages
+    };
+
+    ProbeSoup(u_int32_t inSoupSize)
+    : mWorld(new World())
+    , mInsertingLineage(kNoLineage)
+    , mProbeGenotype(NULL)
+    {
+        mWorld->initializeSoup(inSoupSize);
+        mWorld->addEventListener(this, kBirthEvents | kDeathEvents);
+    }
+
+    ~ProbeSoup()
+    {
+        delete mWorld;
+    }
+
+    World*          world() const   { return mWorld; }
+
+    // The world must have been emptied.
+    void            startProbe()
+    {
+        // keeps the capacity, so that later probes don't allocate
+        mLineages.clear();
+        for (u_int32_t i = 0; i < kNumLineages; ++i)
+        {
+            mBirths[i] = 0;
+            mPopulation[i] = 0;
+        }
+        mExactBirths = 0;
+        mProbeGenotype = NULL;
+    }
+
+    bool            insertGenome(ELineage inLineage, address_t inAddress, const GenomeData& inGenome)
+    {
+        BOOST_ASSERT(inGenome.length() > 0);
+        mInsertingLineage = inLineage;
+        RefPtr<Creature> inserted = mWorld->insertCreature(inAddress, reinterpret_cast<const instruction_t*>(inGenome.dataString().data()),
+                                                           inGenome.length());
+        mInsertingLineage = kNoLineage;
+
+        if (inserted && inLineage == kProbeLineage)
+            mProbeGenotype = mWorld->inventory()->findGenotype(inGenome);
+
+        return inserted.get() != NULL;
+    }
+
+    void            fillResult(ProbeResult& outResult) const
+    {
+        outResult.mInstructions = mWorld->timeSlicer().instructionsExecuted();
+        outResult.mBirths = mBirths[kProbeLineage];
+        outResult.mExactBirths = mExactBirths;
+        outResult.mFinalPopulation = mPopulation[kProbeLineage];
+        outResult.mCompetitorBirths = mBirths[kCompetitorLineage];
+        outResult.mCompetitorFinalPopulation = mPopulation[kCompetitorLineage];
+    }
+
+    virtual void    creatureBorn(const BirthEvent& inEvent)
+    {
+        const u_int8_t lineage = (inEvent.mParentID == 0) ? mInsertingLineage : lineageOf(inEvent.mParentID);
+
+        if (inEvent.mChildID >= mLineages.size())
+            mLineages.resize(inEvent.mChildID + 1, kNoLineage);
+        mLineages[inEvent.mChildID] = lineage;
+        ++mPopulation[lineage];
+
+        if (inEvent.mParentID != 0)
+        {
+            ++mBirths[lineage];
+            // the child only has a genotype if it bred true
+            if (lineage == kProbeLineage && mProbeGenotype && inEvent.mGenotype == mProbeGenotype)
+                ++mExactBirths;
+        }
+    }
+
+    virtual void    creatureDied(const DeathEvent& inEvent)
+    {
+        const u_int8_t lineage = lineageOf(inEvent.mCreatureID);
+        if (mPopulation[lineage] > 0)
+            --mPopulation[lineage];
+        if (inEvent.mCreatureID < mLineages.size())
+            mLineages[inEvent.mCreatureID] = kNoLineage;
+    }
+
+protected:
+
+    u_int8_t        lineageOf(creature_id inCreatureID) const
+    {
+        return (inCreatureID < mLineages.size()) ? mLineages[inCreatureID] : static_cast<u_int8_t>(kNoLineage);
+    }
+
+protected:
+
+    World*          mWorld;
+
+    // indexed by creature ID; IDs start from 1 again in each probe
+    std::vector<u_int8_t>   mLineages;
+    u_int8_t        mInsertingLineage;
+
+    const InventoryGenotype*    mProbeGenotype;
+
+    u_int32_t       mBirths[kNumLineages];
+    u_int32_t       mPopulation[kNumLineages];
+    u_int32_t       mExactBirths;
+};
+
+// Runs one probe on a pool thread, in whichever soup is idle.
+class ProbeTask : public AnalysisPool::Task
+{
+public:
+    ProbeTask(GenotypeProber& inProber, const ProbeRequest& inRequest, ProbeResult& outResult)
+    : mProber(inProber)
+    , mRequest(inRequest)
+    , mResult(outResult)
+    {
+    }
+
+    virtual void run()
+    {
+        ProbeSoup* soup = mProber.takeSoup();
+        mProber.runProbe(soup, mRequest, mResult);
+        mProber.returnSoup(soup);
+    }
+
+protected:
+    GenotypeProber&     mProber;
+    const ProbeRequest& mRequest;
+    ProbeResult&        mResult;
+};
+
+#pragma mark -
+
+GenotypeProber::GenotypeProber(u_int32_t inSoupSize, const Settings& inSettings, u_int32_t inInstructions, u_int32_t inNumThreads)
+: mSoupSize(inSoupSize)
+, mSettings(inSettings)
+, mInstructions(inInstructions)
+, mRandomSeed(1)
+, mPool(NULL)
+{
+    mSettings.setNumShards(1);
+    mPool = new AnalysisPool(inNumThreads);
+}
+
+GenotypeProber::~GenotypeProber()
+{
+    delete mPool;
+
+    for (vector<ProbeSoup*>::const_iterator it = mSoups.begin(); it != mSoups.end(); ++it)
+        delete *it;
+}
+
+ProbeResult
+GenotypeProber::probe(const GenomeData& inGenome, const GenomeData* inCompetitor)
+{
+    vector<ProbeRequest> requests(1, ProbeRequest(&inGenome, inCompetitor));
+    vector<ProbeResult> results;
+    probe(requests, results);
+    return results[0];
+}
+
+void
+GenotypeProber::probe(const vector<ProbeRequest>& inRequests, vector<ProbeResult>& outResults)
+{
+    outResults.assign(inRequests.size(), ProbeResult());
+
+    vector<ProbeTask*> tasks;
+    tasks.reserve(inRequests.size());
+    for (u_int32_t i = 0; i < inRequests.size(); ++i)
+    {
+        tasks.push_back(new ProbeTask(*this, inRequests[i], outResults[i]));
+        mPool->submit(tasks.back());
+    }
+
+    mPool->waitForAll();
+
+    for (vector<ProbeTask*>::const_iterator it = tasks.begin(); it != tasks.end(); ++it)
+        delete *it;
+}
+
+void
+GenotypeProber::probeTopGenotypes(const Inventory& inInventory, u_int32_t inCount, Inventory::GenotypeVector& outGenotypes,
+                                  vector<ProbeResult>& outResults, const GenomeData* inCompetitor)
+{
+    inInventory.topGenotypes(inCount, outGenotypes);
+
+    vector<ProbeRequest> requests;
+    requests.reserve(outGenotypes.size());
+    for (Inventory::GenotypeVector::const_iterator it = outGenotypes.begin(); it != outGenotypes.end(); ++it)
+        requests.push_back(ProbeRequest(&(*it)->genome(), inCompetitor));
+
+    probe(requests, outResults);
+}
+
+ProbeSoup*
+GenotypeProber::takeSoup()
+{
+    {
+        boost::mutex::scoped_lock lock(mSoupsLock);
+        if (!mIdleSoups.empty())
+        {
+            ProbeSoup* soup = mIdleSoups.back();
+            mIdleSoups.pop_back();
+            return soup;
+        }
+    }
+
+    // there are never more soups than threads
+    ProbeSoup* newSoup = new ProbeSoup(mSoupSize);
+
+    boost::mutex::scoped_lock lock(mSoupsLock);
+    mSoups.push_back(newSoup);
+    return newSoup;
+}
+
+void
+GenotypeProber::returnSoup(ProbeSoup* inSoup)
+{
+    boost::mutex::scoped_lock lock(mSoupsLock);
+    mIdleSoups.push_back(inSoup);
+}
+
+void
+GenotypeProber::runProbe(ProbeSoup* inSoup, const ProbeRequest& inRequest, ProbeResult& outResult) const
+{
+    BOOST_ASSERT(inRequest.mGenome);
+
+    World* world = inSoup->world();
+    world->emptySoup();
+    // seed before the settings, which draw the first mutation times
+    world->setInitialRandomSeed(mRandomSeed);
+    world->setSettings(mSettings);
+
+    inSoup->startProbe();
+    // the probe and the competitor start as far apart as they can
+    if (!inSoup->insertGenome(ProbeSoup::kProbeLineage, mSoupSize / 4, *inRequest.mGenome))
+        return;
+
+    if (inRequest.mCompetitor)
+        inSoup->insertGenome(ProbeSoup::kCompetitorLineage, 3 * (mSoupSize / 4), *inRequest.mCompetitor);
+
+    world->iterate(mInstructions);
+    inSoup->fillResult(outResult);
+}
+
+} // namespace MacTierra
@@ -0,0 +1,128 @@
+/*
+ *  MT_GenotypeProbe.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_GenotypeProbe_h
+#define MT_GenotypeProbe_h
+
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+#include "MT_Inventory.h"
+#include "MT_Settings.h"
+
+namespace MacTierra {
+
+class AnalysisPool;
+class ProbeSoup;
+class ProbeTask;
+
+// A genotype to run in a probe soup, alone or with one competitor. The genomes are not owned.
+struct ProbeRequest
+{
+    ProbeRequest(const GenomeData* inGenome = NULL, const GenomeData* inCompetitor = NULL)
+    : mGenome(inGenome)
+    , mCompetitor(inCompetitor)
+    {
+    }
+
+    const GenomeData*   mGenome;
+    const GenomeData*   mCompetitor;    // NULL to run the genotype alone
+};
+
+// What a probe saw. Births and populations are counted by lineage: every descendant of the
+// inserted creature counts for it, whether or not it still has the same genome.
+struct ProbeResult
+{
+    ProbeResult();
+
+    // births per million instructions
+    double          replicationRate() const;
+    double          competitorReplicationRate() const;
+    // the fraction of births that were exact copies of the probed genome
+    double          accuracy() const;
+
+    u_int64_t       mInstructions;
+    u_int32_t       mBirths;
+    u_int32_t       mExactBirths;
+    u_int32_t       mFinalPopulation;
+
+    u_int32_t       mCompetitorBirths;
+    u_int32_t       mCompetitorFinalPopulation;
+};
+
+// Measures how well genotypes replicate by running each in a small soup of its own, with fixed
+// settings and seed, for a fixed number of instructions, so that results depend only on the
+// genomes. Batches of probes run on a pool of threads; each thread reuses its soup from one
+// probe to the next.
+//
+// The engine can probe the common genotypes of a running world between iterations, and tools
+// can probe those of a saved soup.
+class GenotypeProber : Noncopyable
+{
+public:
+    // Settings are used as given, except that probes are never sharded. inNumThreads of 0
+    // means one per processor.
+    GenotypeProber(u_int32_t inSoupSize, const Settings& inSettings, u_int32_t inInstructions, u_int32_t inNumThreads = 0);
+    ~GenotypeProber();
+
+    u_int32_t       soupSize() const        { return mSoupSize; }
+    u_int32_t       instructions() const    { return mInstructions; }
+    const Settings& settings() const        { return mSettings; }
+
+    // Every probe is seeded with this.
+    void            setRandomSeed(u_int32_t inSeed)     { mRandomSeed = inSeed; }
+    u_int32_t       randomSeed() const      { return mRandomSeed; }
+
+    ProbeResult     probe(const GenomeData& inGenome, const GenomeData* inCompetitor = NULL);
+
+    // Runs the probes in parallel, returning when they are all done. The results are in the
+    // order of the requests.
+    void            probe(const std::vector<ProbeRequest>& inRequests, std::vector<ProbeResult>& outResults);
+
+    // Probes up to inCount of the most common living genotypes, each against inCompetitor
+    // if given. Call between iterations of the inventory's world.
+    void            probeTopGenotypes(const Inventory& inInventory, u_int32_t inCount, Inventory::GenotypeVector& outGenotypes,
+                                      std::vector<ProbeResult>& outResults, const GenomeData* inCompetitor = NULL);
+
+    enum {
+        kDefaultSoupSize        = 16 * 1024,
+        kDefaultInstructions    = 2000000
+    };
+
+protected:
+
+    friend class ProbeTask;
+
+    // Takes an idle soup, making one if there are none.
+    ProbeSoup*      takeSoup();
+    void            returnSoup(ProbeSoup* inSoup);
+
+    void            runProbe(ProbeSoup* inSoup, const ProbeRequest& inRequest, ProbeResult& outResult) const;
+
+protected:
+
+    const u_int32_t mSoupSize;
+    Settings        mSettings;
+    const u_int32_t mInstructions;
+    u_int32_t       mRandomSeed;
+
+    AnalysisPool*   mPool;
+
+    boost::mutex                mSoupsLock;
+    std::vector<ProbeSoup*>     mSoups;         // all of them
+    std::vector<ProbeSoup*>     mIdleSoups;
+};
+
+} // namespace MacTierra
+
+#endif // MT_GenotypeProbe_h
@@ -0,0 +1,117 @@
+/*
+ *  MT_GenotypeRegistry.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <sstream>
+
+#include "MT_GenotypeRegistry.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+static const u_int32_t kIdentifierLength = 5;
+
+RegisteredGenotype::RegisteredGenotype(u_int32_t inGlobalID, const std::string& inIdentifier, const GenomeData& inGenome)
+: mGlobalID(inGlobalID)
+, mIdentifier(inIdentifier)
+, mGenome(inGenome)
+{
+}
+
+std::string
+RegisteredGenotype::name() const
+{
+    std::ostringstream formatter;
+    formatter << mGenome.length() << mIdentifier;
+    return formatter.str();
+}
+
+#pragma mark -
+
+GenotypeRegistry::GenotypeRegistry()
+: mNextGlobalID(1)
+{
+}
+
+GenotypeRegistry::~GenotypeRegistry()
+{
+    for (u_int32_t i = 0; i < kNumStripes; ++i)
+    {
+        GenotypeMap& genotypes = mStripes[i].mGenotypes;
+        for (GenotypeMap::const_iterator it = genotypes.begin(); it != genotypes.end(); ++it)
+            delete it->second;
+    }
+}
+
+const RegisteredGenotype*
+GenotypeRegistry::enterGenotype(const GenomeData& inGenome)
+{
+    Stripe& stripe = mStripes[stripeForGenome(inGenome)];
+    boost::mutex::scoped_lock lock(stripe.mLock);
+
+    GenotypeMap::const_iterator it = stripe.mGenotypes.find(&inGenome);
+    if (it != stripe.mGenotypes.end())
+        return it->second;
+
+    RegisteredGenotype* newGenotype = new RegisteredGenotype(__sync_fetch_and_add(&mNextGlobalID, 1),
+                                                             nextIdentifierForLength(inGenome.length()), inGenome);
+    stripe.mGenotypes[&newGenotype->genome()] = newGenotype;
+    return newGenotype;
+}
+
+const RegisteredGenotype*
+GenotypeRegistry::findGenotype(const GenomeData& inGenome) const
+{
+    const Stripe& stripe = mStripes[stripeForGenome(inGenome)];
+    boost::mutex::scoped_lock lock(stripe.mLock);
+
+    GenotypeMap::const_iterator it = stripe.mGenotypes.find(&inGenome);
+    return (it != stripe.mGenotypes.end()) ? it->second : NULL;
+}
+
+u_int32_t
+GenotypeRegistry::numGenotypes() const
+{
+    return __sync_fetch_and_add(const_cast<u_int32_t*>(&mNextGlobalID), 0) - 1;
+}
+
+// FNV-1a
+u_int32_t
+GenotypeRegistry::stripeForGenome(const GenomeData& inGenome)
+{
+    const std::string& data = inGenome.dataString();
+    u_int32_t hash = 2166136261U;
+    for (size_t i = 0; i < data.length(); ++i)
+    {
+        hash ^= static_cast<u_int8_t>(data[i]);
+        hash *= 16777619U;
+    }
+    return (hash ^ (hash >> 16)) % kNumStripes;
+}
+
+std::string
+GenotypeRegistry::nextIdentifierForLength(u_int32_t inLength)
+{
+    u_int32_t index;
+    {
+        boost::mutex::scoped_lock lock(mNamingLock);
+        index = mNumIdentifiersForLength[inLength]++;
+    }
+
+    // "aaaaa", "aaaab" and so on, wrapping after "zzzzz"
+    std::string identifier(kIdentifierLength, 'a');
+    for (int32_t pos = kIdentifierLength - 1; pos >= 0 && index > 0; --pos)
+    {
+        identifier[pos] = 'a' + index % 26;
+        index /= 26;
+    }
+    return identifier;
+}
+
+} // namespace MacTierra
@@ -0,0 +1,101 @@
+/*
+ *  MT_GenotypeRegistry.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_GenotypeRegistry_h
+#define MT_GenotypeRegistry_h
+
+#include <map>
+#include <string>
+
+#include <boost/thread/mutex.hpp>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+#include "MT_Genotype.h"
+
+namespace MacTierra {
+
+// A genome entered in a GenotypeRegistry, with the name and ID it has in every world.
+class RegisteredGenotype : Noncopyable
+{
+public:
+    RegisteredGenotype(u_int32_t inGlobalID, const std::string& inIdentifier, const GenomeData& inGenome);
+
+    u_int32_t           globalID() const    { return mGlobalID; }
+    const std::string&  identifier() const  { return mIdentifier; }
+    const GenomeData&   genome() const      { return mGenome; }
+
+    std::string         name() const;
+
+protected:
+
+    const u_int32_t     mGlobalID;      // from 1, in order of entry
+    const std::string   mIdentifier;
+    const GenomeData    mGenome;
+};
+
+// Genomes shared by the inventories of several worlds in one process, such as islands or
+// the runs of an ensemble. Each genome is stored once, and has the same name and ID in
+// every world; the inventories keep only their own counts.
+//
+// The genomes are spread over kNumStripes hash buckets, each with its own lock, so that
+// worlds on different threads rarely wait for each other. Inventories only come here for
+// genomes that are new to them. Genotypes are never removed; the registry must outlive
+// the worlds that use it.
+//
+// IDs and identifiers are handed out in the order genomes are first entered, by whichever
+// world gets there first. With worlds on more than one thread, that depends on how the
+// threads happen to run, so a run that is otherwise repeatable can give its genotypes
+// different names each time. The genomes, and each world's counts of them, don't change.
+class GenotypeRegistry : Noncopyable
+{
+public:
+
+    enum { kNumStripes = 64 };
+
+    GenotypeRegistry();
+    ~GenotypeRegistry();
+
+    // Returns the genome's entry, making one if it's new. Thread-safe.
+    const RegisteredGenotype*   enterGenotype(const GenomeData& inGenome);
+    // NULL if the genome hasn't been entered. Thread-safe.
+    const RegisteredGenotype*   findGenotype(const GenomeData& inGenome) const;
+
+    u_int32_t       numGenotypes() const;
+
+    static u_int32_t    stripeForGenome(const GenomeData& inGenome);
+
+protected:
+
+    // Identifiers are handed out in order for each length, like an Inventory does.
+    std::string     nextIdentifierForLength(u_int32_t inLength);
+
+protected:
+
+    typedef std::map<const GenomeData*, RegisteredGenotype*, GenomeDataPointerLess> GenotypeMap;
+
+    struct Stripe
+    {
+        mutable boost::mutex    mLock;
+        GenotypeMap             mGenotypes;
+    };
+
+    Stripe          mStripes[kNumStripes];
+
+    u_int32_t       mNextGlobalID;          // atomic
+
+    // only taken for new genotypes
+    boost::mutex    mNamingLock;
+    std::map<u_int32_t, u_int32_t>  mNumIdentifiersForLength;
+};
+
+} // namespace MacTierra
+
+#endif // MT_GenotypeRegistry_h
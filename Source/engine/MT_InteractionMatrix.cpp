@@ -0,0 +1,126 @@
+/*
+ *  MT_InteractionMatrix.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <algorithm>
+#include <ostream>
+
+#include "MT_InteractionMatrix.h"
+
+#include "MT_CellMap.h"
+#include "MT_Creature.h"
+#include "MT_Inventory.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+static u_int64_t totalCount(const InteractionMatrix::Entry& inEntry)
+{
+    return inEntry.mCounts.mExecutions + inEntry.mCounts.mWrites;
+}
+
+static bool compareEntries(const InteractionMatrix::Entry& inLHS, const InteractionMatrix::Entry& inRHS)
+{
+    return totalCount(inLHS) > totalCount(inRHS);
+}
+
+static string genotypeName(const InventoryGenotype* inGenotype)
+{
+    return inGenotype ? inGenotype->name() : string("-");
+}
+
+InteractionMatrix::InteractionMatrix()
+: mLastPair(mCounts.end())
+, mNumForeignExecutions(0)
+, mNumForeignWrites(0)
+{
+}
+
+void
+InteractionMatrix::noteForeignExecution(const Creature& inCreature, address_t inAddress, const CellMap& inCellMap)
+{
+    const Creature* owner = inCellMap.creatureAtAddress(inAddress);
+    if (owner && (owner == &inCreature || owner == inCreature.daughterCreature()))
+        return;
+
+    ++mNumForeignExecutions;
+    if (owner)
+        ++countsForPair(inCreature.genotype(), owner->genotype()).mExecutions;
+}
+
+void
+InteractionMatrix::noteForeignWrite(const Creature& inCreature, address_t inAddress, const CellMap& inCellMap)
+{
+    const Creature* owner = inCellMap.creatureAtAddress(inAddress);
+    if (owner && (owner == &inCreature || owner == inCreature.daughterCreature()))
+        return;
+
+    ++mNumForeignWrites;
+    if (owner)
+        ++countsForPair(inCreature.genotype(), owner->genotype()).mWrites;
+}
+
+InteractionMatrix::Counts
+InteractionMatrix::counts(const InventoryGenotype* inActor, const InventoryGenotype* inTarget) const
+{
+    CountsMap::const_iterator it = mCounts.find(genotype_pair(inActor, inTarget));
+    return it != mCounts.end() ? it->second : Counts();
+}
+
+void
+InteractionMatrix::getEntries(std::vector<Entry>& outEntries) const
+{
+    outEntries.clear();
+    outEntries.reserve(mCounts.size());
+
+    for (CountsMap::const_iterator it = mCounts.begin(); it != mCounts.end(); ++it)
+    {
+        Entry entry;
+        entry.mGenotypes = it->first;
+        entry.mCounts = it->second;
+        outEntries.push_back(entry);
+    }
+
+    stable_sort(outEntries.begin(), outEntries.end(), compareEntries);
+}
+
+void
+InteractionMatrix::clear()
+{
+    mCounts.clear();
+    mLastPair = mCounts.end();
+    mNumForeignExecutions = 0;
+    mNumForeignWrites = 0;
+}
+
+void
+InteractionMatrix::write(std::ostream& inStream) const
+{
+    vector<Entry> entries;
+    getEntries(entries);
+
+    inStream << "actor\ttarget\texecutions\twrites" << endl;
+    for (vector<Entry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+    {
+        inStream << genotypeName(it->mGenotypes.first) << "\t" << genotypeName(it->mGenotypes.second) << "\t"
+                 << it->mCounts.mExecutions << "\t" << it->mCounts.mWrites << endl;
+    }
+}
+
+InteractionMatrix::Counts&
+InteractionMatrix::countsForPair(const InventoryGenotype* inActor, const InventoryGenotype* inTarget)
+{
+    const genotype_pair key(inActor, inTarget);
+    if (mLastPair == mCounts.end() || mLastPair->first != key)
+        mLastPair = mCounts.insert(CountsMap::value_type(key, Counts())).first;
+
+    return mLastPair->second;
+}
+
+} // namespace MacTierra
@@ -0,0 +1,100 @@
+/*
+ *  MT_InteractionMatrix.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_InteractionMatrix_h
+#define MT_InteractionMatrix_h
+
+#include <iosfwd>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+
+namespace MacTierra {
+
+class CellMap;
+class Creature;
+class InventoryGenotype;
+
+// Counts, for each pair of genotypes, how often creatures of one execute code inside, or
+// write into, creatures of the other. This is how parasites, hyper-parasites and the like
+// show up.
+//
+// The execution unit only calls in here when the instruction pointer or a mov_iab target
+// falls outside the creature (and its offspring), which is the uncommon case; the owner is then
+// looked up in the cell map. Creatures that have not bred true have no genotype, and are
+// counted under a NULL genotype. Code in free space has no owner, and is only counted in the
+// totals.
+//
+// Genotypes are held by pointer, so clear() the matrix or remove it from the world before the
+// world's inventory goes away. Install it with World::setInteractionMatrix().
+class InteractionMatrix : Noncopyable
+{
+public:
+    // (actor, target)
+    typedef std::pair<const InventoryGenotype*, const InventoryGenotype*> genotype_pair;
+
+    struct Counts
+    {
+        Counts() : mExecutions(0), mWrites(0) {}
+
+        u_int64_t   mExecutions;
+        u_int64_t   mWrites;
+    };
+
+    struct Entry
+    {
+        genotype_pair   mGenotypes;
+        Counts          mCounts;
+    };
+
+    InteractionMatrix();
+
+    // Called by the execution unit
+    void            noteForeignExecution(const Creature& inCreature, address_t inAddress, const CellMap& inCellMap);
+    void            noteForeignWrite(const Creature& inCreature, address_t inAddress, const CellMap& inCellMap);
+
+    size_t          numEntries() const                  { return mCounts.size(); }
+    Counts          counts(const InventoryGenotype* inActor, const InventoryGenotype* inTarget) const;
+
+    // Every pair that interacted, most active (executions plus writes) first.
+    void            getEntries(std::vector<Entry>& outEntries) const;
+
+    // Instructions executed, and writes made, outside the acting creature, whether or not
+    // another creature owned the cells.
+    u_int64_t       numForeignExecutions() const        { return mNumForeignExecutions; }
+    u_int64_t       numForeignWrites() const            { return mNumForeignWrites; }
+
+    void            clear();
+
+    // One line per pair: actor and target genotype names ("-" for no genotype), executions, writes.
+    void            write(std::ostream& inStream) const;
+
+protected:
+
+    Counts&         countsForPair(const InventoryGenotype* inActor, const InventoryGenotype* inTarget);
+
+protected:
+
+    typedef std::map<genotype_pair, Counts> CountsMap;
+    CountsMap           mCounts;
+
+    // a parasite tends to run many instructions in the same host, so remember the last pair
+    CountsMap::iterator mLastPair;
+
+    u_int64_t           mNumForeignExecutions;
+    u_int64_t           mNumForeignWrites;
+};
+
+} // namespace MacTierra
+
+#endif // MT_InteractionMatrix_h
@@ -9,8 +9,10 @@
 
 #include <iostream>
 
+#include "MT_GenotypeRegistry.h"
 #include "MT_Inventory.h"
 #include "MT_InventoryListener.h"
+#include "MT_PopulationStatistics.h"
 
 namespace MacTierra {
 
@@ -22,9 +24,32 @@ InventoryGenotype::InventoryGenotype(const std::string& inName, const GenomeData
 , mNumEverLived(0)
 , mOriginInstructions(0)
 , mOriginGenerations(0)
+, mListenersNotified(false)
+, mRegistered(NULL)
 {
 }
 
+InventoryGenotype::InventoryGenotype(const RegisteredGenotype* inRegistered)
+: Genotype(inRegistered->identifier(), &inRegistered->genome())
+, mNumAlive(0)
+, mNumEverLived(0)
+, mOriginInstructions(0)
+, mOriginGenerations(0)
+, mListenersNotified(false)
+, mRegistered(inRegistered)
+{
+}
+
+void
+InventoryGenotype::useRegisteredGenotype(const RegisteredGenotype* inRegistered)
+{
+    BOOST_ASSERT(inRegistered->genome() == genome());
+    mIdentifier = inRegistered->identifier();
+    mSharedGenome = &inRegistered->genome();
+    mGenome = GenomeData();
+    mRegistered = inRegistered;
+}
+
 
 #pragma mark -
 
@@ -34,6 +59,8 @@ Inventory::Inventory()
 , mSpeciationCount(0)
 , mExtinctionCount(0)
 , mListenerAliveThreshold(10)
+, mStatistics(NULL)
+, mRegistry(NULL)
 {
 }
 
@@ -54,21 +81,24 @@ Inventory::~Inventory()
 InventoryGenotype*
 Inventory::findGenotype(const GenomeData& inGenotype) const
 {
-    InventoryMap::const_iterator it = mInventoryMap.find(inGenotype);
+    InventoryMap::const_iterator it = mInventoryMap.find(&inGenotype);
     return (it != mInventoryMap.end()) ? it->second  : NULL;
 }
 
 bool
 Inventory::enterGenotype(const GenomeData& inGenotype, InventoryGenotype*& outGenotype)
 {
-    InventoryMap::const_iterator it = mInventoryMap.find(inGenotype);
+    InventoryMap::const_iterator it = mInventoryMap.find(&inGenotype);
     if (it == mInventoryMap.end())
     {
         // not found. make a new one.
-        string newIdentifier = uniqueIdentifierForLength(inGenotype.length());
+        InventoryGenotype* newGenotype;
+        if (mRegistry)
+            newGenotype = new InventoryGenotype(mRegistry->enterGenotype(inGenotype));
+        else
+            newGenotype = new InventoryGenotype(uniqueIdentifierForLength(inGenotype.length()), inGenotype);
 
-        InventoryGenotype* newGenotype = new InventoryGenotype(newIdentifier, inGenotype);
-        mInventoryMap[inGenotype] = newGenotype;
+        mInventoryMap[&newGenotype->genome()] = newGenotype;
         mGenotypeSizeMap.insert(pair<u_int32_t, InventoryGenotype*>(inGenotype.length(), newGenotype));
 
         outGenotype = newGenotype;
@@ -81,17 +111,202 @@ Inventory::enterGenotype(const GenomeData& inGenotype, InventoryGenotype*& outGe
 }
 
 void
-Inventory::creatureBorn(InventoryGenotype* inGenotype)
+Inventory::creatureBorn(InventoryGenotype* inGenotype, Creature& inCreature)
 {
-    inGenotype->creatureBorn();
+    removeFromRanking(inGenotype);
+    inGenotype->creatureBorn(inCreature);
+    addToRanking(inGenotype);
+
+    if (mStatistics)
+        mStatistics->genotypeCountChanged(inGenotype->numberAlive() - 1, inGenotype->numberAlive());
+
     if (inGenotype->numberAlive() > mListenerAliveThreshold)
         notifyListenersForGenotype(inGenotype);
 }
 
 void
-Inventory::creatureDied(InventoryGenotype* inGenotype)
+Inventory::creatureDied(InventoryGenotype* inGenotype, Creature& inCreature)
+{
+    removeFromRanking(inGenotype);
+    inGenotype->creatureDied(inCreature);
+    addToRanking(inGenotype);
+
+    if (mStatistics)
+        mStatistics->genotypeCountChanged(inGenotype->numberAlive() + 1, inGenotype->numberAlive());
+}
+
+void
+Inventory::restoreCreature(Creature& inCreature)
+{
+    InventoryGenotype* genotype = inCreature.genotype();
+    BOOST_ASSERT(genotype && inCreature.genotypeDivergence() == 0);
+    BOOST_ASSERT(genotype->mCreatures.size() < genotype->numberAlive());
+    genotype->mCreatures.push_back(inCreature);
+}
+
+void
+Inventory::copyFrom(const Inventory& inInventory, GenotypeCopyMap& outGenotypes)
+{
+    BOOST_ASSERT(mInventoryMap.empty());
+
+    mNumSpeciesEver = inInventory.mNumSpeciesEver;
+    mNumSpeciesCurrent = inInventory.mNumSpeciesCurrent;
+    mSpeciationCount = inInventory.mSpeciationCount;
+    mExtinctionCount = inInventory.mExtinctionCount;
+    mListenerAliveThreshold = inInventory.mListenerAliveThreshold;
+
+    for (InventoryMap::const_iterator it = inInventory.mInventoryMap.begin(); it != inInventory.mInventoryMap.end(); ++it)
+    {
+        const InventoryGenotype* original = it->second;
+        InventoryGenotype* copy = original->mRegistered ? new InventoryGenotype(original->mRegistered)
+                                                        : new InventoryGenotype(original->identifier(), original->genome());
+        copy->mNumAlive = original->mNumAlive;
+        copy->mNumEverLived = original->mNumEverLived;
+        copy->mOriginInstructions = original->mOriginInstructions;
+        copy->mOriginGenerations = original->mOriginGenerations;
+        copy->mListenersNotified = original->mListenersNotified;
+
+        mInventoryMap.insert(mInventoryMap.end(), InventoryMap::value_type(&copy->genome(), copy));
+        outGenotypes[original] = copy;
+    }
+    mRegistry = inInventory.mRegistry;
+
+    for (SizeMap::const_iterator it = inInventory.mGenotypeSizeMap.begin(); it != inInventory.mGenotypeSizeMap.end(); ++it)
+        mGenotypeSizeMap.insert(mGenotypeSizeMap.end(), SizeMap::value_type(it->first, outGenotypes[it->second]));
+
+    rebuildRanking();
+}
+
+void
+Inventory::clear()
+{
+    BOOST_ASSERT(mAliveRanking.empty());
+
+    for (InventoryMap::const_iterator it = mInventoryMap.begin(); it != mInventoryMap.end(); ++it)
+        delete it->second;
+
+    mInventoryMap.clear();
+    mGenotypeSizeMap.clear();
+    mAliveCountTree.clear();
+
+    mNumSpeciesEver = 0;
+    mNumSpeciesCurrent = 0;
+    mSpeciationCount = 0;
+    mExtinctionCount = 0;
+}
+
+void
+Inventory::setGenotypeRegistry(GenotypeRegistry* inRegistry)
+{
+    BOOST_ASSERT(!mRegistry && inRegistry);
+    mRegistry = inRegistry;
+
+    // the keys point to the genomes, which move to the registry
+    InventoryMap oldMap;
+    oldMap.swap(mInventoryMap);
+    for (InventoryMap::const_iterator it = oldMap.begin(); it != oldMap.end(); ++it)
+    {
+        InventoryGenotype* curGenotype = it->second;
+        curGenotype->useRegisteredGenotype(mRegistry->enterGenotype(curGenotype->genome()));
+        mInventoryMap.insert(mInventoryMap.end(), InventoryMap::value_type(&curGenotype->genome(), curGenotype));
+    }
+
+    // names may have changed
+    rebuildRanking();
+}
+
+void
+Inventory::topGenotypes(u_int32_t inCount, GenotypeVector& outGenotypes) const
 {
-    inGenotype->creatureDied();
+    outGenotypes.clear();
+    AliveRanking::const_iterator it = mAliveRanking.begin(), end = mAliveRanking.end();
+    for (u_int32_t i = 0; i < inCount && it != end; ++i, ++it)
+        outGenotypes.push_back(it->second);
+}
+
+u_int32_t
+Inventory::rankOfGenotype(const InventoryGenotype* inGenotype) const
+{
+    if (inGenotype->numberAlive() == 0)
+        return 0;
+
+    return numGenotypesAboveCount(inGenotype->numberAlive()) + 1;
+}
+
+u_int32_t
+Inventory::numGenotypesAboveCount(u_int32_t inNumAlive) const
+{
+    return mAliveRanking.size() - numGenotypesAtOrBelowCount(inNumAlive);
+}
+
+void
+Inventory::genotypesAboveCount(u_int32_t inNumAlive, GenotypeVector& outGenotypes) const
+{
+    outGenotypes.clear();
+    for (AliveRanking::const_iterator it = mAliveRanking.begin(), end = mAliveRanking.end(); it != end && it->first > inNumAlive; ++it)
+        outGenotypes.push_back(it->second);
+}
+
+void
+Inventory::addToRanking(InventoryGenotype* inGenotype)
+{
+    u_int32_t numAlive = inGenotype->numberAlive();
+    if (numAlive == 0)
+        return;
+
+    mAliveRanking.insert(RankingEntry(numAlive, inGenotype));
+
+    if (numAlive >= mAliveCountTree.size())
+    {
+        // grow, and rebuild the tree from the ranking (which already includes this genotype)
+        mAliveCountTree.assign(max<size_t>(2 * numAlive, 64), 0);
+        for (AliveRanking::const_iterator it = mAliveRanking.begin(), end = mAliveRanking.end(); it != end; ++it)
+            adjustAliveCountTree(it->first, 1);
+    }
+    else
+        adjustAliveCountTree(numAlive, 1);
+}
+
+void
+Inventory::removeFromRanking(InventoryGenotype* inGenotype)
+{
+    u_int32_t numAlive = inGenotype->numberAlive();
+    if (numAlive == 0)
+        return;
+
+    size_t numErased = mAliveRanking.erase(RankingEntry(numAlive, inGenotype));
+    BOOST_ASSERT(numErased == 1);
+    adjustAliveCountTree(numAlive, -1);
+}
+
+void
+Inventory::rebuildRanking()
+{
+    mAliveRanking.clear();
+    mAliveCountTree.clear();
+
+    for (InventoryMap::const_iterator it = mInventoryMap.begin(), end = mInventoryMap.end(); it != end; ++it)
+        addToRanking(it->second);
+}
+
+void
+Inventory::adjustAliveCountTree(u_int32_t inNumAlive, int32_t inDelta)
+{
+    for (size_t i = inNumAlive; i < mAliveCountTree.size(); i += (i & -i))
+        mAliveCountTree[i] += inDelta;
+}
+
+u_int32_t
+Inventory::numGenotypesAtOrBelowCount(u_int32_t inNumAlive) const
+{
+    if (mAliveCountTree.empty())
+        return 0;
+
+    u_int32_t total = 0;
+    size_t i = min<size_t>(inNumAlive, mAliveCountTree.size() - 1);
+    for (; i > 0; i -= (i & -i))
+        total += mAliveCountTree[i];
+    return total;
 }
 
 static std::string incrementString(const std::string& inString)
@@ -151,6 +366,27 @@ Inventory::writeToStream(std::ostream& inStream) const
     }
 }
 
+void
+Inventory::setListenerAliveThreshold(u_int32_t inThreshold)
+{
+    mListenerAliveThreshold = inThreshold;
+
+    // catch up on any genotypes that are already over the new threshold
+    for (AliveRanking::const_iterator it = mAliveRanking.begin(), end = mAliveRanking.end(); it != end && it->first > mListenerAliveThreshold; ++it)
+        notifyListenersForGenotype(it->second);
+}
+
+void
+Inventory::setStatistics(PopulationStatistics* inStatistics)
+{
+    mStatistics = inStatistics;
+    if (!mStatistics)
+        return;
+
+    for (AliveRanking::const_iterator it = mAliveRanking.begin(), end = mAliveRanking.end(); it != end; ++it)
+        mStatistics->genotypeCountChanged(0, it->first);
+}
+
 void
 Inventory::registerListener(InventoryListener* inListener)
 {
@@ -166,15 +402,14 @@ Inventory::unregisterListener(InventoryListener* inListener)
 }
 
 void
-Inventory::notifyListenersForGenotype(const InventoryGenotype* inGenotype)
+Inventory::notifyListenersForGenotype(InventoryGenotype* inGenotype)
 {
-    NotifiedGenotypeMap::const_iterator it = mListenerNotifiedGenotypes.find(inGenotype->genome());
-    if (it == mListenerNotifiedGenotypes.end())
-    {
-        for (ListenerVector::const_iterator it = mListeners.begin(), end = mListeners.end(); it != end; ++it)
-            (*it)->noteGenotype(inGenotype);
-        mListenerNotifiedGenotypes[inGenotype->genome()] = inGenotype;
-    }
+    if (inGenotype->mListenersNotified)
+        return;
+
+    for (ListenerVector::const_iterator it = mListeners.begin(), end = mListeners.end(); it != end; ++it)
+        (*it)->noteGenotype(inGenotype);
+    inGenotype->mListenersNotified = true;
 }
 
 std::string
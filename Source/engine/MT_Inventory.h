@@ -12,6 +12,7 @@
 #define MT_Inventory_h
 
 #include <map>
+#include <set>
 #include <vector>
 
 #include <boost/assert.hpp>
@@ -23,17 +24,29 @@
 #include <wtf/Noncopyable.h>
 
 #include "MT_Engine.h"
+#include "MT_Creature.h"
 #include "MT_Genotype.h"
 
 namespace MacTierra {
 
+class GenotypeRegistry;
+class RegisteredGenotype;
+
+typedef ::boost::intrusive::member_hook<Creature, GenotypeListHook, &Creature::mGenotypeListHook> GenotypeMemberHookOption;
+typedef ::boost::intrusive::list<Creature, GenotypeMemberHookOption> GenotypeCreatureList;
+
 
 class InventoryGenotype : public Genotype
 {
 friend class Inventory;
 public:
     InventoryGenotype(const std::string& inIdentifier, const GenomeData& inGenotype);
+    // Takes its name and genome from the registry.
+    InventoryGenotype(const RegisteredGenotype* inRegistered);
     
+    // NULL unless the inventory has a GenotypeRegistry.
+    const RegisteredGenotype*   registeredGenotype() const  { return mRegistered; }
+
     u_int32_t       numberAlive() const         { return mNumAlive; }
     u_int32_t       numberEverLived() const     { return mNumEverLived; }
 
@@ -43,18 +56,23 @@ public:
     u_int32_t       originGenerations() const  { return mOriginGenerations; }
     void            setOriginGenerations(u_int32_t inGenerations) { mOriginGenerations = inGenerations; }
 
+    // The living creatures counted in numberAlive().
+    const GenotypeCreatureList& creatures() const   { return mCreatures; }
+
 private:
 
-    void creatureBorn()
+    void creatureBorn(Creature& inCreature)
     {
         ++mNumAlive;
         ++mNumEverLived;
+        mCreatures.push_back(inCreature);
     }
 
-    void creatureDied() 
+    void creatureDied(Creature& inCreature)
     {
         BOOST_ASSERT(mNumAlive > 0);
         --mNumAlive;
+        mCreatures.erase(mCreatures.iterator_to(inCreature));
     }
 
 private:
@@ -64,9 +82,13 @@ private:
     , mNumEverLived(0)
     , mOriginInstructions(0)
     , mOriginGenerations(0)
+    , mListenersNotified(false)
+    , mRegistered(NULL)
     {
     }
 
+    void            useRegisteredGenotype(const RegisteredGenotype* inRegistered);
+
     friend class ::boost::serialization::access;
     template<class Archive> void serialize(Archive& ar, const unsigned int version)
     {
@@ -86,6 +108,11 @@ protected:
     
     u_int64_t       mOriginInstructions;
     u_int32_t       mOriginGenerations;
+
+    // not archived
+    bool            mListenersNotified;
+    GenotypeCreatureList mCreatures;
+    const RegisteredGenotype*   mRegistered;
 };
 
 } // namespace MacTierra
@@ -96,14 +123,17 @@ protected:
 namespace MacTierra {
 
 class InventoryListener;
+class PopulationStatistics;
 
 // The inventory tracks the species that are alive now.
 class Inventory : Noncopyable
 {
 public:
-    typedef std::map<GenomeData, InventoryGenotype*> InventoryMap;
+    // Keyed on each genotype's own genome, so that the genome isn't stored twice.
+    typedef std::map<const GenomeData*, InventoryGenotype*, GenomeDataPointerLess> InventoryMap;
     typedef std::multimap<u_int32_t, InventoryGenotype*>  SizeMap;
     typedef std::vector<InventoryListener*> ListenerVector;
+    typedef std::vector<const InventoryGenotype*> GenotypeVector;
 
     Inventory();
     ~Inventory();
@@ -113,18 +143,56 @@ public:
     // return true if it's new
     bool                enterGenotype(const GenomeData& inGenotype, InventoryGenotype*& outGenotype);
 
-    void                creatureBorn(InventoryGenotype* inGenotype);
-    void                creatureDied(InventoryGenotype* inGenotype);
+    void                creatureBorn(InventoryGenotype* inGenotype, Creature& inCreature);
+    void                creatureDied(InventoryGenotype* inGenotype, Creature& inCreature);
+
+    // Re-enter a creature into its genotype's creature list after loading, without counting it.
+    void                restoreCreature(Creature& inCreature);
+
+    // Copies another inventory's genotypes and counts into this empty one, for World::clone().
+    // The genotypes' creature lists are left empty, to be restored as after loading.
+    void                copyFrom(const Inventory& inInventory, GenotypeCopyMap& outGenotypes);
+
+    // Forgets every genotype and count, keeping the listeners, statistics and registry.
+    // No creatures may be alive.
+    void                clear();
+
+    // With a registry, new genotypes take their names and genomes from it, so that they
+    // match those in the other worlds that share it. Genotypes already in the inventory
+    // are entered in the registry, and renamed to match. Set it before the world runs, and
+    // once only; the registry must outlive the inventory.
+    void                setGenotypeRegistry(GenotypeRegistry* inRegistry);
+    GenotypeRegistry*   genotypeRegistry() const            { return mRegistry; }
     
     void                printCreatures() const;
     
     const InventoryMap& inventoryMap() const { return mInventoryMap; }
 
+    // Queries on the ranking of living genotypes by number alive. These are kept up to date
+    // on every birth and death, so they don't have to scan the inventory map.
+    u_int32_t           numAliveGenotypes() const           { return mAliveRanking.size(); }
+
+    // Fills outGenotypes with up to inCount genotypes, most common first. O(inCount).
+    void                topGenotypes(u_int32_t inCount, GenotypeVector& outGenotypes) const;
+
+    // 1-based rank by number alive; genotypes with equal numbers share a rank. Returns 0 for extinct genotypes. O(log n).
+    u_int32_t           rankOfGenotype(const InventoryGenotype* inGenotype) const;
+
+    // Number of genotypes with more than inNumAlive living creatures. O(log n).
+    u_int32_t           numGenotypesAboveCount(u_int32_t inNumAlive) const;
+
+    // Genotypes with more than inNumAlive living creatures, most common first.
+    void                genotypesAboveCount(u_int32_t inNumAlive, GenotypeVector& outGenotypes) const;
+
     void                writeToStream(std::ostream& inStream) const;
 
-    void                setListenerAliveThreshold(u_int32_t inThreshold)    { mListenerAliveThreshold = inThreshold; }
+    void                setListenerAliveThreshold(u_int32_t inThreshold);
     u_int32_t           listenerAliveThreshold() const                      { return mListenerAliveThreshold; }
 
+    // The statistics are told about every change in the number alive of a genotype.
+    // Setting them enters the current counts.
+    void                setStatistics(PopulationStatistics* inStatistics);
+
     void                registerListener(InventoryListener* inListener);
     void                unregisterListener(InventoryListener* inListener);
     
@@ -132,20 +200,59 @@ protected:
 
     std::string         uniqueIdentifierForLength(u_int32_t inLength) const;
 
-    void                notifyListenersForGenotype(const InventoryGenotype* inGenotype);
+    void                notifyListenersForGenotype(InventoryGenotype* inGenotype);
+
+    void                addToRanking(InventoryGenotype* inGenotype);
+    void                removeFromRanking(InventoryGenotype* inGenotype);
+    void                rebuildRanking();
+
+    // Fenwick tree over alive counts, for rank queries
+    void                adjustAliveCountTree(u_int32_t inNumAlive, int32_t inDelta);
+    u_int32_t           numGenotypesAtOrBelowCount(u_int32_t inNumAlive) const;
 
 private:
+    // The inventory map as archived, keyed on copies of the genomes.
+    typedef std::map<GenomeData, InventoryGenotype*> ArchivedInventoryMap;
+
     friend class ::boost::serialization::access;
-    template<class Archive> void serialize(Archive& ar, const unsigned int version)
+    template<class Archive> void save(Archive& ar, const unsigned int version) const
     {
-        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("total_species", mNumSpeciesEver);
-        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("current_species", mNumSpeciesCurrent);
+        ar << MT_BOOST_MEMBER_SERIALIZATION_NVP("total_species", mNumSpeciesEver);
+        ar << MT_BOOST_MEMBER_SERIALIZATION_NVP("current_species", mNumSpeciesCurrent);
 
-        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("speciation", mSpeciationCount);
-        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("extinction", mExtinctionCount);
+        ar << MT_BOOST_MEMBER_SERIALIZATION_NVP("speciation", mSpeciationCount);
+        ar << MT_BOOST_MEMBER_SERIALIZATION_NVP("extinction", mExtinctionCount);
 
-        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("map", mInventoryMap);
-        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("size_map", mGenotypeSizeMap);
+        ArchivedInventoryMap archivedMap;
+        for (InventoryMap::const_iterator it = mInventoryMap.begin(); it != mInventoryMap.end(); ++it)
+            archivedMap.insert(archivedMap.end(), ArchivedInventoryMap::value_type(*it->first, it->second));
+
+        ar << MT_BOOST_MEMBER_SERIALIZATION_NVP("map", archivedMap);
+        ar << MT_BOOST_MEMBER_SERIALIZATION_NVP("size_map", mGenotypeSizeMap);
+    }
+
+    template<class Archive> void load(Archive& ar, const unsigned int version)
+    {
+        ar >> MT_BOOST_MEMBER_SERIALIZATION_NVP("total_species", mNumSpeciesEver);
+        ar >> MT_BOOST_MEMBER_SERIALIZATION_NVP("current_species", mNumSpeciesCurrent);
+
+        ar >> MT_BOOST_MEMBER_SERIALIZATION_NVP("speciation", mSpeciationCount);
+        ar >> MT_BOOST_MEMBER_SERIALIZATION_NVP("extinction", mExtinctionCount);
+
+        ArchivedInventoryMap archivedMap;
+        ar >> MT_BOOST_MEMBER_SERIALIZATION_NVP("map", archivedMap);
+        ar >> MT_BOOST_MEMBER_SERIALIZATION_NVP("size_map", mGenotypeSizeMap);
+
+        mInventoryMap.clear();
+        for (ArchivedInventoryMap::const_iterator it = archivedMap.begin(); it != archivedMap.end(); ++it)
+            mInventoryMap.insert(mInventoryMap.end(), InventoryMap::value_type(&it->second->genome(), it->second));
+
+        rebuildRanking();
+    }
+
+    template<class Archive> void serialize(Archive& ar, const unsigned int file_version)
+    {
+        ::boost::serialization::split_member(ar, *this, file_version);
     }
     
 protected:
@@ -163,9 +270,29 @@ protected:
     u_int32_t       mListenerAliveThreshold;
     ListenerVector  mListeners;
 
-    // remember which genotypes we've notified the listener about
-    typedef std::map<GenomeData, const InventoryGenotype*> NotifiedGenotypeMap;
-    NotifiedGenotypeMap    mListenerNotifiedGenotypes;
+    PopulationStatistics*   mStatistics;
+
+    GenotypeRegistry*       mRegistry;
+
+    // Living genotypes ordered by number alive (descending), then by name.
+    // Entries are keyed on the count so that they can be found again before the count changes.
+    typedef std::pair<u_int32_t, InventoryGenotype*> RankingEntry;
+    struct RankingCompare
+    {
+        bool operator()(const RankingEntry& inLHS, const RankingEntry& inRHS) const
+        {
+            if (inLHS.first != inRHS.first)
+                return inLHS.first > inRHS.first;
+            if (inLHS.second->length() != inRHS.second->length())
+                return inLHS.second->length() < inRHS.second->length();
+            return inLHS.second->identifier() < inRHS.second->identifier();
+        }
+    };
+    typedef std::set<RankingEntry, RankingCompare> AliveRanking;
+    AliveRanking    mAliveRanking;
+
+    // mAliveCountTree[i] is the Fenwick node for alive count i (index 0 unused)
+    std::vector<u_int32_t>  mAliveCountTree;
 
 };
 
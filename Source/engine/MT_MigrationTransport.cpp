@@ -0,0 +1,779 @@
+/*
+ *  MT_MigrationTransport.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "MT_MigrationTransport.h"
+
+#include "MT_Archipelago.h"
+#include "MT_Creature.h"
+#include "MT_InstructionSet.h"
+#include "MT_World.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+const u_int32_t MigrationTransport::kMaxQueuedBytes;
+const u_int32_t MigrationTransport::kMaxGenomeLength;
+
+static const char kFrameMagic[4] = { 'M', 'T', 'M', 'G' };
+static const size_t kFrameHeaderLength = sizeof(kFrameMagic) + 1 + sizeof(u_int32_t);
+static const size_t kMigrantHeaderLength = 4 * sizeof(u_int32_t);
+
+static const int kPollInterval = 100;           // milliseconds, to retry connections
+static const time_t kReconnectDelay = 1;        // seconds
+static const size_t kReadChunkSize = 64 * 1024;
+
+#ifdef MSG_NOSIGNAL
+static const int kSendFlags = MSG_NOSIGNAL;
+#else
+static const int kSendFlags = 0;
+#endif
+
+static void appendWord(string& ioData, u_int32_t inWord)
+{
+    for (u_int32_t i = 0; i < 4; ++i)
+        ioData.push_back(static_cast<char>((inWord >> (8 * i)) & 0xFF));
+}
+
+static u_int32_t readWord(const string& inData, size_t inOffset)
+{
+    u_int32_t word = 0;
+    for (u_int32_t i = 0; i < 4; ++i)
+        word |= static_cast<u_int32_t>(static_cast<unsigned char>(inData[inOffset + i])) << (8 * i);
+    return word;
+}
+
+static bool setNonBlocking(int inSocket)
+{
+    int flags = fcntl(inSocket, F_GETFL, 0);
+    return flags != -1 && fcntl(inSocket, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+static void configureSocket(int inSocket, bool inTCP)
+{
+    setNonBlocking(inSocket);
+
+    int on = 1;
+#ifdef SO_NOSIGPIPE
+    setsockopt(inSocket, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    if (inTCP)
+        setsockopt(inSocket, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+static bool isUnixAddress(const string& inAddress)
+{
+    return inAddress.compare(0, 5, "unix:") == 0;
+}
+
+static bool unixSocketAddress(const string& inAddress, sockaddr_un& outAddress)
+{
+    const string path = inAddress.substr(5);
+    if (path.empty() || path.length() >= sizeof(outAddress.sun_path))
+        return false;
+
+    memset(&outAddress, 0, sizeof(outAddress));
+    outAddress.sun_family = AF_UNIX;
+    strncpy(outAddress.sun_path, path.c_str(), sizeof(outAddress.sun_path) - 1);
+    return true;
+}
+
+// Looks up "<host>:<port>". The caller frees the result with freeaddrinfo().
+static addrinfo* tcpSocketAddresses(const string& inAddress, bool inPassive)
+{
+    const size_t colon = inAddress.rfind(':');
+    if (colon == string::npos || colon + 1 == inAddress.length())
+        return NULL;
+
+    const string host = inAddress.substr(0, colon);
+    const string port = inAddress.substr(colon + 1);
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (inPassive)
+        hints.ai_flags = AI_PASSIVE;
+
+    addrinfo* addresses = NULL;
+    if (getaddrinfo(host.empty() ? NULL : host.c_str(), port.c_str(), &hints, &addresses) != 0)
+        return NULL;
+    return addresses;
+}
+
+MigrationTransport::MigrationTransport(u_int32_t inNodeID)
+: mNodeID(inNodeID)
+, mListenSocket(-1)
+, mIOThread(NULL)
+, mStopping(false)
+, mNumMigrantsSent(0)
+, mNumMigrantsReceived(0)
+, mNumBatchesDropped(0)
+, mNumConnectedPeers(0)
+, mNumMigrantsPlaced(0)
+, mNumMigrantsLost(0)
+{
+    mWakePipe[0] = mWakePipe[1] = -1;
+    if (pipe(mWakePipe) == 0)
+    {
+        setNonBlocking(mWakePipe[0]);
+        setNonBlocking(mWakePipe[1]);
+    }
+}
+
+MigrationTransport::~MigrationTransport()
+{
+    if (mIOThread)
+    {
+        {
+            boost::mutex::scoped_lock lock(mLock);
+            mStopping = true;
+        }
+        wake();
+        mIOThread->join();
+        delete mIOThread;
+    }
+
+    for (size_t i = 0; i < mPeers.size(); ++i)
+    {
+        if (mPeers[i]->mSocket != -1)
+            close(mPeers[i]->mSocket);
+        delete mPeers[i];
+    }
+
+    for (size_t i = 0; i < mConnections.size(); ++i)
+        close(mConnections[i].mSocket);
+
+    if (mListenSocket != -1)
+    {
+        close(mListenSocket);
+        if (!mSocketPath.empty())
+            unlink(mSocketPath.c_str());
+    }
+
+    if (mWakePipe[0] != -1)
+    {
+        close(mWakePipe[0]);
+        close(mWakePipe[1]);
+    }
+}
+
+bool
+MigrationTransport::listen(const string& inAddress)
+{
+    BOOST_ASSERT(!mIOThread && mListenSocket == -1);
+
+    if (isUnixAddress(inAddress))
+    {
+        sockaddr_un address;
+        if (!unixSocketAddress(inAddress, address))
+            return false;
+
+        // a socket left behind by an earlier run; anything else is left alone
+        struct stat fileInfo;
+        if (stat(address.sun_path, &fileInfo) == 0 && S_ISSOCK(fileInfo.st_mode))
+            unlink(address.sun_path);
+
+        int listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenSocket == -1)
+            return false;
+
+        if (bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listenSocket, SOMAXCONN) != 0)
+        {
+            close(listenSocket);
+            return false;
+        }
+
+        configureSocket(listenSocket, false);
+        mListenSocket = listenSocket;
+        mSocketPath = address.sun_path;
+        mListenAddress = inAddress;
+        return true;
+    }
+
+    addrinfo* addresses = tcpSocketAddresses(inAddress, true);
+    if (!addresses)
+        return false;
+
+    for (addrinfo* cur = addresses; cur && mListenSocket == -1; cur = cur->ai_next)
+    {
+        int listenSocket = socket(cur->ai_family, cur->ai_socktype, cur->ai_protocol);
+        if (listenSocket == -1)
+            continue;
+
+        int on = 1;
+        setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+        if (bind(listenSocket, cur->ai_addr, cur->ai_addrlen) != 0 || ::listen(listenSocket, SOMAXCONN) != 0)
+        {
+            close(listenSocket);
+            continue;
+        }
+
+        configureSocket(listenSocket, true);
+        mListenSocket = listenSocket;
+    }
+    freeaddrinfo(addresses);
+
+    if (mListenSocket == -1)
+        return false;
+
+    // with the port the system picked, if it was 0
+    sockaddr_storage boundAddress;
+    socklen_t addressLength = sizeof(boundAddress);
+    getsockname(mListenSocket, reinterpret_cast<sockaddr*>(&boundAddress), &addressLength);
+
+    u_int16_t port = 0;
+    if (boundAddress.ss_family == AF_INET)
+        port = ntohs(reinterpret_cast<sockaddr_in*>(&boundAddress)->sin_port);
+    else if (boundAddress.ss_family == AF_INET6)
+        port = ntohs(reinterpret_cast<sockaddr_in6*>(&boundAddress)->sin6_port);
+
+    std::ostringstream addressStream;
+    addressStream << inAddress.substr(0, inAddress.rfind(':')) << ":" << port;
+    mListenAddress = addressStream.str();
+    return true;
+}
+
+u_int32_t
+MigrationTransport::addPeer(const string& inAddress)
+{
+    BOOST_ASSERT(!mIOThread);
+    Peer* peer = new Peer(inAddress);
+    resolvePeer(*peer);     // and again on the I/O thread, if this fails
+    mPeers.push_back(peer);
+    return mPeers.size() - 1;
+}
+
+void
+MigrationTransport::start()
+{
+    BOOST_ASSERT(!mIOThread);
+    mIOThread = new boost::thread(IOThreadEntry(this));
+}
+
+void
+MigrationTransport::send(u_int32_t inPeer, const vector<NetworkMigrant>& inMigrants)
+{
+    if (inMigrants.empty())
+        return;
+
+    string frame;
+    encodeBatch(inMigrants, frame);
+
+    {
+        boost::mutex::scoped_lock lock(mLock);
+        Peer& peer = *mPeers[inPeer];
+        if (peer.mQueuedBytes + frame.length() > kMaxQueuedBytes)
+        {
+            ++mNumBatchesDropped;
+            return;
+        }
+
+        peer.mQueuedBytes += frame.length();
+        peer.mFrames.push_back(string());
+        peer.mFrames.back().swap(frame);
+        mNumMigrantsSent += inMigrants.size();
+    }
+    wake();
+}
+
+void
+MigrationTransport::receive(vector<NetworkMigrant>& outMigrants)
+{
+    boost::mutex::scoped_lock lock(mLock);
+    outMigrants.insert(outMigrants.end(), mArrived.begin(), mArrived.end());
+    mArrived.clear();
+}
+
+void
+MigrationTransport::exchange(World& ioWorld, u_int32_t inNumMigrants, RandomLib::Random& inRNG)
+{
+    // choose the emigrants before placing anyone, so that new arrivals don't move on again
+    if (!mPeers.empty())
+    {
+        vector<const Creature*> candidates;
+        Archipelago::migrantCandidates(ioWorld, candidates);
+
+        vector<vector<NetworkMigrant> > batches(mPeers.size());
+        for (u_int32_t i = 0; i < inNumMigrants && !candidates.empty(); ++i)
+        {
+            const Creature* emigrant = candidates[inRNG.Integer<size_t>(candidates.size())];
+            const u_int32_t peer = inRNG.Integer<u_int32_t>(mPeers.size());
+
+            NetworkMigrant migrant;
+            migrant.mSourceNode = mNodeID;
+            migrant.mCreatureID = emigrant->creatureID();
+            migrant.mGeneration = emigrant->generation();
+            migrant.mGenome = emigrant->genomeData();
+            batches[peer].push_back(migrant);
+        }
+
+        for (u_int32_t i = 0; i < batches.size(); ++i)
+            send(i, batches[i]);
+    }
+
+    vector<NetworkMigrant> arrived;
+    receive(arrived);
+    for (size_t i = 0; i < arrived.size(); ++i)
+    {
+        if (Archipelago::placeMigrant(ioWorld, arrived[i].mGenome.dataString(), inRNG))
+            ++mNumMigrantsPlaced;
+        else
+            ++mNumMigrantsLost;
+    }
+}
+
+u_int64_t
+MigrationTransport::numMigrantsSent() const
+{
+    boost::mutex::scoped_lock lock(mLock);
+    return mNumMigrantsSent;
+}
+
+u_int64_t
+MigrationTransport::numMigrantsReceived() const
+{
+    boost::mutex::scoped_lock lock(mLock);
+    return mNumMigrantsReceived;
+}
+
+u_int64_t
+MigrationTransport::numBatchesDropped() const
+{
+    boost::mutex::scoped_lock lock(mLock);
+    return mNumBatchesDropped;
+}
+
+u_int32_t
+MigrationTransport::numConnectedPeers() const
+{
+    boost::mutex::scoped_lock lock(mLock);
+    return mNumConnectedPeers;
+}
+
+void
+MigrationTransport::encodeBatch(const vector<NetworkMigrant>& inMigrants, string& outFrame)
+{
+    string payload;
+    appendWord(payload, inMigrants.size());
+    for (size_t i = 0; i < inMigrants.size(); ++i)
+    {
+        const NetworkMigrant& migrant = inMigrants[i];
+        appendWord(payload, migrant.mSourceNode);
+        appendWord(payload, migrant.mCreatureID);
+        appendWord(payload, migrant.mGeneration);
+        appendWord(payload, migrant.mGenome.length());
+        payload.append(migrant.mGenome.dataString());
+    }
+
+    outFrame.assign(kFrameMagic, sizeof(kFrameMagic));
+    outFrame.push_back(static_cast<char>(kProtocolVersion));
+    appendWord(outFrame, payload.length());
+    outFrame.append(payload);
+}
+
+bool
+MigrationTransport::decodeBatches(string& ioBuffer, vector<NetworkMigrant>& outMigrants)
+{
+    size_t frameStart = 0;
+    while (ioBuffer.length() - frameStart >= kFrameHeaderLength)
+    {
+        if (ioBuffer.compare(frameStart, sizeof(kFrameMagic), kFrameMagic, sizeof(kFrameMagic)) != 0
+            || ioBuffer[frameStart + sizeof(kFrameMagic)] != static_cast<char>(kProtocolVersion))
+            return false;
+
+        // senders never queue a frame longer than kMaxQueuedBytes, so don't wait for one
+        const u_int32_t payloadLength = readWord(ioBuffer, frameStart + sizeof(kFrameMagic) + 1);
+        if (payloadLength < sizeof(u_int32_t) || payloadLength > kMaxQueuedBytes)
+            return false;
+
+        if (ioBuffer.length() - frameStart - kFrameHeaderLength < payloadLength)
+            break;      // wait for the rest
+
+        size_t offset = frameStart + kFrameHeaderLength;
+        const size_t frameEnd = offset + payloadLength;
+
+        const u_int32_t numMigrants = readWord(ioBuffer, offset);
+        offset += sizeof(u_int32_t);
+
+        for (u_int32_t i = 0; i < numMigrants; ++i)
+        {
+            if (frameEnd - offset < kMigrantHeaderLength)
+                return false;
+
+            NetworkMigrant migrant;
+            migrant.mSourceNode = readWord(ioBuffer, offset);
+            migrant.mCreatureID = readWord(ioBuffer, offset + 4);
+            migrant.mGeneration = readWord(ioBuffer, offset + 8);
+            const u_int32_t genomeLength = readWord(ioBuffer, offset + 12);
+            offset += kMigrantHeaderLength;
+
+            if (genomeLength == 0 || genomeLength > kMaxGenomeLength || frameEnd - offset < genomeLength)
+                return false;
+
+            // the genome goes straight into a soup
+            for (u_int32_t j = 0; j < genomeLength; ++j)
+            {
+                if (static_cast<u_int8_t>(ioBuffer[offset + j]) >= kInstructionSetSize)
+                    return false;
+            }
+
+            migrant.mGenome.dataString().assign(ioBuffer, offset, genomeLength);
+            offset += genomeLength;
+            outMigrants.push_back(migrant);
+        }
+
+        if (offset != frameEnd)
+            return false;
+
+        frameStart = frameEnd;
+    }
+
+    ioBuffer.erase(0, frameStart);
+    return true;
+}
+
+#pragma mark -
+
+void
+MigrationTransport::runIO()
+{
+    vector<pollfd> pollSockets;
+    vector<NetworkMigrant> arrived;
+
+    while (true)
+    {
+        const time_t now = time(NULL);
+        pollSockets.clear();
+
+        pollfd wakeEntry = { mWakePipe[0], POLLIN, 0 };
+        pollSockets.push_back(wakeEntry);
+
+        // only this thread changes a peer's socket and addresses, so they can be read unlocked
+        for (size_t i = 0; i < mPeers.size(); ++i)
+        {
+            Peer& peer = *mPeers[i];
+            if (peer.mAddresses.empty() && peer.mSocket == -1 && now >= peer.mNextAttempt)
+            {
+                resolvePeer(peer);
+                if (peer.mAddresses.empty())
+                    peer.mNextAttempt = now + kReconnectDelay;
+            }
+        }
+
+        const size_t firstPeer = pollSockets.size();
+        {
+            boost::mutex::scoped_lock lock(mLock);
+            if (mStopping)
+                break;
+
+            for (size_t i = 0; i < mPeers.size(); ++i)
+            {
+                Peer& peer = *mPeers[i];
+                if (peer.mSocket == -1 && now >= peer.mNextAttempt)
+                    connectPeer(peer);
+
+                // peers never write to us, but reading shows when they close
+                pollfd entry = { peer.mSocket, 0, 0 };
+                if (peer.mSocket != -1)
+                    entry.events = !peer.mConnected || !peer.mFrames.empty() ? (POLLOUT | POLLIN) : POLLIN;
+                pollSockets.push_back(entry);
+            }
+        }
+
+        const size_t listenEntry = pollSockets.size();
+        if (mListenSocket != -1)
+        {
+            pollfd entry = { mListenSocket, POLLIN, 0 };
+            pollSockets.push_back(entry);
+        }
+
+        const size_t firstConnection = pollSockets.size();
+        for (size_t i = 0; i < mConnections.size(); ++i)
+        {
+            pollfd entry = { mConnections[i].mSocket, POLLIN, 0 };
+            pollSockets.push_back(entry);
+        }
+
+        if (poll(&pollSockets[0], pollSockets.size(), kPollInterval) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (pollSockets[0].revents & POLLIN)
+        {
+            char buffer[64];
+            while (read(mWakePipe[0], buffer, sizeof(buffer)) > 0)
+                ;
+        }
+
+        {
+            boost::mutex::scoped_lock lock(mLock);
+            for (size_t i = 0; i < mPeers.size(); ++i)
+            {
+                Peer& peer = *mPeers[i];
+                const short events = pollSockets[firstPeer + i].revents;
+                if (peer.mSocket == -1 || pollSockets[firstPeer + i].fd != peer.mSocket || !events)
+                    continue;
+
+                if (!peer.mConnected)
+                {
+                    int error = 0;
+                    socklen_t errorLength = sizeof(error);
+                    if (getsockopt(peer.mSocket, SOL_SOCKET, SO_ERROR, &error, &errorLength) != 0 || error != 0)
+                    {
+                        disconnectPeer(peer);
+                        continue;
+                    }
+                    peer.mConnected = true;
+                    ++mNumConnectedPeers;
+                }
+
+                if (events & (POLLIN | POLLERR | POLLHUP))
+                {
+                    char buffer[256];
+                    ssize_t result = recv(peer.mSocket, buffer, sizeof(buffer), 0);
+                    if (result == 0 || (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+                    {
+                        disconnectPeer(peer);
+                        continue;
+                    }
+                }
+
+                writePeer(peer);
+            }
+        }
+
+        if (mListenSocket != -1 && (pollSockets[listenEntry].revents & POLLIN))
+            acceptConnections();
+
+        arrived.clear();
+        const size_t numConnections = pollSockets.size() - firstConnection;
+        vector<Connection>::iterator it = mConnections.begin();
+        for (size_t i = 0; i < numConnections; ++i)
+        {
+            if (pollSockets[firstConnection + i].revents == 0)
+            {
+                ++it;
+                continue;
+            }
+
+            // frames that came before a close still count; a bad frame closes the connection, and
+            // the rest of what came with it is dropped
+            const size_t previousCount = arrived.size();
+            bool open = readConnection(*it);
+            if (!decodeBatches(it->mInput, arrived))
+            {
+                arrived.resize(previousCount);
+                open = false;
+            }
+
+            if (open)
+                ++it;
+            else
+            {
+                close(it->mSocket);
+                it = mConnections.erase(it);
+            }
+        }
+
+        if (!arrived.empty())
+        {
+            boost::mutex::scoped_lock lock(mLock);
+            mArrived.insert(mArrived.end(), arrived.begin(), arrived.end());
+            mNumMigrantsReceived += arrived.size();
+        }
+    }
+}
+
+void
+MigrationTransport::resolvePeer(Peer& ioPeer)
+{
+    ioPeer.mAddresses.clear();
+    ioPeer.mAddressIndex = 0;
+
+    if (isUnixAddress(ioPeer.mAddress))
+    {
+        sockaddr_un address;
+        if (!unixSocketAddress(ioPeer.mAddress, address))
+            return;
+
+        PeerAddress peerAddress;
+        memset(&peerAddress.mAddress, 0, sizeof(peerAddress.mAddress));
+        memcpy(&peerAddress.mAddress, &address, sizeof(address));
+        peerAddress.mLength = sizeof(address);
+        ioPeer.mAddresses.push_back(peerAddress);
+        return;
+    }
+
+    addrinfo* addresses = tcpSocketAddresses(ioPeer.mAddress, false);
+    if (!addresses)
+        return;
+
+    for (addrinfo* cur = addresses; cur; cur = cur->ai_next)
+    {
+        if (cur->ai_addrlen > sizeof(sockaddr_storage))
+            continue;
+
+        PeerAddress peerAddress;
+        memset(&peerAddress.mAddress, 0, sizeof(peerAddress.mAddress));
+        memcpy(&peerAddress.mAddress, cur->ai_addr, cur->ai_addrlen);
+        peerAddress.mLength = cur->ai_addrlen;
+        ioPeer.mAddresses.push_back(peerAddress);
+    }
+    freeaddrinfo(addresses);
+}
+
+// Called with mLock held. Starts connecting to the next of the peer's addresses that takes a
+// non-blocking connect; disconnectPeer() moves on to the one after if it then fails.
+void
+MigrationTransport::connectPeer(Peer& ioPeer)
+{
+    ioPeer.mNextAttempt = time(NULL) + kReconnectDelay;
+
+    for (size_t i = 0; i < ioPeer.mAddresses.size(); ++i)
+    {
+        const PeerAddress& address = ioPeer.mAddresses[ioPeer.mAddressIndex];
+        ioPeer.mAddressIndex = (ioPeer.mAddressIndex + 1) % ioPeer.mAddresses.size();
+
+        const int family = address.mAddress.ss_family;
+        int peerSocket = socket(family, SOCK_STREAM, 0);
+        if (peerSocket == -1)
+            continue;
+
+        configureSocket(peerSocket, family != AF_UNIX);
+        if (connect(peerSocket, reinterpret_cast<const sockaddr*>(&address.mAddress), address.mLength) != 0 && errno != EINPROGRESS)
+        {
+            close(peerSocket);
+            continue;
+        }
+
+        ioPeer.mSocket = peerSocket;
+        return;
+    }
+}
+
+// Called with mLock held.
+void
+MigrationTransport::disconnectPeer(Peer& ioPeer)
+{
+    close(ioPeer.mSocket);
+    ioPeer.mSocket = -1;
+    // one that never came up goes on to the peer's next address straight away
+    const bool tryNextAddress = !ioPeer.mConnected && ioPeer.mAddressIndex != 0;
+    if (ioPeer.mConnected)
+        --mNumConnectedPeers;
+    ioPeer.mConnected = false;
+    ioPeer.mNextAttempt = tryNextAddress ? 0 : time(NULL) + kReconnectDelay;
+
+    // the rest of a partly written frame would make no sense to the next connection
+    if (ioPeer.mFrameOffset > 0)
+    {
+        ioPeer.mQueuedBytes -= ioPeer.mFrames.front().length();
+        ioPeer.mFrames.pop_front();
+        ioPeer.mFrameOffset = 0;
+        ++mNumBatchesDropped;
+    }
+}
+
+// Called with mLock held. Writes as much as the socket will take without blocking.
+void
+MigrationTransport::writePeer(Peer& ioPeer)
+{
+    while (ioPeer.mConnected && !ioPeer.mFrames.empty())
+    {
+        const string& frame = ioPeer.mFrames.front();
+        ssize_t written = ::send(ioPeer.mSocket, frame.data() + ioPeer.mFrameOffset, frame.length() - ioPeer.mFrameOffset, kSendFlags);
+        if (written < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                disconnectPeer(ioPeer);
+            return;
+        }
+
+        ioPeer.mFrameOffset += written;
+        if (ioPeer.mFrameOffset == frame.length())
+        {
+            ioPeer.mQueuedBytes -= frame.length();
+            ioPeer.mFrames.pop_front();
+            ioPeer.mFrameOffset = 0;
+        }
+    }
+}
+
+void
+MigrationTransport::acceptConnections()
+{
+    while (true)
+    {
+        int connectionSocket = accept(mListenSocket, NULL, NULL);
+        if (connectionSocket == -1)
+            return;
+
+        configureSocket(connectionSocket, !isUnixAddress(mListenAddress));
+
+        Connection connection;
+        connection.mSocket = connectionSocket;
+        mConnections.push_back(connection);
+    }
+}
+
+// Returns false once the connection has closed.
+bool
+MigrationTransport::readConnection(Connection& ioConnection)
+{
+    char buffer[kReadChunkSize];
+    while (true)
+    {
+        ssize_t result = recv(ioConnection.mSocket, buffer, sizeof(buffer), 0);
+        if (result > 0)
+        {
+            ioConnection.mInput.append(buffer, result);
+            continue;
+        }
+
+        if (result == 0)
+            return false;
+
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+}
+
+void
+MigrationTransport::wake()
+{
+    if (mWakePipe[1] != -1)
+    {
+        char byte = 0;
+        ssize_t result = write(mWakePipe[1], &byte, 1);
+        (void)result;   // a full pipe will wake the thread anyway
+    }
+}
+
+} // namespace MacTierra
@@ -0,0 +1,199 @@
+/*
+ *  MT_MigrationTransport.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_MigrationTransport_h
+#define MT_MigrationTransport_h
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+
+#include <boost/thread.hpp>
+
+#include <wtf/Noncopyable.h>
+
+#define HAVE_BOOST_SERIALIZATION 1
+#include <RandomLib/Random.hpp>
+
+#include "MT_Engine.h"
+#include "MT_Genotype.h"
+
+namespace MacTierra {
+
+class World;
+
+// A creature on its way from one process to another.
+struct NetworkMigrant
+{
+    u_int32_t       mSourceNode;
+    creature_id     mCreatureID;    // in the source world
+    u_int32_t       mGeneration;
+    GenomeData      mGenome;
+};
+
+// Moves migrants between mactierra processes over Unix-domain or TCP sockets, like the network
+// of the original Tierra.
+//
+// Each node listens at one address and connects to its peers at theirs, so two nodes that
+// exchange both ways name each other as peers. Addresses are "unix:<path>" or "<host>:<port>".
+// All the socket I/O happens on the transport's own thread, with non-blocking sockets, so the
+// engine thread never waits on the network: send() queues a batch, and receive() takes the
+// batches that have arrived. A peer's address is looked up once, when it is added, and its
+// connection tries each address the lookup gave in turn; connections that fail are retried. A batch for a peer that isn't
+// connected waits, while there are no more than kMaxQueuedBytes waiting for it, and is dropped
+// otherwise; so is one that was partly written when its connection failed.
+//
+// A batch is sent as one frame: the magic "MTMG", a version byte, the length of the rest of the
+// frame and the number of migrants; then for each migrant, its source node, creature ID,
+// generation and genome length, followed by the genome. Numbers are little-endian u_int32_t.
+// A peer that sends a frame longer than kMaxQueuedBytes, or a genome with a byte that isn't an
+// instruction, is disconnected.
+//
+// Migrants arrive whenever the network delivers them, so unlike an Archipelago, a networked
+// run is not repeatable.
+class MigrationTransport : Noncopyable
+{
+public:
+
+    enum { kProtocolVersion = 1 };
+    static const u_int32_t  kMaxQueuedBytes = 1024 * 1024;     // per peer
+    static const u_int32_t  kMaxGenomeLength = 64 * 1024;       // longer ones are refused
+
+    MigrationTransport(u_int32_t inNodeID);
+    // Stops the I/O thread and closes the sockets. Batches still waiting are lost.
+    ~MigrationTransport();
+
+    u_int32_t       nodeID() const      { return mNodeID; }
+
+    // These are called before start(). Listening on port 0 picks a free port, which the
+    // listen address then has.
+    bool            listen(const std::string& inAddress);
+    const std::string&  listenAddress() const   { return mListenAddress; }
+
+    // Returns the peer's index.
+    u_int32_t       addPeer(const std::string& inAddress);
+    u_int32_t       numPeers() const    { return mPeers.size(); }
+
+    void            start();
+
+    // Queues the migrants as one batch.
+    void            send(u_int32_t inPeer, const std::vector<NetworkMigrant>& inMigrants);
+    // Appends the migrants that have arrived since the last call.
+    void            receive(std::vector<NetworkMigrant>& outMigrants);
+
+    // Sends inNumMigrants of ioWorld's creatures to peers chosen at random, then puts the
+    // migrants that have arrived in random places with room for them.
+    void            exchange(World& ioWorld, u_int32_t inNumMigrants, RandomLib::Random& inRNG);
+
+    // Totals since creation.
+    u_int64_t       numMigrantsSent() const;
+    u_int64_t       numMigrantsReceived() const;
+    u_int64_t       numBatchesDropped() const;
+    u_int32_t       numConnectedPeers() const;
+
+    // from exchange()
+    u_int64_t       numMigrantsPlaced() const   { return mNumMigrantsPlaced; }
+    u_int64_t       numMigrantsLost() const     { return mNumMigrantsLost; }
+
+    static void     encodeBatch(const std::vector<NetworkMigrant>& inMigrants, std::string& outFrame);
+    // Takes the complete frames from the front of ioBuffer, leaving any partial one. Returns
+    // false if the data isn't a valid frame.
+    static bool     decodeBatches(std::string& ioBuffer, std::vector<NetworkMigrant>& outMigrants);
+
+protected:
+
+    struct PeerAddress
+    {
+        sockaddr_storage    mAddress;
+        socklen_t           mLength;
+    };
+
+    struct Peer
+    {
+        Peer(const std::string& inAddress)
+        : mAddress(inAddress)
+        , mAddressIndex(0)
+        , mSocket(-1)
+        , mConnected(false)
+        , mNextAttempt(0)
+        , mFrameOffset(0)
+        , mQueuedBytes(0)
+        {
+        }
+
+        std::string         mAddress;
+        std::vector<PeerAddress>    mAddresses; // empty until the lookup succeeds
+        size_t              mAddressIndex;  // the next to try
+        int                 mSocket;
+        bool                mConnected;
+        time_t              mNextAttempt;
+        std::deque<std::string> mFrames;    // waiting to be written
+        size_t              mFrameOffset;   // into the first one
+        size_t              mQueuedBytes;
+    };
+
+    struct Connection
+    {
+        int                 mSocket;
+        std::string         mInput;
+    };
+
+    struct IOThreadEntry
+    {
+        IOThreadEntry(MigrationTransport* inTransport) : mTransport(inTransport) {}
+        void operator()()   { mTransport->runIO(); }
+        MigrationTransport* mTransport;
+    };
+    friend struct IOThreadEntry;
+
+    // Looks up the peer's address; this can take a while, so never with mLock held.
+    static void     resolvePeer(Peer& ioPeer);
+
+    // On the I/O thread.
+    void            runIO();
+    void            connectPeer(Peer& ioPeer);
+    void            disconnectPeer(Peer& ioPeer);
+    void            writePeer(Peer& ioPeer);
+    void            acceptConnections();
+    bool            readConnection(Connection& ioConnection);
+
+    void            wake();
+
+protected:
+
+    const u_int32_t mNodeID;
+
+    std::string     mListenAddress;
+    std::string     mSocketPath;        // to remove, for a Unix-domain socket
+    int             mListenSocket;
+    int             mWakePipe[2];
+
+    std::vector<Peer*>      mPeers;         // their addresses are only touched by the I/O thread once it starts
+    std::vector<Connection> mConnections;  // accepted; only the I/O thread touches them
+
+    boost::thread*  mIOThread;
+
+    // mLock covers the peers' queues and the rest of these.
+    mutable boost::mutex    mLock;
+    bool            mStopping;
+    std::vector<NetworkMigrant> mArrived;
+    u_int64_t       mNumMigrantsSent;
+    u_int64_t       mNumMigrantsReceived;
+    u_int64_t       mNumBatchesDropped;
+    u_int32_t       mNumConnectedPeers;
+
+    u_int64_t       mNumMigrantsPlaced;
+    u_int64_t       mNumMigrantsLost;
+};
+
+} // namespace MacTierra
+
+#endif // MT_MigrationTransport_h
@@ -0,0 +1,255 @@
+/*
+ *  MT_OpcodeCensus.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "MT_OpcodeCensus.h"
+
+#include "MT_Soup.h"
+#include "MT_World.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+static inline bool isNop(instruction_t inInstruction)
+{
+    return (inInstruction & ~1) == 0;
+}
+
+OpcodeCensus::Counts::Counts()
+: mTemplates(0)
+{
+    memset(mInstructions, 0, sizeof(mInstructions));
+}
+
+u_int64_t
+OpcodeCensus::Counts::numCells() const
+{
+    u_int64_t total = 0;
+    for (int32_t i = 0; i < kInstructionSetSize; ++i)
+        total += mInstructions[i];
+    return total;
+}
+
+void
+OpcodeCensus::Counts::add(const Counts& inCounts)
+{
+    for (int32_t i = 0; i < kInstructionSetSize; ++i)
+        mInstructions[i] += inCounts.mInstructions[i];
+    mTemplates += inCounts.mTemplates;
+}
+
+void
+OpcodeCensus::Counts::subtract(const Counts& inCounts)
+{
+    for (int32_t i = 0; i < kInstructionSetSize; ++i)
+        mInstructions[i] -= inCounts.mInstructions[i];
+    mTemplates -= inCounts.mTemplates;
+}
+
+#pragma mark -
+
+OpcodeCensus::OpcodeCensus()
+: mSoup(NULL)
+{
+}
+
+u_int32_t
+OpcodeCensus::update(const Soup& inSoup)
+{
+    const vector<u_int32_t>& soupWrites = inSoup.regionWriteCounts();
+    const u_int32_t numRegions = soupWrites.size();
+
+    if (mSoup != &inSoup || mRegionCounts.size() != numRegions)
+    {
+        mSoup = &inSoup;
+        mRegionCounts.assign(numRegions, Counts());
+        mTotals = Counts();
+
+        for (u_int32_t i = 0; i < numRegions; ++i)
+            recountRegion(inSoup, i);
+
+        mRegionWrites = soupWrites;
+        return numRegions;
+    }
+
+    // A template that starts at the beginning of a region depends on the last cell of the
+    // region before, so a changed region also means recounting the one after it.
+    u_int32_t numRecounted = 0;
+    bool previousChanged = soupWrites[numRegions - 1] != mRegionWrites[numRegions - 1];
+
+    for (u_int32_t i = 0; i < numRegions; ++i)
+    {
+        const bool changed = soupWrites[i] != mRegionWrites[i];
+        if (changed || previousChanged)
+        {
+            recountRegion(inSoup, i);
+            ++numRecounted;
+        }
+        previousChanged = changed;
+    }
+
+    mRegionWrites = soupWrites;
+    return numRecounted;
+}
+
+double
+OpcodeCensus::instructionFraction(instruction_t inInstruction) const
+{
+    const u_int64_t numCells = mTotals.numCells();
+    return numCells > 0 ? static_cast<double>(mTotals.mInstructions[inInstruction]) / numCells : 0.0;
+}
+
+double
+OpcodeCensus::nopFraction() const
+{
+    return instructionFraction(k_nop_0) + instructionFraction(k_nop_1);
+}
+
+double
+OpcodeCensus::templateDensity() const
+{
+    const u_int64_t numCells = mTotals.numCells();
+    return numCells > 0 ? static_cast<double>(mTotals.mTemplates) / numCells : 0.0;
+}
+
+OpcodeCensus::Counts
+OpcodeCensus::regionCounts(address_t inStart, u_int32_t inLength) const
+{
+    Counts counts;
+    if (mRegionCounts.empty() || inLength == 0)
+        return counts;
+
+    const u_int32_t numRegions = mRegionCounts.size();
+    const u_int32_t firstRegion = inStart >> Soup::kWriteRegionShift;
+    const u_int32_t lastRegion = (inStart + inLength - 1) >> Soup::kWriteRegionShift;
+
+    for (u_int32_t i = firstRegion; i <= lastRegion && i - firstRegion < numRegions; ++i)
+        counts.add(mRegionCounts[i % numRegions]);
+
+    return counts;
+}
+
+void
+OpcodeCensus::recountRegion(const Soup& inSoup, u_int32_t inRegion)
+{
+    const u_int32_t soupSize = inSoup.soupSize();
+    const address_t start = inRegion << Soup::kWriteRegionShift;
+    const u_int32_t length = min(Soup::writeRegionSize(), soupSize - start);
+
+    const instruction_t* soup = inSoup.soup();
+
+    Counts& regionCounts = mRegionCounts[inRegion];
+    mTotals.subtract(regionCounts);
+
+    regionCounts = Counts();
+    countInstructions(soup + start, length, regionCounts);
+    regionCounts.mTemplates = countTemplateStarts(soup + start, length, soup[(start + soupSize - 1) % soupSize]);
+
+    mTotals.add(regionCounts);
+}
+
+// Four sets of counters, so that runs of the same instruction (common in the soup) don't
+// serialize on one counter. This beats comparing 16 cells at a time against each of the
+// 32 instructions with SSE2, which is more than twice as slow.
+void
+OpcodeCensus::countInstructions(const instruction_t* inData, size_t inLength, Counts& outCounts)
+{
+    u_int32_t counts[4][kInstructionSetSize];
+    memset(counts, 0, sizeof(counts));
+
+    // 32-bit counters are enough for one call's worth, given the chunking below
+    const size_t kChunkLength = 1U << 30;
+
+    size_t i = 0;
+    while (i < inLength)
+    {
+        const size_t chunkEnd = min(inLength, i + kChunkLength);
+        for (; i + 4 <= chunkEnd; i += 4)
+        {
+            ++counts[0][inData[i] & (kInstructionSetSize - 1)];
+            ++counts[1][inData[i + 1] & (kInstructionSetSize - 1)];
+            ++counts[2][inData[i + 2] & (kInstructionSetSize - 1)];
+            ++counts[3][inData[i + 3] & (kInstructionSetSize - 1)];
+        }
+        for (; i < chunkEnd; ++i)
+            ++counts[0][inData[i] & (kInstructionSetSize - 1)];
+
+        for (int32_t j = 0; j < kInstructionSetSize; ++j)
+        {
+            outCounts.mInstructions[j] += static_cast<u_int64_t>(counts[0][j]) + counts[1][j] + counts[2][j] + counts[3][j];
+            counts[0][j] = counts[1][j] = counts[2][j] = counts[3][j] = 0;
+        }
+    }
+}
+
+u_int64_t
+OpcodeCensus::countTemplateStarts(const instruction_t* inData, size_t inLength, instruction_t inPrevious)
+{
+    if (inLength == 0)
+        return 0;
+
+    u_int64_t numStarts = (isNop(inData[0]) && !isNop(inPrevious)) ? 1 : 0;
+    size_t i = 1;
+
+#if defined(__SSE2__)
+    // 16 cells at a time, comparing each with the one before. The byte counters can take 255
+    // rounds before they have to be added up.
+    const __m128i nopBits = _mm_set1_epi8(static_cast<char>(~1));
+    const __m128i zero = _mm_setzero_si128();
+
+    while (i + 16 <= inLength)
+    {
+        __m128i starts = zero;
+        const size_t blockEnd = min(inLength - (inLength - i) % 16, i + 255 * 16);
+        for (; i < blockEnd; i += 16)
+        {
+            const __m128i cells = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inData + i));
+            const __m128i previousCells = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inData + i - 1));
+
+            const __m128i nops = _mm_cmpeq_epi8(_mm_and_si128(cells, nopBits), zero);
+            const __m128i previousNops = _mm_cmpeq_epi8(_mm_and_si128(previousCells, nopBits), zero);
+
+            // each matching byte is 0xFF, so subtracting adds one
+            starts = _mm_sub_epi8(starts, _mm_andnot_si128(previousNops, nops));
+        }
+
+        const __m128i sums = _mm_sad_epu8(starts, zero);
+        numStarts += _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+    }
+#endif
+
+    for (; i < inLength; ++i)
+    {
+        if (isNop(inData[i]) && !isNop(inData[i - 1]))
+            ++numStarts;
+    }
+
+    return numStarts;
+}
+
+#pragma mark -
+
+OpcodeCensusLogger::OpcodeCensusLogger()
+: mLastRegionsRecounted(0)
+{
+}
+
+void
+OpcodeCensusLogger::collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const World* inWorld)
+{
+    mLastRegionsRecounted = mCensus.update(*inWorld->soup());
+}
+
+} // namespace MacTierra
@@ -0,0 +1,101 @@
+/*
+ *  MT_OpcodeCensus.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_OpcodeCensus_h
+#define MT_OpcodeCensus_h
+
+#include <vector>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+#include "MT_DataCollection.h"
+#include "MT_InstructionSet.h"
+
+namespace MacTierra {
+
+class Soup;
+
+// How often each instruction occurs in the soup, and how many nop templates (runs of nop_0
+// and nop_1) there are.
+//
+// Counts are kept for each of the soup's write regions, so an update only recounts the
+// regions that have been written since the last one. For a large soup, most regions are
+// untouched between collections.
+class OpcodeCensus : Noncopyable
+{
+public:
+
+    struct Counts
+    {
+        Counts();
+
+        u_int64_t   mInstructions[kInstructionSetSize];
+        u_int64_t   mTemplates;
+
+        u_int64_t   numCells() const;
+        void        add(const Counts& inCounts);
+        void        subtract(const Counts& inCounts);
+    };
+
+    OpcodeCensus();
+
+    // Recounts the regions written since the last update, or the whole soup if it's the
+    // first update, or a different soup. Returns the number of regions recounted.
+    u_int32_t       update(const Soup& inSoup);
+
+    const Counts&   totals() const          { return mTotals; }
+
+    double          instructionFraction(instruction_t inInstruction) const;
+    double          nopFraction() const;
+    // templates per cell
+    double          templateDensity() const;
+
+    // Counts for the cells from inStart for inLength, widened to whole write regions.
+    Counts          regionCounts(address_t inStart, u_int32_t inLength) const;
+
+    // The counting kernels. outCounts is added to. A template starts at a nop that doesn't
+    // follow another nop; inPrevious is the instruction before inData.
+    static void     countInstructions(const instruction_t* inData, size_t inLength, Counts& outCounts);
+    static u_int64_t countTemplateStarts(const instruction_t* inData, size_t inLength, instruction_t inPrevious);
+
+protected:
+
+    void            recountRegion(const Soup& inSoup, u_int32_t inRegion);
+
+protected:
+
+    const Soup*             mSoup;          // at the last update
+    std::vector<Counts>     mRegionCounts;
+    std::vector<u_int32_t>  mRegionWrites;  // as seen at the last update
+    Counts                  mTotals;
+};
+
+// Keeps an OpcodeCensus up to date at each collection.
+class OpcodeCensusLogger : public DataLogger
+{
+public:
+    OpcodeCensusLogger();
+
+    const OpcodeCensus& census() const      { return mCensus; }
+    u_int32_t       lastRegionsRecounted() const    { return mLastRegionsRecounted; }
+
+protected:
+
+    virtual void    collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const World* inWorld);
+
+protected:
+
+    OpcodeCensus    mCensus;
+    u_int32_t       mLastRegionsRecounted;
+};
+
+} // namespace MacTierra
+
+#endif // MT_OpcodeCensus_h
@@ -0,0 +1,216 @@
+/*
+ *  MT_PopulationSample.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <math.h>
+
+#include <algorithm>
+#include <map>
+
+#include "MT_PopulationSample.h"
+
+#include "MT_Creature.h"
+#include "MT_Inventory.h"
+#include "MT_TimeSlicer.h"
+#include "MT_World.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+// z value for a 95% confidence interval
+static const double kConfidenceZ = 1.96;
+
+// mixed into the seed so that the sampling stream differs from the world's
+static const u_int32_t kSamplingStreamID = 0x73616d70;
+
+PopulationSample::PopulationSample()
+: mRNG(0)
+, mSampleSize(0)
+, mPopulationSize(0)
+, mSampleInstructions(0)
+{
+}
+
+void
+PopulationSample::setRandomSeed(u_int32_t inSeed)
+{
+    std::vector<u_int32_t> seed;
+    seed.push_back(inSeed);
+    seed.push_back(kSamplingStreamID);
+    mRNG.Reseed(seed);
+}
+
+void
+PopulationSample::takeSample(const World& inWorld)
+{
+    const SlicerList& slicerList = inWorld.timeSlicer().slicerList();
+
+    mCreatures.clear();
+    mPopulationSize = slicerList.size();
+    mSampleInstructions = inWorld.timeSlicer().instructionsExecuted();
+
+    if (mSampleSize == 0)
+        return;
+
+    mCreatures.reserve(min(mSampleSize, mPopulationSize));
+
+    SlicerList::const_iterator it = slicerList.cbegin(), end = slicerList.cend();
+    while (it != end && mCreatures.size() < mSampleSize)
+    {
+        mCreatures.push_back(&(*it));
+        ++it;
+    }
+
+    if (it == end)
+        return;
+
+    // Li's "Algorithm L": skip ahead by a geometric number of items between replacements,
+    // so we only call the random number generator O(k log(N/k)) times.
+    double w = exp(log(mRNG.FixedO()) / mSampleSize);
+    while (true)
+    {
+        u_int64_t skip = static_cast<u_int64_t>(floor(log(mRNG.FixedO()) / log(1.0 - w)));
+        for (u_int64_t i = 0; i < skip && it != end; ++i)
+            ++it;
+
+        if (it == end)
+            break;
+
+        mCreatures[mRNG.Integer(mSampleSize)] = &(*it);
+        ++it;
+        w *= exp(log(mRNG.FixedO()) / mSampleSize);
+    }
+}
+
+SampleEstimate
+PopulationSample::size() const
+{
+    std::vector<double> values;
+    values.reserve(mCreatures.size());
+    for (CreatureVector::const_iterator it = mCreatures.begin(); it != mCreatures.end(); ++it)
+        values.push_back((*it)->length());
+
+    return estimateFromValues(values);
+}
+
+SampleEstimate
+PopulationSample::age() const
+{
+    std::vector<double> values;
+    values.reserve(mCreatures.size());
+    for (CreatureVector::const_iterator it = mCreatures.begin(); it != mCreatures.end(); ++it)
+        values.push_back((double)(mSampleInstructions - (*it)->originInstructions()));
+
+    return estimateFromValues(values);
+}
+
+SampleEstimate
+PopulationSample::errorRate() const
+{
+    std::vector<double> values;
+    values.reserve(mCreatures.size());
+    for (CreatureVector::const_iterator it = mCreatures.begin(); it != mCreatures.end(); ++it)
+    {
+        const Creature* curCreature = *it;
+        u_int64_t instructions = curCreature->totalInstructionsExecuted();
+        values.push_back(instructions ? (double)curCreature->numErrors() / instructions : 0.0);
+    }
+
+    return estimateFromValues(values);
+}
+
+struct GenotypeFrequencyCompare
+{
+    bool operator()(const GenotypeFrequencyEstimate& inLHS, const GenotypeFrequencyEstimate& inRHS) const
+    {
+        if (inLHS.mSampleCount != inRHS.mSampleCount)
+            return inLHS.mSampleCount > inRHS.mSampleCount;
+        return inLHS.mGenotype->name() < inRHS.mGenotype->name();
+    }
+};
+
+void
+PopulationSample::genotypeFrequencies(u_int32_t inMaxGenotypes, GenotypeFrequencyVector& outFrequencies) const
+{
+    outFrequencies.clear();
+
+    typedef std::map<const InventoryGenotype*, u_int32_t> GenotypeCountMap;
+    GenotypeCountMap genotypeCounts;
+    for (CreatureVector::const_iterator it = mCreatures.begin(); it != mCreatures.end(); ++it)
+    {
+        const Creature* curCreature = *it;
+        // diverged creatures aren't counted as members of their genotype
+        if (curCreature->genotype() && curCreature->genotypeDivergence() == 0)
+            ++genotypeCounts[curCreature->genotype()];
+    }
+
+    for (GenotypeCountMap::const_iterator it = genotypeCounts.begin(); it != genotypeCounts.end(); ++it)
+    {
+        GenotypeFrequencyEstimate curEstimate;
+        curEstimate.mGenotype = it->first;
+        curEstimate.mSampleCount = it->second;
+        curEstimate.mFrequency = estimateProportion(it->second);
+        outFrequencies.push_back(curEstimate);
+    }
+
+    sort(outFrequencies.begin(), outFrequencies.end(), GenotypeFrequencyCompare());
+    if (outFrequencies.size() > inMaxGenotypes)
+        outFrequencies.resize(inMaxGenotypes);
+}
+
+SampleEstimate
+PopulationSample::estimateFromValues(const std::vector<double>& inValues) const
+{
+    SampleEstimate estimate;
+    const size_t n = inValues.size();
+    if (n == 0)
+        return estimate;
+
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i)
+        total += inValues[i];
+    estimate.mMean = total / n;
+
+    if (n > 1)
+    {
+        double sumSquares = 0.0;
+        for (size_t i = 0; i < n; ++i)
+            sumSquares += (inValues[i] - estimate.mMean) * (inValues[i] - estimate.mMean);
+
+        double variance = sumSquares / (n - 1);
+        estimate.mHalfWidth = kConfidenceZ * sqrt(variance / n) * finitePopulationCorrection();
+    }
+    return estimate;
+}
+
+SampleEstimate
+PopulationSample::estimateProportion(u_int32_t inCount) const
+{
+    SampleEstimate estimate;
+    const size_t n = mCreatures.size();
+    if (n == 0)
+        return estimate;
+
+    double p = (double)inCount / n;
+    estimate.mMean = p;
+    estimate.mHalfWidth = kConfidenceZ * sqrt(p * (1.0 - p) / n) * finitePopulationCorrection();
+    return estimate;
+}
+
+double
+PopulationSample::finitePopulationCorrection() const
+{
+    // a sample of the whole population has no sampling error
+    if (mPopulationSize <= 1 || mCreatures.size() >= mPopulationSize)
+        return 0.0;
+
+    return sqrt((double)(mPopulationSize - mCreatures.size()) / (mPopulationSize - 1));
+}
+
+} // namespace MacTierra
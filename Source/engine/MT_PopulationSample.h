@@ -0,0 +1,99 @@
+/*
+ *  MT_PopulationSample.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_PopulationSample_h
+#define MT_PopulationSample_h
+
+#include <vector>
+
+#include <wtf/Noncopyable.h>
+
+#define HAVE_BOOST_SERIALIZATION 1
+#include <RandomLib/Random.hpp>
+
+#include "MT_Engine.h"
+
+namespace MacTierra {
+
+class Creature;
+class InventoryGenotype;
+class World;
+
+// An estimate of a population mean, with the half-width of its 95% confidence interval.
+struct SampleEstimate
+{
+    SampleEstimate()
+    : mMean(0.0)
+    , mHalfWidth(0.0)
+    {
+    }
+
+    double      lower() const   { return mMean - mHalfWidth; }
+    double      upper() const   { return mMean + mHalfWidth; }
+
+    double      mMean;
+    double      mHalfWidth;
+};
+
+struct GenotypeFrequencyEstimate
+{
+    const InventoryGenotype*    mGenotype;
+    u_int32_t                   mSampleCount;
+    SampleEstimate              mFrequency;     // proportion of the population
+};
+
+// A uniform random sample of the adult creatures, for data loggers that can make do with
+// estimates. It uses its own random number generator, so taking a sample doesn't change
+// the course of the simulation. The creature pointers are only valid until the world runs again.
+class PopulationSample : Noncopyable
+{
+public:
+    typedef std::vector<const Creature*> CreatureVector;
+    typedef std::vector<GenotypeFrequencyEstimate> GenotypeFrequencyVector;
+
+    PopulationSample();
+
+    u_int32_t       sampleSize() const      { return mSampleSize; }
+    void            setSampleSize(u_int32_t inSize)     { mSampleSize = inSize; }
+
+    void            setRandomSeed(u_int32_t inSeed);
+
+    // Reservoir-sample the slicer list.
+    void            takeSample(const World& inWorld);
+
+    u_int32_t       populationSize() const  { return mPopulationSize; }
+    u_int32_t       numSampled() const      { return mCreatures.size(); }
+    const CreatureVector& creatures() const { return mCreatures; }
+
+    SampleEstimate  size() const;
+    SampleEstimate  age() const;            // instructions since birth
+    SampleEstimate  errorRate() const;      // errors per instruction executed
+
+    // The most common genotypes in the sample, most common first.
+    void            genotypeFrequencies(u_int32_t inMaxGenotypes, GenotypeFrequencyVector& outFrequencies) const;
+
+protected:
+
+    SampleEstimate  estimateFromValues(const std::vector<double>& inValues) const;
+    SampleEstimate  estimateProportion(u_int32_t inCount) const;
+    double          finitePopulationCorrection() const;
+
+protected:
+
+    RandomLib::Random   mRNG;
+
+    u_int32_t       mSampleSize;
+    u_int32_t       mPopulationSize;
+    u_int64_t       mSampleInstructions;
+    CreatureVector  mCreatures;
+};
+
+} // namespace MacTierra
+
+#endif // MT_PopulationSample_h
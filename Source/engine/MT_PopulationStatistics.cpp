@@ -0,0 +1,240 @@
+/*
+ *  MT_PopulationStatistics.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <math.h>
+
+#include <boost/assert.hpp>
+
+#include "MT_PopulationStatistics.h"
+
+#include "MT_Creature.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+static inline double nLogN(u_int32_t inCount)
+{
+    return (inCount > 1) ? inCount * log((double)inCount) : 0.0;
+}
+
+void
+PopulationStatistics::WideSum::square(u_int64_t inValue, u_int64_t& outHigh, u_int64_t& outLow)
+{
+    u_int64_t lowHalf = inValue & 0xFFFFFFFFULL;
+    u_int64_t highHalf = inValue >> 32;
+
+    u_int64_t lowLow = lowHalf * lowHalf;
+    u_int64_t cross = lowHalf * highHalf;
+    u_int64_t highHigh = highHalf * highHalf;
+
+    // (h.2^32 + l)^2 = h^2.2^64 + 2hl.2^32 + l^2
+    u_int64_t middle = (lowLow >> 32) + (cross & 0xFFFFFFFFULL) * 2;
+    outLow = (middle << 32) | (lowLow & 0xFFFFFFFFULL);
+    outHigh = highHigh + (cross >> 32) * 2 + (middle >> 32);
+}
+
+void
+PopulationStatistics::WideSum::addSquare(u_int64_t inValue)
+{
+    u_int64_t high, low;
+    square(inValue, high, low);
+
+    u_int64_t newLow = mLow + low;
+    mHigh += high + (newLow < mLow ? 1 : 0);
+    mLow = newLow;
+}
+
+void
+PopulationStatistics::WideSum::subtractSquare(u_int64_t inValue)
+{
+    u_int64_t high, low;
+    square(inValue, high, low);
+
+    u_int64_t newLow = mLow - low;
+    mHigh -= high + (newLow > mLow ? 1 : 0);
+    mLow = newLow;
+}
+
+double
+PopulationStatistics::WideSum::value() const
+{
+    return ldexp((double)mHigh, 64) + (double)mLow;
+}
+
+#pragma mark -
+
+PopulationStatistics::PopulationStatistics()
+{
+    clear();
+}
+
+void
+PopulationStatistics::clear()
+{
+    mNumAdults = 0;
+    mTotalSize = 0;
+    mTotalSizeSquared = 0;
+    mSizeCounts.clear();
+
+    mTotalBirthInstructions = 0;
+    mTotalBirthInstructionsSquared.clear();
+
+    mTotalGenerations = 0;
+    mTotalGenerationsSquared = 0;
+
+    mGenotypeRichness = 0;
+    mNumGenotypedCreatures = 0;
+    mSumNLogN = 0.0;
+}
+
+void
+PopulationStatistics::creatureBorn(const Creature& inCreature)
+{
+    BOOST_ASSERT(!inCreature.isEmbryo());
+
+    u_int64_t size = inCreature.length();
+    ++mNumAdults;
+    mTotalSize += size;
+    mTotalSizeSquared += size * size;
+    ++mSizeCounts[inCreature.length()];
+
+    mTotalBirthInstructions += inCreature.originInstructions();
+    mTotalBirthInstructionsSquared.addSquare(inCreature.originInstructions());
+
+    u_int64_t generation = inCreature.generation();
+    mTotalGenerations += generation;
+    mTotalGenerationsSquared += generation * generation;
+}
+
+void
+PopulationStatistics::creatureDied(const Creature& inCreature)
+{
+    BOOST_ASSERT(mNumAdults > 0);
+
+    u_int64_t size = inCreature.length();
+    --mNumAdults;
+    mTotalSize -= size;
+    mTotalSizeSquared -= size * size;
+
+    SizeCountMap::iterator it = mSizeCounts.find(inCreature.length());
+    BOOST_ASSERT(it != mSizeCounts.end());
+    if (--it->second == 0)
+        mSizeCounts.erase(it);
+
+    mTotalBirthInstructions -= inCreature.originInstructions();
+    mTotalBirthInstructionsSquared.subtractSquare(inCreature.originInstructions());
+
+    u_int64_t generation = inCreature.generation();
+    mTotalGenerations -= generation;
+    mTotalGenerationsSquared -= generation * generation;
+}
+
+void
+PopulationStatistics::genotypeCountChanged(u_int32_t inOldCount, u_int32_t inNewCount)
+{
+    if (inOldCount == 0 && inNewCount > 0)
+        ++mGenotypeRichness;
+    else if (inOldCount > 0 && inNewCount == 0)
+        --mGenotypeRichness;
+
+    mNumGenotypedCreatures += inNewCount;
+    mNumGenotypedCreatures -= inOldCount;
+    mSumNLogN += nLogN(inNewCount) - nLogN(inOldCount);
+}
+
+double
+PopulationStatistics::meanSize() const
+{
+    return mNumAdults ? (double)mTotalSize / mNumAdults : 0.0;
+}
+
+double
+PopulationStatistics::sizeVariance() const
+{
+    if (mNumAdults == 0)
+        return 0.0;
+
+    double mean = meanSize();
+    return max((double)mTotalSizeSquared / mNumAdults - mean * mean, 0.0);
+}
+
+void
+PopulationStatistics::sizeHistogram(u_int32_t inNumBuckets, SizeBucketVector& outBuckets) const
+{
+    outBuckets.clear();
+    if (inNumBuckets == 0)
+        return;
+
+    u_int32_t minAdultSize = minSize();
+    u_int32_t sizeRange = max(maxSize() - minAdultSize, 1U);
+    u_int32_t bucketSize = ceil((double)sizeRange / inNumBuckets);
+
+    for (u_int32_t i = 0; i < inNumBuckets; ++i)
+    {
+        u_int32_t bucketStart   = minAdultSize + i * bucketSize;
+        u_int32_t bucketEnd     = bucketStart + bucketSize - 1;
+        outBuckets.push_back(SizeBucket(SizeRange(bucketStart, bucketEnd), 0));
+    }
+
+    for (SizeCountMap::const_iterator it = mSizeCounts.begin(), end = mSizeCounts.end(); it != end; ++it)
+    {
+        u_int32_t bucketIndex = min((it->first - minAdultSize) / bucketSize, inNumBuckets - 1);
+        outBuckets[bucketIndex].second += it->second;
+    }
+}
+
+double
+PopulationStatistics::meanAge(u_int64_t inCurrentInstructions) const
+{
+    if (mNumAdults == 0)
+        return 0.0;
+
+    return (double)inCurrentInstructions - (double)mTotalBirthInstructions / mNumAdults;
+}
+
+double
+PopulationStatistics::ageVariance() const
+{
+    if (mNumAdults == 0)
+        return 0.0;
+
+    // the variance of age is the variance of birth time
+    double meanBirth = (double)mTotalBirthInstructions / mNumAdults;
+    return max(mTotalBirthInstructionsSquared.value() / mNumAdults - meanBirth * meanBirth, 0.0);
+}
+
+double
+PopulationStatistics::meanGeneration() const
+{
+    return mNumAdults ? (double)mTotalGenerations / mNumAdults : 0.0;
+}
+
+double
+PopulationStatistics::generationVariance() const
+{
+    if (mNumAdults == 0)
+        return 0.0;
+
+    double mean = meanGeneration();
+    return max((double)mTotalGenerationsSquared / mNumAdults - mean * mean, 0.0);
+}
+
+double
+PopulationStatistics::shannonDiversity() const
+{
+    if (mNumGenotypedCreatures == 0)
+        return 0.0;
+
+    // H = -sum(p ln p) = ln(N) - sum(n ln n) / N
+    double total = (double)mNumGenotypedCreatures;
+    return max(log(total) - mSumNLogN / total, 0.0);
+}
+
+} // namespace MacTierra
@@ -0,0 +1,111 @@
+/*
+ *  MT_PopulationStatistics.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_PopulationStatistics_h
+#define MT_PopulationStatistics_h
+
+#include <map>
+#include <vector>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+
+namespace MacTierra {
+
+class Creature;
+
+// Running totals over the adult population, updated as creatures are born and die, so that
+// the data loggers don't have to walk the cell map or inventory. Not archived; the world
+// rebuilds it after loading.
+class PopulationStatistics : Noncopyable
+{
+public:
+    typedef std::map<u_int32_t, u_int32_t> SizeCountMap;      // length -> number of adults
+    typedef std::pair<u_int32_t, u_int32_t> SizeRange;
+    typedef std::pair<SizeRange, u_int32_t> SizeBucket;
+    typedef std::vector<SizeBucket> SizeBucketVector;
+
+    PopulationStatistics();
+
+    void            clear();
+
+    // Adults only; call after Creature::onBirth(), and before the creature is removed.
+    void            creatureBorn(const Creature& inCreature);
+    void            creatureDied(const Creature& inCreature);
+
+    // Called by the inventory when the number alive of some genotype changes.
+    void            genotypeCountChanged(u_int32_t inOldCount, u_int32_t inNewCount);
+
+    u_int32_t       numAdults() const           { return mNumAdults; }
+    u_int64_t       totalAdultSize() const      { return mTotalSize; }
+
+    double          meanSize() const;
+    double          sizeVariance() const;
+    u_int32_t       minSize() const             { return mSizeCounts.empty() ? 0 : mSizeCounts.begin()->first; }
+    u_int32_t       maxSize() const             { return mSizeCounts.empty() ? 0 : mSizeCounts.rbegin()->first; }
+
+    const SizeCountMap& sizeCounts() const      { return mSizeCounts; }
+
+    // Split the range of adult sizes into inNumBuckets equal buckets. Cost is proportional to the
+    // number of distinct sizes, not the number of creatures.
+    void            sizeHistogram(u_int32_t inNumBuckets, SizeBucketVector& outBuckets) const;
+
+    // Age is measured in instructions since birth.
+    double          meanAge(u_int64_t inCurrentInstructions) const;
+    double          ageVariance() const;
+
+    double          meanGeneration() const;
+    double          generationVariance() const;
+
+    // Genotype diversity, over creatures that are counted in the inventory.
+    u_int32_t       genotypeRichness() const    { return mGenotypeRichness; }
+    double          shannonDiversity() const;
+
+protected:
+
+    // Exact 128-bit sum of squares of 64-bit values, so that adding and removing
+    // birth times doesn't accumulate rounding errors.
+    class WideSum
+    {
+    public:
+        WideSum() : mHigh(0), mLow(0) {}
+
+        void        clear()     { mHigh = 0; mLow = 0; }
+        void        addSquare(u_int64_t inValue);
+        void        subtractSquare(u_int64_t inValue);
+        double      value() const;
+
+    private:
+        static void square(u_int64_t inValue, u_int64_t& outHigh, u_int64_t& outLow);
+
+        u_int64_t   mHigh;
+        u_int64_t   mLow;
+    };
+
+    u_int32_t       mNumAdults;
+
+    u_int64_t       mTotalSize;
+    u_int64_t       mTotalSizeSquared;
+    SizeCountMap    mSizeCounts;
+
+    u_int64_t       mTotalBirthInstructions;
+    WideSum         mTotalBirthInstructionsSquared;
+
+    u_int64_t       mTotalGenerations;
+    u_int64_t       mTotalGenerationsSquared;
+
+    u_int32_t       mGenotypeRichness;
+    u_int64_t       mNumGenotypedCreatures;
+    double          mSumNLogN;          // sum over genotypes of n ln(n)
+};
+
+} // namespace MacTierra
+
+#endif // MT_PopulationStatistics_h
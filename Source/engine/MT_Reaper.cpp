@@ -90,6 +90,14 @@ Reaper::conditionalMoveDown(Creature& inCreature)
     return false;
 }
 
+void
+Reaper::copyFrom(const Reaper& inReaper, const CreatureCopyMap& inCreatures)
+{
+    BOOST_ASSERT(mReaperList.empty());
+    for (ReaperList::const_iterator it = inReaper.mReaperList.cbegin(); it != inReaper.mReaperList.cend(); ++it)
+        mReaperList.push_back(*inCreatures.find(&(*it))->second);
+}
+
 Creature*
 Reaper::headCreature()
 {
@@ -43,8 +43,12 @@ public:
     Creature*   headCreature();
     
     void        reap();
+
+    // Takes on another reaper's order, with each creature replaced by its copy.
+    void        copyFrom(const Reaper& inReaper, const CreatureCopyMap& inCreatures);
     
     size_t      numberOfCreatures() const { return mReaperList.size(); }
+    const ReaperList& reaperList() const { return mReaperList; }
 
     void        printCreatures() const;
 
@@ -0,0 +1,122 @@
+/*
+ *  MT_RingBuffer.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_RingBuffer_h
+#define MT_RingBuffer_h
+
+#include <vector>
+
+#include <boost/assert.hpp>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+
+namespace MacTierra {
+
+// Fixed-capacity, lock-free ring for passing records from one producer thread (the engine)
+// to one consumer thread. Neither side ever blocks. T must be a plain-old-data type, because
+// with kDropOldest the consumer may copy a record while the producer overwrites it; such
+// copies are detected and thrown away.
+template <class T>
+class RingBuffer : Noncopyable
+{
+public:
+    enum EOverflowPolicy {
+        kDropOldest,        // a full ring discards its oldest record to make room
+        kRejectNewest       // a full ring refuses new records; push() returns false so the producer can back off
+    };
+
+    // inCapacity is rounded up to a power of two
+    RingBuffer(u_int32_t inCapacity, EOverflowPolicy inPolicy = kDropOldest)
+    : mPolicy(inPolicy)
+    , mReadIndex(0)
+    , mWriteIndex(0)
+    , mNumDropped(0)
+    {
+        u_int32_t capacity = 1;
+        while (capacity < inCapacity && capacity < 0x80000000U)
+            capacity <<= 1;
+
+        mBuffer.resize(capacity);
+        mMask = capacity - 1;
+    }
+
+    u_int32_t       capacity() const        { return mMask + 1; }
+    EOverflowPolicy overflowPolicy() const  { return mPolicy; }
+
+    // Only an estimate while the other thread is running.
+    u_int32_t       size() const            { return mWriteIndex - mReadIndex; }
+    bool            empty() const           { return size() == 0; }
+
+    // Records dropped or refused because the ring was full.
+    u_int32_t       numDropped() const      { return mNumDropped; }
+
+    // Producer thread only.
+    bool            push(const T& inRecord)
+    {
+        u_int32_t writeIndex = mWriteIndex;
+        u_int32_t readIndex = mReadIndex;
+
+        if (writeIndex - readIndex > mMask)
+        {
+            if (mPolicy == kRejectNewest)
+            {
+                ++mNumDropped;
+                return false;
+            }
+
+            // If this fails the consumer just took the oldest record, which also makes room.
+            if (__sync_bool_compare_and_swap(&mReadIndex, readIndex, readIndex + 1))
+                ++mNumDropped;
+        }
+
+        mBuffer[writeIndex & mMask] = inRecord;
+        __sync_synchronize();       // make the record visible before the index
+        mWriteIndex = writeIndex + 1;
+        return true;
+    }
+
+    // Consumer thread only.
+    bool            pop(T& outRecord)
+    {
+        while (true)
+        {
+            u_int32_t readIndex = mReadIndex;
+            if (readIndex == mWriteIndex)
+                return false;
+
+            __sync_synchronize();   // don't read the record before the index
+            T record = mBuffer[readIndex & mMask];
+
+            // Claim it; if the producer dropped this record while we were copying, try the next one.
+            if (__sync_bool_compare_and_swap(&mReadIndex, readIndex, readIndex + 1))
+            {
+                outRecord = record;
+                return true;
+            }
+        }
+    }
+
+protected:
+
+    std::vector<T>      mBuffer;
+    u_int32_t           mMask;
+    EOverflowPolicy     mPolicy;
+
+    // Free-running counters; only their difference matters.
+    volatile u_int32_t  mReadIndex;
+    volatile u_int32_t  mWriteIndex;
+
+    volatile u_int32_t  mNumDropped;
+};
+
+} // namespace MacTierra
+
+#endif // MT_RingBuffer_h
@@ -35,6 +35,8 @@ Settings::Settings()
 , mClearReapedCreatures(false)
 , mSelectForLeanness(false)
 , mDaughterAllocation(kPreferredAlloc)
+, mNumShards(1)
+, mShardEpochLength(50000)
 {
 }
 
@@ -59,6 +61,14 @@ Settings::setCopyErrorRate(double inRate)
     mMeanCopyErrorInterval = (inRate > 0.0) ? 1.0 / inRate : 0.0;
 }
 
+void
+Settings::scaleMutationRates(double inScale, u_int32_t inSoupSize)
+{
+    setFlawRate(mFlawRate * inScale);
+    setCosmicRate(mCosmicRate * inScale, inSoupSize);
+    setCopyErrorRate(mCopyErrorRate * inScale);
+}
+
 bool
 Settings::globalWritesAllowed() const
 {
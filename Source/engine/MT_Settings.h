@@ -10,8 +10,11 @@
 #ifndef MT_Settings_h
 #define MT_Settings_h
 
+#include <algorithm>
+
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/version.hpp>
 
 #include "MT_Engine.h"
 
@@ -74,6 +77,9 @@ public:
     void            setCopyErrorRate(double inRate);
     double          meanCopyErrorInterval() const  { return mMeanCopyErrorInterval; }
 
+    // Multiplies the flaw, cosmic ray and copy error rates.
+    void            scaleMutationRates(double inScale, u_int32_t inSoupSize);
+
     enum EMutationType {
         kAddOrDec,
         kBitFlip,
@@ -108,6 +114,16 @@ public:
     bool            selectForLeanness() const    { return mSelectForLeanness; }
     void            setSelectForLeanness(bool inSet) { mSelectForLeanness = inSet; }
 
+    // More than one shard splits the soup into that many address ranges, run on separate threads
+    // (see MT_ShardedExecution.h). Each shard runs shardEpochLength() instructions between the
+    // barriers where the shards exchange their effects on each other. Both change the course of
+    // a run, so they are archived.
+    u_int32_t       numShards() const               { return mNumShards; }
+    void            setNumShards(u_int32_t inShards) { mNumShards = std::max(inShards, 1U); }
+
+    u_int32_t       shardEpochLength() const        { return mShardEpochLength; }
+    void            setShardEpochLength(u_int32_t inInstructions) { mShardEpochLength = std::max(inInstructions, 1U); }
+
     void            recomputeMutationIntervals(u_int32_t inSoupSize);
     
 private:
@@ -137,6 +153,12 @@ private:
         ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("select_for_leanness", mSelectForLeanness);
 
         ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("daughter_allocation_type", mDaughterAllocation);
+
+        if (version > 0)
+        {
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("num_shards", mNumShards);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("shard_epoch_length", mShardEpochLength);
+        }
     }
 
 protected:
@@ -170,9 +192,14 @@ protected:
     
     EDaughterAllocationStrategy mDaughterAllocation;
 
+    u_int32_t       mNumShards;
+    u_int32_t       mShardEpochLength;          // instructions per shard between barriers
 };
 
 
 } // namespace MacTierra
 
+// version 1 added the shard settings
+BOOST_CLASS_VERSION(MacTierra::Settings, 1)
+
 #endif // MT_Settings_h
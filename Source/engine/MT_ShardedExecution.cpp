@@ -0,0 +1,593 @@
+/*
+ *  MT_ShardedExecution.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <algorithm>
+
+#include <boost/thread.hpp>
+
+#include "RandomLib/ExponentialDistribution.hpp"
+
+#include "MT_ShardedExecution.h"
+
+#include "MT_AnalysisPool.h"
+#include "MT_CellMap.h"
+#include "MT_Creature.h"
+#include "MT_DataCollection.h"
+#include "MT_InstructionSet.h"
+#include "MT_World.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+// Runs one shard's epoch.
+class ShardTask : public AnalysisPool::Task
+{
+public:
+    ShardTask(Shard& inShard)
+    : mShard(inShard)
+    {
+    }
+
+    virtual void run()
+    {
+        mShard.run();
+    }
+
+protected:
+    Shard&  mShard;
+};
+
+Shard::Shard(World& inWorld, u_int32_t inFirstRegion, u_int32_t inEndRegion)
+: mWorld(inWorld)
+, mFirstRegion(inFirstRegion)
+, mEndRegion(inEndRegion)
+, mStart(inFirstRegion << Soup::kWriteRegionShift)
+, mEnd(min(inEndRegion << Soup::kWriteRegionShift, inWorld.soupSize()))
+, mSoupCopy(inWorld.soupSize())
+, mTimeSlicer(&inWorld)
+, mRNG(0)
+, mInstructionBudget(0)
+, mInstructionsRun(0)
+, mStartCycle(0)
+, mCurCreatureCycles(0)
+, mCurCreatureSliceCycles(0)
+, mNextFlawInstruction(0)
+, mCopyErrorPending(false)
+, mCopiesSinceLastError(0)
+, mNextCopyError(0)
+{
+    // the first epoch copies the whole soup
+    mWorldWriteCounts = inWorld.soup()->regionWriteCounts();
+    for (size_t i = 0; i < mWorldWriteCounts.size(); ++i)
+        --mWorldWriteCounts[i];
+}
+
+Shard::~Shard()
+{
+}
+
+const Settings&
+Shard::settings() const
+{
+    return mWorld.settings();
+}
+
+CellMap*
+Shard::cellMap() const
+{
+    return mWorld.cellMap();
+}
+
+const WorldEvents&
+Shard::events() const
+{
+    return mWorld.events();
+}
+
+instruction_t
+Shard::mutateInstruction(instruction_t inInst, Settings::EMutationType inMutationType) const
+{
+    return World::mutateInstruction(inInst, inMutationType, mRNG);
+}
+
+void
+Shard::writeInstruction(address_t inAddress, instruction_t inInst)
+{
+    // we see our own writes everywhere, but the world only gets the remote ones at the barrier
+    mSoupCopy.setInstructionAtAddress(inAddress, inInst);
+
+    if (!ownsAddress(inAddress))
+    {
+        RemoteWrite remoteWrite;
+        remoteWrite.mAddress = inAddress;
+        remoteWrite.mInstruction = inInst;
+        mRemoteWrites.push_back(remoteWrite);
+    }
+}
+
+void
+Shard::sendMutationEvent(MutationEvent::EKind inKind, const Creature* inCreature, address_t inAddress,
+                         instruction_t inOldInstruction, instruction_t inNewInstruction)
+{
+    MutationEvent event;
+    event.mInstructions     = 0;
+    event.mKind             = inKind;
+    event.mCreatureID       = inCreature ? inCreature->creatureID() : 0;
+    event.mAddress          = inAddress;
+    event.mOldInstruction   = inOldInstruction;
+    event.mNewInstruction   = inNewInstruction;
+
+    mMutationEvents.push_back(event);
+}
+
+void
+Shard::startEpoch(u_int32_t inSeed, u_int64_t inBudget)
+{
+    const Soup& worldSoup = *mWorld.soup();
+    const vector<u_int32_t>& worldCounts = worldSoup.regionWriteCounts();
+    for (u_int32_t i = 0; i < worldCounts.size(); ++i)
+    {
+        if (worldCounts[i] != mWorldWriteCounts[i])
+        {
+            mSoupCopy.copyRegion(worldSoup, i);
+            mWorldWriteCounts[i] = worldCounts[i];
+        }
+    }
+    mCopyWriteCounts = mSoupCopy.regionWriteCounts();
+
+    mRNG.Reseed(inSeed);
+
+    mInstructionBudget = inBudget;
+    mInstructionsRun = 0;
+    mStartCycle = mTimeSlicer.cycleCount();
+    mCurCreatureCycles = 0;
+
+    const Settings& settings = mWorld.settings();
+    if (settings.flawRate() > 0.0)
+        computeNextInstructionFlaw();
+
+    mCopyErrorPending = false;
+    mCopiesSinceLastError = 0;
+    if (settings.copyErrorRate() > 0.0)
+        computeNextCopyError();
+}
+
+void
+Shard::run()
+{
+    const Settings& settings = mWorld.settings();
+
+    Creature* curCreature = mTimeSlicer.currentCreature();
+    while (curCreature && mInstructionsRun < mInstructionBudget)
+    {
+        if (mCurCreatureCycles == 0)
+            mCurCreatureSliceCycles = TimeSlicer::sizeForThisSlice(curCreature, settings.sliceSizeVariance(), mRNG);
+
+        if (mCurCreatureCycles < mCurCreatureSliceCycles)
+        {
+            // mal and divide wait for the barrier, and end the creature's time this epoch
+            const address_t ipAddress = curCreature->addressFromOffset(curCreature->cpu().instructionPointer());
+            const instruction_t nextInst = mSoupCopy.instructionAtAddress(ipAddress);
+            if (nextInst == k_mal || nextInst == k_divide)
+            {
+                mWaitingCreatures.push_back(curCreature);
+                mTimeSlicer.removeCreature(*curCreature);
+
+                curCreature = mTimeSlicer.currentCreature();
+                mCurCreatureCycles = 0;
+                continue;
+            }
+
+            int32_t flaw = 0;
+            if (settings.flawRate() > 0.0 && mInstructionsRun == mNextFlawInstruction)
+                flaw = instructionFlaw(*curCreature);
+
+            mExecution.executeInstruction(*curCreature, *this, flaw);
+
+            if (curCreature->cpu().flag())
+                mReaper.conditionalMoveUp(*curCreature);
+
+            if ((settings.copyErrorRate() > 0.0) && (curCreature->lastInstruction() == k_mov_iab))
+                noteInstructionCopy();
+
+            ++mCurCreatureCycles;
+            ++mInstructionsRun;
+        }
+        else
+        {
+            mTimeSlicer.advance();
+            curCreature = mTimeSlicer.currentCreature();
+            mCurCreatureCycles = 0;
+        }
+    }
+}
+
+void
+Shard::copyWritesToWorld(Soup& ioWorldSoup)
+{
+    const vector<u_int32_t>& copyCounts = mSoupCopy.regionWriteCounts();
+    for (u_int32_t i = mFirstRegion; i < mEndRegion; ++i)
+    {
+        if (copyCounts[i] != mCopyWriteCounts[i])
+        {
+            ioWorldSoup.copyRegion(mSoupCopy, i);
+            // we already have it, unless remote writes land in it too
+            mWorldWriteCounts[i] = ioWorldSoup.regionWriteCounts()[i];
+        }
+    }
+}
+
+int32_t
+Shard::instructionFlaw(const Creature& inCreature)
+{
+    int32_t theFlaw = mRNG.Boolean() ? 1 : -1;
+
+    if (events().wantsMutations())
+    {
+        address_t flawAddress = inCreature.addressFromOffset(inCreature.cpu().instructionPointer());
+        instruction_t inst = mSoupCopy.instructionAtAddress(flawAddress);
+        sendMutationEvent(MutationEvent::kFlaw, &inCreature, flawAddress, inst, inst);
+    }
+
+    computeNextInstructionFlaw();
+    return theFlaw;
+}
+
+void
+Shard::computeNextInstructionFlaw()
+{
+    RandomLib::ExponentialDistribution<double> expDist;
+    int64_t flawDelay;
+    do
+    {
+        flawDelay = static_cast<int64_t>(expDist(mRNG, settings().meanFlawInterval()));
+    } while (flawDelay <= 0);
+
+    mNextFlawInstruction = mInstructionsRun + flawDelay;
+}
+
+void
+Shard::noteInstructionCopy()
+{
+    if (mCopyErrorPending)  // just did one
+    {
+        computeNextCopyError();
+        mCopiesSinceLastError = 0;
+        mCopyErrorPending = false;
+    }
+    else
+    {
+        ++mCopiesSinceLastError;
+        mCopyErrorPending = (mCopiesSinceLastError >= mNextCopyError);
+    }
+}
+
+void
+Shard::computeNextCopyError()
+{
+    RandomLib::ExponentialDistribution<double> expDist;
+    int32_t copyErrorDelay;
+    do
+    {
+        copyErrorDelay = expDist(mRNG, settings().meanCopyErrorInterval());
+    } while (copyErrorDelay <= 0);
+
+    mNextCopyError = copyErrorDelay;
+}
+
+#pragma mark -
+
+ShardedExecution::ShardedExecution(World& inWorld, u_int32_t inNumShards, u_int32_t inNumThreads)
+: mWorld(inWorld)
+, mPool(NULL)
+, mNumEpochs(0)
+, mNumRemoteWrites(0)
+, mNumWaitingInstructions(0)
+{
+    const u_int32_t numRegions = inWorld.soup()->numWriteRegions();
+    const u_int32_t numShards = max(min(inNumShards, numRegions), 1U);
+
+    mRegionShards.resize(numRegions);
+    for (u_int32_t i = 0; i < numShards; ++i)
+    {
+        const u_int32_t firstRegion = static_cast<u_int64_t>(i) * numRegions / numShards;
+        const u_int32_t endRegion = static_cast<u_int64_t>(i + 1) * numRegions / numShards;
+        mShards.push_back(new Shard(inWorld, firstRegion, endRegion));
+
+        for (u_int32_t j = firstRegion; j < endRegion; ++j)
+            mRegionShards[j] = i;
+    }
+
+    u_int32_t numThreads = inNumThreads > 0 ? inNumThreads : boost::thread::hardware_concurrency();
+    numThreads = min(numThreads, numShards);
+    if (numThreads > 1)
+        mPool = new AnalysisPool(numThreads);
+}
+
+ShardedExecution::~ShardedExecution()
+{
+    delete mPool;
+
+    for (size_t i = 0; i < mShards.size(); ++i)
+        delete mShards[i];
+}
+
+u_int32_t
+ShardedExecution::numThreads() const
+{
+    return mPool ? mPool->numThreads() : 1;
+}
+
+u_int32_t
+ShardedExecution::shardForAddress(address_t inAddress) const
+{
+    return mRegionShards[inAddress >> Soup::kWriteRegionShift];
+}
+
+// Epochs end at whole multiples of the epoch length, counted in the world's instructions. What's
+// left over that falls short of the next one is owed until a later call makes up the epoch, so
+// the run doesn't depend on how it is split into calls.
+void
+ShardedExecution::iterate(u_int32_t inNumCycles)
+{
+    const u_int64_t epochInstructions = static_cast<u_int64_t>(mWorld.settings().shardEpochLength()) * mShards.size();
+
+    mWorld.mShardInstructionsOwed += inNumCycles;
+    while (true)
+    {
+        const u_int64_t instructionCount = mWorld.mTimeSlicer.instructionsExecuted();
+        const u_int64_t epochRemaining = epochInstructions - instructionCount % epochInstructions;
+        if (epochRemaining > mWorld.mShardInstructionsOwed)
+            break;
+
+        // short if every creature waits at the barrier, in which case the next one finishes the epoch
+        const u_int64_t instructionsRun = runEpoch(epochRemaining);
+        if (instructionsRun == 0)
+        {
+            mWorld.mShardInstructionsOwed = 0;      // nothing alive
+            break;
+        }
+
+        mWorld.mShardInstructionsOwed -= instructionsRun;
+    }
+
+    mWorld.mCurCreatureCycles = 0;
+}
+
+u_int64_t
+ShardedExecution::runEpoch(u_int64_t inMaxInstructions)
+{
+    distributeCreatures(inMaxInstructions);
+
+    vector<Shard*> busyShards;
+    for (size_t i = 0; i < mShards.size(); ++i)
+    {
+        if (mShards[i]->mInstructionBudget > 0)
+            busyShards.push_back(mShards[i]);
+    }
+
+    if (mPool && busyShards.size() > 1)
+    {
+        vector<ShardTask*> tasks;
+        for (size_t i = 0; i < busyShards.size(); ++i)
+        {
+            tasks.push_back(new ShardTask(*busyShards[i]));
+            mPool->submit(tasks.back());
+        }
+
+        mPool->waitForAll();
+
+        for (size_t i = 0; i < tasks.size(); ++i)
+            delete tasks[i];
+    }
+    else
+    {
+        for (size_t i = 0; i < busyShards.size(); ++i)
+            busyShards[i]->run();
+    }
+
+    // the barrier
+    u_int64_t instructionsRun = 0;
+    u_int64_t cyclesRun = 0;
+    for (size_t i = 0; i < mShards.size(); ++i)
+    {
+        instructionsRun += mShards[i]->mInstructionsRun;
+        cyclesRun = max(cyclesRun, mShards[i]->mTimeSlicer.cycleCount() - mShards[i]->mStartCycle);
+    }
+
+    gatherCreatures();
+    exchangeWrites();
+
+    mWorld.mTimeSlicer.addExecuted(instructionsRun, cyclesRun);
+    sendMutationEvents();
+
+    instructionsRun += runWaitingInstructions(inMaxInstructions - instructionsRun);
+
+    finishEpoch();
+
+    ++mNumEpochs;
+    return instructionsRun;
+}
+
+// Moves the creatures from the world's slicer and reaper to those of their shards, and shares
+// out the epoch's instructions.
+void
+ShardedExecution::distributeCreatures(u_int64_t inMaxInstructions)
+{
+    vector<u_int32_t> shardPopulations(mShards.size(), 0);
+
+    mSlicerOrder.clear();
+    mSlicerShards.clear();
+    mWorld.mTimeSlicer.removeAllCreatures(mSlicerOrder);
+    for (size_t i = 0; i < mSlicerOrder.size(); ++i)
+    {
+        Creature* curCreature = mSlicerOrder[i];
+        const u_int32_t shardIndex = shardForAddress(curCreature->location());
+        mShards[shardIndex]->mTimeSlicer.insertCreature(*curCreature);
+        mSlicerShards.push_back(shardIndex);
+        ++shardPopulations[shardIndex];
+    }
+
+    mReaperOrder.clear();
+    mReaperShards.clear();
+    while (Creature* curCreature = mWorld.mReaper.headCreature())
+    {
+        mWorld.mReaper.removeCreature(*curCreature);
+
+        const u_int32_t shardIndex = shardForAddress(curCreature->location());
+        mShards[shardIndex]->mReaper.addCreature(*curCreature);
+        mReaperOrder.push_back(curCreature);
+        mReaperShards.push_back(shardIndex);
+    }
+
+    // in proportion to population, with what's left over going to the first shards with any
+    const u_int64_t numCreatures = mSlicerOrder.size();
+    vector<u_int64_t> budgets(mShards.size(), 0);
+    u_int64_t leftOver = inMaxInstructions;
+    for (size_t i = 0; i < mShards.size() && numCreatures > 0; ++i)
+    {
+        budgets[i] = inMaxInstructions * shardPopulations[i] / numCreatures;
+        leftOver -= budgets[i];
+    }
+
+    for (size_t i = 0; i < mShards.size() && leftOver > 0; ++i)
+    {
+        if (shardPopulations[i] > 0)
+        {
+            ++budgets[i];
+            --leftOver;
+        }
+    }
+
+    for (size_t i = 0; i < mShards.size(); ++i)
+        mShards[i]->startEpoch(mWorld.mRNG.Integer<u_int32_t>(), budgets[i]);
+}
+
+// Puts the creatures back in the world's slicer and reaper. Each creature takes one of the places
+// its shard's creatures had at the start of the epoch, in the order the shard now has them; those
+// that stopped at mal or divide go after the shard's others in the slicer.
+void
+ShardedExecution::gatherCreatures()
+{
+    vector<vector<Creature*> > shardSlicerOrders(mShards.size());
+    vector<vector<Creature*> > shardReaperOrders(mShards.size());
+
+    for (size_t i = 0; i < mShards.size(); ++i)
+    {
+        Shard* curShard = mShards[i];
+        curShard->mTimeSlicer.removeAllCreatures(shardSlicerOrders[i]);
+        shardSlicerOrders[i].insert(shardSlicerOrders[i].end(), curShard->mWaitingCreatures.begin(), curShard->mWaitingCreatures.end());
+
+        while (Creature* curCreature = curShard->mReaper.headCreature())
+        {
+            curShard->mReaper.removeCreature(*curCreature);
+            shardReaperOrders[i].push_back(curCreature);
+        }
+    }
+
+    vector<size_t> nextIndex(mShards.size(), 0);
+    for (size_t i = 0; i < mSlicerOrder.size(); ++i)
+    {
+        const u_int32_t shardIndex = mSlicerShards[i];
+        mWorld.mTimeSlicer.insertCreature(*shardSlicerOrders[shardIndex][nextIndex[shardIndex]++]);
+    }
+
+    fill(nextIndex.begin(), nextIndex.end(), 0);
+    for (size_t i = 0; i < mReaperOrder.size(); ++i)
+    {
+        const u_int32_t shardIndex = mReaperShards[i];
+        mWorld.mReaper.addCreature(*shardReaperOrders[shardIndex][nextIndex[shardIndex]++]);
+    }
+}
+
+void
+ShardedExecution::exchangeWrites()
+{
+    Soup& worldSoup = *mWorld.soup();
+
+    for (size_t i = 0; i < mShards.size(); ++i)
+        mShards[i]->copyWritesToWorld(worldSoup);
+
+    // where shards wrote to the same cell, the last shard wins
+    for (size_t i = 0; i < mShards.size(); ++i)
+    {
+        vector<Shard::RemoteWrite>& remoteWrites = mShards[i]->mRemoteWrites;
+        for (size_t j = 0; j < remoteWrites.size(); ++j)
+            worldSoup.setInstructionAtAddress(remoteWrites[j].mAddress, remoteWrites[j].mInstruction);
+
+        mNumRemoteWrites += remoteWrites.size();
+        remoteWrites.clear();
+    }
+}
+
+u_int64_t
+ShardedExecution::runWaitingInstructions(u_int64_t inMaxInstructions)
+{
+    u_int64_t instructionsRun = 0;
+    for (size_t i = 0; i < mShards.size(); ++i)
+    {
+        vector<Creature*>& waitingCreatures = mShards[i]->mWaitingCreatures;
+        for (size_t j = 0; j < waitingCreatures.size() && instructionsRun < inMaxInstructions; ++j)
+        {
+            // any that don't get to run try again next epoch
+            mWorld.runInstruction(waitingCreatures[j], 0);
+            mWorld.mTimeSlicer.executedInstruction();
+            ++instructionsRun;
+        }
+        waitingCreatures.clear();
+    }
+
+    mNumWaitingInstructions += instructionsRun;
+    return instructionsRun;
+}
+
+void
+ShardedExecution::sendMutationEvents()
+{
+    for (size_t i = 0; i < mShards.size(); ++i)
+    {
+        vector<MutationEvent>& events = mShards[i]->mMutationEvents;
+        for (size_t j = 0; j < events.size(); ++j)
+        {
+            events[j].mInstructions = mWorld.mTimeSlicer.instructionsExecuted();
+            mWorld.mEvents.sendMutation(events[j]);
+        }
+        events.clear();
+    }
+}
+
+// What the serial world does along the way: reaping, cosmic rays and data collection.
+void
+ShardedExecution::finishEpoch()
+{
+    const Settings& settings = mWorld.settings();
+
+    while (mWorld.mCellMap->fullness() > settings.reapThreshold())
+    {
+        Creature* doomedCreature = mWorld.mReaper.headCreature();
+        if (!doomedCreature)
+            break;
+
+        mWorld.handleDeath(doomedCreature);
+    }
+
+    const u_int64_t instructionCount = mWorld.mTimeSlicer.instructionsExecuted();
+    while (settings.cosmicRate() > 0.0 && mWorld.mNextCosmicRayInstruction <= instructionCount)
+        mWorld.cosmicRay(mWorld.mNextCosmicRayInstruction);
+
+    DataCollector* collector = mWorld.dataCollector();
+    if (collector && collector->nextCollectionInstructions() <= instructionCount)
+        collector->collectPeriodicData(instructionCount, mWorld.mTimeSlicer.cycleCount(), &mWorld);
+
+    if (mWorld.timeForSlicerCycleDataCollection(mWorld.mTimeSlicer.cycleCount()))
+        collector->collectCyclicalData(instructionCount, mWorld.mTimeSlicer.cycleCount(), &mWorld);
+}
+
+} // namespace MacTierra
@@ -0,0 +1,211 @@
+/*
+ *  MT_ShardedExecution.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_ShardedExecution_h
+#define MT_ShardedExecution_h
+
+#include <vector>
+
+#include <wtf/Noncopyable.h>
+
+#define HAVE_BOOST_SERIALIZATION 1
+#include <RandomLib/Random.hpp>
+
+#include "MT_Engine.h"
+#include "MT_ExecutionUnit0.h"
+#include "MT_Reaper.h"
+#include "MT_Settings.h"
+#include "MT_Soup.h"
+#include "MT_TimeSlicer.h"
+#include "MT_WorldEvents.h"
+
+namespace MacTierra {
+
+class AnalysisPool;
+class CellMap;
+class Creature;
+class InteractionMatrix;
+class SoupHeatmap;
+class World;
+
+// One address range of a sharded world, and the creatures whose first cell is in it.
+//
+// While the shards run, each one stands in for the world as far as the execution unit is
+// concerned. A shard works on its own copy of the soup, in which it sees its own range as it
+// changes and the rest as it was at the last barrier; its writes outside its range are also
+// queued for the world. A creature that reaches mal or divide stops there until the barrier,
+// since both change the cell map and the inventory.
+class Shard : Noncopyable
+{
+public:
+
+    Shard(World& inWorld, u_int32_t inFirstRegion, u_int32_t inEndRegion);
+    ~Shard();
+
+    address_t       start() const       { return mStart; }
+    address_t       end() const         { return mEnd; }
+    bool            ownsAddress(address_t inAddress) const  { return inAddress >= mStart && inAddress < mEnd; }
+
+    // The world interface used by the execution unit.
+    const Settings& settings() const;
+    u_int32_t       soupSize() const    { return mSoupCopy.soupSize(); }
+    Soup*           soup()              { return &mSoupCopy; }
+    CellMap*        cellMap() const;
+    SoupHeatmap*    heatmap() const     { return NULL; }
+    InteractionMatrix* interactionMatrix() const    { return NULL; }
+
+    const WorldEvents&  events() const;
+
+    bool            copyErrorPending() const { return mCopyErrorPending; }
+    instruction_t   mutateInstruction(instruction_t inInst, Settings::EMutationType inMutationType) const;
+
+    void            writeInstruction(address_t inAddress, instruction_t inInst);
+
+    // Queued for the barrier, which stamps them with the world's instruction count.
+    void            sendMutationEvent(MutationEvent::EKind inKind, const Creature* inCreature, address_t inAddress,
+                                      instruction_t inOldInstruction, instruction_t inNewInstruction);
+
+protected:
+
+    friend class ShardedExecution;
+    friend class ShardTask;
+
+    struct RemoteWrite
+    {
+        address_t       mAddress;
+        instruction_t   mInstruction;
+    };
+
+    // Brings the copy of the soup up to date and gets ready to run inBudget instructions.
+    void            startEpoch(u_int32_t inSeed, u_int64_t inBudget);
+
+    // Called on a worker thread.
+    void            run();
+
+    // Copies the regions of our range that we wrote to into the world's soup.
+    void            copyWritesToWorld(Soup& ioWorldSoup);
+
+    int32_t         instructionFlaw(const Creature& inCreature);
+    void            computeNextInstructionFlaw();
+
+    void            noteInstructionCopy();
+    void            computeNextCopyError();
+
+protected:
+
+    World&          mWorld;
+
+    const u_int32_t mFirstRegion;
+    const u_int32_t mEndRegion;
+    const address_t mStart;
+    const address_t mEnd;
+
+    Soup            mSoupCopy;
+    std::vector<u_int32_t>  mWorldWriteCounts;  // the world's region counts when we last copied from it
+    std::vector<u_int32_t>  mCopyWriteCounts;   // ours at the same point, to find the regions we wrote
+
+    TimeSlicer      mTimeSlicer;
+    Reaper          mReaper;
+    ExecutionUnit0  mExecution;
+
+    mutable RandomLib::Random   mRNG;           // reseeded from the world's every epoch
+
+    // this epoch
+    u_int64_t       mInstructionBudget;
+    u_int64_t       mInstructionsRun;
+    u_int64_t       mStartCycle;
+
+    u_int32_t       mCurCreatureCycles;
+    u_int32_t       mCurCreatureSliceCycles;
+
+    u_int64_t       mNextFlawInstruction;
+
+    bool            mCopyErrorPending;
+    u_int32_t       mCopiesSinceLastError;
+    u_int32_t       mNextCopyError;
+
+    // for the barrier
+    std::vector<RemoteWrite>    mRemoteWrites;
+    std::vector<Creature*>      mWaitingCreatures;  // stopped at mal or divide, in the order they stopped
+    std::vector<MutationEvent>  mMutationEvents;
+};
+
+// Runs a world as shards on a pool of threads, for Settings::numShards() greater than one.
+//
+// The soup is split into that many address ranges, on write region boundaries, and each shard
+// time slices and reaper-orders its own creatures. The shards run in epochs of
+// Settings::shardEpochLength() instructions each, and the world's instructions are shared out
+// in proportion to their creatures. Epochs always end at multiples of that many instructions
+// per shard, so iterate() runs whole epochs, and whatever falls short of one is run by a later
+// call. At the barrier after each epoch, the world takes the
+// shards' messages in shard order: their writes outside their own range, then the mal and
+// divide instructions their creatures stopped at, then their mutation events. It then reaps,
+// throws cosmic rays and collects data, as a serial world would have along the way. The
+// cell map is only touched at barriers, so the shards share it.
+//
+// Between calls to iterate(), the world's slicer and reaper hold all the creatures, and it can be
+// saved, inspected or run serially as usual. A run depends on the seed and the shard settings,
+// but not on how it is split into calls to iterate(), or on the number of threads.
+class ShardedExecution : Noncopyable
+{
+public:
+
+    // 0 threads means one per processor. There are never more shards than write regions in
+    // the soup, or more threads than shards.
+    ShardedExecution(World& inWorld, u_int32_t inNumShards, u_int32_t inNumThreads = 0);
+    ~ShardedExecution();
+
+    u_int32_t       numShards() const       { return mShards.size(); }
+    u_int32_t       numThreads() const;
+
+    const Shard&    shard(u_int32_t inIndex) const  { return *mShards[inIndex]; }
+    u_int32_t       shardForAddress(address_t inAddress) const;
+
+    void            iterate(u_int32_t inNumCycles);
+
+    // Totals since creation.
+    u_int64_t       numEpochs() const           { return mNumEpochs; }
+    u_int64_t       numRemoteWrites() const     { return mNumRemoteWrites; }
+    u_int64_t       numWaitingInstructions() const  { return mNumWaitingInstructions; }
+
+protected:
+
+    // Returns the number of instructions run, at most inMaxInstructions.
+    u_int64_t       runEpoch(u_int64_t inMaxInstructions);
+
+    void            distributeCreatures(u_int64_t inMaxInstructions);
+    void            gatherCreatures();
+    void            exchangeWrites();
+    u_int64_t       runWaitingInstructions(u_int64_t inMaxInstructions);
+    void            sendMutationEvents();
+    void            finishEpoch();
+
+protected:
+
+    World&              mWorld;
+
+    std::vector<Shard*> mShards;
+    std::vector<u_int32_t>  mRegionShards;      // shard index for each write region
+
+    AnalysisPool*       mPool;                  // NULL for one thread
+
+    // the world's slicer and reaper orders when the epoch started, and each creature's shard
+    std::vector<Creature*>  mSlicerOrder;
+    std::vector<u_int32_t>  mSlicerShards;
+    std::vector<Creature*>  mReaperOrder;
+    std::vector<u_int32_t>  mReaperShards;
+
+    u_int64_t           mNumEpochs;
+    u_int64_t           mNumRemoteWrites;
+    u_int64_t           mNumWaitingInstructions;
+};
+
+} // namespace MacTierra
+
+#endif // MT_ShardedExecution_h
@@ -8,6 +8,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <new>
 
 #include <boost/assert.hpp>
@@ -30,6 +31,8 @@ Soup::Soup(u_int32_t inSize)
         // for a malloc failure.
         throw std::bad_alloc();
     }
+
+    mRegionWrites.resize((mSoupSize + writeRegionSize() - 1) >> kWriteRegionShift, 0);
 }
 
 Soup::~Soup()
@@ -43,7 +46,9 @@ Soup::seachForTemplate(ESearchDirection inDirection, address_t& ioOffset, u_int3
 {
     const int32_t kMaxTemplateLength = 10;
     
-    const address_t   templateAddr = ioOffset;
+    // callers pass the address after an instruction, which can be one past the end of the soup
+    const address_t   templateAddr = ioOffset % mSoupSize;
+    ioOffset = templateAddr;
     
     instruction_t   instTemplate[kMaxTemplateLength + 1];
     int32_t i;
@@ -87,9 +92,37 @@ Soup::setInstructionAtAddress(address_t inAddress, instruction_t inInst)
     if (inAddress < mSoupSize)
     {
         *(mSoup + inAddress) = inInst;
+        ++mRegionWrites[inAddress >> kWriteRegionShift];
     }
 }
 
+void
+Soup::copyRegion(const Soup& inSource, u_int32_t inRegion)
+{
+    BOOST_ASSERT(inSource.soupSize() == mSoupSize && inRegion < numWriteRegions());
+    const address_t regionStart = inRegion << kWriteRegionShift;
+    const u_int32_t regionLength = std::min(writeRegionSize(), mSoupSize - regionStart);
+
+    memcpy(mSoup + regionStart, inSource.soup() + regionStart, regionLength);
+    ++mRegionWrites[inRegion];
+}
+
+void
+Soup::copyFrom(const Soup& inSource)
+{
+    BOOST_ASSERT(inSource.soupSize() == mSoupSize);
+    memcpy(mSoup, inSource.soup(), mSoupSize);
+    mRegionWrites = inSource.regionWriteCounts();
+}
+
+void
+Soup::clear()
+{
+    memset(mSoup, 0, mSoupSize);
+    for (u_int32_t i = 0; i < numWriteRegions(); ++i)
+        ++mRegionWrites[i];
+}
+
 void
 Soup::injectInstructions(address_t inAddress, const instruction_t* inInstructions, u_int32_t inLength)
 {
@@ -17,6 +17,8 @@
 #include <boost/serialization/serialization.hpp>
 #include <boost/serialization/split_member.hpp>
 
+#include <vector>
+
 #include <wtf/Noncopyable.h>
 
 #include "MT_Engine.h"
@@ -49,6 +51,21 @@ public:
 
     bool            operator==(const Soup& inRHS) const;
 
+    // Every write is counted against the region of the soup it lands in, so that clients that
+    // scan the soup can skip the regions that haven't changed since they last looked. The counts
+    // only ever go up (until they wrap), so any number of clients can each keep their own copy.
+    enum { kWriteRegionShift = 12 };
+    static u_int32_t    writeRegionSize()   { return 1U << kWriteRegionShift; }
+    u_int32_t       numWriteRegions() const { return mRegionWrites.size(); }
+    const std::vector<u_int32_t>&   regionWriteCounts() const   { return mRegionWrites; }
+
+    // Copies one write region from a soup of the same size, counting it as a write.
+    void            copyRegion(const Soup& inSource, u_int32_t inRegion);
+    // Copies the whole of a soup of the same size, with its write counts.
+    void            copyFrom(const Soup& inSource);
+    // Zeroes the whole soup, counting it as a write to every region.
+    void            clear();
+
 protected:
 
     bool            searchForwardsForTemplate(const instruction_t* inTemplate, u_int32_t inTemplateLen, address_t& ioOffset);
@@ -82,6 +99,8 @@ protected:
     
     instruction_t*  mSoup;
 
+    std::vector<u_int32_t>  mRegionWrites;      // not archived
+
 };
 
 } // namespace MacTierra
@@ -0,0 +1,88 @@
+/*
+ *  MT_SoupHeatmap.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <algorithm>
+
+#include "MT_SoupHeatmap.h"
+
+#include "MT_Creature.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+SoupHeatmap::SoupHeatmap(u_int32_t inSoupSize, u_int32_t inBlockSize, u_int32_t inSampleInterval)
+: mSoupSize(inSoupSize)
+, mBlockSize(inBlockSize > 0 ? inBlockSize : static_cast<u_int32_t>(kDefaultBlockSize))
+, mSampleInterval(inSampleInterval > 0 ? inSampleInterval : 1)
+, mDecayFactor(0.5)
+, mFetchCountdown(mSampleInterval)
+, mWriteCountdown(mSampleInterval)
+{
+    const u_int32_t numBlocks = (mSoupSize + mBlockSize - 1) / mBlockSize;
+    mFetches.resize(numBlocks, 0.0);
+    mForeignFetches.resize(numBlocks, 0.0);
+    mWrites.resize(numBlocks, 0.0);
+}
+
+void
+SoupHeatmap::setDecayFactor(double inFactor)
+{
+    mDecayFactor = min(max(inFactor, 0.0), 1.0);
+}
+
+void
+SoupHeatmap::takeSnapshot(Snapshot& outSnapshot)
+{
+    outSnapshot.mBlockSize = mBlockSize;
+    outSnapshot.mFetches = mFetches;
+    outSnapshot.mForeignFetches = mForeignFetches;
+    outSnapshot.mWrites = mWrites;
+
+    for (u_int32_t i = 0; i < mFetches.size(); ++i)
+    {
+        mFetches[i] *= mDecayFactor;
+        mForeignFetches[i] *= mDecayFactor;
+        mWrites[i] *= mDecayFactor;
+    }
+}
+
+void
+SoupHeatmap::clear()
+{
+    fill(mFetches.begin(), mFetches.end(), 0.0);
+    fill(mForeignFetches.begin(), mForeignFetches.end(), 0.0);
+    fill(mWrites.begin(), mWrites.end(), 0.0);
+}
+
+void
+SoupHeatmap::countFetch(address_t inAddress, const Creature& inCreature)
+{
+    mFetchCountdown = mSampleInterval;
+
+    const u_int32_t block = inAddress / mBlockSize;
+    if (block >= mFetches.size())
+        return;
+
+    mFetches[block] += mSampleInterval;
+    if (!inCreature.containsAddress(inAddress, mSoupSize))
+        mForeignFetches[block] += mSampleInterval;
+}
+
+void
+SoupHeatmap::countWrite(address_t inAddress)
+{
+    mWriteCountdown = mSampleInterval;
+
+    const u_int32_t block = inAddress / mBlockSize;
+    if (block < mWrites.size())
+        mWrites[block] += mSampleInterval;
+}
+
+} // namespace MacTierra
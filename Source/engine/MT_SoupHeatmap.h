@@ -0,0 +1,99 @@
+/*
+ *  MT_SoupHeatmap.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_SoupHeatmap_h
+#define MT_SoupHeatmap_h
+
+#include <vector>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+
+namespace MacTierra {
+
+class Creature;
+
+// Counts, per block of soup cells, how often code there is fetched for execution, how often it
+// is executed by a creature that doesn't own it (parasites and the like), and how often it is
+// written by mov_iab.
+//
+// Only one in every N fetches and writes is counted, with a weight of N, so the cost in the
+// execution unit is a decrement and a test. Install it with World::setHeatmap(). Snapshots are
+// taken on the engine thread (normally by a data logger), and each one decays the counters, so
+// that they show recent activity rather than the whole run.
+class SoupHeatmap : Noncopyable
+{
+public:
+    enum {
+        kDefaultBlockSize       = 256,
+        kDefaultSampleInterval  = 16
+    };
+
+    SoupHeatmap(u_int32_t inSoupSize, u_int32_t inBlockSize = kDefaultBlockSize, u_int32_t inSampleInterval = kDefaultSampleInterval);
+
+    u_int32_t       soupSize() const        { return mSoupSize; }
+    u_int32_t       blockSize() const       { return mBlockSize; }
+    u_int32_t       numBlocks() const       { return mFetches.size(); }
+
+    u_int32_t       sampleInterval() const  { return mSampleInterval; }
+
+    // The fraction of the counts kept after each snapshot; 0 clears them, 1 never decays.
+    double          decayFactor() const     { return mDecayFactor; }
+    void            setDecayFactor(double inFactor);
+
+    // Called by the execution unit for every fetch and every mov_iab write.
+    void            noteFetch(address_t inAddress, const Creature& inCreature)
+                    {
+                        if (--mFetchCountdown == 0)
+                            countFetch(inAddress, inCreature);
+                    }
+
+    void            noteWrite(address_t inAddress)
+                    {
+                        if (--mWriteCountdown == 0)
+                            countWrite(inAddress);
+                    }
+
+    struct Snapshot
+    {
+        u_int32_t           mBlockSize;
+        std::vector<double> mFetches;
+        std::vector<double> mForeignFetches;
+        std::vector<double> mWrites;
+    };
+
+    // Copies the counters, then decays them.
+    void            takeSnapshot(Snapshot& outSnapshot);
+
+    void            clear();
+
+protected:
+
+    void            countFetch(address_t inAddress, const Creature& inCreature);
+    void            countWrite(address_t inAddress);
+
+protected:
+
+    u_int32_t       mSoupSize;
+    u_int32_t       mBlockSize;
+    u_int32_t       mSampleInterval;
+    double          mDecayFactor;
+
+    u_int32_t       mFetchCountdown;
+    u_int32_t       mWriteCountdown;
+
+    std::vector<double> mFetches;
+    std::vector<double> mForeignFetches;
+    std::vector<double> mWrites;
+};
+
+} // namespace MacTierra
+
+#endif // MT_SoupHeatmap_h
@@ -0,0 +1,441 @@
+/*
+ *  MT_TimeSeries.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_TimeSeries_h
+#define MT_TimeSeries_h
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/serialization/deque.hpp>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "MT_Engine.h"
+
+namespace MacTierra {
+
+// How values of type T are summed and compared when samples are merged into buckets.
+template <class T>
+struct TimeSeriesTraits
+{
+    typedef double sum_type;
+
+    static sum_type zero()                                  { return 0.0; }
+    static void     add(sum_type& ioSum, const T& inValue)  { ioSum += static_cast<double>(inValue); }
+    static void     addSum(sum_type& ioSum, const sum_type& inSum)  { ioSum += inSum; }
+
+    static T        mean(const sum_type& inSum, u_int64_t inCount)  { return fromDouble(inSum / inCount); }
+    static T        minimum(const T& inA, const T& inB)     { return std::min(inA, inB); }
+    static T        maximum(const T& inA, const T& inB)     { return std::max(inA, inB); }
+
+    static T        fromDouble(double inValue)
+    {
+        return std::numeric_limits<T>::is_integer ? static_cast<T>(inValue + 0.5) : static_cast<T>(inValue);
+    }
+};
+
+// Pairs are aggregated member by member.
+template <class U, class V>
+struct TimeSeriesTraits<std::pair<U, V> >
+{
+    typedef std::pair<U, V> value_type;
+    typedef std::pair<double, double> sum_type;
+
+    static sum_type zero()      { return sum_type(0.0, 0.0); }
+    static void     add(sum_type& ioSum, const value_type& inValue)
+    {
+        ioSum.first += static_cast<double>(inValue.first);
+        ioSum.second += static_cast<double>(inValue.second);
+    }
+    static void     addSum(sum_type& ioSum, const sum_type& inSum)
+    {
+        ioSum.first += inSum.first;
+        ioSum.second += inSum.second;
+    }
+
+    static value_type mean(const sum_type& inSum, u_int64_t inCount)
+    {
+        return value_type(TimeSeriesTraits<U>::fromDouble(inSum.first / inCount), TimeSeriesTraits<V>::fromDouble(inSum.second / inCount));
+    }
+    static value_type minimum(const value_type& inA, const value_type& inB)
+    {
+        return value_type(std::min(inA.first, inB.first), std::min(inA.second, inB.second));
+    }
+    static value_type maximum(const value_type& inA, const value_type& inB)
+    {
+        return value_type(std::max(inA.first, inB.first), std::max(inA.second, inB.second));
+    }
+};
+
+// A run of consecutive samples, summarized.
+template <class T>
+struct TimeSeriesBucket
+{
+    typedef TimeSeriesTraits<T> traits;
+    typedef typename traits::sum_type sum_type;
+
+    TimeSeriesBucket()
+    : mFirstInstructions(0)
+    , mLastInstructions(0)
+    , mFirstCycles(0)
+    , mLastCycles(0)
+    , mCount(0)
+    , mMin()
+    , mMax()
+    , mSum(traits::zero())
+    {
+    }
+
+    TimeSeriesBucket(u_int64_t inInstructions, u_int64_t inCycles, const T& inValue)
+    : mFirstInstructions(inInstructions)
+    , mLastInstructions(inInstructions)
+    , mFirstCycles(inCycles)
+    , mLastCycles(inCycles)
+    , mCount(1)
+    , mMin(inValue)
+    , mMax(inValue)
+    , mSum(traits::zero())
+    {
+        traits::add(mSum, inValue);
+    }
+
+    bool        empty() const   { return mCount == 0; }
+    T           mean() const    { return mCount ? traits::mean(mSum, mCount) : T(); }
+
+    // inLater must follow this bucket in time.
+    void        merge(const TimeSeriesBucket& inLater)
+    {
+        if (inLater.empty())
+            return;
+
+        if (empty())
+        {
+            *this = inLater;
+            return;
+        }
+
+        mLastInstructions = inLater.mLastInstructions;
+        mLastCycles = inLater.mLastCycles;
+        mCount += inLater.mCount;
+        mMin = traits::minimum(mMin, inLater.mMin);
+        mMax = traits::maximum(mMax, inLater.mMax);
+        traits::addSum(mSum, inLater.mSum);
+    }
+
+    u_int64_t   mFirstInstructions;
+    u_int64_t   mLastInstructions;
+    u_int64_t   mFirstCycles;
+    u_int64_t   mLastCycles;
+
+    u_int64_t   mCount;
+    T           mMin;
+    T           mMax;
+    sum_type    mSum;
+
+private:
+    friend class ::boost::serialization::access;
+    template<class Archive> void serialize(Archive& ar, const unsigned int file_version)
+    {
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("first_inst", mFirstInstructions);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("last_inst", mLastInstructions);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("first_cycles", mFirstCycles);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("last_cycles", mLastCycles);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("count", mCount);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("min", mMin);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("max", mMax);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("sum", mSum);
+    }
+};
+
+// A time series of bounded size that keeps recent samples at full resolution and older ones
+// at progressively coarser resolution. Level 0 holds individual samples; each bucket in
+// level n summarizes 'fanout' buckets of level n - 1. Every level holds at most levelCapacity
+// buckets; lower levels forget their oldest buckets, which are still covered by the levels
+// above, and the top level merges neighbouring buckets when it fills, so it always covers the
+// whole run. Appending is amortized O(1), and a query costs O(levels + buckets returned).
+template <class T>
+class TimeSeries
+{
+public:
+    typedef T value_type;
+    typedef TimeSeriesBucket<T> Bucket;
+    typedef std::vector<Bucket> BucketVector;
+
+    enum {
+        kDefaultLevelCapacity   = 1024,
+        kDefaultFanout          = 4,
+        kDefaultMaxLevels       = 12
+    };
+
+    TimeSeries(u_int32_t inLevelCapacity = kDefaultLevelCapacity, u_int32_t inFanout = kDefaultFanout, u_int32_t inMaxLevels = kDefaultMaxLevels)
+    : mLevelCapacity(std::max(inLevelCapacity, 2U))
+    , mFanout(std::max(inFanout, 2U))
+    , mMaxLevels(std::max(inMaxLevels, 2U))
+    {
+    }
+
+    void            clear()
+    {
+        mLevels.clear();
+        mTotal = Bucket();
+    }
+
+    u_int32_t       levelCapacity() const   { return mLevelCapacity; }
+    // Shrinking the capacity coarsens the data that no longer fits.
+    void            setLevelCapacity(u_int32_t inCapacity)
+    {
+        inCapacity = std::max(inCapacity, 2U);
+        if (inCapacity == mLevelCapacity)
+            return;
+
+        mLevelCapacity = inCapacity;
+        for (size_t i = 0; i < mLevels.size(); ++i)
+        {
+            while (mLevels[i].mBuckets.size() > mLevelCapacity)
+                trimLevel(i);
+        }
+    }
+
+    u_int32_t       fanout() const          { return mFanout; }
+    u_int32_t       numLevels() const       { return mLevels.size(); }
+
+    bool            empty() const           { return mTotal.empty(); }
+    u_int64_t       numSamples() const      { return mTotal.mCount; }
+
+    // Summary of the whole run.
+    const Bucket&   total() const           { return mTotal; }
+
+    void            append(u_int64_t inInstructions, u_int64_t inCycles, const T& inValue)
+    {
+        Bucket sample(inInstructions, inCycles, inValue);
+        mTotal.merge(sample);
+
+        if (mLevels.empty())
+            mLevels.push_back(Level(1));
+
+        addBucket(0, sample);
+    }
+
+    // The samples from inFromInstructions onwards, as buckets from the finest level that reaches
+    // back that far in no more than inMaxBuckets buckets. If no level does, neighbouring buckets
+    // of the top level are merged to fit.
+    void            query(u_int64_t inFromInstructions, u_int32_t inMaxBuckets, BucketVector& outBuckets) const
+    {
+        outBuckets.clear();
+        if (mLevels.empty() || inMaxBuckets == 0)
+            return;
+
+        size_t levelIndex = mLevels.size() - 1;
+        for (size_t i = 0; i < mLevels.size(); ++i)
+        {
+            const Level& curLevel = mLevels[i];
+            if (curLevel.mTruncated && (curLevel.mBuckets.empty() || curLevel.mBuckets.front().mFirstInstructions > inFromInstructions))
+                continue;
+
+            size_t count = curLevel.mBuckets.end() - firstBucketFrom(curLevel, inFromInstructions) + 1;    // + 1 for the unfinished tail
+            if (count <= inMaxBuckets)
+            {
+                levelIndex = i;
+                break;
+            }
+        }
+
+        const Level& level = mLevels[levelIndex];
+        outBuckets.reserve(std::min<size_t>(level.mBuckets.size() + 1, inMaxBuckets));
+
+        // The unfinished buckets of this level and those below hold the most recent samples; the
+        // higher the level, the older they are.
+        Bucket tail;
+        for (size_t i = levelIndex; i > 0; --i)
+            tail.merge(mLevels[i].mPending);
+
+        const size_t available = level.mBuckets.end() - firstBucketFrom(level, inFromInstructions) + (tail.empty() ? 0 : 1);
+        const size_t groupSize = (available + inMaxBuckets - 1) / inMaxBuckets;
+
+        Bucket group;
+        size_t groupCount = 0;
+        for (typename BucketDeque::const_iterator it = firstBucketFrom(level, inFromInstructions); it != level.mBuckets.end(); ++it)
+        {
+            group.merge(*it);
+            if (++groupCount == groupSize)
+            {
+                outBuckets.push_back(group);
+                group = Bucket();
+                groupCount = 0;
+            }
+        }
+
+        group.merge(tail);
+        if (!group.empty())
+            outBuckets.push_back(group);
+    }
+
+    void            fullRange(u_int32_t inMaxBuckets, BucketVector& outBuckets) const
+    {
+        query(0, inMaxBuckets, outBuckets);
+    }
+
+protected:
+
+    typedef std::deque<Bucket> BucketDeque;
+
+    struct Level
+    {
+        Level(u_int32_t inChildrenPerBucket = 1)
+        : mChildrenPerBucket(inChildrenPerBucket)
+        , mPendingChildren(0)
+        , mTruncated(false)
+        {
+        }
+
+        BucketDeque     mBuckets;
+        Bucket          mPending;               // buckets from the level below that don't yet make a whole bucket here
+        u_int32_t       mChildrenPerBucket;
+        u_int32_t       mPendingChildren;
+        bool            mTruncated;             // true once old buckets have been thrown away
+
+    private:
+        friend class ::boost::serialization::access;
+        template<class Archive> void serialize(Archive& ar, const unsigned int file_version)
+        {
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("buckets", mBuckets);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("pending", mPending);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("children_per_bucket", mChildrenPerBucket);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("pending_children", mPendingChildren);
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("truncated", mTruncated);
+        }
+    };
+
+    struct BucketEndsBefore
+    {
+        bool operator()(const Bucket& inBucket, u_int64_t inInstructions) const
+        {
+            return inBucket.mLastInstructions < inInstructions;
+        }
+    };
+
+    static typename BucketDeque::const_iterator firstBucketFrom(const Level& inLevel, u_int64_t inInstructions)
+    {
+        return std::lower_bound(inLevel.mBuckets.begin(), inLevel.mBuckets.end(), inInstructions, BucketEndsBefore());
+    }
+
+    void            addBucket(size_t inLevelIndex, const Bucket& inBucket)
+    {
+        mLevels[inLevelIndex].mBuckets.push_back(inBucket);
+
+        if (inLevelIndex + 1 < mLevels.size())
+        {
+            Level& parent = mLevels[inLevelIndex + 1];
+            parent.mPending.merge(inBucket);
+            if (++parent.mPendingChildren == parent.mChildrenPerBucket)
+            {
+                Bucket completed = parent.mPending;
+                parent.mPending = Bucket();
+                parent.mPendingChildren = 0;
+                addBucket(inLevelIndex + 1, completed);     // may add a level, so don't use 'parent' after this
+            }
+        }
+
+        if (mLevels[inLevelIndex].mBuckets.size() > mLevelCapacity)
+            trimLevel(inLevelIndex);
+    }
+
+    void            trimLevel(size_t inLevelIndex)
+    {
+        if (inLevelIndex + 1 == mLevels.size())
+        {
+            if (mLevels.size() >= mMaxLevels)
+            {
+                compactTopLevel();
+                return;
+            }
+            addLevelAbove(inLevelIndex);
+        }
+
+        Level& level = mLevels[inLevelIndex];
+        while (level.mBuckets.size() > mLevelCapacity)
+            level.mBuckets.pop_front();
+        level.mTruncated = true;
+    }
+
+    // The top level has never been truncated, so the new level can be built from all of it.
+    void            addLevelAbove(size_t inLevelIndex)
+    {
+        Level parent(mFanout);
+        const BucketDeque& children = mLevels[inLevelIndex].mBuckets;
+        for (typename BucketDeque::const_iterator it = children.begin(); it != children.end(); ++it)
+        {
+            parent.mPending.merge(*it);
+            if (++parent.mPendingChildren == parent.mChildrenPerBucket)
+            {
+                parent.mBuckets.push_back(parent.mPending);
+                parent.mPending = Bucket();
+                parent.mPendingChildren = 0;
+            }
+        }
+        mLevels.push_back(parent);
+    }
+
+    // Merge neighbouring pairs of buckets, halving the top level's resolution.
+    void            compactTopLevel()
+    {
+        Level& top = mLevels.back();
+
+        BucketDeque compacted;
+        const size_t numBuckets = top.mBuckets.size();
+        for (size_t i = 0; i + 1 < numBuckets; i += 2)
+        {
+            Bucket merged = top.mBuckets[i];
+            merged.merge(top.mBuckets[i + 1]);
+            compacted.push_back(merged);
+        }
+
+        // An odd bucket out is only half of a new bucket, so goes back to being unfinished.
+        if (numBuckets % 2)
+        {
+            Bucket pending = top.mBuckets.back();
+            pending.merge(top.mPending);
+            top.mPending = pending;
+            top.mPendingChildren += top.mChildrenPerBucket;
+        }
+
+        top.mBuckets.swap(compacted);
+        top.mChildrenPerBucket *= 2;
+    }
+
+private:
+    friend class ::boost::serialization::access;
+    template<class Archive> void serialize(Archive& ar, const unsigned int file_version)
+    {
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("level_capacity", mLevelCapacity);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("fanout", mFanout);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("max_levels", mMaxLevels);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("levels", mLevels);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("total", mTotal);
+    }
+
+protected:
+
+    u_int32_t           mLevelCapacity;
+    u_int32_t           mFanout;
+    u_int32_t           mMaxLevels;
+
+    std::vector<Level>  mLevels;
+    Bucket              mTotal;
+};
+
+} // namespace MacTierra
+
+#endif // MT_TimeSeries_h
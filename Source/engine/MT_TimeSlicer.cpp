@@ -101,18 +101,85 @@ TimeSlicer::initialSliceSizeForCreature(const Creature* inCreature, const Settin
 
 u_int32_t
 TimeSlicer::sizeForThisSlice(const Creature* inCreature, double inSliceSizeVariance)
+{
+    return sizeForThisSlice(inCreature, inSliceSizeVariance, mWorld->RNG());
+}
+
+u_int32_t
+TimeSlicer::sizeForThisSlice(const Creature* inCreature, double inSliceSizeVariance, RandomLib::Random& inRNG)
 {
     if (inSliceSizeVariance > 0.0)
     {
         double sliceSize = inCreature->meanSliceSize();
         
         RandomLib::NormalDistribution<double> normdist;
-        return std::max(lround(normdist(mWorld->RNG(), sliceSize, inSliceSizeVariance)), 1L);
+        return std::max(lround(normdist(inRNG, sliceSize, inSliceSizeVariance)), 1L);
     }
     
     return lround(inCreature->meanSliceSize());
 }
 
+void
+TimeSlicer::removeAllCreatures(std::vector<Creature*>& outCreatures)
+{
+    if (mSlicerList.empty())
+        return;
+
+    SlicerList::iterator it = mCurrentItem;
+    do
+    {
+        outCreatures.push_back(&(*it));
+        if (++it == mSlicerList.end())
+            it = mSlicerList.begin();
+    } while (it != mCurrentItem);
+
+    mSlicerList.clear();
+    mCurrentItem = mSlicerList.end();
+}
+
+void
+TimeSlicer::addExecuted(u_int64_t inInstructions, u_int64_t inCycles)
+{
+    if (inCycles > 0)
+    {
+        mCycleCount += inCycles;
+        mLastCycleInstructions = 0;
+    }
+
+    mLastCycleInstructions += inInstructions;
+    mTotalInstructions += inInstructions;
+}
+
+void
+TimeSlicer::copyFrom(const TimeSlicer& inSlicer, const CreatureCopyMap& inCreatures)
+{
+    BOOST_ASSERT(mSlicerList.empty());
+
+    mCycleCount = inSlicer.mCycleCount;
+    mLastCycleInstructions = inSlicer.mLastCycleInstructions;
+    mTotalInstructions = inSlicer.mTotalInstructions;
+
+    mCurrentItem = mSlicerList.end();
+    for (SlicerList::const_iterator it = inSlicer.mSlicerList.cbegin(); it != inSlicer.mSlicerList.cend(); ++it)
+    {
+        Creature& copy = *inCreatures.find(&(*it))->second;
+        mSlicerList.push_back(copy);
+        if (it == SlicerList::const_iterator(inSlicer.mCurrentItem))
+            mCurrentItem = mSlicerList.iterator_to(copy);
+    }
+}
+
+void
+TimeSlicer::resetCounts()
+{
+    BOOST_ASSERT(mSlicerList.empty());
+
+    mCycleCount = 0;
+    mLastCycleInstructions = 0;
+    mTotalInstructions = 0;
+    mCurrentItem = mSlicerList.end();
+}
+
 void
 TimeSlicer::printCreatures() const
 {
@@ -10,9 +10,14 @@
 #ifndef MT_Timeslicer_h
 #define MT_Timeslicer_h
 
+#include <vector>
+
 #include <boost/intrusive/list.hpp>
 #include <boost/serialization/serialization.hpp>
 
+#define HAVE_BOOST_SERIALIZATION 1
+#include <RandomLib/Random.hpp>
+
 #include "MT_Engine.h"
 #include "MT_Creature.h"
 
@@ -54,6 +59,21 @@ public:
     double      initialSliceSizeForCreature(const Creature* inCreature, const Settings& inSettings);
 
     u_int32_t   sizeForThisSlice(const Creature* inCreature, double inSliceSizeVariance);
+    // for slicers that don't draw from the world's generator, such as those of shards
+    static u_int32_t sizeForThisSlice(const Creature* inCreature, double inSliceSizeVariance, RandomLib::Random& inRNG);
+
+    // Empties the list, returning the creatures in the order they would have run, starting with
+    // the current one. Unlike removeCreature(), doesn't count a cycle.
+    void        removeAllCreatures(std::vector<Creature*>& outCreatures);
+
+    // Counts instructions and cycles run by other slicers, e.g. those of a sharded world.
+    void        addExecuted(u_int64_t inInstructions, u_int64_t inCycles);
+
+    // Takes on another slicer's counts and order, with each creature replaced by its copy.
+    void        copyFrom(const TimeSlicer& inSlicer, const CreatureCopyMap& inCreatures);
+
+    // Zeroes the counts of an empty slicer.
+    void        resetCounts();
 
     u_int32_t   numCreatures() const { return mSlicerList.size(); }
 
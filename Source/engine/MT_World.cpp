@@ -10,6 +10,7 @@
 #define __STDC_LIMIT_MACROS
 #include <stdint.h>
 
+#include <limits>
 #include <map>
 
 #include <sstream>
@@ -26,6 +27,7 @@
 #include "MT_Genotype.h"
 #include "MT_InstructionSet.h"
 #include "MT_Inventory.h"
+#include "MT_ShardedExecution.h"
 #include "MT_Soup.h"
 
 namespace MacTierra {
@@ -42,6 +44,12 @@ World::World()
 , mTimeSlicer(this)
 , mInventory(NULL)
 , mDataCollector(NULL)
+, mHeatmap(NULL)
+, mInteractions(NULL)
+, mShardedExecution(NULL)
+, mShardThreads(0)
+, mBulkCopyLoops(true)
+, mBulkCopyInstructions(0)
 , mCurCreatureCycles(0)
 , mCurCreatureSliceCycles(0)
 , mCopyErrorPending(false)
@@ -49,12 +57,14 @@ World::World()
 , mNextCopyError(0)
 , mNextFlawInstruction(0)
 , mNextCosmicRayInstruction(0)
+, mShardInstructionsOwed(0)
 {
     mDataCollector = new DataCollector();
 }
 
 World::~World()
 {
+    delete mShardedExecution;
     destroyCreatures();
     delete mSoup;
     delete mCellMap;
@@ -77,10 +87,112 @@ World::initializeSoup(u_int32_t inSoupSize)
     mExecution = new ExecutionUnit0();
     
     mInventory = new Inventory();
+    mInventory->setStatistics(&mStatistics);
     
     computeNextMutationTimes();
 }
 
+World*
+World::clone() const
+{
+    BOOST_ASSERT(mSoup);
+
+    World* theCopy = new World();
+    theCopy->mSettings = mSettings;
+    theCopy->initializeSoup(mSoupSize);
+    theCopy->mRNG = mRNG;
+
+    theCopy->mSoup->copyFrom(*mSoup);
+
+    GenotypeCopyMap genotypes;
+    theCopy->mInventory->copyFrom(*mInventory, genotypes);
+
+    // copy the creatures first, then point them at each other and at the copied genotypes
+    theCopy->mNextCreatureID = mNextCreatureID;
+
+    CreatureCopyMap creatures;
+    CreatureIDMap::const_iterator theEnd = mCreatureIDMap.end();
+    for (CreatureIDMap::const_iterator it = mCreatureIDMap.begin(); it != theEnd; ++it)
+    {
+        RefPtr<Creature> creatureCopy = it->second->copyInSoup(theCopy->mSoup);
+        creatures[it->second.get()] = creatureCopy.get();
+        theCopy->mCreatureIDMap[it->first] = creatureCopy;
+    }
+
+    for (CreatureIDMap::const_iterator it = mCreatureIDMap.begin(); it != theEnd; ++it)
+        creatures[it->second.get()]->copyLinks(*it->second, creatures, genotypes);
+
+    theCopy->mCellMap->copyCells(*mCellMap, creatures);
+    theCopy->mTimeSlicer.copyFrom(mTimeSlicer, creatures);
+    theCopy->mReaper.copyFrom(mReaper, creatures);
+
+    theCopy->mShardThreads = mShardThreads;
+    theCopy->mBulkCopyLoops = mBulkCopyLoops;
+
+    theCopy->mCurCreatureCycles = mCurCreatureCycles;
+    theCopy->mCurCreatureSliceCycles = mCurCreatureSliceCycles;
+    theCopy->mCopyErrorPending = mCopyErrorPending;
+    theCopy->mCopiesSinceLastError = mCopiesSinceLastError;
+    theCopy->mNextCopyError = mNextCopyError;
+    theCopy->mNextFlawInstruction = mNextFlawInstruction;
+    theCopy->mNextCosmicRayInstruction = mNextCosmicRayInstruction;
+    theCopy->mShardInstructionsOwed = mShardInstructionsOwed;
+
+    theCopy->rebuildPopulationState();
+
+    DataCollector* collector = theCopy->mDataCollector;
+    collector->setCollectionInterval(mDataCollector->collectionInterval(), mTimeSlicer.instructionsExecuted());
+    collector->setNextCollectionInstructions(mDataCollector->nextCollectionInstructions());
+    collector->setCollectionCycles(mDataCollector->collectionCycles(), mTimeSlicer.cycleCount());
+    collector->setNextCollectionCycle(mDataCollector->nextCollectionCycle());
+    collector->setSampleSize(mDataCollector->sampleSize());
+    collector->setSamplingSeed(initialRandomSeed());
+
+    return theCopy;
+}
+
+World*
+World::clone(u_int32_t inRandomSeed) const
+{
+    World* theCopy = clone();
+    theCopy->setInitialRandomSeed(inRandomSeed);
+
+    // the copy's next mutations come from its own generator too
+    theCopy->mCopyErrorPending = false;
+    theCopy->mCopiesSinceLastError = 0;
+    theCopy->computeNextMutationTimes();
+    return theCopy;
+}
+
+void
+World::emptySoup()
+{
+    BOOST_ASSERT(mSoup);
+
+    // the shards refer to the old creatures
+    delete mShardedExecution;
+    mShardedExecution = NULL;
+
+    destroyCreatures();
+
+    mSoup->clear();
+    mInventory->clear();
+    mTimeSlicer.resetCounts();
+    mNextCreatureID = 1;
+
+    mDataCollector->setNextCollectionInstructions(0);
+    mDataCollector->setNextCollectionCycle(0);
+
+    mCurCreatureCycles = 0;
+    mCurCreatureSliceCycles = 0;
+    mCopyErrorPending = false;
+    mCopiesSinceLastError = 0;
+    mNextCopyError = 0;
+    mNextFlawInstruction = 0;
+    mNextCosmicRayInstruction = 0;
+    mShardInstructionsOwed = 0;
+}
+
 PassRefPtr<Creature>
 World::createCreature(u_int32_t inLength)
 {
@@ -96,13 +208,31 @@ World::createCreature(u_int32_t inLength)
 }
 
 void
-World::eradicateCreature(Creature* inCreature)
+World::addEventListener(WorldEventListener* inListener, u_int32_t inEventMask)
+{
+    mEvents.addListener(inListener, inEventMask);
+}
+
+void
+World::removeEventListener(WorldEventListener* inListener)
+{
+    mEvents.removeListener(inListener);
+}
+
+void
+World::eradicateCreature(Creature* inCreature, DeathEvent::EReason inReason)
 {
+    if (mEvents.wantsDeaths())
+        sendDeathEvent(*inCreature, inReason);
+
     if (inCreature->isDividing())
     {
         Creature* daughterCreature = const_cast<Creature*>(inCreature->daughterCreature());
         BOOST_ASSERT(daughterCreature);
         
+        if (mEvents.wantsDeaths())
+            sendDeathEvent(*daughterCreature, DeathEvent::kParentDied);
+
         if (mSettings.clearReapedCreatures())
             daughterCreature->clearSpace();
 
@@ -149,9 +279,7 @@ World::numAdultCreatures() const
 double
 World::meanCreatureSize() const
 {
-    u_int32_t numAdults;
-    u_int32_t totalSize = mCellMap->totalAdultSize(numAdults);
-    return (double)totalSize / numAdults;
+    return mStatistics.meanSize();
 }
 
 void
@@ -188,7 +316,7 @@ World::insertCreature(address_t inAddress, const instruction_t* inInstructions,
     BOOST_ASSERT(theGenotype);
     theCreature->setGenotype(theGenotype);
     theCreature->setGeneration(1);
-    mInventory->creatureBorn(theGenotype);
+    mInventory->creatureBorn(theGenotype, *theCreature);
 
     theCreature->setMeanSliceSize(mTimeSlicer.initialSliceSizeForCreature(theCreature.get(), mSettings));
     theCreature->setReferencedLocation(theCreature->location());
@@ -200,19 +328,75 @@ World::insertCreature(address_t inAddress, const instruction_t* inInstructions,
     creatureAdded(theCreature.get());
     
     theCreature->onBirth(*this);     // IVF, kinda
+    mStatistics.creatureBorn(*theCreature);
+
+    if (mEvents.wantsBirths())
+        sendBirthEvent(NULL, *theCreature, true);
+
     return theCreature.release();
 }
 
 void
 World::iterate(u_int32_t inNumCycles)
+{
+    if (mSettings.numShards() > 1 && mSoup)
+    {
+        if (!mShardedExecution)
+            mShardedExecution = new ShardedExecution(*this, mSettings.numShards(), mShardThreads);
+
+        mShardedExecution->iterate(inNumCycles);
+        return;
+    }
+
+    // what the shards still owe is dropped, and their runs leave the world's own flaw time behind
+    mShardInstructionsOwed = 0;
+    if (mSettings.flawRate() > 0.0 && mNextFlawInstruction < mTimeSlicer.instructionsExecuted())
+        computeNextInstructionFlaw(mTimeSlicer.instructionsExecuted());
+
+    iterateSerially(inNumCycles);
+}
+
+void
+World::iterateSerially(u_int32_t inNumCycles)
 {
     u_int32_t   cycles = 0;
     u_int32_t   numCycles = inNumCycles;      // unless tracing
     
-    Creature*   curCreature = mTimeSlicer.currentCreature();
+    Creature*   curCreature = startIterating();
     if (!curCreature)
         return;
 
+    while (cycles < numCycles)
+    {
+        if (mCurCreatureCycles < mCurCreatureSliceCycles)
+        {
+            const u_int32_t loopCycles = mBulkCopyLoops ? runCopyLoop(curCreature, numCycles - cycles) : 0;
+            if (loopCycles > 0)
+                cycles += loopCycles;
+            else
+            {
+                stepCurrentCreature(curCreature);
+                ++cycles;
+            }
+        }
+        else        // we are at the end of the slice for one creature
+        {
+            curCreature = startNextSlice();
+            if (!curCreature)
+                break;
+        }
+    }
+    
+    //cout << "Executed " << mTimeSlicer.instructionsExecuted() << " instructions" << endl;
+}
+
+Creature*
+World::startIterating()
+{
+    Creature*   curCreature = mTimeSlicer.currentCreature();
+    if (!curCreature)
+        return NULL;
+
     if (mCurCreatureCycles == 0)
         mCurCreatureSliceCycles = mTimeSlicer.sizeForThisSlice(curCreature, mSettings.sliceSizeVariance());
 
@@ -220,82 +404,129 @@ World::iterate(u_int32_t inNumCycles)
         mDataCollector->collectCyclicalData(mTimeSlicer.instructionsExecuted(), mTimeSlicer.cycleCount(), this);
     
     BOOST_ASSERT(mCurCreatureSliceCycles > 0);
-    while (cycles < numCycles)
-    {
-        if (mCurCreatureCycles < mCurCreatureSliceCycles)
-        {
-            const u_int64_t instructionCount = mTimeSlicer.instructionsExecuted();
+    return curCreature;
+}
 
-            // data collection
-            if (timeForPeriodicDataCollection(instructionCount))
-                mDataCollector->collectPeriodicData(instructionCount, mTimeSlicer.cycleCount(), this);
+void
+World::stepCurrentCreature(Creature* inCreature)
+{
+    const u_int64_t instructionCount = mTimeSlicer.instructionsExecuted();
 
-            // do cosmic rays
-            if (timeForCosmicRay(instructionCount))
-                cosmicRay(instructionCount);
-            
-            // decide whether to throw in a flaw
-            int32_t flaw = 0;
-            if (timeForFlaw(instructionCount))
-                flaw = instructionFlaw(instructionCount);
-            
-            // TODO: track leanness
+    // data collection
+    if (timeForPeriodicDataCollection(instructionCount))
+        mDataCollector->collectPeriodicData(instructionCount, mTimeSlicer.cycleCount(), this);
 
-            // execute the next instruction
-            RefPtr<Creature> daughterCreature = mExecution->execute(*curCreature, *this, flaw);
-            if (daughterCreature)
-                handleBirth(curCreature, daughterCreature.get());
-        
-            // if there was an error, adjust in the reaper queue
-            if (curCreature->cpu().flag())
-                mReaper.conditionalMoveUp(*curCreature);
-            else if (curCreature->lastInstruction() == k_mal || curCreature->lastInstruction() == k_divide)
-                mReaper.conditionalMoveDown(*curCreature);
-
-            // compute next copy error time
-            if ((mSettings.copyErrorRate() > 0.0) && (curCreature->lastInstruction() == k_mov_iab))
-                noteInstructionCopy();
-            
-            ++mCurCreatureCycles;
-            mTimeSlicer.executedInstruction();
+    // do cosmic rays
+    if (timeForCosmicRay(instructionCount))
+        cosmicRay(instructionCount);
+    
+    // decide whether to throw in a flaw
+    int32_t flaw = 0;
+    if (timeForFlaw(instructionCount))
+        flaw = instructionFlaw(instructionCount);
+    
+    // TODO: track leanness
 
-            ++cycles;
-        }
-        else        // we are at the end of the slice for one creature
-        {
-            // maybe reap
-            if (mCellMap->fullness() > mSettings.reapThreshold())
-            {
-                //mReaper.printCreatures();
-                Creature* doomedCreature = mReaper.headCreature();
-                //cout << "Reaping creature " << doomedCreature->creatureID() << " (" << doomedCreature->numErrors() << " errors)" << endl;
-                handleDeath(doomedCreature);
-            }
-            
-            // maybe kill off long-lived creatures
-            
-            
-            // rotate the slicer
-            bool cycled = mTimeSlicer.advance();
-            if (cycled)
-            {
-                //mInventory->printCreatures();
+    // execute the next instruction
+    runInstruction(inCreature, flaw);
+    
+    ++mCurCreatureCycles;
+    mTimeSlicer.executedInstruction();
+}
 
-                if (timeForSlicerCycleDataCollection(mTimeSlicer.cycleCount()))
-                    mDataCollector->collectCyclicalData(mTimeSlicer.instructionsExecuted(), mTimeSlicer.cycleCount(), this);
-            }
-            
-            // start on the next creature
-            curCreature = mTimeSlicer.currentCreature();
-            if (!curCreature)
-                break;
+Creature*
+World::startNextSlice()
+{
+    // maybe reap
+    if (mCellMap->fullness() > mSettings.reapThreshold())
+    {
+        //mReaper.printCreatures();
+        Creature* doomedCreature = mReaper.headCreature();
+        //cout << "Reaping creature " << doomedCreature->creatureID() << " (" << doomedCreature->numErrors() << " errors)" << endl;
+        handleDeath(doomedCreature);
+    }
+    
+    // maybe kill off long-lived creatures
+    
+    
+    // rotate the slicer
+    bool cycled = mTimeSlicer.advance();
+    if (cycled)
+    {
+        //mInventory->printCreatures();
 
-            mCurCreatureCycles = 0;
-            mCurCreatureSliceCycles = mTimeSlicer.sizeForThisSlice(curCreature, mSettings.sliceSizeVariance());
-        }
+        if (timeForSlicerCycleDataCollection(mTimeSlicer.cycleCount()))
+            mDataCollector->collectCyclicalData(mTimeSlicer.instructionsExecuted(), mTimeSlicer.cycleCount(), this);
     }
     
-    //cout << "Executed " << mTimeSlicer.instructionsExecuted() << " instructions" << endl;
+    // start on the next creature
+    Creature* curCreature = mTimeSlicer.currentCreature();
+    if (!curCreature)
+        return NULL;
+
+    mCurCreatureCycles = 0;
+    mCurCreatureSliceCycles = mTimeSlicer.sizeForThisSlice(curCreature, mSettings.sliceSizeVariance());
+    return curCreature;
+}
+
+u_int64_t
+World::instructionsUntilNextEvent() const
+{
+    const u_int64_t instructionCount = mTimeSlicer.instructionsExecuted();
+    u_int64_t instructions = std::numeric_limits<u_int64_t>::max();
+
+    // these are only due when the count matches exactly, so times already passed never come round
+    if (mDataCollector && mDataCollector->nextCollectionInstructions() >= instructionCount)
+        instructions = std::min(instructions, mDataCollector->nextCollectionInstructions() - instructionCount);
+
+    if (mSettings.cosmicRate() > 0.0 && mNextCosmicRayInstruction >= instructionCount)
+        instructions = std::min(instructions, mNextCosmicRayInstruction - instructionCount);
+
+    if (mSettings.flawRate() > 0.0 && mNextFlawInstruction >= instructionCount)
+        instructions = std::min(instructions, mNextFlawInstruction - instructionCount);
+
+    return instructions;
+}
+
+u_int32_t
+World::runCopyLoop(Creature* inCreature, u_int32_t inMaxCycles)
+{
+    // cheap enough to ask before every instruction; a slice can also start part way round a loop
+    if (mCurCreatureCycles > 0 && inCreature->getSoupInstruction(inCreature->cpu().mInstructionPointer) != k_mov_iab)
+        return 0;
+
+    // these want to see every instruction
+    if (mHeatmap || mInteractions || mSettings.selectForLeanness())
+        return 0;
+
+    const u_int64_t maxInstructions = std::min<u_int64_t>(std::min(inMaxCycles, mCurCreatureSliceCycles - mCurCreatureCycles),
+                                                          instructionsUntilNextEvent());
+    if (maxInstructions == 0)
+        return 0;
+
+    const u_int32_t instructions = mExecution->executeCopyLoop(*inCreature, *this, static_cast<u_int32_t>(maxInstructions));
+    mCurCreatureCycles += instructions;
+    mTimeSlicer.addExecuted(instructions, 0);
+    mBulkCopyInstructions += instructions;
+    return instructions;
+}
+
+void
+World::runInstruction(Creature* inCreature, int32_t inFlaw)
+{
+    RefPtr<Creature> daughterCreature = mExecution->execute(*inCreature, *this, inFlaw);
+    if (daughterCreature)
+        handleBirth(inCreature, daughterCreature.get());
+
+    // if there was an error, adjust in the reaper queue
+    if (inCreature->cpu().flag())
+        mReaper.conditionalMoveUp(*inCreature);
+    else if (inCreature->lastInstruction() == k_mal || inCreature->lastInstruction() == k_divide)
+        mReaper.conditionalMoveDown(*inCreature);
+
+    // compute next copy error time
+    if ((mSettings.copyErrorRate() > 0.0) && (inCreature->lastInstruction() == k_mov_iab))
+        noteInstructionCopy();
 }
 
 bool
@@ -308,17 +539,33 @@ World::stepCreature(const Creature* inCreature)
     // run until this creature is current
     while (mTimeSlicer.currentCreature() != inCreature)
     {
-        iterate(1);
+        iterateSerially(1);
         if (inCreature->isDead())
             return false;
     }
 
-    iterate(1);
+    iterateSerially(1);
     return true;
 }
 
+void
+World::setShardThreads(u_int32_t inNumThreads)
+{
+    mShardThreads = inNumThreads;
+
+    // made again with the new number of threads when next needed
+    delete mShardedExecution;
+    mShardedExecution = NULL;
+}
+
 instruction_t
 World::mutateInstruction(instruction_t inInst, Settings::EMutationType inMutationType) const
+{
+    return mutateInstruction(inInst, inMutationType, mRNG);
+}
+
+instruction_t
+World::mutateInstruction(instruction_t inInst, Settings::EMutationType inMutationType, RandomLib::Random& inRNG)
 {
     instruction_t resultInst = inInst;
 
@@ -326,17 +573,17 @@ World::mutateInstruction(instruction_t inInst, Settings::EMutationType inMutatio
     {
         case Settings::kAddOrDec:
             {
-                int32_t delta = mRNG.Boolean() ? -1 : 1;
+                int32_t delta = inRNG.Boolean() ? -1 : 1;
                 resultInst = (inInst + kInstructionSetSize + delta) % kInstructionSetSize;
             }
             break;
 
         case Settings::kBitFlip:
-            resultInst ^= (1 << mRNG.Integer(5));
+            resultInst ^= (1 << inRNG.Integer(5));
             break;
 
         case Settings::kRandomChoice:
-            resultInst = mRNG.Integer(kInstructionSetSize);
+            resultInst = inRNG.Integer(kInstructionSetSize);
             break;
     }
     return resultInst;
@@ -368,10 +615,14 @@ World::destroyCreatures()
         if (theCreature->isInReaperList())
             mReaper.removeCreature(*theCreature);
 
+        if (theCreature->isInGenotypeList())
+            mInventory->creatureDied(theCreature->genotype(), *theCreature);
+
         theCreature->clearDaughter();
     }
 
     mCreatureIDMap.clear();
+    mStatistics.clear();
 }
 
 // this allocates space for the daughter in the cell map,
@@ -545,19 +796,19 @@ World::handleBirth(Creature* inParent, Creature* inChild)
                 // cout << "was: " << parentGenotype->name() << " " << parentGenotype->printableGenome() << endl;
                 // cout << "now: " << foundGenotype->name() << " " << foundGenotype->printableGenome() << endl;
                 // old genotype lost a member
-                mInventory->creatureDied(parentGenotype);
+                mInventory->creatureDied(parentGenotype, *inParent);
             }
 
             inParent->setGenotype(foundGenotype);
             inParent->setGenotypeDivergence(0);
-            mInventory->creatureBorn(foundGenotype);  // count the parent
+            mInventory->creatureBorn(foundGenotype, *inParent);  // count the parent
         }
 
         inChild->setGenotype(foundGenotype);
         inChild->setGenotypeDivergence(0);
         
         inChild->setParentalGenotype(inParent->genotype());
-        mInventory->creatureBorn(foundGenotype);  // count the child
+        mInventory->creatureBorn(foundGenotype, *inChild);  // count the child
     }
     else
     {
@@ -569,6 +820,10 @@ World::handleBirth(Creature* inParent, Creature* inChild)
     }
     
     inChild->onBirth(*this);
+    mStatistics.creatureBorn(*inChild);
+
+    if (mEvents.wantsBirths())
+        sendBirthEvent(inParent, *inChild, bredTrue);
 }
 
 void
@@ -577,9 +832,9 @@ World::handleDeath(Creature* inCreature)
     inCreature->onDeath(*this);
 
     if (inCreature->genotypeDivergence() == 0)
-        mInventory->creatureDied(inCreature->genotype());
+        mInventory->creatureDied(inCreature->genotype(), *inCreature);
 
-    eradicateCreature(inCreature);
+    eradicateCreature(inCreature, DeathEvent::kReaped);
 }
 
 int32_t
@@ -587,6 +842,14 @@ World::instructionFlaw(u_int64_t inInstructionCount)
 {
     int32_t theFlaw = mRNG.Boolean() ? 1 : -1;
 
+    if (mEvents.wantsMutations())
+    {
+        const Creature* curCreature = mTimeSlicer.currentCreature();
+        address_t flawAddress = curCreature->addressFromOffset(curCreature->cpu().instructionPointer());
+        instruction_t inst = mSoup->instructionAtAddress(flawAddress);
+        sendMutationEvent(MutationEvent::kFlaw, curCreature, flawAddress, inst, inst);
+    }
+
     computeNextInstructionFlaw(inInstructionCount);
     
     return theFlaw;
@@ -610,9 +873,12 @@ World::cosmicRay(u_int64_t inInstructionCount)
 {
     address_t   target = mRNG.Integer(mSoupSize);
 
-    instruction_t inst = mSoup->instructionAtAddress(target);
-    inst = mutateInstruction(inst, mSettings.mutationType());
+    instruction_t oldInst = mSoup->instructionAtAddress(target);
+    instruction_t inst = mutateInstruction(oldInst, mSettings.mutationType());
     mSoup->setInstructionAtAddress(target, inst);
+
+    if (mEvents.wantsMutations())
+        sendMutationEvent(MutationEvent::kCosmicRay, NULL, target, oldInst, inst);
     
     computeNextCosmicRay(inInstructionCount);
 }
@@ -644,6 +910,9 @@ World::creatureRemoved(Creature* inCreature)
 {
     BOOST_ASSERT(inCreature && inCreature->soup() == mSoup);
 
+    if (!inCreature->isEmbryo())
+        mStatistics.creatureDied(*inCreature);
+
     if (inCreature->isInReaperList())
         mReaper.removeCreature(*inCreature);
 
@@ -653,13 +922,95 @@ World::creatureRemoved(Creature* inCreature)
     mCreatureIDMap.erase(inCreature->creatureID());
 }
 
+void
+World::sendBirthEvent(const Creature* inParent, const Creature& inChild, bool inBredTrue) const
+{
+    BirthEvent event;
+    event.mInstructions     = mTimeSlicer.instructionsExecuted();
+    event.mParentID         = inParent ? inParent->creatureID() : 0;
+    event.mChildID          = inChild.creatureID();
+    event.mLocation         = inChild.location();
+    event.mLength           = inChild.length();
+    event.mGeneration       = inChild.generation();
+    event.mGenotype         = inChild.genotypeDivergence() == 0 ? inChild.genotype() : NULL;
+    event.mParentalGenotype = inChild.parentalGenotype();
+    event.mBredTrue         = inBredTrue;
+
+    mEvents.sendBirth(event);
+}
+
+void
+World::sendDeathEvent(const Creature& inCreature, DeathEvent::EReason inReason) const
+{
+    DeathEvent event;
+    event.mInstructions     = mTimeSlicer.instructionsExecuted();
+    event.mCreatureID       = inCreature.creatureID();
+    event.mReason           = inReason;
+    event.mLocation         = inCreature.location();
+    event.mLength           = inCreature.length();
+    event.mBirthInstructions = inCreature.originInstructions();
+    event.mNumOffspring     = inCreature.numOffspring();
+    event.mNumErrors        = inCreature.numErrors();
+    event.mGenotype         = inCreature.genotypeDivergence() == 0 ? inCreature.genotype() : NULL;
+
+    mEvents.sendDeath(event);
+}
+
+void
+World::sendMutationEvent(MutationEvent::EKind inKind, const Creature* inCreature, address_t inAddress,
+                         instruction_t inOldInstruction, instruction_t inNewInstruction) const
+{
+    MutationEvent event;
+    event.mInstructions     = mTimeSlicer.instructionsExecuted();
+    event.mKind             = inKind;
+    event.mCreatureID       = inCreature ? inCreature->creatureID() : 0;
+    event.mAddress          = inAddress;
+    event.mOldInstruction   = inOldInstruction;
+    event.mNewInstruction   = inNewInstruction;
+
+    mEvents.sendMutation(event);
+}
+
+void
+World::sendAllocationFailureEvent(const Creature& inCreature, AllocationFailureEvent::EReason inReason, u_int32_t inLength) const
+{
+    AllocationFailureEvent event;
+    event.mInstructions     = mTimeSlicer.instructionsExecuted();
+    event.mCreatureID       = inCreature.creatureID();
+    event.mReason           = inReason;
+    event.mRequestedLength  = inLength;
+
+    mEvents.sendAllocationFailure(event);
+}
+
 void
 World::wasDeserialized()
 {
+    rebuildPopulationState();
+
     mDataCollector->setNextCollectionInstructions(mTimeSlicer.instructionsExecuted());
     mDataCollector->setNextCollectionCycle(mTimeSlicer.cycleCount());
 }
 
+void
+World::rebuildPopulationState()
+{
+    mStatistics.clear();
+
+    CreatureIDMap::const_iterator theEnd = mCreatureIDMap.end();
+    for (CreatureIDMap::const_iterator it = mCreatureIDMap.begin(); it != theEnd; ++it)
+    {
+        Creature* curCreature = it->second.get();
+        if (curCreature->genotype() && curCreature->genotypeDivergence() == 0)
+            mInventory->restoreCreature(*curCreature);
+
+        if (!curCreature->isEmbryo())
+            mStatistics.creatureBorn(*curCreature);
+    }
+
+    mInventory->setStatistics(&mStatistics);
+}
+
 #pragma mark -
 
 // Settings
@@ -670,6 +1021,10 @@ World::setSettings(const Settings& inSettings)
     
     if (mSoupSize > 0)
         mSettings.recomputeMutationIntervals(mSoupSize);
+
+    // the number of shards may have changed
+    delete mShardedExecution;
+    mShardedExecution = NULL;
     
     computeNextMutationTimes();
 }
@@ -678,6 +1033,7 @@ void
 World::setInitialRandomSeed(u_int32_t inIntialSeed)
 {
     mRNG.Reseed(inIntialSeed);
+    mDataCollector->setSamplingSeed(inIntialSeed);
 }
 
 u_int32_t
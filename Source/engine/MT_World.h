@@ -15,6 +15,7 @@
 #include <boost/serialization/export.hpp>
 #include <boost/serialization/map.hpp>
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/version.hpp>
 
 #include <boost/thread.hpp>
 
@@ -32,18 +33,24 @@
 #include "MT_ExecutionUnit.h"
 #include "MT_ExecutionUnit0.h"      // needed for serialization registration
 #include "MT_Inventory.h"
+#include "MT_PopulationStatistics.h"
 #include "MT_Reaper.h"
 #include "MT_Settings.h"
 #include "MT_Soup.h"
 #include "MT_Timeslicer.h"
+#include "MT_WorldEvents.h"
 
 namespace MacTierra {
 
 class Creature;
+class InteractionMatrix;
+class ShardedExecution;
+class SoupHeatmap;
 
 class World : Noncopyable
 {
 friend class ExecutionUnit0;
+friend class ShardedExecution;
 public:
 
     World();
@@ -51,6 +58,20 @@ public:
 
     void                initializeSoup(u_int32_t inSoupSize);
 
+    // A deep copy of the soup, cell map, creatures, slicer and reaper order, inventory and random
+    // number generator, without going through an archive; it runs on exactly as this world would.
+    // Event listeners, the heatmap, the interaction matrix and the data collector's loggers and
+    // analyses are not copied. The second form reseeds the copy's generator and draws its next
+    // copy error, flaw and cosmic ray afresh, so that it goes its own way. Call between iterations.
+    World*              clone() const;
+    World*              clone(u_int32_t inRandomSeed) const;
+
+    // Removes every creature and genotype, zeroes the soup and the counts, and puts the world
+    // back as initializeSoup() left it, without reallocating the soup or cell map. Settings,
+    // event listeners and the data collector's loggers are kept. Reseed, then call setSettings()
+    // to draw the first mutation times, before inserting creatures. Call between iterations.
+    void                emptySoup();
+
     u_int32_t           soupSize() const    { return mSoupSize; }
 
     Soup*               soup() const        { return mSoup; }
@@ -58,28 +79,62 @@ public:
 
     const TimeSlicer&   timeSlicer() const { return mTimeSlicer; }
     const Reaper&       reaper() const  { return mReaper; }
+
+    const PopulationStatistics& statistics() const  { return mStatistics; }
     
     Inventory*          inventory() const   { return mInventory; }
 
     DataCollector*      dataCollector() const   { return mDataCollector; }
+
+    // inEventMask is a combination of WorldEventListener::EEventMask values. Listeners are not owned.
+    void                addEventListener(WorldEventListener* inListener, u_int32_t inEventMask);
+    void                removeEventListener(WorldEventListener* inListener);
+    const WorldEvents&  events() const          { return mEvents; }
+
+    // Optional soup activity counters, maintained by the execution unit. Not owned or archived.
+    // When the world is sharded, only the instructions run at the barriers are counted.
+    void                setHeatmap(SoupHeatmap* inHeatmap)  { mHeatmap = inHeatmap; }
+    SoupHeatmap*        heatmap() const             { return mHeatmap; }
+
+    // Optional counts of creatures executing or writing inside each other. Not owned or archived.
+    void                setInteractionMatrix(InteractionMatrix* inMatrix)   { mInteractions = inMatrix; }
+    InteractionMatrix*  interactionMatrix() const   { return mInteractions; }
     
     PassRefPtr<Creature> createCreature(u_int32_t inLength);
-    void                 eradicateCreature(Creature* inCreature);
+    void                 eradicateCreature(Creature* inCreature, DeathEvent::EReason inReason = DeathEvent::kKilled);
     
     const Creature*     creatureWithID(creature_id inCreatureID) const;
     
     PassRefPtr<Creature> insertCreature(address_t inAddress, const instruction_t* inInstructions, u_int32_t inLength);
     
+    // Runs the shards in parallel if the settings have more than one; see MT_ShardedExecution.h.
     void                iterate(u_int32_t inNumCycles);
     // execute one cycle for the current creature; at the end if its slice, execute all other creatures
     // and then step the same creature again. Return false if the creature could not be stepped (e.g. it died)
+    // Always steps serially, even if the world is sharded.
     bool                stepCreature(const Creature* inCreature);
 
+    // Threads to run the shards on; 0 means one per processor, and there are never more threads
+    // than shards. Results don't depend on the number of threads. Not archived.
+    void                setShardThreads(u_int32_t inNumThreads);
+    u_int32_t           shardThreads() const        { return mShardThreads; }
+    // NULL until the world has run sharded.
+    const ShardedExecution* shardedExecution() const { return mShardedExecution; }
+
+    // Whether iterating serially runs a creature's copy loop in one go, when it finds one; see
+    // ExecutionUnit::executeCopyLoop(). On by default. Results are exactly the same either way.
+    // Not archived.
+    void                setBulkCopyLoops(bool inBulk)   { mBulkCopyLoops = inBulk; }
+    bool                bulkCopyLoops() const           { return mBulkCopyLoops; }
+    // Instructions run that way.
+    u_int64_t           bulkCopyInstructions() const    { return mBulkCopyInstructions; }
+
     RandomLib::Random&  RNG()   { return mRNG; }
 
     bool                copyErrorPending() const { return mCopyErrorPending; }
 
     instruction_t       mutateInstruction(instruction_t inInst, Settings::EMutationType inMutationType) const;
+    static instruction_t mutateInstruction(instruction_t inInst, Settings::EMutationType inMutationType, RandomLib::Random& inRNG);
 
     // settings
     const Settings&     settings() const { return mSettings; }
@@ -100,6 +155,31 @@ protected:
 
     void            destroyCreatures();
 
+    void            iterateSerially(u_int32_t inNumCycles);
+
+    // The steps of iterateSerially(). startIterating() and startNextSlice() return the current
+    // creature, drawing its slice size when it starts a new slice, or NULL if there are none.
+    Creature*       startIterating();
+    void            stepCurrentCreature(Creature* inCreature);
+    Creature*       startNextSlice();
+
+    // Instructions that can run before data collection, a cosmic ray or a flaw falls due; 0 if
+    // one is due now.
+    u_int64_t       instructionsUntilNextEvent() const;
+
+    // Runs the creature's copy loop, if it is in one, within its slice and inMaxCycles, and
+    // counts the instructions. Returns how many ran.
+    u_int32_t       runCopyLoop(Creature* inCreature, u_int32_t inMaxCycles);
+
+    // Runs one instruction of the creature, handling any birth and moving it in the reaper queue.
+    // Doesn't count the instruction.
+    void            runInstruction(Creature* inCreature, int32_t inFlaw);
+
+    void            writeInstruction(address_t inAddress, instruction_t inInst)
+                    {
+                        mSoup->setInstructionAtAddress(inAddress, inInst);
+                    }
+
     // handle the 'mal' instruction
     PassRefPtr<Creature> allocateSpaceForOffspring(const Creature& inParent, u_int32_t inDaughterLength);
 
@@ -143,7 +223,17 @@ protected:
     void            creatureAdded(Creature* inCreature);
     void            creatureRemoved(Creature* inCreature);
 
+    // Only call these if mEvents wants the event.
+    void            sendBirthEvent(const Creature* inParent, const Creature& inChild, bool inBredTrue) const;
+    void            sendDeathEvent(const Creature& inCreature, DeathEvent::EReason inReason) const;
+    void            sendMutationEvent(MutationEvent::EKind inKind, const Creature* inCreature, address_t inAddress,
+                                      instruction_t inOldInstruction, instruction_t inNewInstruction) const;
+    void            sendAllocationFailureEvent(const Creature& inCreature, AllocationFailureEvent::EReason inReason, u_int32_t inLength) const;
+
     void            wasDeserialized();
+    // Rebuilds the per-genotype creature lists and the population statistics, which are neither
+    // archived nor cloned.
+    void            rebuildPopulationState();
     
 private:
     friend class ::boost::serialization::access;
@@ -181,6 +271,8 @@ private:
 
         ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("next_flaw_time", mNextFlawInstruction);
         ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("next_cosmic_ray_time", mNextCosmicRayInstruction);
+
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("shard_instructions_owed", mShardInstructionsOwed);
     }
 
     template<class Archive> void load(Archive& ar, const unsigned int version)
@@ -219,6 +311,9 @@ private:
         ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("next_flaw_time", mNextFlawInstruction);
         ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("next_cosmic_ray_time", mNextCosmicRayInstruction);
 
+        if (version > 0)
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("shard_instructions_owed", mShardInstructionsOwed);
+
         wasDeserialized();
     }
 
@@ -253,8 +348,20 @@ protected:
     
     Inventory*      mInventory;
     
+    PopulationStatistics    mStatistics;    // not archived
+
     DataCollector*  mDataCollector;
 
+    WorldEvents     mEvents;                    // not archived
+    SoupHeatmap*    mHeatmap;                   // not archived
+    InteractionMatrix*  mInteractions;          // not archived
+
+    ShardedExecution*   mShardedExecution;      // created when first run sharded; not archived
+    u_int32_t           mShardThreads;          // not archived
+
+    bool                mBulkCopyLoops;         // not archived
+    u_int64_t           mBulkCopyInstructions;  // not archived
+
     // runtime
     u_int32_t       mCurCreatureCycles;         // fAlive
     u_int32_t       mCurCreatureSliceCycles;    // fCurCpuSliceSize
@@ -265,6 +372,8 @@ protected:
 
     u_int64_t       mNextFlawInstruction;
     u_int64_t       mNextCosmicRayInstruction;    
+
+    u_int64_t       mShardInstructionsOwed;     // asked of the shards, but short of a whole epoch
 };
 
 } // namespace MacTierra
@@ -298,4 +407,7 @@ inline void serialize(Archive & ar, RefPtr<MacTierra::Creature>& t, const unsign
 } // namespace boost
 
 
+// version 1 added the instructions owed by the shards
+BOOST_CLASS_VERSION(MacTierra::World, 1)
+
 #endif // MT_World_h
@@ -0,0 +1,51 @@
+/*
+ *  MT_WorldEvents.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <algorithm>
+
+#include "MT_WorldEvents.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+static void removeFromVector(WorldEvents::ListenerVector& ioListeners, WorldEventListener* inListener)
+{
+    ioListeners.erase(remove(ioListeners.begin(), ioListeners.end(), inListener), ioListeners.end());
+}
+
+void
+WorldEvents::addListener(WorldEventListener* inListener, u_int32_t inEventMask)
+{
+    // re-registering replaces the old mask
+    removeListener(inListener);
+
+    if (inEventMask & WorldEventListener::kBirthEvents)
+        mBirthListeners.push_back(inListener);
+
+    if (inEventMask & WorldEventListener::kDeathEvents)
+        mDeathListeners.push_back(inListener);
+
+    if (inEventMask & WorldEventListener::kMutationEvents)
+        mMutationListeners.push_back(inListener);
+
+    if (inEventMask & WorldEventListener::kAllocationFailureEvents)
+        mAllocationFailureListeners.push_back(inListener);
+}
+
+void
+WorldEvents::removeListener(WorldEventListener* inListener)
+{
+    removeFromVector(mBirthListeners, inListener);
+    removeFromVector(mDeathListeners, inListener);
+    removeFromVector(mMutationListeners, inListener);
+    removeFromVector(mAllocationFailureListeners, inListener);
+}
+
+} // namespace MacTierra
@@ -0,0 +1,161 @@
+/*
+ *  MT_WorldEvents.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_WorldEvents_h
+#define MT_WorldEvents_h
+
+#include <vector>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+
+namespace MacTierra {
+
+class InventoryGenotype;
+
+// Events are built on the stack and passed by reference, and are only valid for the duration
+// of the call. They carry IDs and plain values rather than creatures, so listeners can't
+// hold on to creatures by accident.
+
+struct BirthEvent
+{
+    u_int64_t       mInstructions;
+    creature_id     mParentID;          // 0 for creatures inserted into the soup
+    creature_id     mChildID;
+    address_t       mLocation;
+    u_int32_t       mLength;
+    u_int32_t       mGeneration;
+    const InventoryGenotype* mGenotype;         // NULL if the child is not counted in the inventory
+    const InventoryGenotype* mParentalGenotype;
+    bool            mBredTrue;
+};
+
+struct DeathEvent
+{
+    enum EReason {
+        kReaped,            // taken by the reaper
+        kKilled,            // removed by the user, or by an engine client
+        kParentDied         // an embryo whose parent died before dividing
+    };
+
+    u_int64_t       mInstructions;
+    creature_id     mCreatureID;
+    EReason         mReason;
+    address_t       mLocation;
+    u_int32_t       mLength;
+    u_int64_t       mBirthInstructions;
+    u_int32_t       mNumOffspring;
+    u_int32_t       mNumErrors;
+    const InventoryGenotype* mGenotype;
+};
+
+struct MutationEvent
+{
+    enum EKind {
+        kCosmicRay,
+        kCopyError,
+        kFlaw
+    };
+
+    u_int64_t       mInstructions;
+    EKind           mKind;
+    creature_id     mCreatureID;        // 0 for cosmic rays
+    address_t       mAddress;           // not meaningful for flaws
+    instruction_t   mOldInstruction;
+    instruction_t   mNewInstruction;
+};
+
+struct AllocationFailureEvent
+{
+    enum EReason {
+        kBadLength,         // too small, or too large relative to the mother
+        kAlreadyDividing,
+        kNoSpace
+    };
+
+    u_int64_t       mInstructions;
+    creature_id     mCreatureID;
+    EReason         mReason;
+    u_int32_t       mRequestedLength;
+};
+
+// Subclass and register with World::addEventListener(), passing a mask of the events
+// you want. Listeners are called on the engine thread, with the engine in the middle of
+// an instruction, so must not change the world.
+class WorldEventListener
+{
+public:
+    enum EEventMask {
+        kBirthEvents                = 1 << 0,
+        kDeathEvents                = 1 << 1,
+        kMutationEvents             = 1 << 2,
+        kAllocationFailureEvents    = 1 << 3,
+
+        kAllEvents                  = 0xF
+    };
+
+    virtual ~WorldEventListener() {}
+
+    virtual void    creatureBorn(const BirthEvent& inEvent)                 {}
+    virtual void    creatureDied(const DeathEvent& inEvent)                 {}
+    virtual void    mutationOccurred(const MutationEvent& inEvent)          {}
+    virtual void    allocationFailed(const AllocationFailureEvent& inEvent) {}
+};
+
+// The listeners for each kind of event are sorted out when they are registered, so sending
+// an event that nobody wants costs one test of an empty vector, and the event is never built.
+class WorldEvents : Noncopyable
+{
+public:
+    typedef std::vector<WorldEventListener*> ListenerVector;
+
+    void            addListener(WorldEventListener* inListener, u_int32_t inEventMask);
+    void            removeListener(WorldEventListener* inListener);
+
+    bool            wantsBirths() const             { return !mBirthListeners.empty(); }
+    bool            wantsDeaths() const             { return !mDeathListeners.empty(); }
+    bool            wantsMutations() const          { return !mMutationListeners.empty(); }
+    bool            wantsAllocationFailures() const { return !mAllocationFailureListeners.empty(); }
+
+    void            sendBirth(const BirthEvent& inEvent) const
+    {
+        for (ListenerVector::const_iterator it = mBirthListeners.begin(); it != mBirthListeners.end(); ++it)
+            (*it)->creatureBorn(inEvent);
+    }
+
+    void            sendDeath(const DeathEvent& inEvent) const
+    {
+        for (ListenerVector::const_iterator it = mDeathListeners.begin(); it != mDeathListeners.end(); ++it)
+            (*it)->creatureDied(inEvent);
+    }
+
+    void            sendMutation(const MutationEvent& inEvent) const
+    {
+        for (ListenerVector::const_iterator it = mMutationListeners.begin(); it != mMutationListeners.end(); ++it)
+            (*it)->mutationOccurred(inEvent);
+    }
+
+    void            sendAllocationFailure(const AllocationFailureEvent& inEvent) const
+    {
+        for (ListenerVector::const_iterator it = mAllocationFailureListeners.begin(); it != mAllocationFailureListeners.end(); ++it)
+            (*it)->allocationFailed(inEvent);
+    }
+
+protected:
+
+    ListenerVector  mBirthListeners;
+    ListenerVector  mDeathListeners;
+    ListenerVector  mMutationListeners;
+    ListenerVector  mAllocationFailureListeners;
+};
+
+} // namespace MacTierra
+
+#endif // MT_WorldEvents_h
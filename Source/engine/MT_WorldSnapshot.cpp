@@ -0,0 +1,82 @@
+/*
+ *  MT_WorldSnapshot.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include <map>
+
+#include "MT_WorldSnapshot.h"
+
+#include "MT_CellMap.h"
+#include "MT_Creature.h"
+#include "MT_Inventory.h"
+#include "MT_Soup.h"
+#include "MT_World.h"
+
+namespace MacTierra {
+
+using namespace std;
+
+WorldSnapshot::WorldSnapshot(const World& inWorld, u_int64_t inInstructionCount, u_int64_t inSlicerCycles)
+: mInstructions(inInstructionCount)
+, mSlicerCycles(inSlicerCycles)
+{
+    const instruction_t* soupData = inWorld.soup()->soup();
+    mSoup.assign(soupData, soupData + inWorld.soupSize());
+
+    Inventory::GenotypeVector aliveGenotypes;
+    inWorld.inventory()->genotypesAboveCount(0, aliveGenotypes);
+
+    typedef map<const InventoryGenotype*, int32_t> GenotypeIndexMap;
+    GenotypeIndexMap genotypeIndices;
+
+    mGenotypes.resize(aliveGenotypes.size());
+    for (size_t i = 0; i < aliveGenotypes.size(); ++i)
+    {
+        const InventoryGenotype* genotype = aliveGenotypes[i];
+        GenotypeSnapshot& genotypeSnapshot = mGenotypes[i];
+
+        genotypeSnapshot.mName = genotype->name();
+        genotypeSnapshot.mGenome = genotype->genome();
+        genotypeSnapshot.mNumAlive = genotype->numberAlive();
+        genotypeSnapshot.mNumEverLived = genotype->numberEverLived();
+        genotypeSnapshot.mOriginInstructions = genotype->originInstructions();
+
+        genotypeIndices[genotype] = i;
+    }
+
+    const CellMap::CreatureList& cells = inWorld.cellMap()->cells();
+    mCells.resize(cells.size());
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        const Creature* creature = cells[i].mData;
+        CellSnapshot& cellSnapshot = mCells[i];
+
+        cellSnapshot.mStart = cells[i].start();
+        cellSnapshot.mLength = cells[i].length();
+        cellSnapshot.mCreatureID = creature->creatureID();
+        cellSnapshot.mGeneration = creature->generation();
+
+        GenotypeIndexMap::const_iterator findIter = genotypeIndices.find(creature->genotype());
+        cellSnapshot.mGenotypeIndex = (findIter != genotypeIndices.end()) ? findIter->second : -1;
+    }
+}
+
+std::string
+WorldSnapshot::cellInstructions(const CellSnapshot& inCell) const
+{
+    std::string instructions;
+    instructions.reserve(inCell.mLength);
+
+    const u_int32_t soupSize = mSoup.size();
+    for (u_int32_t i = 0; i < inCell.mLength; ++i)
+        instructions.push_back(static_cast<char>(mSoup[(inCell.mStart + i) % soupSize]));
+
+    return instructions;
+}
+
+} // namespace MacTierra
@@ -0,0 +1,100 @@
+/*
+ *  MT_WorldSnapshot.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MT_WorldSnapshot_h
+#define MT_WorldSnapshot_h
+
+#include <string>
+#include <vector>
+
+#include <wtf/Noncopyable.h>
+
+#include "MT_Engine.h"
+#include "MT_Genotype.h"
+
+namespace MacTierra {
+
+class World;
+
+// A copy of the soup, the cell map and the living genotypes in the inventory, taken on the
+// engine thread at a collection. It shares nothing with the world, so analyses can read it on
+// other threads while the engine carries on.
+class WorldSnapshot : Noncopyable
+{
+public:
+
+    struct CellSnapshot
+    {
+        address_t       mStart;
+        u_int32_t       mLength;
+        creature_id     mCreatureID;
+        u_int32_t       mGeneration;
+        int32_t         mGenotypeIndex;     // into genotypes(), or -1 if the creature has no genotype
+    };
+
+    struct GenotypeSnapshot
+    {
+        std::string     mName;
+        GenomeData      mGenome;
+        u_int32_t       mNumAlive;
+        u_int32_t       mNumEverLived;
+        u_int64_t       mOriginInstructions;
+    };
+
+    WorldSnapshot(const World& inWorld, u_int64_t inInstructionCount, u_int64_t inSlicerCycles);
+
+    u_int64_t       instructions() const    { return mInstructions; }
+    u_int64_t       slicerCycles() const    { return mSlicerCycles; }
+
+    u_int32_t       soupSize() const        { return mSoup.size(); }
+    const std::vector<instruction_t>&   soup() const        { return mSoup; }
+
+    // in address order
+    const std::vector<CellSnapshot>&    cells() const       { return mCells; }
+    // most common first
+    const std::vector<GenotypeSnapshot>& genotypes() const  { return mGenotypes; }
+
+    // The instructions of a cell, as they are now, which may differ from its genotype's genome.
+    std::string     cellInstructions(const CellSnapshot& inCell) const;
+
+protected:
+
+    u_int64_t                       mInstructions;
+    u_int64_t                       mSlicerCycles;
+
+    std::vector<instruction_t>      mSoup;
+    std::vector<CellSnapshot>       mCells;
+    std::vector<GenotypeSnapshot>   mGenotypes;
+};
+
+// Results are subclassed by each analysis.
+class AnalysisResult
+{
+public:
+    virtual ~AnalysisResult() {}
+};
+
+// An analysis that runs on the DataCollector's analysis threads. See DataCollector::addAnalysis().
+class SnapshotAnalysis
+{
+public:
+    virtual ~SnapshotAnalysis() {}
+
+    // Called on a worker thread, possibly for several snapshots at once, so it should only
+    // read the snapshot and the analysis's own settings.
+    virtual AnalysisResult* analyze(const WorldSnapshot& inSnapshot) const = 0;
+
+    // Called on the engine thread, in the order the snapshots were taken. The collector deletes
+    // the result afterwards.
+    virtual void    resultReady(const WorldSnapshot& inSnapshot, AnalysisResult* inResult) = 0;
+};
+
+} // namespace MacTierra
+
+#endif // MT_WorldSnapshot_h
@@ -0,0 +1,161 @@
+/*
+ *  ArchipelagoTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "ArchipelagoTests.h"
+
+#include <string.h>
+
+#include <iostream>
+#include <vector>
+
+#include "MT_Ancestor.h"
+#include "MT_Archipelago.h"
+#include "MT_CellMap.h"
+#include "MT_Soup.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static const u_int32_t kSoupSize = 20480;
+
+static bool neighborsAre(const Archipelago& inArchipelago, u_int32_t inIndex, const u_int32_t* inExpected, size_t inCount)
+{
+    vector<u_int32_t> neighbors;
+    inArchipelago.neighbors(inIndex, neighbors);
+    return neighbors == vector<u_int32_t>(inExpected, inExpected + inCount);
+}
+
+static bool soupsEqual(const World* inLHS, const World* inRHS)
+{
+    return memcmp(inLHS->soup()->soup(), inRHS->soup()->soup(), inLHS->soupSize()) == 0;
+}
+
+ArchipelagoTests::ArchipelagoTests()
+{
+}
+
+ArchipelagoTests::~ArchipelagoTests()
+{
+}
+
+void
+ArchipelagoTests::setUp()
+{
+}
+
+void
+ArchipelagoTests::tearDown()
+{
+}
+
+void
+ArchipelagoTests::testTopology()
+{
+    const Settings settings = Settings::zeroMutationSettings();
+
+    Archipelago ring(5, 1024, settings, 1, Archipelago::kRing, 1);
+    const u_int32_t ring0[] = { 1, 4 };
+    const u_int32_t ring2[] = { 1, 3 };
+    TEST_CONDITION(neighborsAre(ring, 0, ring0, 2));
+    TEST_CONDITION(neighborsAre(ring, 2, ring2, 2));
+
+    // two islands are each other's only neighbor
+    Archipelago pair(2, 1024, settings, 1, Archipelago::kRing, 1);
+    const u_int32_t pair0[] = { 1 };
+    TEST_CONDITION(neighborsAre(pair, 0, pair0, 1));
+
+    // 12 islands make 3 rows of 4
+    Archipelago grid(12, 1024, settings, 1, Archipelago::kGrid, 1);
+    const u_int32_t grid0[] = { 1, 3, 4, 8 };
+    const u_int32_t grid5[] = { 1, 4, 6, 9 };
+    TEST_CONDITION(neighborsAre(grid, 0, grid0, 4));
+    TEST_CONDITION(neighborsAre(grid, 5, grid5, 4));
+
+    Archipelago full(4, 1024, settings, 1, Archipelago::kFullyConnected, 1);
+    const u_int32_t full2[] = { 0, 1, 3 };
+    TEST_CONDITION(neighborsAre(full, 2, full2, 3));
+
+    Archipelago::ETopology topology;
+    TEST_CONDITION(Archipelago::topologyFromName("grid", topology) && topology == Archipelago::kGrid);
+    TEST_CONDITION(!Archipelago::topologyFromName("tree", topology));
+    TEST_CONDITION(string(Archipelago::nameForTopology(Archipelago::kFullyConnected)) == "full");
+}
+
+void
+ArchipelagoTests::testMigration()
+{
+    // only the first island is seeded; the others are populated by migrants
+    Archipelago archipelago(3, kSoupSize, Settings::zeroMutationSettings(), 1, Archipelago::kRing, 3);
+    archipelago.setMigrationInterval(100000);
+    archipelago.setMigrantsPerIsland(2);
+    archipelago.island(0)->insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+
+    archipelago.run(250000);
+    TEST_CONDITION(archipelago.instructionsRun() == 250000);
+    TEST_CONDITION(archipelago.numMigrations() == 2);
+    TEST_CONDITION(archipelago.numMigrants() > 0);
+
+    for (u_int32_t i = 0; i < archipelago.numIslands(); ++i)
+        TEST_CONDITION(archipelago.island(i)->cellMap()->numCreatures() > 0);
+
+    // the rest of the epoch, then a migration at the boundary
+    archipelago.run(50000);
+    TEST_CONDITION(archipelago.numMigrations() == 3);
+}
+
+void
+ArchipelagoTests::testDeterminism()
+{
+    const Settings settings = Settings::mediumMutationSettings(kSoupSize);
+
+    Archipelago serial(4, kSoupSize, settings, 17, Archipelago::kRing, 1);
+    Archipelago parallel(4, kSoupSize, settings, 17, Archipelago::kRing, 4);
+    TEST_CONDITION(parallel.numThreads() == 4);
+
+    Archipelago* archipelagos[] = { &serial, &parallel };
+    for (u_int32_t i = 0; i < 2; ++i)
+    {
+        archipelagos[i]->setMigrationInterval(200000);
+        archipelagos[i]->setMigrantsPerIsland(3);
+        archipelagos[i]->seedIslands(kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+    }
+
+    // the parallel one gets there in uneven steps
+    serial.run(1000000);
+    parallel.run(350000);
+    parallel.run(650000);
+
+    TEST_CONDITION(serial.numMigrants() + serial.numMigrantsLost() == 5 * 4 * 3);
+    TEST_CONDITION(serial.numMigrants() == parallel.numMigrants());
+
+    bool islandsMatch = true;
+    for (u_int32_t i = 0; i < serial.numIslands(); ++i)
+    {
+        if (!soupsEqual(serial.island(i), parallel.island(i))
+            || serial.island(i)->cellMap()->numCreatures() != parallel.island(i)->cellMap()->numCreatures())
+            islandsMatch = false;
+    }
+    TEST_CONDITION(islandsMatch);
+
+    // islands have their own random streams
+    TEST_CONDITION(!soupsEqual(serial.island(0), serial.island(1)));
+}
+
+void
+ArchipelagoTests::runTest()
+{
+    std::cout << "ArchipelagoTests" << std::endl;
+
+    testTopology();
+    testMigration();
+    testDeterminism();
+}
+
+TestRegistration archipelagoTestReg(new ArchipelagoTests);
@@ -0,0 +1,36 @@
+/*
+ *  ArchipelagoTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef ArchipelagoTests_h
+#define ArchipelagoTests_h
+
+#include "TestRunner.h"
+
+class ArchipelagoTests : public TestCase
+{
+public:
+    ArchipelagoTests();
+    ~ArchipelagoTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testTopology();
+    void testMigration();
+    void testDeterminism();
+
+};
+
+
+#endif // ArchipelagoTests_h
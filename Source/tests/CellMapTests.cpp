@@ -146,6 +146,21 @@ CellMapTests::runTest()
 
     cellMap->printCreatures();
 
+    // no room anywhere, with the backwards search wrapping first
+    {
+        CellMap fullMap(kSoupSize);
+
+        RefPtr<Creature>   firstCreature = mWorld->createCreature(500);
+        firstCreature->setLocation(0);
+        RefPtr<Creature>   secondCreature = mWorld->createCreature(510);
+        secondCreature->setLocation(510);
+
+        TEST_CONDITION(fullMap.insertCreature(firstCreature.get()));
+        TEST_CONDITION(fullMap.insertCreature(secondCreature.get()));
+
+        spaceAddr = 505;
+        TEST_CONDITION(!fullMap.searchForSpace(spaceAddr, 100, kSoupSize, CellMap::kBothways));
+    }
 }
 
 TestRegistration cellMapTestReg(new CellMapTests);
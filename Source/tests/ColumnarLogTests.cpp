@@ -0,0 +1,228 @@
+/*
+ *  ColumnarLogTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "ColumnarLogTests.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "MT_Ancestor.h"
+#include "MT_ColumnarLog.h"
+#include "MT_DataLogSinks.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static std::string temporaryLogPath()
+{
+    char path[] = "/tmp/mactierra_columnar_log_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd != -1)
+        close(fd);
+    return path;
+}
+
+static u_int64_t fileLength(const std::string& inPath)
+{
+    std::ifstream fileStream(inPath.c_str(), ios::in | ios::binary | ios::ate);
+    return fileStream.tellg();
+}
+
+static void writeTestLog(const std::string& inPath, u_int32_t inNumRows)
+{
+    ColumnarLogWriter writer(10);
+    writer.schema().addColumn("count", ColumnarLogSchema::kUInt64Column);
+    writer.schema().addColumn("ratio", ColumnarLogSchema::kDoubleColumn);
+    writer.schema().addColumn("name", ColumnarLogSchema::kStringColumn);
+    writer.open(inPath);
+
+    for (u_int32_t i = 0; i < inNumRows; ++i)
+    {
+        std::ostringstream name;
+        name << "row " << i;
+
+        writer.appendUInt64(i * 1000ULL);
+        writer.appendDouble(i / 4.0);
+        writer.appendString(name.str());
+        writer.finishRow();
+    }
+
+    writer.close();
+}
+
+ColumnarLogTests::ColumnarLogTests()
+{
+}
+
+ColumnarLogTests::~ColumnarLogTests()
+{
+}
+
+void
+ColumnarLogTests::setUp()
+{
+}
+
+void
+ColumnarLogTests::tearDown()
+{
+}
+
+void
+ColumnarLogTests::testRoundTrip()
+{
+    const std::string logPath = temporaryLogPath();
+    writeTestLog(logPath, 95);
+
+    ColumnarLogReader reader;
+    TEST_CONDITION(reader.open(logPath));
+    TEST_CONDITION(reader.schema().numColumns() == 3);
+    TEST_CONDITION(reader.schema().columnIndex("ratio") == 1);
+    TEST_CONDITION(reader.schema().column(2).mType == ColumnarLogSchema::kStringColumn);
+
+    u_int32_t numGroups = 0;
+    u_int32_t row = 0;
+    bool matches = true;
+    while (reader.nextGroup())
+    {
+        ++numGroups;
+        for (u_int32_t i = 0; i < reader.groupRows(); ++i, ++row)
+        {
+            std::ostringstream name;
+            name << "row " << row;
+
+            if (reader.uint64Column(0)[i] != row * 1000ULL || reader.doubleColumn(1)[i] != row / 4.0 || reader.stringColumn(2)[i] != name.str())
+                matches = false;
+        }
+    }
+
+    TEST_CONDITION(matches);
+    TEST_CONDITION(row == 95);
+    TEST_CONDITION(numGroups == 10);
+    TEST_CONDITION(!reader.isTruncated());
+
+    // CSV
+    ColumnarLogReader csvReader;
+    TEST_CONDITION(csvReader.open(logPath));
+    std::ostringstream csvStream;
+    TEST_CONDITION(csvReader.writeCSV(csvStream) == 95);
+
+    std::istringstream csvLines(csvStream.str());
+    std::string line;
+    std::getline(csvLines, line);
+    TEST_CONDITION(line == "count,ratio,name");
+    std::getline(csvLines, line);
+    TEST_CONDITION(line == "0,0,row 0");
+    std::getline(csvLines, line);
+    TEST_CONDITION(line == "1000,0.25,row 1");
+
+    unlink(logPath.c_str());
+}
+
+void
+ColumnarLogTests::testTruncatedLog()
+{
+    const std::string logPath = temporaryLogPath();
+    writeTestLog(logPath, 95);
+
+    // cut the last group short, as if the run had been killed while writing it
+    TEST_CONDITION(truncate(logPath.c_str(), fileLength(logPath) - 7) == 0);
+
+    ColumnarLogReader reader;
+    TEST_CONDITION(reader.open(logPath));
+
+    u_int32_t numRows = 0;
+    while (reader.nextGroup())
+        numRows += reader.groupRows();
+
+    TEST_CONDITION(numRows == 90);
+    TEST_CONDITION(reader.isTruncated());
+
+    unlink(logPath.c_str());
+}
+
+void
+ColumnarLogTests::testDataLogSinks()
+{
+    const std::string populationPath = temporaryLogPath();
+    const std::string genotypePath = temporaryLogPath();
+
+    const u_int32_t kSoupSize = 20480;
+    World world;
+    world.setInitialRandomSeed(1);
+    world.initializeSoup(kSoupSize);
+    world.setSettings(Settings::mediumMutationSettings(kSoupSize));
+    world.insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+
+    PopulationLogSink populationLog;
+    GenotypeLogSink genotypeLog(3);
+    TEST_CONDITION(populationLog.open(populationPath));
+    TEST_CONDITION(genotypeLog.open(genotypePath));
+
+    DataCollector* collector = world.dataCollector();
+    collector->setCollectionInterval(50000, world.timeSlicer().instructionsExecuted());
+    collector->addRecordRing(populationLog.recordRing());
+    collector->addPeriodicLogger(&genotypeLog);
+
+    world.iterate(1000000);
+
+    collector->removeRecordRing(populationLog.recordRing());
+    collector->removePeriodicLogger(&genotypeLog);
+    populationLog.close();
+    genotypeLog.close();
+
+    // the cyclical collections' records are on the ring too, but aren't logged
+    const u_int32_t numRows = populationLog.numRows();
+    TEST_CONDITION(numRows >= 19);
+    TEST_CONDITION(populationLog.numDropped() == 0);
+
+    ColumnarLogReader populationReader;
+    TEST_CONDITION(populationReader.open(populationPath));
+    TEST_CONDITION(populationReader.schema().column(0).mName == "instructions");
+    TEST_CONDITION(populationReader.nextGroup());
+    TEST_CONDITION(populationReader.groupRows() == numRows);
+
+    bool onInterval = true;
+    for (u_int32_t i = 0; i < numRows; ++i)
+    {
+        if (populationReader.uint64Column(0)[i] != (i + 1) * 50000ULL)
+            onInterval = false;
+    }
+    TEST_CONDITION(onInterval);
+
+    const int32_t populationColumn = populationReader.schema().columnIndex("population");
+    TEST_CONDITION(populationColumn >= 0 && populationReader.uint64Column(populationColumn)[0] > 0);
+
+    ColumnarLogReader genotypeReader;
+    TEST_CONDITION(genotypeReader.open(genotypePath));
+    TEST_CONDITION(genotypeReader.schema().numColumns() == 9);
+    TEST_CONDITION(genotypeReader.nextGroup());
+    TEST_CONDITION(genotypeReader.stringColumn(genotypeReader.schema().columnIndex("genotype_1"))[0] == "80aaaaa");
+
+    unlink(populationPath.c_str());
+    unlink(genotypePath.c_str());
+}
+
+void
+ColumnarLogTests::runTest()
+{
+    std::cout << "ColumnarLogTests" << std::endl;
+
+    testRoundTrip();
+    testTruncatedLog();
+    testDataLogSinks();
+}
+
+TestRegistration columnarLogTestReg(new ColumnarLogTests);
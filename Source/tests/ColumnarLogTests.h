@@ -0,0 +1,36 @@
+/*
+ *  ColumnarLogTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef ColumnarLogTests_h
+#define ColumnarLogTests_h
+
+#include "TestRunner.h"
+
+class ColumnarLogTests : public TestCase
+{
+public:
+    ColumnarLogTests();
+    ~ColumnarLogTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testRoundTrip();
+    void testTruncatedLog();
+    void testDataLogSinks();
+
+};
+
+
+#endif // ColumnarLogTests_h
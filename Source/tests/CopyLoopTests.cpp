@@ -0,0 +1,191 @@
+/*
+ *  CopyLoopTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "CopyLoopTests.h"
+
+#include <string.h>
+
+#include <iostream>
+
+#include "MT_Cpu.h"
+#include "MT_Creature.h"
+#include "MT_DataCollection.h"
+#include "MT_InstructionSet.h"
+#include "MT_ISA.h"
+#include "MT_Soup.h"
+#include "MT_World.h"
+
+#include "WorldTestHelpers.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static const u_int32_t kSoupSize = 8 * 1024;
+
+// a copy loop at offset 2, found by the jmp back through the template at 0
+static const instruction_t kLoopGenome[] = {
+    k_nop_1,
+    k_nop_1,
+    k_mov_iab,
+    k_dec_c,
+    k_if_cz,
+    k_jmp,
+    k_nop_0,
+    k_inc_a,
+    k_inc_b,
+    k_jmp,
+    k_nop_0,
+    k_nop_0
+};
+
+static const u_int32_t kLoopCreatureLength = 40;
+
+// A world with one creature about to run kLoopGenome, copying itself from offset 2 to inTarget.
+static World* createLoopWorld(int32_t inTarget, int32_t inCount)
+{
+    World* world = new World();
+    world->initializeSoup(kSoupSize);
+    world->setSettings(Settings::zeroMutationSettings());
+    world->setInitialRandomSeed(1);
+    world->dataCollector()->setCollectionInterval(100000, 0);
+
+    instruction_t genome[kLoopCreatureLength];
+    memset(genome, k_zero, sizeof(genome));
+    memcpy(genome, kLoopGenome, sizeof(kLoopGenome));
+    RefPtr<Creature> creature = world->insertCreature(kSoupSize / 2, genome, kLoopCreatureLength);
+
+    Cpu& cpu = creature->cpu();
+    cpu.mInstructionPointer = 2;
+    cpu.mRegisters[k_ax] = inTarget;
+    cpu.mRegisters[k_bx] = 2;
+    cpu.mRegisters[k_cx] = inCount;
+    return world;
+}
+
+static World* singleSteppingClone(const World* inWorld)
+{
+    World* theCopy = inWorld->clone();
+    theCopy->setBulkCopyLoops(false);
+    return theCopy;
+}
+
+CopyLoopTests::CopyLoopTests()
+{
+}
+
+CopyLoopTests::~CopyLoopTests()
+{
+}
+
+void
+CopyLoopTests::setUp()
+{
+}
+
+void
+CopyLoopTests::tearDown()
+{
+}
+
+void
+CopyLoopTests::testMatchesSingleStepping()
+{
+    // with and without copy errors, flaws and cosmic rays
+    const u_int32_t kNumWorlds = 4;
+    const u_int32_t kSoupSizes[kNumWorlds] = { 16 * 1024, 32 * 1024, 32 * 1024, 64 * 1024 };
+
+    bool allMatch = true;
+    for (u_int32_t i = 0; i < kNumWorlds; ++i)
+    {
+        Settings settings = (i == 0) ? Settings::zeroMutationSettings() : Settings::mediumMutationSettings(kSoupSizes[i]);
+        if (i == 3)
+        {
+            // frequent enough to fall inside most copy loops
+            settings.setCopyErrorRate(2.0E-2);
+            settings.setFlawRate(5.0E-3);
+        }
+
+        World* world = createAncestorWorld(kSoupSizes[i], settings, 200 + i);
+        World* reference = singleSteppingClone(world);
+        TEST_CONDITION(world->bulkCopyLoops() && !reference->bulkCopyLoops());
+
+        // uneven lengths, so that iterations stop in the middle of loops and slices
+        const u_int32_t kIterationLengths[] = { 1, 777, 250001, 1000000, 333333 };
+        for (u_int32_t j = 0; j < sizeof(kIterationLengths) / sizeof(kIterationLengths[0]); ++j)
+        {
+            world->iterate(kIterationLengths[j]);
+            reference->iterate(kIterationLengths[j]);
+            if (!worldsMatch(world, reference))
+            {
+                cout << "World " << i << " differs from single stepping after " << world->timeSlicer().instructionsExecuted() << " instructions" << endl;
+                allMatch = false;
+                break;
+            }
+        }
+
+        // the ancestor spends most of its time copying, until frequent copy errors break its loop
+        TEST_CONDITION(world->bulkCopyInstructions() > world->timeSlicer().instructionsExecuted() / ((i == 3) ? 5 : 2));
+        TEST_CONDITION(reference->bulkCopyInstructions() == 0);
+
+        delete reference;
+        delete world;
+    }
+    TEST_CONDITION(allMatch);
+}
+
+void
+CopyLoopTests::testStopsAtFailedWrite()
+{
+    // copies into the last 6 cells of the creature, then off its end, where it may not write
+    World* world = createLoopWorld(kLoopCreatureLength - 6, 30);
+    World* reference = singleSteppingClone(world);
+
+    world->iterate(100);
+    reference->iterate(100);
+
+    TEST_CONDITION(worldsMatch(world, reference));
+    TEST_CONDITION(world->bulkCopyInstructions() > 0);
+
+    const Creature* creature = &world->timeSlicer().slicerList().front();
+    TEST_CONDITION(creature->numErrors() > 0);
+    TEST_CONDITION(memcmp(world->soup()->soup() + kSoupSize / 2 + kLoopCreatureLength - 6, kLoopGenome + 2, 6) == 0);
+    TEST_CONDITION(world->soup()->instructionAtAddress(kSoupSize / 2 + kLoopCreatureLength) == k_nop_0);
+
+    delete reference;
+    delete world;
+}
+
+void
+CopyLoopTests::testWritesIntoLoop()
+{
+    // copies over the loop's own jmp template, which single stepping has to see
+    World* world = createLoopWorld(10, 20);
+    World* reference = singleSteppingClone(world);
+
+    world->iterate(200);
+    reference->iterate(200);
+
+    TEST_CONDITION(worldsMatch(world, reference));
+    TEST_CONDITION(world->bulkCopyInstructions() == 0);
+
+    delete reference;
+    delete world;
+}
+
+void
+CopyLoopTests::runTest()
+{
+    std::cout << "CopyLoopTests" << std::endl;
+
+    testMatchesSingleStepping();
+    testStopsAtFailedWrite();
+    testWritesIntoLoop();
+}
+
+TestRegistration copyLoopTestReg(new CopyLoopTests);
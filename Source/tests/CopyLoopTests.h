@@ -0,0 +1,36 @@
+/*
+ *  CopyLoopTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef CopyLoopTests_h
+#define CopyLoopTests_h
+
+#include "TestRunner.h"
+
+class CopyLoopTests : public TestCase
+{
+public:
+    CopyLoopTests();
+    ~CopyLoopTests();
+
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testMatchesSingleStepping();
+    void testStopsAtFailedWrite();
+    void testWritesIntoLoop();
+
+};
+
+
+#endif // CopyLoopTests_h
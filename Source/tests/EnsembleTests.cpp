@@ -0,0 +1,195 @@
+/*
+ *  EnsembleTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "EnsembleTests.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "MT_Ancestor.h"
+#include "MT_CellMap.h"
+#include "MT_ColumnarLog.h"
+#include "MT_Ensemble.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static const u_int32_t kSoupSize = 20480;
+
+static std::string temporaryPrefix()
+{
+    char path[] = "/tmp/mactierra_ensemble_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd != -1)
+    {
+        close(fd);
+        unlink(path);
+    }
+    return path;
+}
+
+EnsembleTests::EnsembleTests()
+{
+}
+
+EnsembleTests::~EnsembleTests()
+{
+}
+
+void
+EnsembleTests::setUp()
+{
+}
+
+void
+EnsembleTests::tearDown()
+{
+}
+
+void
+EnsembleTests::testRuns()
+{
+    Ensemble ensemble(7, 2);
+    TEST_CONDITION(ensemble.numThreads() == 2);
+
+    ensemble.addConfiguration("small", SoupConfiguration(kSoupSize, 1234, Settings::mediumMutationSettings(kSoupSize)), 3);
+    ensemble.addConfiguration("large", SoupConfiguration(4 * kSoupSize, 1234, Settings::mediumMutationSettings(4 * kSoupSize)));
+    TEST_CONDITION(ensemble.numRuns() == 4);
+    TEST_CONDITION(ensemble.run(0).mName == "small_r0");
+    TEST_CONDITION(ensemble.run(2).mName == "small_r2");
+    TEST_CONDITION(ensemble.run(3).mName == "large_r0");
+    TEST_CONDITION(ensemble.run(3).mConfiguration.soupSize() == 4 * kSoupSize);
+
+    // seeds come from the master seed, not the configuration, and differ between runs
+    bool seedsDerived = true;
+    for (size_t i = 0; i < ensemble.numRuns(); ++i)
+    {
+        if (ensemble.run(i).mConfiguration.randomSeed() != Ensemble::seedForRun(7, i))
+            seedsDerived = false;
+    }
+    TEST_CONDITION(seedsDerived);
+    TEST_CONDITION(ensemble.run(0).mConfiguration.randomSeed() != ensemble.run(1).mConfiguration.randomSeed());
+    TEST_CONDITION(Ensemble::seedForRun(7, 0) != Ensemble::seedForRun(8, 0));
+
+    TEST_CONDITION(Ensemble::worldFileName("out/", ensemble.run(3), WorldArchiver::kBinary) == "out/large_r0.mactierra");
+    TEST_CONDITION(Ensemble::worldFileName("out/", ensemble.run(3), WorldArchiver::kXML) == "out/large_r0.mactierra_xml");
+}
+
+void
+EnsembleTests::testGrid()
+{
+    const Settings settings = Settings::mediumMutationSettings(kSoupSize);
+
+    vector<u_int32_t> soupSizes;
+    soupSizes.push_back(kSoupSize);
+    soupSizes.push_back(2 * kSoupSize);
+
+    vector<double> scales;
+    scales.push_back(0.5);
+    scales.push_back(1);
+    scales.push_back(2);
+
+    Ensemble ensemble(1, 1);
+    ensemble.addGrid("grid", settings, soupSizes, scales, 2);
+    TEST_CONDITION(ensemble.numRuns() == 2 * 3 * 2);
+    TEST_CONDITION(ensemble.run(0).mName == "grid_s20480_m0.5_r0");
+    TEST_CONDITION(ensemble.run(11).mName == "grid_s40960_m2_r1");
+
+    const Settings& scaledSettings = ensemble.run(10).mConfiguration.settings();
+    TEST_CONDITION(ensemble.run(10).mConfiguration.soupSize() == 2 * kSoupSize);
+    TEST_CONDITION(scaledSettings.copyErrorRate() == 2 * settings.copyErrorRate());
+    TEST_CONDITION(scaledSettings.flawRate() == 2 * settings.flawRate());
+    // the cosmic ray interval follows the soup size as well as the rate
+    TEST_CONDITION(fabs(scaledSettings.meanCosmicTimeInterval() * 4 / settings.meanCosmicTimeInterval() - 1.0) < 1e-9);
+}
+
+void
+EnsembleTests::testRunning()
+{
+    const string prefix = temporaryPrefix();
+
+    // more worlds than threads
+    Ensemble ensemble(3, 2);
+    ensemble.addConfiguration("run", SoupConfiguration(kSoupSize, 0, Settings::mediumMutationSettings(kSoupSize)), 5);
+    ensemble.setRunLength(250000);
+    ensemble.setQuantum(100000);
+    ensemble.setDataLogging(prefix + "_", 50000);
+
+    TEST_CONDITION(ensemble.start());
+
+    u_int32_t numRounds = 0;
+    while (ensemble.runRound())
+        ++numRounds;
+    ++numRounds;
+
+    TEST_CONDITION(numRounds == 3);
+    TEST_CONDITION(ensemble.finished());
+    TEST_CONDITION(ensemble.instructionsRun() == 5 * 250000);
+    TEST_CONDITION(ensemble.fractionComplete() == 1.0);
+    TEST_CONDITION(ensemble.run(4).mInstructionsRun == 250000);
+    TEST_CONDITION(ensemble.run(4).instructionsPerSecond() > 0);
+
+    // each run is the same as a world run on its own with the same seed
+    World world;
+    world.initializeSoup(kSoupSize);
+    world.setSettings(Settings::mediumMutationSettings(kSoupSize));
+    world.setInitialRandomSeed(ensemble.run(2).mConfiguration.randomSeed());
+    world.insertCreature(kSoupSize / 2, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+    world.iterate(250000);
+
+    const World* ensembleWorld = ensemble.run(2).mWorld;
+    TEST_CONDITION(memcmp(world.soup()->soup(), ensembleWorld->soup()->soup(), kSoupSize) == 0);
+    TEST_CONDITION(world.cellMap()->numCreatures() == ensembleWorld->cellMap()->numCreatures());
+
+    // a population log per run
+    const string logPath = prefix + "_run_r2_population.mtcols";
+    ColumnarLogReader reader;
+    TEST_CONDITION(reader.open(logPath));
+    u_int64_t numRows = 0;
+    while (reader.nextGroup())
+        numRows += reader.groupRows();
+    TEST_CONDITION(numRows >= 4);
+
+    std::ostringstream summary;
+    ensemble.writeSummary(summary);
+    TEST_CONDITION(summary.str().find("run_r4\t") != string::npos);
+
+    TEST_CONDITION(ensemble.saveWorlds(prefix + "_", WorldArchiver::kBinary));
+    for (size_t i = 0; i < ensemble.numRuns(); ++i)
+    {
+        const string worldPath = Ensemble::worldFileName(prefix + "_", ensemble.run(i), WorldArchiver::kBinary);
+        std::ifstream worldStream(worldPath.c_str());
+        TEST_CONDITION(worldStream.good());
+
+        std::ostringstream logName;
+        logName << prefix << "_" << ensemble.run(i).mName << "_population.mtcols";
+        unlink(worldPath.c_str());
+        unlink(logName.str().c_str());
+    }
+}
+
+void
+EnsembleTests::runTest()
+{
+    std::cout << "EnsembleTests" << std::endl;
+
+    testRuns();
+    testGrid();
+    testRunning();
+}
+
+TestRegistration ensembleTestReg(new EnsembleTests);
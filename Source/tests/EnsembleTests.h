@@ -0,0 +1,36 @@
+/*
+ *  EnsembleTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef EnsembleTests_h
+#define EnsembleTests_h
+
+#include "TestRunner.h"
+
+class EnsembleTests : public TestCase
+{
+public:
+    EnsembleTests();
+    ~EnsembleTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testRuns();
+    void testGrid();
+    void testRunning();
+
+};
+
+
+#endif // EnsembleTests_h
@@ -0,0 +1,280 @@
+/*
+ *  EventLogIndexTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "EventLogIndexTests.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <vector>
+
+#include "MT_Ancestor.h"
+#include "MT_EventLogIndex.h"
+#include "MT_Inventory.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+const u_int32_t kSoupSize = 20480;
+
+// Remembers what the log contains, to check query results against.
+class LineageRecordingListener : public WorldEventListener
+{
+public:
+    virtual void creatureBorn(const BirthEvent& inEvent)
+    {
+        mBirthIDs.push_back(inEvent.mChildID);
+        mBirthParentIDs.push_back(inEvent.mParentID);
+    }
+
+    virtual void creatureDied(const DeathEvent& inEvent)
+    {
+        mDeathInstructions.push_back(inEvent.mInstructions);
+        mDeathAges.push_back(inEvent.mInstructions - inEvent.mBirthInstructions);
+    }
+
+    std::vector<creature_id>    mBirthIDs;
+    std::vector<creature_id>    mBirthParentIDs;
+    std::vector<u_int64_t>      mDeathInstructions;
+    std::vector<u_int64_t>      mDeathAges;
+};
+
+static std::string temporaryLogPath()
+{
+    char path[] = "/tmp/mactierra_event_index_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd != -1)
+        close(fd);
+    return path;
+}
+
+static void removeLog(const std::string& inLogPath)
+{
+    unlink(inLogPath.c_str());
+    unlink(EventLogIndex::indexPathForLog(inLogPath).c_str());
+}
+
+static void copyFile(const std::string& inFromPath, const std::string& inToPath, u_int64_t inLength)
+{
+    std::ifstream inStream(inFromPath.c_str(), ios::in | ios::binary);
+    std::vector<char> data((istreambuf_iterator<char>(inStream)), istreambuf_iterator<char>());
+    data.resize(min<u_int64_t>(inLength, data.size()));
+
+    std::ofstream outStream(inToPath.c_str(), ios::out | ios::binary | ios::trunc);
+    outStream.write(&data[0], data.size());
+}
+
+// Runs a world, logging into inLogPath.
+static World* runLoggedWorld(const std::string& inLogPath, LineageRecordingListener& outExpected)
+{
+    World* world = new World();
+    world->setInitialRandomSeed(1);
+    world->initializeSoup(kSoupSize);
+    world->setSettings(Settings::mediumMutationSettings(kSoupSize));
+
+    // small blocks, so that the log has many of them
+    EventLogWriter writer(4096);
+    writer.open(inLogPath, true);
+
+    world->addEventListener(&writer, writer.eventMask());
+    world->addEventListener(&outExpected, WorldEventListener::kBirthEvents | WorldEventListener::kDeathEvents);
+
+    world->insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+    world->iterate(3000000);
+
+    world->removeEventListener(&outExpected);
+    world->removeEventListener(&writer);
+    writer.close();
+
+    return world;
+}
+
+EventLogIndexTests::EventLogIndexTests()
+{
+}
+
+EventLogIndexTests::~EventLogIndexTests()
+{
+}
+
+void
+EventLogIndexTests::setUp()
+{
+}
+
+void
+EventLogIndexTests::tearDown()
+{
+}
+
+void
+EventLogIndexTests::testQueries()
+{
+    const std::string logPath = temporaryLogPath();
+    removeLog(logPath);
+
+    LineageRecordingListener expected;
+    World* world = runLoggedWorld(logPath, expected);
+
+    EventLogIndex index;
+    index.setNumThreads(4);
+    TEST_CONDITION(index.open(logPath));
+    TEST_CONDITION(!index.indexWasCurrent());
+    TEST_CONDITION(!index.isCorrupt());
+    TEST_CONDITION(index.numBlocks() > 10);
+    TEST_CONDITION(index.numRecords() == expected.mBirthIDs.size() + expected.mDeathAges.size());
+
+    // lifespans in a window
+    const u_int64_t fromInstructions = 1000000;
+    const u_int64_t toInstructions = 2000000;
+
+    std::vector<u_int64_t> expectedAges;
+    for (size_t i = 0; i < expected.mDeathAges.size(); ++i)
+    {
+        if (expected.mDeathInstructions[i] >= fromInstructions && expected.mDeathInstructions[i] <= toInstructions)
+            expectedAges.push_back(expected.mDeathAges[i]);
+    }
+
+    std::vector<u_int64_t> ages;
+    index.lifespans(fromInstructions, toInstructions, ages);
+    TEST_CONDITION(!expectedAges.empty());
+    TEST_CONDITION(ages == expectedAges);
+
+    // descendants of a creature from early in the run
+    const creature_id ancestorID = expected.mBirthIDs[20];
+    std::set<creature_id> lineage;
+    lineage.insert(ancestorID);
+    std::vector<creature_id> expectedDescendants;
+    for (size_t i = 0; i < expected.mBirthIDs.size(); ++i)
+    {
+        if (lineage.count(expected.mBirthParentIDs[i]))
+        {
+            lineage.insert(expected.mBirthIDs[i]);
+            expectedDescendants.push_back(expected.mBirthIDs[i]);
+        }
+    }
+
+    std::vector<EventLogRecord> births;
+    index.descendants(ancestorID, births);
+    TEST_CONDITION(births.size() == expectedDescendants.size());
+    bool descendantsMatch = true;
+    for (size_t i = 0; i < births.size() && i < expectedDescendants.size(); ++i)
+    {
+        if (births[i].mCreatureID != expectedDescendants[i])
+            descendantsMatch = false;
+    }
+    TEST_CONDITION(descendantsMatch);
+
+    // the populations at the end of the run agree with the inventory
+    Inventory::GenotypeVector genotypes;
+    world->inventory()->topGenotypes(5, genotypes);
+    TEST_CONDITION(!genotypes.empty());
+    for (Inventory::GenotypeVector::const_iterator it = genotypes.begin(); it != genotypes.end(); ++it)
+    {
+        EventLogIndex::PopulationSeries series;
+        TEST_CONDITION(index.genotypePopulation((*it)->name(), 0, series));
+        TEST_CONDITION(!series.empty() && series.back().second == (int64_t)(*it)->numberAlive());
+
+        // sampling ends in the same place
+        EventLogIndex::PopulationSeries sampledSeries;
+        TEST_CONDITION(index.genotypePopulation((*it)->name(), 100000, sampledSeries));
+        TEST_CONDITION(!sampledSeries.empty() && sampledSeries.back().second == series.back().second);
+        TEST_CONDITION(sampledSeries.back().first % 100000 == 0);
+    }
+
+    // one thread gives the same answers
+    EventLogIndex serialIndex;
+    serialIndex.setNumThreads(1);
+    TEST_CONDITION(serialIndex.open(logPath));
+    TEST_CONDITION(serialIndex.indexWasCurrent());
+    TEST_CONDITION(serialIndex.numBlocks() == index.numBlocks());
+
+    std::vector<u_int64_t> serialAges;
+    serialIndex.lifespans(fromInstructions, toInstructions, serialAges);
+    TEST_CONDITION(serialAges == ages);
+
+    EventLogIndex::PopulationSeries parallelSeries, serialSeries;
+    index.genotypePopulation("80aaaaa", 0, parallelSeries);
+    serialIndex.genotypePopulation("80aaaaa", 0, serialSeries);
+    TEST_CONDITION(!parallelSeries.empty() && parallelSeries == serialSeries);
+
+    EventLogIndex::PopulationSeries badSeries;
+    TEST_CONDITION(!index.genotypePopulation("aaaaa", 0, badSeries));
+
+    delete world;
+    removeLog(logPath);
+}
+
+void
+EventLogIndexTests::testExtendIndex()
+{
+    const std::string logPath = temporaryLogPath();
+    const std::string partialLogPath = temporaryLogPath();
+    removeLog(logPath);
+    removeLog(partialLogPath);
+
+    LineageRecordingListener expected;
+    delete runLoggedWorld(logPath, expected);
+
+    // index a log that was cut off part way through a block, as if the run were still going
+    EventLogReader reader;
+    TEST_CONDITION(reader.open(logPath));
+    EventLogBlockInfo blockInfo;
+    for (u_int32_t i = 0; i < 5; ++i)
+    {
+        TEST_CONDITION(reader.nextBlockInfo(blockInfo));
+        reader.skipBlock(blockInfo);
+    }
+
+    copyFile(logPath, partialLogPath, blockInfo.mFileOffset + 20);
+
+    {
+        EventLogIndex partialIndex;
+        TEST_CONDITION(partialIndex.open(partialLogPath));
+        TEST_CONDITION(partialIndex.numBlocks() == 4);
+        TEST_CONDITION(!partialIndex.isCorrupt());
+    }
+
+    // now let it "finish"
+    copyFile(logPath, partialLogPath, ULLONG_MAX);
+
+    EventLogIndex fullIndex;
+    TEST_CONDITION(fullIndex.open(logPath));
+
+    EventLogIndex extendedIndex;
+    TEST_CONDITION(extendedIndex.open(partialLogPath));
+    TEST_CONDITION(!extendedIndex.indexWasCurrent());
+    TEST_CONDITION(extendedIndex.numBlocks() == fullIndex.numBlocks());
+    TEST_CONDITION(extendedIndex.numRecords() == fullIndex.numRecords());
+    TEST_CONDITION(extendedIndex.lastInstructions() == fullIndex.lastInstructions());
+
+    std::vector<EventLogRecord> extendedBirths, fullBirths;
+    extendedIndex.descendants(expected.mBirthIDs[0], extendedBirths);
+    fullIndex.descendants(expected.mBirthIDs[0], fullBirths);
+    TEST_CONDITION(!fullBirths.empty() && extendedBirths.size() == fullBirths.size());
+
+    removeLog(logPath);
+    removeLog(partialLogPath);
+}
+
+void
+EventLogIndexTests::runTest()
+{
+    std::cout << "EventLogIndexTests" << std::endl;
+
+    testQueries();
+    testExtendIndex();
+}
+
+TestRegistration eventLogIndexTestReg(new EventLogIndexTests);
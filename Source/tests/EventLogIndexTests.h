@@ -0,0 +1,35 @@
+/*
+ *  EventLogIndexTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef EventLogIndexTests_h
+#define EventLogIndexTests_h
+
+#include "TestRunner.h"
+
+class EventLogIndexTests : public TestCase
+{
+public:
+    EventLogIndexTests();
+    ~EventLogIndexTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testQueries();
+    void testExtendIndex();
+
+};
+
+
+#endif // EventLogIndexTests_h
@@ -0,0 +1,194 @@
+/*
+ *  EventLogTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "EventLogTests.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <vector>
+
+#include "MT_Ancestor.h"
+#include "MT_EventLog.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+const u_int32_t kSoupSize = 20480;
+
+// Remembers what the log should contain.
+class EventRecordingListener : public WorldEventListener
+{
+public:
+    virtual void creatureBorn(const BirthEvent& inEvent)
+    {
+        mBirthIDs.push_back(inEvent.mChildID);
+        mBirthParentIDs.push_back(inEvent.mParentID);
+    }
+
+    virtual void creatureDied(const DeathEvent& inEvent)
+    {
+        mDeathIDs.push_back(inEvent.mCreatureID);
+        mDeathAges.push_back(inEvent.mInstructions - inEvent.mBirthInstructions);
+    }
+
+    std::vector<creature_id>    mBirthIDs;
+    std::vector<creature_id>    mBirthParentIDs;
+    std::vector<creature_id>    mDeathIDs;
+    std::vector<u_int64_t>      mDeathAges;
+};
+
+static std::string temporaryLogPath()
+{
+    char path[] = "/tmp/mactierra_event_log_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd != -1)
+        close(fd);
+    return path;
+}
+
+EventLogTests::EventLogTests()
+{
+}
+
+EventLogTests::~EventLogTests()
+{
+}
+
+void
+EventLogTests::setUp()
+{
+}
+
+void
+EventLogTests::tearDown()
+{
+}
+
+void
+EventLogTests::testCompression()
+{
+    // something repetitive, like a log
+    std::vector<u_int8_t> data;
+    for (u_int32_t i = 0; i < 100000; ++i)
+        data.push_back(static_cast<u_int8_t>((i % 37) ^ (i / 1000)));
+
+    std::vector<u_int8_t> compressed, decompressed;
+    TEST_CONDITION(compressEventBlock(&data[0], data.size(), compressed));
+    TEST_CONDITION(compressed.size() < data.size() / 4);
+    TEST_CONDITION(decompressEventBlock(&compressed[0], compressed.size(), data.size(), decompressed));
+    TEST_CONDITION(decompressed == data);
+
+    // truncated data is rejected, not overrun
+    TEST_CONDITION(!decompressEventBlock(&compressed[0], compressed.size() / 2, data.size(), decompressed));
+
+    // random data doesn't compress
+    RandomLib::Random rng(1);
+    for (u_int32_t i = 0; i < data.size(); ++i)
+        data[i] = rng.Integer(256);
+    TEST_CONDITION(!compressEventBlock(&data[0], data.size(), compressed));
+}
+
+void
+EventLogTests::testWorldLog(bool inCompress)
+{
+    const std::string logPath = temporaryLogPath();
+
+    World world;
+    world.setInitialRandomSeed(1);
+    world.initializeSoup(kSoupSize);
+    world.setSettings(Settings::mediumMutationSettings(kSoupSize));
+
+    // small blocks, so that the log has many of them
+    EventLogWriter writer(4096);
+    TEST_CONDITION(writer.open(logPath, inCompress));
+
+    EventRecordingListener expected;
+    world.addEventListener(&writer, writer.eventMask());
+    world.addEventListener(&expected, WorldEventListener::kBirthEvents | WorldEventListener::kDeathEvents);
+
+    world.insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+    world.iterate(3000000);
+
+    world.removeEventListener(&writer);
+    writer.close();
+
+    TEST_CONDITION(writer.numRecords() == expected.mBirthIDs.size() + expected.mDeathIDs.size());
+    TEST_CONDITION(expected.mBirthIDs.size() > 100);
+
+    EventLogReader reader;
+    TEST_CONDITION(reader.open(logPath));
+
+    size_t birthIndex = 0;
+    size_t deathIndex = 0;
+    u_int64_t lastInstructions = 0;
+    bool matches = true;
+    bool sawGenotype = false;
+
+    EventLogRecord record;
+    while (reader.nextRecord(record))
+    {
+        if (record.mInstructions < lastInstructions)
+            matches = false;
+        lastInstructions = record.mInstructions;
+
+        if (record.mType == EventLogRecord::kBirth)
+        {
+            if (birthIndex >= expected.mBirthIDs.size() ||
+                record.mCreatureID != expected.mBirthIDs[birthIndex] ||
+                record.mParentID != expected.mBirthParentIDs[birthIndex])
+                matches = false;
+            ++birthIndex;
+        }
+        else
+        {
+            if (deathIndex >= expected.mDeathIDs.size() ||
+                record.mCreatureID != expected.mDeathIDs[deathIndex] ||
+                record.mAge != expected.mDeathAges[deathIndex])
+                matches = false;
+            ++deathIndex;
+        }
+
+        if (record.mGenotypeLength > 0)
+        {
+            std::string name = record.genotypeName();
+            sawGenotype = true;
+            if (name.length() < 2 || record.mGenotypeLength != (u_int32_t)atoi(name.c_str()))
+                matches = false;
+        }
+    }
+
+    TEST_CONDITION(!reader.isCorrupt());
+    TEST_CONDITION(matches);
+    TEST_CONDITION(sawGenotype);
+    TEST_CONDITION(birthIndex == expected.mBirthIDs.size());
+    TEST_CONDITION(deathIndex == expected.mDeathIDs.size());
+
+    // the first creature was inserted into the soup
+    EventLogReader firstReader;
+    TEST_CONDITION(firstReader.open(logPath));
+    TEST_CONDITION(firstReader.nextRecord(record));
+    TEST_CONDITION(record.mType == EventLogRecord::kBirth && record.mParentID == 0 && record.genotypeName() == "80aaaaa");
+
+    unlink(logPath.c_str());
+}
+
+void
+EventLogTests::runTest()
+{
+    std::cout << "EventLogTests" << std::endl;
+
+    testCompression();
+    testWorldLog(false);
+    testWorldLog(true);
+}
+
+TestRegistration eventLogTestReg(new EventLogTests);
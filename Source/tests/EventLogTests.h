@@ -0,0 +1,35 @@
+/*
+ *  EventLogTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef EventLogTests_h
+#define EventLogTests_h
+
+#include "TestRunner.h"
+
+class EventLogTests : public TestCase
+{
+public:
+    EventLogTests();
+    ~EventLogTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testCompression();
+    void testWorldLog(bool inCompress);
+
+};
+
+
+#endif // EventLogTests_h
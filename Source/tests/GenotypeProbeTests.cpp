@@ -0,0 +1,206 @@
+/*
+ *  GenotypeProbeTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "GenotypeProbeTests.h"
+
+#include <string.h>
+
+#include <iostream>
+
+#include "MT_Ancestor.h"
+#include "MT_GenotypeProbe.h"
+#include "MT_Inventory.h"
+#include "MT_Soup.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static const u_int32_t kSoupSize = 16 * 4096;
+static const u_int32_t kProbeSoupSize = 16 * 1024;
+static const u_int32_t kProbeInstructions = 1000000;
+
+static GenomeData ancestorGenome()
+{
+    return GenomeData(std::string(reinterpret_cast<const char*>(kAncestor80aaa), sizeof(kAncestor80aaa)));
+}
+
+// Seeded before the settings are set, as probes are.
+static World* createWorld(u_int32_t inSeed)
+{
+    World* world = new World();
+    world->initializeSoup(kSoupSize);
+    world->setInitialRandomSeed(inSeed);
+    world->setSettings(Settings::mediumMutationSettings(kSoupSize));
+    world->insertCreature(kSoupSize / 2, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+    return world;
+}
+
+static bool resultsMatch(const ProbeResult& inLHS, const ProbeResult& inRHS)
+{
+    return inLHS.mInstructions == inRHS.mInstructions && inLHS.mBirths == inRHS.mBirths &&
+           inLHS.mExactBirths == inRHS.mExactBirths && inLHS.mFinalPopulation == inRHS.mFinalPopulation &&
+           inLHS.mCompetitorBirths == inRHS.mCompetitorBirths && inLHS.mCompetitorFinalPopulation == inRHS.mCompetitorFinalPopulation;
+}
+
+GenotypeProbeTests::GenotypeProbeTests()
+{
+}
+
+GenotypeProbeTests::~GenotypeProbeTests()
+{
+}
+
+void
+GenotypeProbeTests::setUp()
+{
+}
+
+void
+GenotypeProbeTests::tearDown()
+{
+}
+
+void
+GenotypeProbeTests::testEmptySoup()
+{
+    World* world = createWorld(5);
+    world->iterate(1500000);
+    TEST_CONDITION(world->inventory()->inventoryMap().size() > 1);
+
+    world->emptySoup();
+    TEST_CONDITION(world->timeSlicer().instructionsExecuted() == 0);
+    TEST_CONDITION(world->timeSlicer().numCreatures() == 0 && world->reaper().reaperList().empty());
+    TEST_CONDITION(world->inventory()->inventoryMap().empty() && world->inventory()->numAliveGenotypes() == 0);
+    TEST_CONDITION(world->numAdultCreatures() == 0);
+
+    // an emptied world runs just like a new one
+    world->setInitialRandomSeed(7);
+    world->setSettings(Settings::mediumMutationSettings(kSoupSize));
+    world->insertCreature(kSoupSize / 2, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+
+    World* freshWorld = createWorld(7);
+
+    world->iterate(1500000);
+    freshWorld->iterate(1500000);
+    TEST_CONDITION(memcmp(world->soup()->soup(), freshWorld->soup()->soup(), kSoupSize) == 0);
+    TEST_CONDITION(world->inventory()->inventoryMap().size() == freshWorld->inventory()->inventoryMap().size());
+    TEST_CONDITION(world->numAdultCreatures() == freshWorld->numAdultCreatures());
+
+    delete freshWorld;
+    delete world;
+}
+
+void
+GenotypeProbeTests::testAncestor()
+{
+    GenotypeProber prober(kProbeSoupSize, Settings::zeroMutationSettings(), kProbeInstructions, 2);
+
+    GenomeData ancestor = ancestorGenome();
+    ProbeResult result = prober.probe(ancestor);
+    TEST_CONDITION(result.mInstructions == kProbeInstructions);
+    TEST_CONDITION(result.mBirths > 10 && result.mFinalPopulation > 1);
+    // without mutations, every copy is exact
+    TEST_CONDITION(result.mExactBirths == result.mBirths && result.accuracy() == 1.0);
+    TEST_CONDITION(result.mCompetitorBirths == 0 && result.mCompetitorFinalPopulation == 0);
+
+    // a genome that never divides
+    GenomeData stillborn(std::string(80, '\x00'));
+    ProbeResult stillbornResult = prober.probe(stillborn);
+    TEST_CONDITION(stillbornResult.mBirths == 0 && stillbornResult.replicationRate() == 0.0);
+    TEST_CONDITION(stillbornResult.mFinalPopulation == 1);
+
+    // which the ancestor outbreeds
+    ProbeResult contest = prober.probe(stillborn, &ancestor);
+    TEST_CONDITION(contest.mBirths == 0 && contest.mCompetitorBirths > 10);
+}
+
+void
+GenotypeProbeTests::testReuse()
+{
+    GenomeData ancestor = ancestorGenome();
+    GenomeData stillborn(std::string(80, '\x00'));
+
+    GenotypeProber prober(kProbeSoupSize, Settings::mediumMutationSettings(kProbeSoupSize), kProbeInstructions, 3);
+    prober.setRandomSeed(11);
+
+    ProbeResult single = prober.probe(ancestor);
+    TEST_CONDITION(single.mBirths > 10 && single.mExactBirths < single.mBirths);
+
+    vector<ProbeRequest> requests;
+    for (u_int32_t i = 0; i < 4; ++i)
+    {
+        requests.push_back(ProbeRequest(&ancestor));
+        requests.push_back(ProbeRequest(&ancestor, &stillborn));
+        requests.push_back(ProbeRequest(&stillborn, &ancestor));
+    }
+
+    // the soups are reused, so each probe starts in one that has run others
+    vector<ProbeResult> results;
+    prober.probe(requests, results);
+    TEST_CONDITION(results.size() == requests.size());
+
+    bool allMatch = true;
+    for (u_int32_t i = 0; i < results.size(); ++i)
+    {
+        if (!resultsMatch(results[i], results[i % 3]))
+            allMatch = false;
+    }
+    TEST_CONDITION(allMatch);
+    TEST_CONDITION(resultsMatch(results[0], single));
+    TEST_CONDITION(results[2].mCompetitorBirths > 0);
+
+    // and the same probes with another seed differ
+    prober.setRandomSeed(12);
+    TEST_CONDITION(!resultsMatch(prober.probe(ancestor), single));
+}
+
+void
+GenotypeProbeTests::testTopGenotypes()
+{
+    World* world = createWorld(3);
+    world->iterate(3000000);
+
+    GenotypeProber prober(kProbeSoupSize, world->settings(), kProbeInstructions);
+
+    Inventory::GenotypeVector genotypes;
+    vector<ProbeResult> results;
+    prober.probeTopGenotypes(*world->inventory(), 5, genotypes, results);
+
+    Inventory::GenotypeVector topGenotypes;
+    world->inventory()->topGenotypes(5, topGenotypes);
+    TEST_CONDITION(genotypes == topGenotypes && !genotypes.empty());
+    TEST_CONDITION(results.size() == genotypes.size());
+
+    // the most common genotype can replicate
+    TEST_CONDITION(results[0].mBirths > 0);
+
+    // probing doesn't touch the world
+    World* reference = createWorld(3);
+    reference->iterate(3000000);
+    world->iterate(500000);
+    reference->iterate(500000);
+    TEST_CONDITION(memcmp(world->soup()->soup(), reference->soup()->soup(), kSoupSize) == 0);
+
+    delete reference;
+    delete world;
+}
+
+void
+GenotypeProbeTests::runTest()
+{
+    std::cout << "GenotypeProbeTests" << std::endl;
+
+    testEmptySoup();
+    testAncestor();
+    testReuse();
+    testTopGenotypes();
+}
+
+TestRegistration genotypeProbeTestReg(new GenotypeProbeTests);
@@ -0,0 +1,37 @@
+/*
+ *  GenotypeProbeTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef GenotypeProbeTests_h
+#define GenotypeProbeTests_h
+
+#include "TestRunner.h"
+
+class GenotypeProbeTests : public TestCase
+{
+public:
+    GenotypeProbeTests();
+    ~GenotypeProbeTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testEmptySoup();
+    void testAncestor();
+    void testReuse();
+    void testTopGenotypes();
+
+};
+
+
+#endif // GenotypeProbeTests_h
@@ -0,0 +1,264 @@
+/*
+ *  GenotypeRegistryTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "GenotypeRegistryTests.h"
+
+#include <iostream>
+#include <set>
+#include <sstream>
+
+#include <boost/thread.hpp>
+
+#include "MT_Ancestor.h"
+#include "MT_GenotypeRegistry.h"
+#include "MT_Inventory.h"
+#include "MT_Soup.h"
+#include "MT_World.h"
+#include "MT_WorldArchiver.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static const u_int32_t kSoupSize = 16 * 4096;
+static const u_int32_t kNumThreads = 8;
+static const u_int32_t kNumThreadedGenomes = 2000;
+
+static GenomeData genomeForIndex(u_int32_t inIndex)
+{
+    std::string data(20 + inIndex % 7, '\x01');
+    for (u_int32_t i = 0; i < 4; ++i)
+        data[i] = static_cast<char>((inIndex >> (8 * i)) & 0xFF);
+    return GenomeData(data);
+}
+
+static World* createWorld(u_int32_t inSeed, GenotypeRegistry* inRegistry)
+{
+    World* world = new World();
+    world->initializeSoup(kSoupSize);
+    world->setSettings(Settings::mediumMutationSettings(kSoupSize));
+    world->setInitialRandomSeed(inSeed);
+    if (inRegistry)
+        world->inventory()->setGenotypeRegistry(inRegistry);
+    world->insertCreature(kSoupSize / 2, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+    return world;
+}
+
+// Every genotype's name and genome come from the registry.
+static bool inventoryUsesRegistry(const Inventory& inInventory, const GenotypeRegistry& inRegistry)
+{
+    const Inventory::InventoryMap& inventoryMap = inInventory.inventoryMap();
+    for (Inventory::InventoryMap::const_iterator it = inventoryMap.begin(); it != inventoryMap.end(); ++it)
+    {
+        const InventoryGenotype* genotype = it->second;
+        const RegisteredGenotype* registered = inRegistry.findGenotype(genotype->genome());
+        if (!registered || genotype->registeredGenotype() != registered || &genotype->genome() != &registered->genome()
+            || genotype->name() != registered->name() || it->first != &registered->genome())
+            return false;
+    }
+    return true;
+}
+
+GenotypeRegistryTests::GenotypeRegistryTests()
+{
+}
+
+GenotypeRegistryTests::~GenotypeRegistryTests()
+{
+}
+
+void
+GenotypeRegistryTests::setUp()
+{
+}
+
+void
+GenotypeRegistryTests::tearDown()
+{
+}
+
+void
+GenotypeRegistryTests::testEntries()
+{
+    GenotypeRegistry registry;
+
+    const RegisteredGenotype* first = registry.enterGenotype(GenomeData(std::string(10, '\x01')));
+    const RegisteredGenotype* second = registry.enterGenotype(GenomeData(std::string(10, '\x02')));
+    const RegisteredGenotype* other = registry.enterGenotype(GenomeData(std::string(20, '\x01')));
+
+    TEST_CONDITION(first->name() == "10aaaaa" && first->globalID() == 1);
+    TEST_CONDITION(second->name() == "10aaaab" && second->globalID() == 2);
+    TEST_CONDITION(other->name() == "20aaaaa" && other->globalID() == 3);
+
+    TEST_CONDITION(registry.enterGenotype(GenomeData(std::string(10, '\x02'))) == second);
+    TEST_CONDITION(registry.findGenotype(GenomeData(std::string(20, '\x01'))) == other);
+    TEST_CONDITION(registry.findGenotype(GenomeData(std::string(20, '\x02'))) == NULL);
+    TEST_CONDITION(registry.numGenotypes() == 3);
+}
+
+struct RegistryEnterer
+{
+    RegistryEnterer(GenotypeRegistry& inRegistry, u_int32_t inOffset, vector<const RegisteredGenotype*>& outEntries)
+    : mRegistry(inRegistry)
+    , mOffset(inOffset)
+    , mEntries(outEntries)
+    {
+    }
+
+    void operator()()
+    {
+        // each thread starts at a different place, so they race to enter the same genomes
+        mEntries.resize(kNumThreadedGenomes);
+        for (u_int32_t i = 0; i < kNumThreadedGenomes; ++i)
+        {
+            u_int32_t index = (i + mOffset) % kNumThreadedGenomes;
+            mEntries[index] = mRegistry.enterGenotype(genomeForIndex(index));
+        }
+    }
+
+    GenotypeRegistry&   mRegistry;
+    u_int32_t           mOffset;
+    vector<const RegisteredGenotype*>& mEntries;
+};
+
+void
+GenotypeRegistryTests::testThreaded()
+{
+    GenotypeRegistry registry;
+
+    vector<vector<const RegisteredGenotype*> > entries(kNumThreads);
+    boost::thread_group threads;
+    for (u_int32_t i = 0; i < kNumThreads; ++i)
+        threads.create_thread(RegistryEnterer(registry, i * kNumThreadedGenomes / kNumThreads, entries[i]));
+    threads.join_all();
+
+    TEST_CONDITION(registry.numGenotypes() == kNumThreadedGenomes);
+
+    // every thread got the same entry for each genome, and no two genomes share an ID or name
+    bool entriesMatch = true;
+    std::set<u_int32_t> globalIDs;
+    std::set<std::string> names;
+    for (u_int32_t i = 0; i < kNumThreadedGenomes; ++i)
+    {
+        const RegisteredGenotype* entry = entries[0][i];
+        for (u_int32_t j = 1; j < kNumThreads; ++j)
+            if (entries[j][i] != entry)
+                entriesMatch = false;
+
+        if (!(entry->genome() == genomeForIndex(i)))
+            entriesMatch = false;
+
+        globalIDs.insert(entry->globalID());
+        names.insert(entry->name());
+    }
+    TEST_CONDITION(entriesMatch);
+    TEST_CONDITION(globalIDs.size() == kNumThreadedGenomes && *globalIDs.rbegin() == kNumThreadedGenomes);
+    TEST_CONDITION(names.size() == kNumThreadedGenomes);
+}
+
+void
+GenotypeRegistryTests::testSharedByWorlds()
+{
+    GenotypeRegistry registry;
+    World* firstWorld = createWorld(3, &registry);
+    World* secondWorld = createWorld(4, &registry);
+
+    // entered after it has genotypes of its own
+    World* lateWorld = createWorld(5, NULL);
+    lateWorld->iterate(500000);
+    lateWorld->inventory()->setGenotypeRegistry(&registry);
+
+    firstWorld->iterate(2000000);
+    secondWorld->iterate(2000000);
+    lateWorld->iterate(500000);
+
+    TEST_CONDITION(firstWorld->inventory()->inventoryMap().size() > 10);
+    TEST_CONDITION(inventoryUsesRegistry(*firstWorld->inventory(), registry));
+    TEST_CONDITION(inventoryUsesRegistry(*secondWorld->inventory(), registry));
+    TEST_CONDITION(inventoryUsesRegistry(*lateWorld->inventory(), registry));
+
+    // the ancestor has the same name everywhere
+    GenomeData ancestor(std::string(reinterpret_cast<const char*>(kAncestor80aaa), sizeof(kAncestor80aaa)));
+    const InventoryGenotype* firstAncestor = firstWorld->inventory()->findGenotype(ancestor);
+    const InventoryGenotype* secondAncestor = secondWorld->inventory()->findGenotype(ancestor);
+    TEST_CONDITION(firstAncestor && secondAncestor && firstAncestor != secondAncestor);
+    TEST_CONDITION(firstAncestor->registeredGenotype() == secondAncestor->registeredGenotype());
+    TEST_CONDITION(firstAncestor->name() == secondAncestor->name());
+
+    // the counts are still each world's own
+    TEST_CONDITION(firstWorld->inventory()->numAliveGenotypes() > 0);
+    TEST_CONDITION(registry.numGenotypes() <= firstWorld->inventory()->inventoryMap().size() + secondWorld->inventory()->inventoryMap().size()
+                                                + lateWorld->inventory()->inventoryMap().size());
+
+    // clones share the registry
+    World* copy = firstWorld->clone();
+    TEST_CONDITION(copy->inventory()->genotypeRegistry() == &registry);
+    copy->iterate(200000);
+    TEST_CONDITION(inventoryUsesRegistry(*copy->inventory(), registry));
+
+    delete copy;
+    delete lateWorld;
+    delete secondWorld;
+    delete firstWorld;
+}
+
+void
+GenotypeRegistryTests::testArchiving()
+{
+    GenotypeRegistry registry;
+    World* world = createWorld(6, &registry);
+    world->iterate(1000000);
+
+    // a world that shares genotypes archives like any other
+    std::stringstream archiveStream;
+    {
+        WorldExporter exporter(archiveStream, WorldArchiver::kBinary);
+        exporter.saveWorld(world);
+    }
+    WorldImporter importer(archiveStream, WorldArchiver::kBinary);
+    World* loadedWorld = importer.loadWorld();
+
+    const Inventory::InventoryMap& inventoryMap = world->inventory()->inventoryMap();
+    const Inventory::InventoryMap& loadedMap = loadedWorld->inventory()->inventoryMap();
+    TEST_CONDITION(loadedMap.size() == inventoryMap.size());
+    TEST_CONDITION(loadedWorld->inventory()->genotypeRegistry() == NULL);
+
+    bool genotypesMatch = loadedMap.size() == inventoryMap.size();
+    for (Inventory::InventoryMap::const_iterator it = inventoryMap.begin(), loadedIt = loadedMap.begin();
+         genotypesMatch && it != inventoryMap.end(); ++it, ++loadedIt)
+    {
+        if (!(loadedIt->second->genome() == it->second->genome()) || loadedIt->second->name() != it->second->name()
+            || loadedIt->second->numberAlive() != it->second->numberAlive() || loadedIt->first != &loadedIt->second->genome())
+            genotypesMatch = false;
+    }
+    TEST_CONDITION(genotypesMatch);
+
+    // and can rejoin the registry
+    loadedWorld->inventory()->setGenotypeRegistry(&registry);
+    TEST_CONDITION(inventoryUsesRegistry(*loadedWorld->inventory(), registry));
+
+    loadedWorld->iterate(100000);
+    world->iterate(100000);
+    TEST_CONDITION(*loadedWorld->soup() == *world->soup());
+
+    delete loadedWorld;
+    delete world;
+}
+
+void
+GenotypeRegistryTests::runTest()
+{
+    std::cout << "GenotypeRegistryTests" << std::endl;
+
+    testEntries();
+    testThreaded();
+    testSharedByWorlds();
+    testArchiving();
+}
+
+TestRegistration genotypeRegistryTestReg(new GenotypeRegistryTests);
@@ -0,0 +1,37 @@
+/*
+ *  GenotypeRegistryTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef GenotypeRegistryTests_h
+#define GenotypeRegistryTests_h
+
+#include "TestRunner.h"
+
+class GenotypeRegistryTests : public TestCase
+{
+public:
+    GenotypeRegistryTests();
+    ~GenotypeRegistryTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testEntries();
+    void testThreaded();
+    void testSharedByWorlds();
+    void testArchiving();
+
+};
+
+
+#endif // GenotypeRegistryTests_h
@@ -0,0 +1,191 @@
+/*
+ *  InteractionMatrixTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "InteractionMatrixTests.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "MT_Ancestor.h"
+#include "MT_Creature.h"
+#include "MT_Cpu.h"
+#include "MT_ExecutionUnit0.h"
+#include "MT_InstructionSet.h"
+#include "MT_InteractionMatrix.h"
+#include "MT_Inventory.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static const u_int32_t kSoupSize = 20480;
+static const address_t kHostAddress = 1000;
+static const address_t kFreeAddress = 5000;
+
+// An 80aaaaa ancestor at 100, and a 20-instruction "host" of nops at kHostAddress.
+static void setUpWorld(World& ioWorld, RefPtr<Creature>& outAncestor, RefPtr<Creature>& outHost)
+{
+    ioWorld.setInitialRandomSeed(1);
+    ioWorld.initializeSoup(kSoupSize);
+    ioWorld.setSettings(Settings::mediumMutationSettings(kSoupSize));
+
+    outAncestor = ioWorld.insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+
+    vector<instruction_t> hostCode(20, k_nop_0);
+    outHost = ioWorld.insertCreature(kHostAddress, &hostCode[0], hostCode.size());
+}
+
+InteractionMatrixTests::InteractionMatrixTests()
+{
+}
+
+InteractionMatrixTests::~InteractionMatrixTests()
+{
+}
+
+void
+InteractionMatrixTests::setUp()
+{
+}
+
+void
+InteractionMatrixTests::tearDown()
+{
+}
+
+void
+InteractionMatrixTests::testExecution()
+{
+    World world;
+    RefPtr<Creature> ancestor, host;
+    setUpWorld(world, ancestor, host);
+    TEST_CONDITION(ancestor && host);
+
+    InteractionMatrix matrix;
+    world.setInteractionMatrix(&matrix);
+
+    ExecutionUnit0 executionUnit;
+
+    // own code isn't counted
+    ancestor->setReferencedLocation(110);
+    executionUnit.execute(*ancestor, world, 0);
+    TEST_CONDITION(matrix.numForeignExecutions() == 0);
+
+    // executing in the host is
+    ancestor->setReferencedLocation(kHostAddress + 5);
+    executionUnit.execute(*ancestor, world, 0);
+    executionUnit.execute(*ancestor, world, 0);
+    TEST_CONDITION(matrix.numForeignExecutions() == 2);
+    TEST_CONDITION(matrix.numEntries() == 1);
+    TEST_CONDITION(matrix.counts(ancestor->genotype(), host->genotype()).mExecutions == 2);
+    TEST_CONDITION(matrix.counts(host->genotype(), ancestor->genotype()).mExecutions == 0);
+
+    // free space has no owner
+    ancestor->setReferencedLocation(kFreeAddress);
+    executionUnit.execute(*ancestor, world, 0);
+    TEST_CONDITION(matrix.numForeignExecutions() == 3);
+    TEST_CONDITION(matrix.numEntries() == 1);
+
+    world.setInteractionMatrix(NULL);
+    ancestor->setReferencedLocation(kHostAddress);
+    executionUnit.execute(*ancestor, world, 0);
+    TEST_CONDITION(matrix.numForeignExecutions() == 3);
+
+    std::ostringstream output;
+    matrix.write(output);
+    TEST_CONDITION(output.str() == "actor\ttarget\texecutions\twrites\n80aaaaa\t20aaaaa\t2\t0\n");
+}
+
+void
+InteractionMatrixTests::testWrites()
+{
+    World world;
+    RefPtr<Creature> ancestor, host;
+    setUpWorld(world, ancestor, host);
+
+    InteractionMatrix matrix;
+    world.setInteractionMatrix(&matrix);
+
+    ExecutionUnit0 executionUnit;
+
+    // the ancestor runs a mov_iab in its own code, which copies into the host
+    const address_t movAddress = 150;
+    const instruction_t movInst = k_mov_iab;
+    world.soup()->injectInstructions(movAddress, &movInst, 1);
+
+    Cpu& cpu = ancestor->cpu();
+
+    ancestor->setReferencedLocation(movAddress);
+    cpu.mRegisters[k_ax] = ancestor->offsetFromAddress(kHostAddress + 3);
+    cpu.mRegisters[k_bx] = ancestor->offsetFromAddress(100);
+    executionUnit.execute(*ancestor, world, 0);
+    // refused without global writes
+    TEST_CONDITION(matrix.numForeignWrites() == 0);
+
+    Settings settings = world.settings();
+    settings.setGlobalWritesAllowed(true);
+    world.setSettings(settings);
+
+    ancestor->setReferencedLocation(movAddress);
+    executionUnit.execute(*ancestor, world, 0);
+    TEST_CONDITION(matrix.numForeignExecutions() == 0);
+    TEST_CONDITION(matrix.numForeignWrites() == 1);
+    TEST_CONDITION(matrix.counts(ancestor->genotype(), host->genotype()).mWrites == 1);
+
+    // writes to its own code aren't counted
+    ancestor->setReferencedLocation(movAddress);
+    cpu.mRegisters[k_ax] = ancestor->offsetFromAddress(170);
+    executionUnit.execute(*ancestor, world, 0);
+    TEST_CONDITION(matrix.numForeignWrites() == 1);
+
+    matrix.clear();
+    TEST_CONDITION(matrix.numEntries() == 0 && matrix.numForeignWrites() == 0);
+}
+
+void
+InteractionMatrixTests::testRun()
+{
+    World world;
+    world.setInitialRandomSeed(1);
+    world.initializeSoup(kSoupSize);
+    world.setSettings(Settings::mediumMutationSettings(kSoupSize));
+    world.insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+
+    InteractionMatrix matrix;
+    world.setInteractionMatrix(&matrix);
+    world.iterate(1000000);
+    world.setInteractionMatrix(NULL);
+
+    vector<InteractionMatrix::Entry> entries;
+    matrix.getEntries(entries);
+    TEST_CONDITION(entries.size() == matrix.numEntries());
+
+    u_int64_t executions = 0;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        executions += entries[i].mCounts.mExecutions;
+        if (i > 0)
+            TEST_CONDITION(entries[i - 1].mCounts.mExecutions + entries[i - 1].mCounts.mWrites >= entries[i].mCounts.mExecutions + entries[i].mCounts.mWrites);
+    }
+    TEST_CONDITION(executions <= matrix.numForeignExecutions());
+    TEST_CONDITION(matrix.numForeignWrites() == 0);     // no global writes in the default settings
+}
+
+void
+InteractionMatrixTests::runTest()
+{
+    std::cout << "InteractionMatrixTests" << std::endl;
+
+    testExecution();
+    testWrites();
+    testRun();
+}
+
+TestRegistration interactionMatrixTestReg(new InteractionMatrixTests);
@@ -0,0 +1,36 @@
+/*
+ *  InteractionMatrixTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef InteractionMatrixTests_h
+#define InteractionMatrixTests_h
+
+#include "TestRunner.h"
+
+class InteractionMatrixTests : public TestCase
+{
+public:
+    InteractionMatrixTests();
+    ~InteractionMatrixTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testExecution();
+    void testWrites();
+    void testRun();
+
+};
+
+
+#endif // InteractionMatrixTests_h
@@ -0,0 +1,135 @@
+/*
+ *  InventoryTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "InventoryTests.h"
+
+#include <iostream>
+#include <vector>
+
+#include "MT_Creature.h"
+#include "MT_Inventory.h"
+#include "MT_Soup.h"
+
+
+using namespace MacTierra;
+
+
+InventoryTests::InventoryTests()
+: mSoup(NULL)
+, mInventory(NULL)
+{
+}
+
+
+InventoryTests::~InventoryTests()
+{
+}
+
+void
+InventoryTests::setUp()
+{
+    mSoup = new Soup(1024);
+    mInventory = new Inventory();
+}
+
+void
+InventoryTests::tearDown()
+{
+    delete mInventory; mInventory = NULL;
+    delete mSoup; mSoup = NULL;
+}
+
+void
+InventoryTests::runTest()
+{
+    std::cout << "InventoryTests" << std::endl;
+
+    InventoryGenotype* genotype1 = NULL;
+    InventoryGenotype* genotype2 = NULL;
+    InventoryGenotype* genotype3 = NULL;
+
+    TEST_CONDITION(mInventory->enterGenotype(GenomeData(std::string(10, '\x01')), genotype1));
+    TEST_CONDITION(mInventory->enterGenotype(GenomeData(std::string(10, '\x02')), genotype2));
+    TEST_CONDITION(mInventory->enterGenotype(GenomeData(std::string(20, '\x01')), genotype3));
+    
+    TEST_CONDITION(mInventory->numAliveGenotypes() == 0);
+    TEST_CONDITION(mInventory->rankOfGenotype(genotype1) == 0);
+
+    creature_id creatureID = 0;
+    std::vector<RefPtr<Creature> > creatures1, creatures2, creatures3;
+    for (int i = 0; i < 3; ++i)
+    {
+        creatures1.push_back(Creature::create(++creatureID, 10, mSoup));
+        mInventory->creatureBorn(genotype1, *creatures1.back());
+    }
+
+    for (int i = 0; i < 5; ++i)
+    {
+        creatures2.push_back(Creature::create(++creatureID, 10, mSoup));
+        mInventory->creatureBorn(genotype2, *creatures2.back());
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        creatures3.push_back(Creature::create(++creatureID, 20, mSoup));
+        mInventory->creatureBorn(genotype3, *creatures3.back());
+    }
+
+    TEST_CONDITION(mInventory->numAliveGenotypes() == 3);
+    TEST_CONDITION(mInventory->rankOfGenotype(genotype3) == 1);
+    TEST_CONDITION(mInventory->rankOfGenotype(genotype2) == 2);
+    TEST_CONDITION(mInventory->rankOfGenotype(genotype1) == 3);
+
+    TEST_CONDITION(genotype1->creatures().size() == 3);
+    TEST_CONDITION(&genotype1->creatures().front() == creatures1[0].get());
+    TEST_CONDITION(creatures1[0]->isInGenotypeList());
+
+    Inventory::GenotypeVector topGenotypes;
+    mInventory->topGenotypes(2, topGenotypes);
+    TEST_CONDITION(topGenotypes.size() == 2);
+    TEST_CONDITION(topGenotypes[0] == genotype3 && topGenotypes[1] == genotype2);
+
+    TEST_CONDITION(mInventory->numGenotypesAboveCount(4) == 2);
+    TEST_CONDITION(mInventory->numGenotypesAboveCount(100) == 0);
+    TEST_CONDITION(mInventory->numGenotypesAboveCount(0) == 3);
+
+    // equal counts share a rank
+    for (int i = 0; i < 2; ++i)
+        mInventory->creatureDied(genotype2, *creatures2[i]);
+
+    TEST_CONDITION(mInventory->rankOfGenotype(genotype1) == 2);
+    TEST_CONDITION(mInventory->rankOfGenotype(genotype2) == 2);
+    TEST_CONDITION(genotype2->creatures().size() == 3);
+    TEST_CONDITION(!creatures2[0]->isInGenotypeList());
+    TEST_CONDITION(&genotype2->creatures().front() == creatures2[2].get());
+
+    Inventory::GenotypeVector aboveGenotypes;
+    mInventory->genotypesAboveCount(2, aboveGenotypes);
+    TEST_CONDITION(aboveGenotypes.size() == 3);
+    TEST_CONDITION(aboveGenotypes[0] == genotype3);
+
+    // extinction removes from the ranking
+    for (int i = 0; i < 3; ++i)
+        mInventory->creatureDied(genotype1, *creatures1[i]);
+
+    TEST_CONDITION(mInventory->numAliveGenotypes() == 2);
+    TEST_CONDITION(mInventory->rankOfGenotype(genotype1) == 0);
+    TEST_CONDITION(mInventory->numGenotypesAboveCount(2) == 2);
+    TEST_CONDITION(genotype1->creatures().empty());
+
+    for (size_t i = 2; i < creatures2.size(); ++i)
+        mInventory->creatureDied(genotype2, *creatures2[i]);
+
+    for (size_t i = 0; i < creatures3.size(); ++i)
+        mInventory->creatureDied(genotype3, *creatures3[i]);
+
+    TEST_CONDITION(mInventory->numAliveGenotypes() == 0);
+}
+
+TestRegistration inventoryTestReg(new InventoryTests);
@@ -0,0 +1,40 @@
+/*
+ *  InventoryTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef InventoryTests_h
+#define InventoryTests_h
+
+#include "TestRunner.h"
+
+namespace MacTierra {
+class Inventory;
+class Soup;
+}
+
+class InventoryTests : public TestCase
+{
+public:
+    InventoryTests();
+    ~InventoryTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    MacTierra::Soup*        mSoup;
+    MacTierra::Inventory*   mInventory;
+
+};
+
+
+#endif // InventoryTests_h
@@ -0,0 +1,205 @@
+/*
+ *  MigrationTransportTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "MigrationTransportTests.h"
+
+#include <unistd.h>
+
+#include <iostream>
+#include <sstream>
+
+#include <boost/thread.hpp>
+
+#include "MT_Ancestor.h"
+#include "MT_CellMap.h"
+#include "MT_MigrationTransport.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static NetworkMigrant makeMigrant(u_int32_t inNode, creature_id inID, const string& inGenome)
+{
+    NetworkMigrant migrant;
+    migrant.mSourceNode = inNode;
+    migrant.mCreatureID = inID;
+    migrant.mGeneration = inID * 10;
+    migrant.mGenome = GenomeData(inGenome);
+    return migrant;
+}
+
+// Gives the I/O threads up to ten seconds to deliver inCount migrants.
+static bool receiveMigrants(MigrationTransport& inTransport, vector<NetworkMigrant>& outMigrants, size_t inCount)
+{
+    for (u_int32_t i = 0; i < 1000 && outMigrants.size() < inCount; ++i)
+    {
+        inTransport.receive(outMigrants);
+        if (outMigrants.size() < inCount)
+            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    }
+    return outMigrants.size() == inCount;
+}
+
+MigrationTransportTests::MigrationTransportTests()
+{
+}
+
+MigrationTransportTests::~MigrationTransportTests()
+{
+}
+
+void
+MigrationTransportTests::setUp()
+{
+}
+
+void
+MigrationTransportTests::tearDown()
+{
+}
+
+void
+MigrationTransportTests::testEncoding()
+{
+    vector<NetworkMigrant> migrants;
+    migrants.push_back(makeMigrant(3, 7, string("\x01\x02\x1f", 3)));
+    migrants.push_back(makeMigrant(3, 70000, string(80, '\x05')));
+
+    string frame;
+    MigrationTransport::encodeBatch(migrants, frame);
+    TEST_CONDITION(frame.compare(0, 4, "MTMG") == 0);
+    TEST_CONDITION(frame.length() == 9 + 4 + 2 * 16 + 3 + 80);
+
+    // two frames, the second arriving in pieces
+    string buffer = frame + frame.substr(0, 20);
+    vector<NetworkMigrant> decoded;
+    TEST_CONDITION(MigrationTransport::decodeBatches(buffer, decoded));
+    TEST_CONDITION(decoded.size() == 2 && buffer.length() == 20);
+    TEST_CONDITION(decoded[1].mSourceNode == 3 && decoded[1].mCreatureID == 70000 && decoded[1].mGeneration == 700000);
+    TEST_CONDITION(decoded[0].mGenome == migrants[0].mGenome && decoded[1].mGenome == migrants[1].mGenome);
+
+    buffer += frame.substr(20);
+    TEST_CONDITION(MigrationTransport::decodeBatches(buffer, decoded));
+    TEST_CONDITION(decoded.size() == 4 && buffer.empty());
+
+    // bad magic, and a genome longer than its frame
+    string badMagic = frame;
+    badMagic[0] = 'X';
+    TEST_CONDITION(!MigrationTransport::decodeBatches(badMagic, decoded));
+
+    string badLength = frame;
+    badLength[9 + 4 + 12] = 100;
+    TEST_CONDITION(!MigrationTransport::decodeBatches(badLength, decoded));
+
+    // a frame too long to wait for, and a genome byte that isn't an instruction
+    string tooLong = frame.substr(0, 20);
+    tooLong[5] = tooLong[6] = tooLong[7] = tooLong[8] = '\xff';
+    TEST_CONDITION(!MigrationTransport::decodeBatches(tooLong, decoded));
+
+    string badInstruction = frame;
+    badInstruction[9 + 4 + 16 + 2] = 32;
+    TEST_CONDITION(!MigrationTransport::decodeBatches(badInstruction, decoded));
+    TEST_CONDITION(decoded.size() == 4);
+}
+
+void
+MigrationTransportTests::testUnixSockets()
+{
+    std::ostringstream pathStream;
+    pathStream << "unix:/tmp/mactierra_test_" << getpid() << ".sock";
+
+    MigrationTransport receiver(1);
+    TEST_CONDITION(receiver.listen(pathStream.str()));
+    receiver.start();
+
+    MigrationTransport sender(2);
+    TEST_CONDITION(sender.addPeer(pathStream.str()) == 0);
+    sender.start();
+
+    vector<NetworkMigrant> batch;
+    for (u_int32_t i = 0; i < 50; ++i)
+        batch.push_back(makeMigrant(2, i, string(80, static_cast<char>(i % 32))));
+
+    // queued before the connection is up, and sent once it is
+    sender.send(0, batch);
+    sender.send(0, batch);
+
+    vector<NetworkMigrant> received;
+    TEST_CONDITION(receiveMigrants(receiver, received, 100));
+    TEST_CONDITION(received[49].mCreatureID == 49 && received[99].mGenome == batch[49].mGenome);
+    TEST_CONDITION(sender.numMigrantsSent() == 100 && receiver.numMigrantsReceived() == 100);
+    TEST_CONDITION(sender.numConnectedPeers() == 1 && sender.numBatchesDropped() == 0);
+}
+
+void
+MigrationTransportTests::testTCPExchange()
+{
+    const u_int32_t kSoupSize = 16 * 1024;
+
+    World* worlds[2];
+    MigrationTransport* transports[2];
+    for (u_int32_t i = 0; i < 2; ++i)
+    {
+        worlds[i] = new World();
+        worlds[i]->initializeSoup(kSoupSize);
+        worlds[i]->setSettings(Settings::mediumMutationSettings(kSoupSize));
+        worlds[i]->setInitialRandomSeed(i + 1);
+        worlds[i]->insertCreature(kSoupSize / 2, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+
+        transports[i] = new MigrationTransport(i);
+        TEST_CONDITION(transports[i]->listen("127.0.0.1:0"));
+        TEST_CONDITION(transports[i]->listenAddress() != "127.0.0.1:0");
+    }
+
+    for (u_int32_t i = 0; i < 2; ++i)
+    {
+        transports[i]->addPeer(transports[1 - i]->listenAddress());
+        transports[i]->start();
+    }
+
+    // each world sends five migrants to the other
+    RandomLib::Random rng(5);
+    for (u_int32_t i = 0; i < 2; ++i)
+    {
+        worlds[i]->iterate(100000);
+        transports[i]->exchange(*worlds[i], 5, rng);
+    }
+
+    for (u_int32_t i = 0; i < 2; ++i)
+    {
+        for (u_int32_t attempt = 0; attempt < 1000 && transports[i]->numMigrantsReceived() < 5; ++attempt)
+            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+
+        // some may have been placed already, by the first exchange
+        const u_int32_t numCreatures = worlds[i]->cellMap()->numCreatures();
+        const u_int64_t numPlaced = transports[i]->numMigrantsPlaced();
+        transports[i]->exchange(*worlds[i], 0, rng);
+        TEST_CONDITION(transports[i]->numMigrantsReceived() == 5);
+        TEST_CONDITION(transports[i]->numMigrantsPlaced() + transports[i]->numMigrantsLost() == 5);
+        TEST_CONDITION(worlds[i]->cellMap()->numCreatures() == numCreatures + transports[i]->numMigrantsPlaced() - numPlaced);
+    }
+
+    for (u_int32_t i = 0; i < 2; ++i)
+    {
+        delete transports[i];
+        delete worlds[i];
+    }
+}
+
+void
+MigrationTransportTests::runTest()
+{
+    std::cout << "MigrationTransportTests" << std::endl;
+
+    testEncoding();
+    testUnixSockets();
+    testTCPExchange();
+}
+
+TestRegistration migrationTransportTestReg(new MigrationTransportTests);
@@ -0,0 +1,36 @@
+/*
+ *  MigrationTransportTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef MigrationTransportTests_h
+#define MigrationTransportTests_h
+
+#include "TestRunner.h"
+
+class MigrationTransportTests : public TestCase
+{
+public:
+    MigrationTransportTests();
+    ~MigrationTransportTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testEncoding();
+    void testUnixSockets();
+    void testTCPExchange();
+
+};
+
+
+#endif // MigrationTransportTests_h
@@ -0,0 +1,152 @@
+/*
+ *  OpcodeCensusTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "OpcodeCensusTests.h"
+
+#include <iostream>
+#include <vector>
+
+#include "MT_Ancestor.h"
+#include "MT_InstructionSet.h"
+#include "MT_OpcodeCensus.h"
+#include "MT_Soup.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static bool countsEqual(const OpcodeCensus::Counts& inLHS, const OpcodeCensus::Counts& inRHS)
+{
+    for (int32_t i = 0; i < kInstructionSetSize; ++i)
+    {
+        if (inLHS.mInstructions[i] != inRHS.mInstructions[i])
+            return false;
+    }
+    return inLHS.mTemplates == inRHS.mTemplates;
+}
+
+static bool isNop(instruction_t inInstruction)
+{
+    return inInstruction == k_nop_0 || inInstruction == k_nop_1;
+}
+
+OpcodeCensusTests::OpcodeCensusTests()
+{
+}
+
+OpcodeCensusTests::~OpcodeCensusTests()
+{
+}
+
+void
+OpcodeCensusTests::setUp()
+{
+}
+
+void
+OpcodeCensusTests::tearDown()
+{
+}
+
+void
+OpcodeCensusTests::testKernels()
+{
+    // mostly nops, in runs of various lengths, like real soup
+    RandomLib::Random rng(1);
+    vector<instruction_t> data(10000);
+    for (u_int32_t i = 0; i < data.size(); ++i)
+        data[i] = rng.Integer(3) == 0 ? rng.Integer(kInstructionSetSize) : rng.Integer(2);
+
+    // odd lengths and offsets, to exercise the unaligned and leftover cells
+    const u_int32_t kLengths[] = { 0, 1, 15, 16, 17, 100, 4095, 4096 * 2 + 3 };
+    bool kernelsMatch = true;
+    for (u_int32_t offset = 1; offset < 4; ++offset)
+    {
+        for (u_int32_t l = 0; l < sizeof(kLengths) / sizeof(kLengths[0]); ++l)
+        {
+            const u_int32_t length = kLengths[l];
+
+            OpcodeCensus::Counts expected;
+            u_int64_t expectedStarts = 0;
+            for (u_int32_t i = offset; i < offset + length; ++i)
+            {
+                ++expected.mInstructions[data[i]];
+                if (isNop(data[i]) && !isNop(data[i - 1]))
+                    ++expectedStarts;
+            }
+
+            OpcodeCensus::Counts counts;
+            OpcodeCensus::countInstructions(&data[offset], length, counts);
+            if (!countsEqual(counts, expected))
+                kernelsMatch = false;
+
+            if (OpcodeCensus::countTemplateStarts(&data[offset], length, data[offset - 1]) != expectedStarts)
+                kernelsMatch = false;
+        }
+    }
+    TEST_CONDITION(kernelsMatch);
+
+    // a nop run that starts in the cell before doesn't start a template here
+    const instruction_t run[] = { k_nop_1, k_nop_0, k_mal, k_nop_1 };
+    TEST_CONDITION(OpcodeCensus::countTemplateStarts(run, 4, k_nop_0) == 1);
+    TEST_CONDITION(OpcodeCensus::countTemplateStarts(run, 4, k_divide) == 2);
+}
+
+void
+OpcodeCensusTests::testIncremental()
+{
+    const u_int32_t kSoupSize = 4 * 65536;
+    World world;
+    world.setInitialRandomSeed(1);
+    world.initializeSoup(kSoupSize);
+    // cosmic rays would touch the whole soup
+    world.setSettings(Settings::zeroMutationSettings());
+    world.insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+
+    const Soup& soup = *world.soup();
+    TEST_CONDITION(soup.numWriteRegions() == kSoupSize / Soup::writeRegionSize());
+    TEST_CONDITION(soup.regionWriteCounts()[0] == sizeof(kAncestor80aaa) / sizeof(instruction_t));
+
+    OpcodeCensus census;
+    TEST_CONDITION(census.update(soup) == soup.numWriteRegions());
+    TEST_CONDITION(census.totals().numCells() == kSoupSize);
+    TEST_CONDITION(census.totals().mInstructions[k_mal] == 1);
+
+    // nothing written, nothing recounted
+    TEST_CONDITION(census.update(soup) == 0);
+
+    world.iterate(300000);
+
+    // the population is still small, so most of the soup hasn't been touched
+    const u_int32_t numRecounted = census.update(soup);
+    TEST_CONDITION(numRecounted > 0 && numRecounted < soup.numWriteRegions());
+
+    OpcodeCensus freshCensus;
+    freshCensus.update(soup);
+    TEST_CONDITION(countsEqual(census.totals(), freshCensus.totals()));
+    TEST_CONDITION(census.totals().mTemplates > 0);
+    TEST_CONDITION(census.nopFraction() > 0 && census.nopFraction() <= 1.0);
+
+    // regions add up to the whole, and wrap around the end of the soup
+    OpcodeCensus::Counts firstHalf = census.regionCounts(0, kSoupSize / 2);
+    firstHalf.add(census.regionCounts(kSoupSize / 2, kSoupSize / 2));
+    TEST_CONDITION(countsEqual(firstHalf, census.totals()));
+    TEST_CONDITION(countsEqual(census.regionCounts(kSoupSize / 2, kSoupSize), census.totals()));
+}
+
+void
+OpcodeCensusTests::runTest()
+{
+    std::cout << "OpcodeCensusTests" << std::endl;
+
+    testKernels();
+    testIncremental();
+}
+
+TestRegistration opcodeCensusTestReg(new OpcodeCensusTests);
@@ -0,0 +1,35 @@
+/*
+ *  OpcodeCensusTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef OpcodeCensusTests_h
+#define OpcodeCensusTests_h
+
+#include "TestRunner.h"
+
+class OpcodeCensusTests : public TestCase
+{
+public:
+    OpcodeCensusTests();
+    ~OpcodeCensusTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testKernels();
+    void testIncremental();
+
+};
+
+
+#endif // OpcodeCensusTests_h
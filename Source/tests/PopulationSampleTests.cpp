@@ -0,0 +1,136 @@
+/*
+ *  PopulationSampleTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "PopulationSampleTests.h"
+
+#include <iostream>
+#include <set>
+#include <limits.h>
+#include <math.h>
+
+#include "MT_Ancestor.h"
+#include "MT_Creature.h"
+#include "MT_DataCollection.h"
+#include "MT_PopulationSample.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+const u_int32_t kSoupSize = 20480;
+const u_int32_t kSampleSize = 20;
+
+// Logger that just checks that it gets a sample
+class SampleCheckingLogger : public DataLogger
+{
+public:
+    SampleCheckingLogger()
+    : mNumSampled(0)
+    , mNumCollections(0)
+    {
+    }
+
+    virtual EDataRequirement dataRequirement() const { return kSampledDataAllowed; }
+
+    virtual void collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const World* inWorld)
+    {
+        const PopulationSample* sample = sampledData();
+        if (sample)
+            mNumSampled += sample->numSampled();
+        ++mNumCollections;
+    }
+
+    u_int32_t   mNumSampled;
+    u_int32_t   mNumCollections;
+};
+
+PopulationSampleTests::PopulationSampleTests()
+: mWorld(NULL)
+, mSampledWorld(NULL)
+{
+}
+
+PopulationSampleTests::~PopulationSampleTests()
+{
+}
+
+void
+PopulationSampleTests::setUp()
+{
+    mWorld = new World();
+    mWorld->setInitialRandomSeed(1);
+    mWorld->initializeSoup(kSoupSize);
+
+    mSampledWorld = new World();
+    mSampledWorld->setInitialRandomSeed(1);
+    mSampledWorld->initializeSoup(kSoupSize);
+}
+
+void
+PopulationSampleTests::tearDown()
+{
+    delete mWorld; mWorld = NULL;
+    delete mSampledWorld; mSampledWorld = NULL;
+}
+
+void
+PopulationSampleTests::runTest()
+{
+    cout << "PopulationSampleTests" << endl;
+
+    const u_int32_t ancestorLength = sizeof(kAncestor80aaa) / sizeof(instruction_t);
+    mWorld->insertCreature(100, kAncestor80aaa, ancestorLength);
+    mSampledWorld->insertCreature(100, kAncestor80aaa, ancestorLength);
+
+    SampleCheckingLogger logger;
+    mSampledWorld->dataCollector()->setSampleSize(kSampleSize);
+    mSampledWorld->dataCollector()->addPeriodicLogger(&logger);
+
+    mWorld->iterate(500000);
+    mSampledWorld->iterate(500000);
+
+    // sampling must not change the course of the simulation
+    TEST_CONDITION(*mWorld->soup() == *mSampledWorld->soup());
+    TEST_CONDITION(logger.mNumCollections > 0);
+    TEST_CONDITION(logger.mNumSampled > 0);
+
+    mSampledWorld->dataCollector()->removePeriodicLogger(&logger);
+
+    PopulationSample sample;
+    sample.setRandomSeed(2);
+    sample.setSampleSize(kSampleSize);
+    sample.takeSample(*mWorld);
+
+    TEST_CONDITION(sample.populationSize() == mWorld->numAdultCreatures());
+    TEST_CONDITION(sample.numSampled() == min(kSampleSize, sample.populationSize()));
+
+    // no creature is sampled twice
+    set<const Creature*> sampledCreatures(sample.creatures().begin(), sample.creatures().end());
+    TEST_CONDITION(sampledCreatures.size() == sample.numSampled());
+
+    SampleEstimate sizeEstimate = sample.size();
+    TEST_CONDITION(sizeEstimate.lower() <= sizeEstimate.mMean && sizeEstimate.mMean <= sizeEstimate.upper());
+    TEST_CONDITION(sizeEstimate.mMean > 0.0);
+
+    PopulationSample::GenotypeFrequencyVector frequencies;
+    sample.genotypeFrequencies(5, frequencies);
+    TEST_CONDITION(frequencies.size() <= 5);
+    for (size_t i = 1; i < frequencies.size(); ++i)
+        TEST_CONDITION(frequencies[i - 1].mSampleCount >= frequencies[i].mSampleCount);
+
+    // a sample at least as large as the population is exact
+    PopulationSample fullSample;
+    fullSample.setSampleSize(UINT_MAX);
+    fullSample.takeSample(*mWorld);
+    TEST_CONDITION(fullSample.numSampled() == fullSample.populationSize());
+    TEST_CONDITION(fullSample.size().mHalfWidth == 0.0);
+    TEST_CONDITION(fabs(fullSample.size().mMean - mWorld->statistics().meanSize()) < 1e-9);
+}
+
+TestRegistration populationSampleTestReg(new PopulationSampleTests);
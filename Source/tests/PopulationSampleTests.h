@@ -0,0 +1,39 @@
+/*
+ *  PopulationSampleTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef PopulationSampleTests_h
+#define PopulationSampleTests_h
+
+#include "TestRunner.h"
+
+namespace MacTierra {
+class World;
+}
+
+class PopulationSampleTests : public TestCase
+{
+public:
+    PopulationSampleTests();
+    ~PopulationSampleTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    MacTierra::World*   mWorld;
+    MacTierra::World*   mSampledWorld;
+
+};
+
+
+#endif // PopulationSampleTests_h
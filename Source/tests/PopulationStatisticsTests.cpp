@@ -0,0 +1,123 @@
+/*
+ *  PopulationStatisticsTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "PopulationStatisticsTests.h"
+
+#include <iostream>
+#include <math.h>
+
+#include "MT_Ancestor.h"
+#include "MT_CellMap.h"
+#include "MT_Creature.h"
+#include "MT_Inventory.h"
+#include "MT_PopulationStatistics.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+const u_int32_t kSoupSize = 20480;
+
+PopulationStatisticsTests::PopulationStatisticsTests()
+: mWorld(NULL)
+{
+}
+
+PopulationStatisticsTests::~PopulationStatisticsTests()
+{
+}
+
+void
+PopulationStatisticsTests::setUp()
+{
+    mWorld = new World();
+    mWorld->setInitialRandomSeed(1);
+    mWorld->initializeSoup(kSoupSize);
+}
+
+void
+PopulationStatisticsTests::tearDown()
+{
+    delete mWorld; mWorld = NULL;
+}
+
+// Compare the running statistics with values computed the slow way
+void
+PopulationStatisticsTests::checkStatistics(const World* inWorld)
+{
+    const PopulationStatistics& stats = inWorld->statistics();
+
+    u_int32_t numAdults;
+    u_int32_t totalSize = inWorld->cellMap()->totalAdultSize(numAdults);
+
+    TEST_CONDITION(stats.numAdults() == numAdults);
+    TEST_CONDITION(stats.numAdults() == inWorld->numAdultCreatures());
+    TEST_CONDITION(stats.totalAdultSize() == totalSize);
+
+    u_int32_t numGenotypes = 0;
+    u_int32_t numGenotyped = 0;
+    const Inventory::InventoryMap& inventoryMap = inWorld->inventory()->inventoryMap();
+    for (Inventory::InventoryMap::const_iterator it = inventoryMap.begin(); it != inventoryMap.end(); ++it)
+    {
+        if (it->second->numberAlive() > 0)
+        {
+            ++numGenotypes;
+            numGenotyped += it->second->numberAlive();
+        }
+    }
+
+    double entropy = 0.0;
+    for (Inventory::InventoryMap::const_iterator it = inventoryMap.begin(); it != inventoryMap.end(); ++it)
+    {
+        if (it->second->numberAlive() > 0)
+        {
+            double p = (double)it->second->numberAlive() / numGenotyped;
+            entropy -= p * log(p);
+        }
+    }
+
+    TEST_CONDITION(stats.genotypeRichness() == numGenotypes);
+    TEST_CONDITION(fabs(stats.shannonDiversity() - entropy) < 1e-9);
+
+    PopulationStatistics::SizeBucketVector buckets;
+    stats.sizeHistogram(10, buckets);
+    u_int32_t bucketTotal = 0;
+    for (size_t i = 0; i < buckets.size(); ++i)
+        bucketTotal += buckets[i].second;
+    TEST_CONDITION(bucketTotal == numAdults);
+}
+
+void
+PopulationStatisticsTests::runTest()
+{
+    cout << "PopulationStatisticsTests" << endl;
+
+    const PopulationStatistics& stats = mWorld->statistics();
+    TEST_CONDITION(stats.numAdults() == 0);
+    TEST_CONDITION(stats.meanSize() == 0.0);
+
+    RefPtr<Creature> creature1 = mWorld->insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+    TEST_CONDITION(stats.numAdults() == 1);
+    TEST_CONDITION(stats.meanSize() == 80.0);
+    TEST_CONDITION(stats.minSize() == 80 && stats.maxSize() == 80);
+    TEST_CONDITION(stats.meanGeneration() == 1.0);
+    TEST_CONDITION(stats.genotypeRichness() == 1);
+    TEST_CONDITION(stats.shannonDiversity() == 0.0);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        mWorld->iterate(50000);
+        checkStatistics(mWorld);
+    }
+
+    TEST_CONDITION(stats.meanGeneration() > 1.0);
+    TEST_CONDITION(stats.meanAge(mWorld->timeSlicer().instructionsExecuted()) >= 0.0);
+}
+
+TestRegistration populationStatisticsTestReg(new PopulationStatisticsTests);
@@ -0,0 +1,40 @@
+/*
+ *  PopulationStatisticsTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef PopulationStatisticsTests_h
+#define PopulationStatisticsTests_h
+
+#include "TestRunner.h"
+
+namespace MacTierra {
+class World;
+}
+
+class PopulationStatisticsTests : public TestCase
+{
+public:
+    PopulationStatisticsTests();
+    ~PopulationStatisticsTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void checkStatistics(const MacTierra::World* inWorld);
+
+    MacTierra::World*   mWorld;
+
+};
+
+
+#endif // PopulationStatisticsTests_h
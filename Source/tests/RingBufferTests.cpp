@@ -0,0 +1,158 @@
+/*
+ *  RingBufferTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "RingBufferTests.h"
+
+#include <iostream>
+
+#include <boost/thread.hpp>
+
+#include "MT_Ancestor.h"
+#include "MT_DataCollection.h"
+#include "MT_RingBuffer.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+typedef RingBuffer<u_int32_t> TestRing;
+
+const u_int32_t kNumThreadedRecords = 200000;
+
+RingBufferTests::RingBufferTests()
+{
+}
+
+RingBufferTests::~RingBufferTests()
+{
+}
+
+void
+RingBufferTests::setUp()
+{
+}
+
+void
+RingBufferTests::tearDown()
+{
+}
+
+void
+RingBufferTests::testOverflow()
+{
+    TestRing dropRing(3, TestRing::kDropOldest);
+    TEST_CONDITION(dropRing.capacity() == 4);
+
+    for (u_int32_t i = 0; i < 6; ++i)
+        TEST_CONDITION(dropRing.push(i));
+
+    TEST_CONDITION(dropRing.size() == 4);
+    TEST_CONDITION(dropRing.numDropped() == 2);
+
+    u_int32_t value;
+    TEST_CONDITION(dropRing.pop(value) && value == 2);
+    TEST_CONDITION(dropRing.pop(value) && value == 3);
+
+    TestRing rejectRing(4, TestRing::kRejectNewest);
+    for (u_int32_t i = 0; i < 4; ++i)
+        TEST_CONDITION(rejectRing.push(i));
+
+    TEST_CONDITION(!rejectRing.push(4));
+    TEST_CONDITION(rejectRing.numDropped() == 1);
+    TEST_CONDITION(rejectRing.pop(value) && value == 0);
+    TEST_CONDITION(rejectRing.push(5));
+
+    u_int32_t count = 0;
+    while (rejectRing.pop(value))
+        ++count;
+    TEST_CONDITION(count == 4 && value == 5);
+    TEST_CONDITION(rejectRing.empty());
+}
+
+struct RingProducer
+{
+    RingProducer(TestRing& inRing) : mRing(inRing) {}
+
+    void operator()()
+    {
+        for (u_int32_t i = 1; i <= kNumThreadedRecords; ++i)
+            mRing.push(i);
+    }
+
+    TestRing&   mRing;
+};
+
+void
+RingBufferTests::testThreaded()
+{
+    TestRing ring(64, TestRing::kDropOldest);
+
+    RingProducer producer(ring);
+    boost::thread producerThread(producer);
+
+    // records must arrive in order, with none duplicated
+    u_int32_t lastValue = 0;
+    u_int32_t numReceived = 0;
+    bool inOrder = true;
+    while (lastValue < kNumThreadedRecords)
+    {
+        u_int32_t value;
+        if (ring.pop(value))
+        {
+            if (value <= lastValue)
+                inOrder = false;
+            lastValue = value;
+            ++numReceived;
+        }
+        else if (producerThread.timed_join(boost::posix_time::milliseconds(0)) && ring.empty())
+            break;
+    }
+    producerThread.join();
+
+    TEST_CONDITION(inOrder);
+    TEST_CONDITION(lastValue == kNumThreadedRecords);
+    TEST_CONDITION(numReceived + ring.numDropped() == kNumThreadedRecords);
+}
+
+void
+RingBufferTests::testCollectorRecords()
+{
+    World world;
+    world.setInitialRandomSeed(1);
+    world.initializeSoup(10240);
+    world.insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+
+    CollectionRecordRing ring(16);
+    world.dataCollector()->addRecordRing(&ring);
+    world.iterate(500000);
+    world.dataCollector()->removeRecordRing(&ring);
+
+    TEST_CONDITION(!ring.empty());
+
+    CollectionRecord record;
+    u_int64_t lastInstructions = 0;
+    while (ring.pop(record))
+    {
+        TEST_CONDITION(record.mInstructions >= lastInstructions);
+        lastInstructions = record.mInstructions;
+    }
+    TEST_CONDITION(lastInstructions > 0);
+}
+
+void
+RingBufferTests::runTest()
+{
+    std::cout << "RingBufferTests" << std::endl;
+
+    testOverflow();
+    testThreaded();
+    testCollectorRecords();
+}
+
+TestRegistration ringBufferTestReg(new RingBufferTests);
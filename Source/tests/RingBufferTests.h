@@ -0,0 +1,36 @@
+/*
+ *  RingBufferTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef RingBufferTests_h
+#define RingBufferTests_h
+
+#include "TestRunner.h"
+
+class RingBufferTests : public TestCase
+{
+public:
+    RingBufferTests();
+    ~RingBufferTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testOverflow();
+    void testThreaded();
+    void testCollectorRecords();
+
+};
+
+
+#endif // RingBufferTests_h
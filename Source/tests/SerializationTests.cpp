@@ -106,6 +106,11 @@ SerializationTests::runTest()
 
     TEST_CONDITION(*mWorld->soup() == *newWorld2->soup());
 
+    // the population statistics are rebuilt on load
+    TEST_CONDITION(newWorld2->statistics().numAdults() == mWorld->statistics().numAdults());
+    TEST_CONDITION(newWorld2->statistics().totalAdultSize() == mWorld->statistics().totalAdultSize());
+    TEST_CONDITION(newWorld2->statistics().genotypeRichness() == mWorld->statistics().genotypeRichness());
+
     // run both worlds, then compare again
     mWorld->iterate(20000);
     newWorld2->iterate(20000);
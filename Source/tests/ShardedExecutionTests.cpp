@@ -0,0 +1,183 @@
+/*
+ *  ShardedExecutionTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "ShardedExecutionTests.h"
+
+#include <iostream>
+#include <sstream>
+
+#include "MT_CellMap.h"
+#include "MT_ShardedExecution.h"
+#include "MT_Soup.h"
+#include "MT_World.h"
+#include "MT_WorldArchiver.h"
+
+#include "WorldTestHelpers.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static const u_int32_t kSoupSize = 16 * 4096;
+static const u_int32_t kEpochInstructions = 4 * 20000;     // for 4 shards
+
+static World* createShardedWorld(u_int32_t inSoupSize, u_int32_t inNumShards, u_int32_t inNumThreads)
+{
+    Settings settings = Settings::mediumMutationSettings(inSoupSize);
+    settings.setNumShards(inNumShards);
+    settings.setShardEpochLength(20000);
+
+    World* world = createAncestorWorld(inSoupSize, settings, 99);
+    world->setShardThreads(inNumThreads);
+    return world;
+}
+
+ShardedExecutionTests::ShardedExecutionTests()
+{
+}
+
+ShardedExecutionTests::~ShardedExecutionTests()
+{
+}
+
+void
+ShardedExecutionTests::setUp()
+{
+}
+
+void
+ShardedExecutionTests::tearDown()
+{
+}
+
+void
+ShardedExecutionTests::testPartition()
+{
+    World* world = createShardedWorld(kSoupSize, 4, 2);
+    TEST_CONDITION(!world->shardedExecution());
+    world->iterate(kEpochInstructions + 1000);
+
+    const ShardedExecution* sharded = world->shardedExecution();
+    TEST_CONDITION(sharded && sharded->numShards() == 4 && sharded->numThreads() == 2);
+    TEST_CONDITION(sharded->shard(1).start() == kSoupSize / 4 && sharded->shard(3).end() == kSoupSize);
+    TEST_CONDITION(sharded->shardForAddress(0) == 0);
+    TEST_CONDITION(sharded->shardForAddress(kSoupSize / 2) == 2);
+    TEST_CONDITION(sharded->shardForAddress(kSoupSize - 1) == 3);
+    TEST_CONDITION(world->timeSlicer().instructionsExecuted() == kEpochInstructions);
+
+    // back to serial with one shard
+    Settings serialSettings = world->settings();
+    serialSettings.setNumShards(1);
+    world->setSettings(serialSettings);
+    world->iterate(1000);
+    TEST_CONDITION(!world->shardedExecution());
+    TEST_CONDITION(world->timeSlicer().instructionsExecuted() == kEpochInstructions + 1000);
+    delete world;
+
+    // no more shards than write regions
+    World* smallWorld = createShardedWorld(2 * Soup::writeRegionSize(), 4, 0);
+    smallWorld->iterate(1000);
+    TEST_CONDITION(smallWorld->shardedExecution()->numShards() == 2);
+    delete smallWorld;
+}
+
+void
+ShardedExecutionTests::testDeterminism()
+{
+    World* serialWorld = createShardedWorld(kSoupSize, 4, 1);
+    World* parallelWorld = createShardedWorld(kSoupSize, 4, 4);
+
+    serialWorld->iterate(40 * kEpochInstructions);
+    parallelWorld->iterate(40 * kEpochInstructions);
+
+    TEST_CONDITION(worldsMatch(serialWorld, parallelWorld));
+    TEST_CONDITION(serialWorld->timeSlicer().instructionsExecuted() == 40 * kEpochInstructions);
+    TEST_CONDITION(serialWorld->cellMap()->numCreatures() > 10);
+
+    const ShardedExecution* sharded = parallelWorld->shardedExecution();
+    TEST_CONDITION(sharded->numThreads() == 4);
+    TEST_CONDITION(sharded->numEpochs() > 0 && sharded->numWaitingInstructions() > 0);
+    TEST_CONDITION(sharded->numRemoteWrites() == serialWorld->shardedExecution()->numRemoteWrites());
+
+    // the creatures have spread beyond the shard they started in
+    u_int32_t shardsOccupied[4] = { 0, 0, 0, 0 };
+    const SlicerList& creatures = serialWorld->timeSlicer().slicerList();
+    for (SlicerList::const_iterator it = creatures.begin(); it != creatures.end(); ++it)
+        shardsOccupied[sharded->shardForAddress(it->location())] = 1;
+    TEST_CONDITION(shardsOccupied[0] + shardsOccupied[1] + shardsOccupied[2] + shardsOccupied[3] > 1);
+
+    delete serialWorld;
+    delete parallelWorld;
+}
+
+void
+ShardedExecutionTests::testSplitIterations()
+{
+    World* world = createShardedWorld(kSoupSize, 4, 2);
+    World* splitWorld = createShardedWorld(kSoupSize, 4, 2);
+
+    // neither length is a whole number of epochs
+    world->iterate(1000000 + 1234567);
+    splitWorld->iterate(1000000);
+    splitWorld->iterate(1234567);
+
+    TEST_CONDITION(worldsMatch(world, splitWorld));
+    TEST_CONDITION(world->RNG() == splitWorld->RNG());
+    TEST_CONDITION(world->timeSlicer().instructionsExecuted() % kEpochInstructions == 0);
+
+    // many calls shorter than an epoch
+    for (u_int32_t i = 0; i < 100; ++i)
+        splitWorld->iterate(4321);
+    world->iterate(100 * 4321);
+
+    TEST_CONDITION(worldsMatch(world, splitWorld));
+    TEST_CONDITION(world->RNG() == splitWorld->RNG());
+
+    delete world;
+    delete splitWorld;
+}
+
+void
+ShardedExecutionTests::testArchiving()
+{
+    World* world = createShardedWorld(kSoupSize, 4, 4);
+    world->iterate(1000000);
+
+    std::stringstream archiveStream;
+    {
+        WorldExporter exporter(archiveStream, WorldArchiver::kBinary);
+        exporter.saveWorld(world);
+    }
+
+    WorldImporter importer(archiveStream, WorldArchiver::kBinary);
+    World* loadedWorld = importer.loadWorld();
+    TEST_CONDITION(loadedWorld && loadedWorld->settings().numShards() == 4);
+    TEST_CONDITION(loadedWorld->settings().shardEpochLength() == 20000);
+
+    // the loaded world carries on exactly as the original does
+    loadedWorld->setShardThreads(2);
+    world->iterate(500000);
+    loadedWorld->iterate(500000);
+    TEST_CONDITION(worldsMatch(world, loadedWorld));
+
+    delete world;
+    delete loadedWorld;
+}
+
+void
+ShardedExecutionTests::runTest()
+{
+    std::cout << "ShardedExecutionTests" << std::endl;
+
+    testPartition();
+    testDeterminism();
+    testSplitIterations();
+    testArchiving();
+}
+
+TestRegistration shardedExecutionTestReg(new ShardedExecutionTests);
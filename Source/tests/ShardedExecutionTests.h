@@ -0,0 +1,37 @@
+/*
+ *  ShardedExecutionTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef ShardedExecutionTests_h
+#define ShardedExecutionTests_h
+
+#include "TestRunner.h"
+
+class ShardedExecutionTests : public TestCase
+{
+public:
+    ShardedExecutionTests();
+    ~ShardedExecutionTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testPartition();
+    void testDeterminism();
+    void testSplitIterations();
+    void testArchiving();
+
+};
+
+
+#endif // ShardedExecutionTests_h
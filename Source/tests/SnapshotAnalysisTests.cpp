@@ -0,0 +1,243 @@
+/*
+ *  SnapshotAnalysisTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "SnapshotAnalysisTests.h"
+
+#include <iostream>
+#include <vector>
+
+#include "MT_AnalysisPool.h"
+#include "MT_Ancestor.h"
+#include "MT_CellMap.h"
+#include "MT_DataCollection.h"
+#include "MT_World.h"
+#include "MT_WorldSnapshot.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static const u_int32_t kSoupSize = 20480;
+
+// Sums a range of numbers, slowly.
+class SumTask : public AnalysisPool::Task
+{
+public:
+    SumTask(u_int32_t inCount) : mCount(inCount), mSum(0) {}
+
+    virtual void run()
+    {
+        for (u_int32_t i = 1; i <= mCount; ++i)
+            mSum += i;
+    }
+
+    u_int32_t   mCount;
+    u_int64_t   mSum;
+};
+
+class PopulationResult : public AnalysisResult
+{
+public:
+    u_int32_t   mNumCells;
+    u_int32_t   mNumClassified;
+    u_int64_t   mChecksum;
+};
+
+// Counts the cells in the snapshot, and checksums the soup, on a worker thread.
+class PopulationAnalysis : public SnapshotAnalysis
+{
+public:
+    virtual AnalysisResult* analyze(const WorldSnapshot& inSnapshot) const
+    {
+        PopulationResult* result = new PopulationResult;
+        result->mNumCells = inSnapshot.cells().size();
+        result->mNumClassified = 0;
+        for (size_t i = 0; i < inSnapshot.cells().size(); ++i)
+        {
+            if (inSnapshot.cells()[i].mGenotypeIndex >= 0)
+                ++result->mNumClassified;
+        }
+
+        result->mChecksum = 0;
+        for (u_int32_t i = 0; i < inSnapshot.soupSize(); ++i)
+            result->mChecksum = result->mChecksum * 31 + inSnapshot.soup()[i];
+
+        return result;
+    }
+
+    virtual void resultReady(const WorldSnapshot& inSnapshot, AnalysisResult* inResult)
+    {
+        mInstructions.push_back(inSnapshot.instructions());
+        mNumCells.push_back(static_cast<PopulationResult*>(inResult)->mNumCells);
+        mChecksums.push_back(static_cast<PopulationResult*>(inResult)->mChecksum);
+    }
+
+    vector<u_int64_t>   mInstructions;
+    vector<u_int32_t>   mNumCells;
+    vector<u_int64_t>   mChecksums;
+};
+
+// The same numbers, computed on the engine thread.
+class PopulationLogger : public DataLogger
+{
+protected:
+    virtual void collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const World* inWorld)
+    {
+        mInstructions.push_back(inInstructionCount);
+        mNumCells.push_back(inWorld->cellMap()->numCreatures());
+
+        u_int64_t checksum = 0;
+        const instruction_t* soup = inWorld->soup()->soup();
+        for (u_int32_t i = 0; i < inWorld->soupSize(); ++i)
+            checksum = checksum * 31 + soup[i];
+        mChecksums.push_back(checksum);
+    }
+
+public:
+    vector<u_int64_t>   mInstructions;
+    vector<u_int32_t>   mNumCells;
+    vector<u_int64_t>   mChecksums;
+};
+
+SnapshotAnalysisTests::SnapshotAnalysisTests()
+{
+}
+
+SnapshotAnalysisTests::~SnapshotAnalysisTests()
+{
+}
+
+void
+SnapshotAnalysisTests::setUp()
+{
+}
+
+void
+SnapshotAnalysisTests::tearDown()
+{
+}
+
+void
+SnapshotAnalysisTests::testPool()
+{
+    AnalysisPool pool(4);
+    TEST_CONDITION(pool.numThreads() == 4);
+
+    // uneven amounts of work, so that workers have to steal
+    vector<SumTask*> tasks;
+    for (u_int32_t i = 0; i < 200; ++i)
+        tasks.push_back(new SumTask((i % 8 == 0) ? 2000000 : 1000));
+
+    for (size_t i = 0; i < tasks.size(); ++i)
+        pool.submit(tasks[i]);
+
+    pool.waitFor(tasks[0]);
+    TEST_CONDITION(tasks[0]->isDone());
+
+    pool.waitForAll();
+
+    bool allDone = true;
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        const u_int64_t count = tasks[i]->mCount;
+        if (!tasks[i]->isDone() || tasks[i]->mSum != count * (count + 1) / 2)
+            allDone = false;
+        delete tasks[i];
+    }
+    TEST_CONDITION(allDone);
+}
+
+void
+SnapshotAnalysisTests::testSnapshot()
+{
+    World world;
+    world.setInitialRandomSeed(1);
+    world.initializeSoup(kSoupSize);
+    world.setSettings(Settings::mediumMutationSettings(kSoupSize));
+    world.insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+
+    WorldSnapshot firstSnapshot(world, 0, 0);
+    TEST_CONDITION(firstSnapshot.soupSize() == kSoupSize);
+    TEST_CONDITION(firstSnapshot.cells().size() == 1);
+    TEST_CONDITION(firstSnapshot.genotypes().size() == 1);
+    TEST_CONDITION(firstSnapshot.genotypes()[0].mName == "80aaaaa");
+    TEST_CONDITION(firstSnapshot.cells()[0].mGenotypeIndex == 0);
+    TEST_CONDITION(firstSnapshot.cellInstructions(firstSnapshot.cells()[0]) == firstSnapshot.genotypes()[0].mGenome.dataString());
+
+    world.iterate(500000);
+
+    WorldSnapshot snapshot(world, world.timeSlicer().instructionsExecuted(), world.timeSlicer().cycleCount());
+    TEST_CONDITION(snapshot.cells().size() == world.cellMap()->numCreatures());
+    TEST_CONDITION(snapshot.genotypes().size() == world.inventory()->numAliveGenotypes());
+
+    // genotypes are alive, and most common first
+    bool genotypesInOrder = snapshot.genotypes()[0].mNumAlive > 0;
+    for (size_t i = 1; i < snapshot.genotypes().size(); ++i)
+    {
+        if (snapshot.genotypes()[i].mNumAlive == 0 || snapshot.genotypes()[i].mNumAlive > snapshot.genotypes()[i - 1].mNumAlive)
+            genotypesInOrder = false;
+    }
+    TEST_CONDITION(genotypesInOrder);
+
+    bool cellsInOrder = true;
+    for (size_t i = 1; i < snapshot.cells().size(); ++i)
+    {
+        if (snapshot.cells()[i].mStart <= snapshot.cells()[i - 1].mStart)
+            cellsInOrder = false;
+    }
+    TEST_CONDITION(cellsInOrder);
+
+    // the snapshot doesn't change when the world does
+    const vector<instruction_t> soupBefore = snapshot.soup();
+    world.iterate(100000);
+    TEST_CONDITION(snapshot.soup() == soupBefore);
+}
+
+void
+SnapshotAnalysisTests::testCollectorAnalyses()
+{
+    World world;
+    world.setInitialRandomSeed(1);
+    world.initializeSoup(kSoupSize);
+    world.setSettings(Settings::mediumMutationSettings(kSoupSize));
+    world.insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+
+    PopulationAnalysis analysis;
+    PopulationLogger logger;
+
+    DataCollector* collector = world.dataCollector();
+    collector->setNumAnalysisThreads(3);
+    collector->setCollectionInterval(20000, world.timeSlicer().instructionsExecuted());
+    collector->addPeriodicLogger(&logger);
+    collector->addAnalysis(&analysis, DataLogger::kCollectionPeriodic);
+
+    world.iterate(1000000);
+
+    collector->removePeriodicLogger(&logger);
+    TEST_CONDITION(collector->removeAnalysis(&analysis));
+    TEST_CONDITION(collector->numPendingAnalyses() == 0);
+    TEST_CONDITION(!collector->removeAnalysis(&analysis));
+
+    // every collection was analyzed, in order, and saw what the engine saw
+    TEST_CONDITION(logger.mInstructions.size() >= 49);
+    TEST_CONDITION(analysis.mInstructions == logger.mInstructions);
+    TEST_CONDITION(analysis.mNumCells == logger.mNumCells);
+    TEST_CONDITION(analysis.mChecksums == logger.mChecksums);
+}
+
+void
+SnapshotAnalysisTests::runTest()
+{
+    std::cout << "SnapshotAnalysisTests" << std::endl;
+
+    testPool();
+    testSnapshot();
+    testCollectorAnalyses();
+}
+
+TestRegistration snapshotAnalysisTestReg(new SnapshotAnalysisTests);
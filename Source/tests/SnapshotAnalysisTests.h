@@ -0,0 +1,36 @@
+/*
+ *  SnapshotAnalysisTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef SnapshotAnalysisTests_h
+#define SnapshotAnalysisTests_h
+
+#include "TestRunner.h"
+
+class SnapshotAnalysisTests : public TestCase
+{
+public:
+    SnapshotAnalysisTests();
+    ~SnapshotAnalysisTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testPool();
+    void testSnapshot();
+    void testCollectorAnalyses();
+
+};
+
+
+#endif // SnapshotAnalysisTests_h
@@ -0,0 +1,162 @@
+/*
+ *  SoupHeatmapTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "SoupHeatmapTests.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+#include "MT_Ancestor.h"
+#include "MT_SoupHeatmap.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static const u_int32_t kSoupSize = 20480;
+static const u_int64_t kNumInstructions = 500000;
+
+static void setUpWorld(World& ioWorld)
+{
+    ioWorld.setInitialRandomSeed(1);
+    ioWorld.initializeSoup(kSoupSize);
+    ioWorld.setSettings(Settings::mediumMutationSettings(kSoupSize));
+    ioWorld.insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+}
+
+static double total(const vector<double>& inCounts)
+{
+    return accumulate(inCounts.begin(), inCounts.end(), 0.0);
+}
+
+SoupHeatmapTests::SoupHeatmapTests()
+{
+}
+
+SoupHeatmapTests::~SoupHeatmapTests()
+{
+}
+
+void
+SoupHeatmapTests::setUp()
+{
+}
+
+void
+SoupHeatmapTests::tearDown()
+{
+}
+
+void
+SoupHeatmapTests::testDecay()
+{
+    SoupHeatmap heatmap(1000, 256, 1);
+    TEST_CONDITION(heatmap.numBlocks() == 4);
+
+    for (u_int32_t i = 0; i < 8; ++i)
+        heatmap.noteWrite(999);
+    heatmap.noteWrite(2000);    // off the end; ignored
+
+    SoupHeatmap::Snapshot snapshot;
+    heatmap.takeSnapshot(snapshot);
+    TEST_CONDITION(snapshot.mBlockSize == 256);
+    TEST_CONDITION(snapshot.mWrites[3] == 8.0);
+    TEST_CONDITION(total(snapshot.mWrites) == 8.0);
+
+    heatmap.takeSnapshot(snapshot);
+    TEST_CONDITION(snapshot.mWrites[3] == 4.0);
+
+    heatmap.setDecayFactor(0.0);
+    heatmap.takeSnapshot(snapshot);
+    TEST_CONDITION(snapshot.mWrites[3] == 2.0);
+    heatmap.takeSnapshot(snapshot);
+    TEST_CONDITION(total(snapshot.mWrites) == 0.0);
+}
+
+void
+SoupHeatmapTests::testCounting()
+{
+    World world;
+    setUpWorld(world);
+
+    SoupHeatmap heatmap(kSoupSize, 256, 1);
+    heatmap.setDecayFactor(0.0);
+    world.setHeatmap(&heatmap);
+
+    const u_int64_t startInstructions = world.timeSlicer().instructionsExecuted();
+    world.iterate(kNumInstructions);
+    const u_int64_t numExecuted = world.timeSlicer().instructionsExecuted() - startInstructions;
+
+    world.setHeatmap(NULL);
+
+    SoupHeatmap::Snapshot snapshot;
+    heatmap.takeSnapshot(snapshot);
+
+    // without sampling, every fetch is counted
+    TEST_CONDITION(total(snapshot.mFetches) == numExecuted);
+    TEST_CONDITION(snapshot.mFetches[0] > 0);
+    TEST_CONDITION(total(snapshot.mWrites) > 0);
+    TEST_CONDITION(total(snapshot.mForeignFetches) <= total(snapshot.mFetches));
+
+    heatmap.takeSnapshot(snapshot);
+    TEST_CONDITION(total(snapshot.mFetches) == 0.0);
+}
+
+void
+SoupHeatmapTests::testSampling()
+{
+    const u_int32_t kSampleInterval = 16;
+
+    World exactWorld;
+    setUpWorld(exactWorld);
+    SoupHeatmap exactHeatmap(kSoupSize, 256, 1);
+    exactWorld.setHeatmap(&exactHeatmap);
+    exactWorld.iterate(kNumInstructions);
+    exactWorld.setHeatmap(NULL);
+
+    World sampledWorld;
+    setUpWorld(sampledWorld);
+    SoupHeatmap sampledHeatmap(kSoupSize, 256, kSampleInterval);
+    sampledWorld.setHeatmap(&sampledHeatmap);
+    sampledWorld.iterate(kNumInstructions);
+    sampledWorld.setHeatmap(NULL);
+
+    // the heatmap doesn't change the run
+    TEST_CONDITION(exactWorld.cellMap()->numCreatures() == sampledWorld.cellMap()->numCreatures());
+    TEST_CONDITION(exactWorld.timeSlicer().instructionsExecuted() == sampledWorld.timeSlicer().instructionsExecuted());
+
+    SoupHeatmap::Snapshot exact, sampled;
+    exactHeatmap.takeSnapshot(exact);
+    sampledHeatmap.takeSnapshot(sampled);
+
+    // every Nth event is counted with a weight of N, so totals are short by less than N
+    const double fetchShortfall = total(exact.mFetches) - total(sampled.mFetches);
+    TEST_CONDITION(fetchShortfall >= 0 && fetchShortfall < kSampleInterval);
+
+    const double writeShortfall = total(exact.mWrites) - total(sampled.mWrites);
+    TEST_CONDITION(writeShortfall >= 0 && writeShortfall < kSampleInterval);
+
+    // and the hot blocks are the same
+    u_int32_t exactHottest = max_element(exact.mFetches.begin(), exact.mFetches.end()) - exact.mFetches.begin();
+    u_int32_t sampledHottest = max_element(sampled.mFetches.begin(), sampled.mFetches.end()) - sampled.mFetches.begin();
+    TEST_CONDITION(sampled.mFetches[exactHottest] > 0.5 * sampled.mFetches[sampledHottest]);
+}
+
+void
+SoupHeatmapTests::runTest()
+{
+    std::cout << "SoupHeatmapTests" << std::endl;
+
+    testDecay();
+    testCounting();
+    testSampling();
+}
+
+TestRegistration soupHeatmapTestReg(new SoupHeatmapTests);
@@ -0,0 +1,36 @@
+/*
+ *  SoupHeatmapTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef SoupHeatmapTests_h
+#define SoupHeatmapTests_h
+
+#include "TestRunner.h"
+
+class SoupHeatmapTests : public TestCase
+{
+public:
+    SoupHeatmapTests();
+    ~SoupHeatmapTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testDecay();
+    void testCounting();
+    void testSampling();
+
+};
+
+
+#endif // SoupHeatmapTests_h
@@ -320,6 +320,21 @@ void SoupTests::runEndConditionTests(u_int32_t soupSize)
     TEST_CONDITION(mSoup->seachForTemplate(Soup::kBothways, templateAddr, foundLength));
     TEST_CONDITION(templateAddr == firstTargetLocation);
     TEST_CONDITION(foundLength == templateLength);
+
+    // Template after an instruction at the end, so starting one past the end of the soup
+    memset(const_cast<instruction_t*>(mSoup->soup()), 0, soupSize);
+    mSoup->injectInstructions(0, sourceTemplate, templateLength + 1);
+    mSoup->injectInstructions(soupSize / 2, targetTemplate, templateLength);
+
+    const Soup::ESearchDirection kDirections[] = { Soup::kBothways, Soup::kBackwards, Soup::kForwards };
+    for (u_int32_t i = 0; i < sizeof(kDirections) / sizeof(kDirections[0]); ++i)
+    {
+        templateAddr = soupSize;
+        foundLength = 0;
+        TEST_CONDITION(mSoup->seachForTemplate(kDirections[i], templateAddr, foundLength));
+        TEST_CONDITION(templateAddr == soupSize / 2);
+        TEST_CONDITION(foundLength == templateLength);
+    }
 }
 
 TestRegistration soupTestReg(new SoupTests);
@@ -0,0 +1,209 @@
+/*
+ *  TimeSeriesTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "TimeSeriesTests.h"
+
+#include <iostream>
+#include <sstream>
+
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+
+#include "MT_TimeSeries.h"
+
+using namespace MacTierra;
+using namespace std;
+
+typedef TimeSeries<u_int32_t> UInt32Series;
+
+// Checks that the buckets are in order, cover every sample once, and agree with the series totals.
+template <class T>
+static bool bucketsCoverSeries(const TimeSeries<T>& inSeries, const typename TimeSeries<T>::BucketVector& inBuckets)
+{
+    if (inBuckets.empty())
+        return inSeries.empty();
+
+    u_int64_t numSamples = 0;
+    for (size_t i = 0; i < inBuckets.size(); ++i)
+    {
+        numSamples += inBuckets[i].mCount;
+        if (i > 0 && inBuckets[i].mFirstInstructions <= inBuckets[i - 1].mLastInstructions)
+            return false;
+    }
+
+    return numSamples == inSeries.numSamples()
+        && inBuckets.front().mFirstInstructions == inSeries.total().mFirstInstructions
+        && inBuckets.back().mLastInstructions == inSeries.total().mLastInstructions;
+}
+
+TimeSeriesTests::TimeSeriesTests()
+{
+}
+
+TimeSeriesTests::~TimeSeriesTests()
+{
+}
+
+void
+TimeSeriesTests::setUp()
+{
+}
+
+void
+TimeSeriesTests::tearDown()
+{
+}
+
+void
+TimeSeriesTests::testBoundedSize()
+{
+    const u_int32_t kCapacity = 64;
+    const u_int32_t kNumSamples = 1000000;
+
+    UInt32Series series(kCapacity, 4, 8);
+    for (u_int32_t i = 0; i < kNumSamples; ++i)
+        series.append(i * 10, i, i % 1000);
+
+    TEST_CONDITION(series.numSamples() == kNumSamples);
+    TEST_CONDITION(series.numLevels() <= 8);
+    TEST_CONDITION(series.total().mMin == 0 && series.total().mMax == 999);
+
+    UInt32Series::BucketVector buckets;
+    series.fullRange(kCapacity, buckets);
+    TEST_CONDITION(buckets.size() <= kCapacity);
+    TEST_CONDITION(bucketsCoverSeries(series, buckets));
+
+    // a small request is met by merging buckets
+    series.fullRange(10, buckets);
+    TEST_CONDITION(buckets.size() <= 10);
+    TEST_CONDITION(bucketsCoverSeries(series, buckets));
+}
+
+void
+TimeSeriesTests::testRecentResolution()
+{
+    UInt32Series series(16, 4, 8);
+    for (u_int32_t i = 0; i < 10000; ++i)
+        series.append(i, i, i);
+
+    // the last few samples are still held individually
+    UInt32Series::BucketVector buckets;
+    series.query(9990, 16, buckets);
+    TEST_CONDITION(buckets.size() == 10);
+    for (size_t i = 0; i < buckets.size(); ++i)
+        TEST_CONDITION(buckets[i].mCount == 1 && buckets[i].mMin == 9990 + i);
+
+    // older ones come from coarser levels
+    series.query(9000, 16, buckets);
+    TEST_CONDITION(buckets.size() <= 16);
+    TEST_CONDITION(buckets.back().mLastInstructions == 9999);
+    TEST_CONDITION(buckets.front().mFirstInstructions <= 9000);
+
+    u_int64_t numSamples = 0;
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        numSamples += buckets[i].mCount;
+        TEST_CONDITION(buckets[i].mMin == buckets[i].mFirstInstructions);
+        TEST_CONDITION(buckets[i].mMax == buckets[i].mLastInstructions);
+    }
+    TEST_CONDITION(numSamples == 10000 - buckets.front().mFirstInstructions);
+}
+
+void
+TimeSeriesTests::testTopLevelCompaction()
+{
+    // with only two levels, the top one has to keep merging its buckets
+    UInt32Series series(8, 2, 2);
+    for (u_int32_t i = 0; i < 5000; ++i)
+        series.append(i, i, 1);
+
+    TEST_CONDITION(series.numLevels() == 2);
+
+    UInt32Series::BucketVector buckets;
+    series.fullRange(100, buckets);
+    TEST_CONDITION(buckets.size() <= 9);
+    TEST_CONDITION(bucketsCoverSeries(series, buckets));
+    for (size_t i = 0; i < buckets.size(); ++i)
+        TEST_CONDITION(buckets[i].mean() == 1);
+
+    // shrinking the capacity keeps the whole run
+    series.setLevelCapacity(3);
+    series.fullRange(100, buckets);
+    TEST_CONDITION(buckets.size() <= 4);
+    TEST_CONDITION(bucketsCoverSeries(series, buckets));
+}
+
+void
+TimeSeriesTests::testPairs()
+{
+    typedef TimeSeries<std::pair<u_int32_t, u_int32_t> > PairSeries;
+
+    PairSeries series(4, 2, 4);
+    for (u_int32_t i = 0; i < 100; ++i)
+        series.append(i, i, std::make_pair(i, 100 - i));
+
+    PairSeries::BucketVector buckets;
+    series.fullRange(1, buckets);
+    TEST_CONDITION(buckets.size() == 1);
+    TEST_CONDITION(buckets[0].mMin == std::make_pair(0U, 1U));
+    TEST_CONDITION(buckets[0].mMax == std::make_pair(99U, 100U));
+    TEST_CONDITION(buckets[0].mean() == std::make_pair(50U, 51U));     // 49.5 and 50.5, rounded
+}
+
+void
+TimeSeriesTests::testSerialization()
+{
+    TimeSeries<double> series(32, 4, 6);
+    for (u_int32_t i = 0; i < 20000; ++i)
+        series.append(i, i / 2, i * 0.5);
+
+    std::stringstream stream;
+    {
+        ::boost::archive::text_oarchive archive(stream);
+        archive << MT_BOOST_MEMBER_SERIALIZATION_NVP("series", series);
+    }
+
+    TimeSeries<double> loadedSeries;
+    {
+        ::boost::archive::text_iarchive archive(stream);
+        archive >> MT_BOOST_MEMBER_SERIALIZATION_NVP("series", loadedSeries);
+    }
+
+    TEST_CONDITION(loadedSeries.numSamples() == series.numSamples());
+    TEST_CONDITION(loadedSeries.numLevels() == series.numLevels());
+
+    // both carry on identically
+    series.append(20000, 10000, 1.0);
+    loadedSeries.append(20000, 10000, 1.0);
+
+    TimeSeries<double>::BucketVector buckets, loadedBuckets;
+    series.fullRange(32, buckets);
+    loadedSeries.fullRange(32, loadedBuckets);
+    TEST_CONDITION(buckets.size() == loadedBuckets.size());
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        TEST_CONDITION(buckets[i].mCount == loadedBuckets[i].mCount);
+        TEST_CONDITION(buckets[i].mLastCycles == loadedBuckets[i].mLastCycles);
+        TEST_CONDITION(buckets[i].mean() == loadedBuckets[i].mean());
+    }
+}
+
+void
+TimeSeriesTests::runTest()
+{
+    std::cout << "TimeSeriesTests" << std::endl;
+
+    testBoundedSize();
+    testRecentResolution();
+    testTopLevelCompaction();
+    testPairs();
+    testSerialization();
+}
+
+TestRegistration timeSeriesTestReg(new TimeSeriesTests);
@@ -0,0 +1,38 @@
+/*
+ *  TimeSeriesTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef TimeSeriesTests_h
+#define TimeSeriesTests_h
+
+#include "TestRunner.h"
+
+class TimeSeriesTests : public TestCase
+{
+public:
+    TimeSeriesTests();
+    ~TimeSeriesTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testBoundedSize();
+    void testRecentResolution();
+    void testTopLevelCompaction();
+    void testPairs();
+    void testSerialization();
+
+};
+
+
+#endif // TimeSeriesTests_h
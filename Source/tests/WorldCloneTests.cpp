@@ -0,0 +1,177 @@
+/*
+ *  WorldCloneTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "WorldCloneTests.h"
+
+#include <string.h>
+
+#include <iostream>
+
+#include "MT_CellMap.h"
+#include "MT_DataCollection.h"
+#include "MT_Soup.h"
+#include "MT_World.h"
+#include "MT_WorldEvents.h"
+
+#include "WorldTestHelpers.h"
+
+using namespace MacTierra;
+using namespace std;
+
+static const u_int32_t kSoupSize = 16 * 4096;
+
+// Notes when the first flaw and cosmic ray happen.
+class FirstMutationListener : public WorldEventListener
+{
+public:
+    FirstMutationListener()
+    : mFirstFlaw(0)
+    , mFirstCosmicRay(0)
+    {
+    }
+
+    virtual void mutationOccurred(const MutationEvent& inEvent)
+    {
+        if (inEvent.mKind == MutationEvent::kFlaw && mFirstFlaw == 0)
+            mFirstFlaw = inEvent.mInstructions;
+        else if (inEvent.mKind == MutationEvent::kCosmicRay && mFirstCosmicRay == 0)
+            mFirstCosmicRay = inEvent.mInstructions;
+    }
+
+    u_int64_t   mFirstFlaw;
+    u_int64_t   mFirstCosmicRay;
+};
+
+static World* createWorld()
+{
+    World* world = createAncestorWorld(kSoupSize, Settings::mediumMutationSettings(kSoupSize), 23);
+    world->dataCollector()->setCollectionInterval(100000, 0);
+    return world;
+}
+
+WorldCloneTests::WorldCloneTests()
+{
+}
+
+WorldCloneTests::~WorldCloneTests()
+{
+}
+
+void
+WorldCloneTests::setUp()
+{
+}
+
+void
+WorldCloneTests::tearDown()
+{
+}
+
+void
+WorldCloneTests::testMatchesOriginal()
+{
+    World* world = createWorld();
+    // an uneven length, so that the clone is taken in the middle of a slice
+    world->iterate(3000001);
+    TEST_CONDITION(world->cellMap()->numCreatures() > 10);
+
+    World* copy = world->clone();
+    TEST_CONDITION(worldsMatch(world, copy));
+    TEST_CONDITION(copy->cellMap()->numCreatures() == world->cellMap()->numCreatures());
+
+    for (u_int32_t i = 0; i < 5; ++i)
+    {
+        world->iterate(400000);
+        copy->iterate(400000);
+        TEST_CONDITION(worldsMatch(world, copy));
+    }
+
+    delete copy;
+    delete world;
+}
+
+void
+WorldCloneTests::testIndependent()
+{
+    World* world = createWorld();
+    world->iterate(2000000);
+
+    World* reference = createWorld();
+    reference->iterate(2000000);
+
+    // running, then deleting, the clone leaves the original untouched
+    World* copy = world->clone();
+    copy->iterate(1000000);
+    delete copy;
+
+    world->iterate(1000000);
+    reference->iterate(1000000);
+    TEST_CONDITION(worldsMatch(world, reference));
+
+    delete reference;
+    delete world;
+}
+
+void
+WorldCloneTests::testReseeded()
+{
+    World* world = createWorld();
+    world->iterate(2000000);
+
+    World* copy = world->clone(99);
+    TEST_CONDITION(copy->initialRandomSeed() == 99);
+    TEST_CONDITION(memcmp(world->soup()->soup(), copy->soup()->soup(), kSoupSize) == 0);
+
+    world->iterate(1000000);
+    copy->iterate(1000000);
+    TEST_CONDITION(!worldsMatch(world, copy));
+    TEST_CONDITION(copy->cellMap()->numCreatures() > 0);
+
+    delete copy;
+    delete world;
+}
+
+void
+WorldCloneTests::testReseededMutationTimes()
+{
+    World* world = createWorld();
+    world->iterate(2000000);
+
+    World* copies[2] = { world->clone(99), world->clone(100) };
+    FirstMutationListener listeners[2];
+    for (u_int32_t i = 0; i < 2; ++i)
+    {
+        copies[i]->addEventListener(&listeners[i], WorldEventListener::kMutationEvents);
+        copies[i]->iterate(3000000);
+        copies[i]->removeEventListener(&listeners[i]);
+    }
+
+    // not inherited from the original
+    TEST_CONDITION(listeners[0].mFirstFlaw > 0 && listeners[1].mFirstFlaw > 0);
+    TEST_CONDITION(listeners[0].mFirstCosmicRay > 0 && listeners[1].mFirstCosmicRay > 0);
+    TEST_CONDITION(listeners[0].mFirstFlaw != listeners[1].mFirstFlaw);
+    TEST_CONDITION(listeners[0].mFirstCosmicRay != listeners[1].mFirstCosmicRay);
+
+    delete copies[0];
+    delete copies[1];
+    delete world;
+}
+
+void
+WorldCloneTests::runTest()
+{
+    std::cout << "WorldCloneTests" << std::endl;
+
+    testMatchesOriginal();
+    testIndependent();
+    testReseeded();
+    testReseededMutationTimes();
+}
+
+TestRegistration worldCloneTestReg(new WorldCloneTests);
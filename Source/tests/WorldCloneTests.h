@@ -0,0 +1,37 @@
+/*
+ *  WorldCloneTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef WorldCloneTests_h
+#define WorldCloneTests_h
+
+#include "TestRunner.h"
+
+class WorldCloneTests : public TestCase
+{
+public:
+    WorldCloneTests();
+    ~WorldCloneTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testMatchesOriginal();
+    void testIndependent();
+    void testReseeded();
+    void testReseededMutationTimes();
+
+};
+
+
+#endif // WorldCloneTests_h
@@ -0,0 +1,210 @@
+/*
+ *  WorldEventsTests.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "WorldEventsTests.h"
+
+#include <iostream>
+#include <set>
+
+#include "MT_Ancestor.h"
+#include "MT_Creature.h"
+#include "MT_World.h"
+#include "MT_WorldEvents.h"
+
+using namespace MacTierra;
+using namespace std;
+
+const u_int32_t kSoupSize = 20480;
+const u_int32_t kNumCycles = 2000000;
+
+class CountingEventListener : public WorldEventListener
+{
+public:
+    CountingEventListener()
+    : mNumBirths(0)
+    , mNumInsertions(0)
+    , mNumDeaths(0)
+    , mNumReaped(0)
+    , mNumCosmicRays(0)
+    , mNumCopyErrors(0)
+    , mNumFlaws(0)
+    , mNumAllocationFailures(0)
+    , mEventsInOrder(true)
+    , mLastInstructions(0)
+    {
+    }
+
+    virtual void creatureBorn(const BirthEvent& inEvent)
+    {
+        noteTime(inEvent.mInstructions);
+        ++mNumBirths;
+        if (inEvent.mParentID == 0)
+            ++mNumInsertions;
+        mLiving.insert(inEvent.mChildID);
+    }
+
+    virtual void creatureDied(const DeathEvent& inEvent)
+    {
+        noteTime(inEvent.mInstructions);
+        ++mNumDeaths;
+        if (inEvent.mReason == DeathEvent::kReaped)
+            ++mNumReaped;
+        if (inEvent.mReason != DeathEvent::kParentDied)
+            mLiving.erase(inEvent.mCreatureID);
+    }
+
+    virtual void mutationOccurred(const MutationEvent& inEvent)
+    {
+        noteTime(inEvent.mInstructions);
+        switch (inEvent.mKind)
+        {
+            case MutationEvent::kCosmicRay:     ++mNumCosmicRays; break;
+            case MutationEvent::kCopyError:     ++mNumCopyErrors; break;
+            case MutationEvent::kFlaw:          ++mNumFlaws; break;
+        }
+    }
+
+    virtual void allocationFailed(const AllocationFailureEvent& inEvent)
+    {
+        noteTime(inEvent.mInstructions);
+        ++mNumAllocationFailures;
+    }
+
+    void noteTime(u_int64_t inInstructions)
+    {
+        if (inInstructions < mLastInstructions)
+            mEventsInOrder = false;
+        mLastInstructions = inInstructions;
+    }
+
+    u_int32_t   mNumBirths;
+    u_int32_t   mNumInsertions;
+    u_int32_t   mNumDeaths;
+    u_int32_t   mNumReaped;
+    u_int32_t   mNumCosmicRays;
+    u_int32_t   mNumCopyErrors;
+    u_int32_t   mNumFlaws;
+    u_int32_t   mNumAllocationFailures;
+
+    bool        mEventsInOrder;
+    u_int64_t   mLastInstructions;
+
+    std::set<creature_id>   mLiving;
+};
+
+static World* createWorld()
+{
+    World* world = new World();
+    world->setInitialRandomSeed(1);
+    world->initializeSoup(kSoupSize);
+    world->setSettings(Settings::mediumMutationSettings(kSoupSize));
+    return world;
+}
+
+WorldEventsTests::WorldEventsTests()
+{
+}
+
+WorldEventsTests::~WorldEventsTests()
+{
+}
+
+void
+WorldEventsTests::setUp()
+{
+}
+
+void
+WorldEventsTests::tearDown()
+{
+}
+
+void
+WorldEventsTests::testEventCounts()
+{
+    World* world = createWorld();
+    World* quietWorld = createWorld();
+
+    CountingEventListener listener;
+    world->addEventListener(&listener, WorldEventListener::kAllEvents);
+
+    const u_int32_t ancestorLength = sizeof(kAncestor80aaa) / sizeof(instruction_t);
+    world->insertCreature(100, kAncestor80aaa, ancestorLength);
+    quietWorld->insertCreature(100, kAncestor80aaa, ancestorLength);
+
+    world->iterate(kNumCycles);
+    quietWorld->iterate(kNumCycles);
+
+    // listening must not change the course of the simulation
+    TEST_CONDITION(*world->soup() == *quietWorld->soup());
+
+    TEST_CONDITION(listener.mEventsInOrder);
+    TEST_CONDITION(listener.mNumInsertions == 1);
+    TEST_CONDITION(listener.mNumBirths > 1);
+    TEST_CONDITION(listener.mNumReaped > 0);
+    TEST_CONDITION(listener.mNumCosmicRays > 0);
+    TEST_CONDITION(listener.mNumCopyErrors > 0);
+    TEST_CONDITION(listener.mNumFlaws > 0);
+    TEST_CONDITION(listener.mNumAllocationFailures > 0);
+
+    // every adult that was born and hasn't died is still in the world
+    TEST_CONDITION(listener.mLiving.size() == world->numAdultCreatures());
+    for (std::set<creature_id>::const_iterator it = listener.mLiving.begin(); it != listener.mLiving.end(); ++it)
+    {
+        const Creature* curCreature = world->creatureWithID(*it);
+        TEST_CONDITION(curCreature && !curCreature->isEmbryo());
+    }
+
+    world->removeEventListener(&listener);
+    u_int32_t numBirths = listener.mNumBirths;
+    world->iterate(100000);
+    TEST_CONDITION(listener.mNumBirths == numBirths);
+
+    delete world;
+    delete quietWorld;
+}
+
+void
+WorldEventsTests::testEventMask()
+{
+    World* world = createWorld();
+
+    CountingEventListener birthListener;
+    CountingEventListener mutationListener;
+    world->addEventListener(&birthListener, WorldEventListener::kBirthEvents);
+    world->addEventListener(&mutationListener, WorldEventListener::kMutationEvents);
+
+    TEST_CONDITION(world->events().wantsBirths() && world->events().wantsMutations());
+    TEST_CONDITION(!world->events().wantsDeaths() && !world->events().wantsAllocationFailures());
+
+    world->insertCreature(100, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+    world->iterate(kNumCycles);
+
+    TEST_CONDITION(birthListener.mNumBirths > 1);
+    TEST_CONDITION(birthListener.mNumDeaths == 0 && birthListener.mNumCosmicRays == 0);
+    TEST_CONDITION(mutationListener.mNumBirths == 0 && mutationListener.mNumAllocationFailures == 0);
+    TEST_CONDITION(mutationListener.mNumCosmicRays > 0);
+
+    world->removeEventListener(&birthListener);
+    world->removeEventListener(&mutationListener);
+    TEST_CONDITION(!world->events().wantsBirths() && !world->events().wantsMutations());
+
+    delete world;
+}
+
+void
+WorldEventsTests::runTest()
+{
+    std::cout << "WorldEventsTests" << std::endl;
+
+    testEventCounts();
+    testEventMask();
+}
+
+TestRegistration worldEventsTestReg(new WorldEventsTests);
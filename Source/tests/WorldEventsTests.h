@@ -0,0 +1,35 @@
+/*
+ *  WorldEventsTests.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef WorldEventsTests_h
+#define WorldEventsTests_h
+
+#include "TestRunner.h"
+
+class WorldEventsTests : public TestCase
+{
+public:
+    WorldEventsTests();
+    ~WorldEventsTests();
+    
+    void setUp();
+    void tearDown();
+
+    // tests
+    void runTest();
+
+protected:
+
+    void testEventCounts();
+    void testEventMask();
+
+};
+
+
+#endif // WorldEventsTests_h
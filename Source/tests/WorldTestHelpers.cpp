@@ -0,0 +1,87 @@
+/*
+ *  WorldTestHelpers.cpp
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#include "WorldTestHelpers.h"
+
+#include <string.h>
+
+#include "MT_Ancestor.h"
+#include "MT_Inventory.h"
+#include "MT_Soup.h"
+#include "MT_World.h"
+
+using namespace MacTierra;
+
+World* createAncestorWorld(u_int32_t inSoupSize, const Settings& inSettings, u_int32_t inSeed)
+{
+    World* world = new World();
+    world->initializeSoup(inSoupSize);
+    world->setSettings(inSettings);
+    world->setInitialRandomSeed(inSeed);
+    world->insertCreature(inSoupSize / 2, kAncestor80aaa, sizeof(kAncestor80aaa) / sizeof(instruction_t));
+    return world;
+}
+
+bool worldsMatch(World* inLHS, World* inRHS)
+{
+    if (inLHS->soupSize() != inRHS->soupSize() ||
+        memcmp(inLHS->soup()->soup(), inRHS->soup()->soup(), inLHS->soupSize()) != 0 ||
+        inLHS->timeSlicer().instructionsExecuted() != inRHS->timeSlicer().instructionsExecuted() ||
+        inLHS->timeSlicer().cycleCount() != inRHS->timeSlicer().cycleCount() ||
+        inLHS->copyErrorPending() != inRHS->copyErrorPending() ||
+        inLHS->RNG() != inRHS->RNG())
+        return false;
+
+    const SlicerList& lhsCreatures = inLHS->timeSlicer().slicerList();
+    const SlicerList& rhsCreatures = inRHS->timeSlicer().slicerList();
+    if (lhsCreatures.size() != rhsCreatures.size())
+        return false;
+
+    SlicerList::const_iterator rhsIt = rhsCreatures.begin();
+    for (SlicerList::const_iterator lhsIt = lhsCreatures.begin(); lhsIt != lhsCreatures.end(); ++lhsIt, ++rhsIt)
+    {
+        if (lhsIt->creatureID() != rhsIt->creatureID() ||
+            !(lhsIt->cpu() == rhsIt->cpu()) ||
+            lhsIt->numErrors() != rhsIt->numErrors() ||
+            lhsIt->lastInstruction() != rhsIt->lastInstruction() ||
+            lhsIt->totalInstructionsExecuted() != rhsIt->totalInstructionsExecuted())
+            return false;
+    }
+
+    const ReaperList& lhsQueue = inLHS->reaper().reaperList();
+    const ReaperList& rhsQueue = inRHS->reaper().reaperList();
+    if (lhsQueue.size() != rhsQueue.size())
+        return false;
+
+    ReaperList::const_iterator rhsReaperIt = rhsQueue.begin();
+    for (ReaperList::const_iterator lhsIt = lhsQueue.begin(); lhsIt != lhsQueue.end(); ++lhsIt, ++rhsReaperIt)
+    {
+        if (lhsIt->creatureID() != rhsReaperIt->creatureID())
+            return false;
+    }
+
+    // both maps are ordered by genome
+    const Inventory::InventoryMap& lhsInventory = inLHS->inventory()->inventoryMap();
+    const Inventory::InventoryMap& rhsInventory = inRHS->inventory()->inventoryMap();
+    if (lhsInventory.size() != rhsInventory.size() ||
+        inLHS->inventory()->numAliveGenotypes() != inRHS->inventory()->numAliveGenotypes())
+        return false;
+
+    Inventory::InventoryMap::const_iterator rhsGenotypeIt = rhsInventory.begin();
+    for (Inventory::InventoryMap::const_iterator lhsIt = lhsInventory.begin(); lhsIt != lhsInventory.end(); ++lhsIt, ++rhsGenotypeIt)
+    {
+        if (lhsIt->second->name() != rhsGenotypeIt->second->name() ||
+            lhsIt->second->numberAlive() != rhsGenotypeIt->second->numberAlive() ||
+            lhsIt->second->numberEverLived() != rhsGenotypeIt->second->numberEverLived())
+            return false;
+    }
+
+    return inLHS->statistics().numAdults() == inRHS->statistics().numAdults() &&
+           inLHS->statistics().totalAdultSize() == inRHS->statistics().totalAdultSize();
+}
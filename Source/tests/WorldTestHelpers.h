@@ -0,0 +1,27 @@
+/*
+ *  WorldTestHelpers.h
+ *  MacTierra
+ *
+ *  Created by agent on 10/19/26.
+ *  Copyright 2026 __MyCompanyName__. All rights reserved.
+ *
+ */
+
+#ifndef WorldTestHelpers_h
+#define WorldTestHelpers_h
+
+#include "MT_Settings.h"
+
+namespace MacTierra {
+class World;
+}
+
+// A world with one 80aaa ancestor in the middle of its soup.
+MacTierra::World* createAncestorWorld(u_int32_t inSoupSize, const MacTierra::Settings& inSettings, u_int32_t inSeed);
+
+// True if the worlds would run on identically: the same soup, instruction and cycle counts,
+// pending copy error and generator state, creatures in the same slicer and reaper order with
+// the same CPUs and counts, and the same inventory and population statistics.
+bool worldsMatch(MacTierra::World* inLHS, MacTierra::World* inRHS);
+
+#endif // WorldTestHelpers_h
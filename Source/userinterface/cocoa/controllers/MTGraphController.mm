@@ -443,6 +443,43 @@ static double graphAxisMax(double inMaxValue, u_int32_t* outNumDivisions)
 
 #pragma mark -
 
+@interface MTErrorRateGraphAdapter : MTCyclesGraphAdapter
+@end
+
+@implementation MTErrorRateGraphAdapter
+
++ (NSString*)identifier
+{
+    return @"error_rate_timeline";
+}
+
++ (NSString*)localizedName
+{
+    return NSLocalizedString(@"MeanErrorRate", @"");
+}
+
+- (NSInteger)numberOfSeries
+{
+    return 1;
+}
+
+- (void)getPoint:(NSPointPointer *)point atIndex:(unsigned)index inSeries:(NSInteger)inSeries
+{
+    MeanErrorRateLogger* errorRateLogger = dynamic_cast<MeanErrorRateLogger*>(dataLogger);
+    if (errorRateLogger && index < errorRateLogger->dataCount())
+    {
+        MeanErrorRateLogger::data_tuple curTuple = errorRateLogger->data()[index];
+        *(*point) = NSMakePoint((double)MeanErrorRateLogger::getSlicerCycles(curTuple), MeanErrorRateLogger::getData(curTuple));
+        return;
+    }
+    
+    *point = NULL;
+}
+
+@end
+
+#pragma mark -
+
 @implementation TwoGenotypesViewController
 
 - (MTGenotypeImageView*)firstGenotypeImageView
@@ -796,6 +833,7 @@ static double graphAxisMax(double inMaxValue, u_int32_t* outNumDivisions)
     [adaptors addObject:[MTPopulationSizeGraphAdapter graphAdaptorWithGraphController:self]];
     [adaptors addObject:[MTCreatureSizeGraphAdapter graphAdaptorWithGraphController:self]];
     [adaptors addObject:[MTMaxFitnessGraphAdapter graphAdaptorWithGraphController:self]];
+    [adaptors addObject:[MTErrorRateGraphAdapter graphAdaptorWithGraphController:self]];
     [adaptors addObject:[MTTwoGenotypesFrequencyGraphAdapter graphAdaptorWithGraphController:self]];
     [adaptors addObject:[MTGenotypeFrequencyGraphAdapter graphAdaptorWithGraphController:self]];
     [adaptors addObject:[MTSizeHistorgramGraphAdapter graphAdaptorWithGraphController:self]];
@@ -830,6 +868,9 @@ static double graphAxisMax(double inMaxValue, u_int32_t* outNumDivisions)
         MTGraphAdapter* fitnessGrapher = [self adaptorWithIdentifier:[MTMaxFitnessGraphAdapter identifier]];
         fitnessGrapher.dataLogger = dataCollectors->maxFitnessDataLogger();
 
+        MTGraphAdapter* errorRateGrapher = [self adaptorWithIdentifier:[MTErrorRateGraphAdapter identifier]];
+        errorRateGrapher.dataLogger = dataCollectors->meanErrorRateLogger();
+
         MTGraphAdapter* twoGenotypesGrapher = [self adaptorWithIdentifier:[MTTwoGenotypesFrequencyGraphAdapter identifier]];
         twoGenotypesGrapher.dataLogger = dataCollectors->twoGenotypesFrequencyLogger();
 
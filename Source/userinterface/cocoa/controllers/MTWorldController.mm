@@ -559,8 +559,10 @@ static BOOL filePathFromURL(NSURL* inURL, std::string& outPath)
         std::ifstream fileStream(filePath.c_str());
         WorldImporter importer(fileStream, inFileFormat);
 
+        // "data" is in documents saved before the data collectors were versioned
         std::vector<std::string> archivingTypes;
         archivingTypes.push_back("data");
+        archivingTypes.push_back("data_collectors");
         importer.registerAddition(archivingTypes, dataCollectorsAddition.get());
 
         newWorld = importer.loadWorld();
@@ -588,7 +590,7 @@ static BOOL filePathFromURL(NSURL* inURL, std::string& outPath)
         WorldExporter exporter(fileStream, inFileFormat);
 
         std::vector<std::string> archivingTypes;
-        archivingTypes.push_back("data");
+        archivingTypes.push_back("data_collectors");
         exporter.registerAddition(archivingTypes, mWorldData->dataCollectors());
 
         exporter.saveWorld(mWorldData->world());
@@ -13,6 +13,7 @@
 #include <iosfwd>
 
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/version.hpp>
 
 #include <wtf/Noncopyable.h>
 
@@ -22,7 +23,9 @@
 
 class GenebankInventoryListener;
 
-// Container for C++ world-related data, particularly for data collection
+// Container for C++ world-related data, particularly for data collection.
+// It is archived as the "data_collectors" addition; documents saved before that was versioned
+// have the "data" addition instead, which is read as version 0.
 class WorldDataCollectors : public MacTierra::WorldArchivingAddition
 {
 private:
@@ -31,6 +34,7 @@ private:
     , mMeanSizeLogger(NULL)
     , mFitnessFrequencyLogger(NULL)
     , mTwoGenotypesFrequencyLogger(NULL)
+    , mErrorRateLogger(NULL)
     , mGenotypeFrequencyLogger(NULL)
     , mSizeFrequencyLogger(NULL)
     {
@@ -56,6 +60,7 @@ public:
     MeanCreatureSizeLogger*  meanCreatureSizeLogger() const             { return mMeanSizeLogger; }
     MaxFitnessDataLogger*    maxFitnessDataLogger() const               { return mFitnessFrequencyLogger; }
     TwoGenotypesFrequencyLogger* twoGenotypesFrequencyLogger() const    { return mTwoGenotypesFrequencyLogger; }
+    MeanErrorRateLogger*     meanErrorRateLogger() const                { return mErrorRateLogger; }
 
     GenotypeFrequencyDataLogger* genotypeFrequencyDataLogger() const    { return mGenotypeFrequencyLogger; }
     SizeHistogramDataLogger*     sizeHistogramDataLogger() const        { return mSizeFrequencyLogger; }
@@ -72,11 +77,28 @@ protected:
     void setupDataCollectors(MacTierra::World* inWorld);
     void clearDataCollectors();
 
+private:
+    friend class ::boost::serialization::access;
+    template<class Archive> void serialize(Archive& ar, const unsigned int file_version)
+    {
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("population_size_logger", mPopSizeLogger);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("mean_size_logger", mMeanSizeLogger);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("max_fitness_logger", mFitnessFrequencyLogger);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("two_genotypes_logger", mTwoGenotypesFrequencyLogger);
+
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("genotype_frequency_logger", mGenotypeFrequencyLogger);
+        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("size_frequency_logger", mSizeFrequencyLogger);
+
+        if (file_version > 0)
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("error_rate_logger", mErrorRateLogger);
+    }
+
 protected:
     PopulationSizeLogger*           mPopSizeLogger;
     MeanCreatureSizeLogger*         mMeanSizeLogger;
     MaxFitnessDataLogger*           mFitnessFrequencyLogger;
     TwoGenotypesFrequencyLogger*    mTwoGenotypesFrequencyLogger;
+    MeanErrorRateLogger*            mErrorRateLogger;
     
     GenotypeFrequencyDataLogger*    mGenotypeFrequencyLogger;
     SizeHistogramDataLogger*     	mSizeFrequencyLogger;
@@ -84,6 +106,8 @@ protected:
     GenebankInventoryListener*      mGenebankListener;
 };
 
+BOOST_CLASS_VERSION(WorldDataCollectors, 1)
+
 class WorldData : Noncopyable
 {
 public:
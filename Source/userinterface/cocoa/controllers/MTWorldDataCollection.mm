@@ -40,6 +40,10 @@ void
 WorldDataCollectors::setupDataCollectors(World* inWorld)
 {
     const NSUInteger kMaxDataPoints = 500;
+    // enough creatures to give the error rate graph a narrow confidence interval
+    const u_int32_t kSampleSize = 200;
+
+    inWorld->dataCollector()->setSampleSize(kSampleSize);
     
     if (!mPopSizeLogger)
     {
@@ -69,6 +73,13 @@ WorldDataCollectors::setupDataCollectors(World* inWorld)
     }
     inWorld->dataCollector()->addCyclicalLogger(mTwoGenotypesFrequencyLogger);
 
+    if (!mErrorRateLogger)
+    {
+        mErrorRateLogger = new MeanErrorRateLogger();
+        mErrorRateLogger->setMaxDataCount(kMaxDataPoints);
+    }
+    inWorld->dataCollector()->addCyclicalLogger(mErrorRateLogger);
+
     
     if (!mGenotypeFrequencyLogger)
     {
@@ -97,6 +108,9 @@ WorldDataCollectors::clearDataCollectors()
 
     delete mTwoGenotypesFrequencyLogger;
     mTwoGenotypesFrequencyLogger = NULL;
+
+    delete mErrorRateLogger;
+    mErrorRateLogger = NULL;
     
     delete mGenotypeFrequencyLogger;
     mGenotypeFrequencyLogger = NULL;
@@ -114,6 +128,7 @@ WorldDataCollectors::registerTypes(boost::archive::polymorphic_oarchive& inArchi
     inArchive.register_type(static_cast<TwoGenotypesFrequencyLogger *>(NULL));
     inArchive.register_type(static_cast<GenotypeFrequencyDataLogger *>(NULL));
     inArchive.register_type(static_cast<SizeHistogramDataLogger *>(NULL));
+    inArchive.register_type(static_cast<MeanErrorRateLogger *>(NULL));
 }
 
 void
@@ -125,30 +140,23 @@ WorldDataCollectors::registerTypes(boost::archive::polymorphic_iarchive& inArchi
     inArchive.register_type(static_cast<TwoGenotypesFrequencyLogger *>(NULL));
     inArchive.register_type(static_cast<GenotypeFrequencyDataLogger *>(NULL));
     inArchive.register_type(static_cast<SizeHistogramDataLogger *>(NULL));
+    inArchive.register_type(static_cast<MeanErrorRateLogger *>(NULL));
 }
 
 void
 WorldDataCollectors::loadAddition(const std::string& inAdditionType, boost::archive::polymorphic_iarchive& inArchive)
 {
-    inArchive >> MT_BOOST_MEMBER_SERIALIZATION_NVP("population_size_logger", mPopSizeLogger);
-    inArchive >> MT_BOOST_MEMBER_SERIALIZATION_NVP("mean_size_logger", mMeanSizeLogger);
-    inArchive >> MT_BOOST_MEMBER_SERIALIZATION_NVP("max_fitness_logger", mFitnessFrequencyLogger);
-    inArchive >> MT_BOOST_MEMBER_SERIALIZATION_NVP("two_genotypes_logger", mTwoGenotypesFrequencyLogger);
-
-    inArchive >> MT_BOOST_MEMBER_SERIALIZATION_NVP("genotype_frequency_logger", mGenotypeFrequencyLogger);
-    inArchive >> MT_BOOST_MEMBER_SERIALIZATION_NVP("size_frequency_logger", mSizeFrequencyLogger);
+    // the old "data" addition has the version 0 loggers, with no class information
+    if (inAdditionType == "data")
+        serialize(inArchive, 0);
+    else
+        inArchive >> MT_BOOST_MEMBER_SERIALIZATION_NVP("data_collectors", *this);
 }
 
 void
 WorldDataCollectors::saveAddition(const std::string& inAdditionType, boost::archive::polymorphic_oarchive& inArchive)
 {
-    inArchive << MT_BOOST_MEMBER_SERIALIZATION_NVP("population_size_logger", mPopSizeLogger);
-    inArchive << MT_BOOST_MEMBER_SERIALIZATION_NVP("mean_size_logger", mMeanSizeLogger);
-    inArchive << MT_BOOST_MEMBER_SERIALIZATION_NVP("max_fitness_logger", mFitnessFrequencyLogger);
-    inArchive << MT_BOOST_MEMBER_SERIALIZATION_NVP("two_genotypes_logger", mTwoGenotypesFrequencyLogger);
-
-    inArchive << MT_BOOST_MEMBER_SERIALIZATION_NVP("genotype_frequency_logger", mGenotypeFrequencyLogger);
-    inArchive << MT_BOOST_MEMBER_SERIALIZATION_NVP("size_frequency_logger", mSizeFrequencyLogger);
+    inArchive << MT_BOOST_MEMBER_SERIALIZATION_NVP("data_collectors", *this);
 }
 
 #pragma mark -
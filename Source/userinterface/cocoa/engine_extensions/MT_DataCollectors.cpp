@@ -7,8 +7,6 @@
  *
  */
 
-#include <set>
-
 #include "MT_DataCollectors.h"
 
 #include "MT_CellMap.h"
@@ -47,7 +45,8 @@ TwoGenotypesFrequencyLogger::collectData(ECollectionType inCollectionType, u_int
     if (mSecondGenotype)
         twoFrequencies.second = mSecondGenotype->numberAlive();
         
-    mData.push_back(data_tuple(inInstructionCount, inSlicerCycles, twoFrequencies));
+    mSeries.append(inInstructionCount, inSlicerCycles, twoFrequencies);
+    mDataValid = false;
     
     // We just use the first of the maxValue pair
     u_int32_t larger = std::max(twoFrequencies.first, twoFrequencies.second);
@@ -58,25 +57,40 @@ TwoGenotypesFrequencyLogger::collectData(ECollectionType inCollectionType, u_int
 
 // collectData is called on the engine thread
 void
-MaxFitnessDataLogger::collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const MacTierra::World* inWorld)
+MeanErrorRateLogger::collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const MacTierra::World* inWorld)
 {
-    u_int32_t maxAlive = 0;
-    const InventoryGenotype* mostCommonGenotype = NULL;
-    
-    // find the most common genotype (slow!)
-    const Inventory*  inventory = inWorld->inventory();
-    Inventory::InventoryMap::const_iterator it, end;
-    for (it = inventory->inventoryMap().begin(), end = inventory->inventoryMap().end();
-         it != end;
-         ++it)
+    const PopulationSample* sample = sampledData();
+    if (sample)
     {
-        const InventoryGenotype* curEntry = it->second;
-        if (curEntry->numberAlive() > maxAlive)
-        {
-            mostCommonGenotype = curEntry;
-            maxAlive = curEntry->numberAlive();
-        }
+        appendValue(inInstructionCount, inSlicerCycles, sample->errorRate().mMean);
+        return;
+    }
+
+    double totalErrorRate = 0.0;
+    u_int32_t numCreatures = 0;
+
+    const SlicerList& slicerList = inWorld->timeSlicer().slicerList();
+    for (SlicerList::const_iterator it = slicerList.cbegin(); it != slicerList.cend(); ++it)
+    {
+        const Creature& curCreature = (*it);
+        if (curCreature.totalInstructionsExecuted() > 0)
+            totalErrorRate += (double)curCreature.numErrors() / curCreature.totalInstructionsExecuted();
+        ++numCreatures;
     }
+
+    appendValue(inInstructionCount, inSlicerCycles, numCreatures ? totalErrorRate / numCreatures : 0.0);
+}
+
+#pragma mark -
+
+// collectData is called on the engine thread
+void
+MaxFitnessDataLogger::collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const MacTierra::World* inWorld)
+{
+    // find the most common genotype
+    Inventory::GenotypeVector topGenotypes;
+    inWorld->inventory()->topGenotypes(1, topGenotypes);
+    const InventoryGenotype* mostCommonGenotype = topGenotypes.empty() ? NULL : topGenotypes.front();
     
     if (!mostCommonGenotype)
     {
@@ -86,17 +100,16 @@ MaxFitnessDataLogger::collectData(ECollectionType inCollectionType, u_int64_t in
     
     double maxFitness = 0.0;
 
-    const TimeSlicer& slicer = inWorld->timeSlicer();
-
     u_int64_t   totalInstructions = 0;
     u_int32_t   numCreatures = 0;
     u_int32_t   numTrueOffspring = 0;
     double      totSliceSize = 0.0;
     
-    for (SlicerList::const_iterator it = slicer.slicerList().cbegin(); it != slicer.slicerList().cend(); ++it)
+    const GenotypeCreatureList& genotypeCreatures = mostCommonGenotype->creatures();
+    for (GenotypeCreatureList::const_iterator it = genotypeCreatures.cbegin(); it != genotypeCreatures.cend(); ++it)
     {
         const Creature& curCreature = (*it);
-        if (curCreature.genotype() == mostCommonGenotype && curCreature.numIdenticalOffspring() > 0)
+        if (curCreature.numIdenticalOffspring() > 0)
         {
             // We don't count the number of instructions that went into true offspring, so just count
             // all offspring
@@ -120,42 +133,19 @@ MaxFitnessDataLogger::collectData(ECollectionType inCollectionType, u_int64_t in
 
 #pragma mark -
 
-struct aliveReverseSort
-{
-    bool operator()(const InventoryGenotype* s1, const InventoryGenotype* s2) const
-    {
-        return s1->numberAlive() > s2->numberAlive();
-    }
-};
-
 void
 GenotypeFrequencyDataLogger::collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const MacTierra::World* inWorld)
 {
     const Inventory*  inventory = inWorld->inventory();
 
-    typedef std::multiset<const InventoryGenotype*, aliveReverseSort> alive_set;
-    alive_set    commonGenotypeSet;
-    
-    // This is slow for large inventories. Maybe have the inventory move
-    // extinct genotypes into a different map?
-    Inventory::InventoryMap::const_iterator it, end;
-    for (it = inventory->inventoryMap().begin(), end = inventory->inventoryMap().end();
-         it != end;
-         ++it)
-    {
-        const InventoryGenotype* curEntry = it->second;
-        if (curEntry->numberAlive() == 0)
-            continue;
+    // The inventory keeps living genotypes ranked, so this is O(mMaxBuckets)
+    Inventory::GenotypeVector commonGenotypes;
+    inventory->topGenotypes(mMaxBuckets, commonGenotypes);
 
-        commonGenotypeSet.insert(curEntry);
-    }
-
-    // Now pick the top N
     mData.clear();
-    alive_set::const_iterator aliveIt = commonGenotypeSet.begin(), aliveEnd = commonGenotypeSet.end();
-    for (u_int32_t i = 0; i < mMaxBuckets && aliveIt != aliveEnd; ++i, ++aliveIt)
+    for (Inventory::GenotypeVector::const_iterator it = commonGenotypes.begin(), end = commonGenotypes.end(); it != end; ++it)
     {
-        const InventoryGenotype* curEntry = *aliveIt;
+        const InventoryGenotype* curEntry = *it;
         mData.push_back(data_pair(curEntry->name(), curEntry->numberAlive()));
     }
 }
@@ -165,47 +155,7 @@ GenotypeFrequencyDataLogger::collectData(ECollectionType inCollectionType, u_int
 void
 SizeHistogramDataLogger::collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const MacTierra::World* inWorld)
 {
-    const CellMap* cellMap = inWorld->cellMap();
-    
-    // first find the max
-    u_int32_t minAdultSize = UINT_MAX, maxAdultSize = 0;
-    CellMap::CreatureList::const_iterator it, end = cellMap->cells().end();
-    for (it = cellMap->cells().begin();
-         it != end;
-         ++it)
-    {
-        const CreatureRange&    cell = (*it);
-        const Creature*         creature = cell.mData;
-        if (creature->isEmbryo())
-            continue;
-
-        minAdultSize = min(minAdultSize, cell.length());
-        maxAdultSize = max(maxAdultSize, cell.length());
-    }
-    
-    // now build the frequency table
-    u_int32_t sizeRange = max(maxAdultSize - minAdultSize, 1U);
-    u_int32_t bucketSize = ceil((double)sizeRange / mMaxBuckets);
-
-    mData.clear();
-    for (size_t i = 0; i < mMaxBuckets; ++i)
-    {
-        u_int32_t bucketStart   = minAdultSize + i * bucketSize;
-        u_int32_t bucketEnd     = bucketStart + bucketSize - 1;
-        mData.push_back(data_pair(range_pair(bucketStart, bucketEnd), 0));
-    }
-    
-    for (it = cellMap->cells().begin();
-         it != end;
-         ++it)
-    {
-        const CreatureRange&    cell = (*it);
-        const Creature*         creature = cell.mData;
-        if (creature->isEmbryo())
-            continue;
-
-        u_int32_t bucketIndex = (cell.length() - minAdultSize) / bucketSize;
-        ++mData[bucketIndex].second;
-    }
+    // The statistics keep counts by size, so this doesn't need to look at every cell
+    inWorld->statistics().sizeHistogram(mMaxBuckets, mData);
 }
 
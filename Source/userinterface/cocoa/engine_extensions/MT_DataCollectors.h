@@ -14,9 +14,12 @@
 
 #include <boost/serialization/export.hpp>
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 #include <boost/tuple/tuple.hpp>
 
 #include "MT_Inventory.h"
+#include "MT_TimeSeries.h"
 
 #include "MT_DataCollection.h"
 
@@ -26,8 +29,9 @@
 // to store the collected data, and whether to save that data in soup files.
 
 
-// This data logger collects up to maxDataCount, then prunes the data, throwing
-// away every other data point, to conserve memory and make the graphing quicker.
+// This data logger collects a value every mCollectionInterval calls. Subclasses keep their
+// values in a MacTierra::TimeSeries, so memory use is bounded however long the run, and
+// data() returns at most maxDataCount points covering the whole run.
 
 class SimpleDataLogger : public MacTierra::DataLogger
 {
@@ -45,11 +49,6 @@ public:
         if (mCallCount == mNextCollectionCount)
         {
             DataLogger::collect(inCollectionType, inInstructionCount, inSlicerCycles, inWorld);
-        
-            // now see if we should prune
-            if (dataCount() > maxDataCount())
-                pruneData();
-            
             mNextCollectionCount = mCallCount + mCollectionInterval;
         }
         ++mCallCount;
@@ -62,8 +61,7 @@ public:
         if (inMax != mMaxDataCount)
         {
             mMaxDataCount = inMax;
-            if (dataCount() > maxDataCount())
-                pruneData();
+            maxDataCountChanged();
         }
     }
 
@@ -79,7 +77,7 @@ public:
 
 protected:
 
-    virtual void pruneData() = 0;
+    virtual void maxDataCountChanged() = 0;
 
 private:
     friend class ::boost::serialization::access;
@@ -107,62 +105,67 @@ class TypedSimpleDataLogger : public SimpleDataLogger
 public:
     typedef T data_type;
     typedef boost::tuple<u_int64_t, u_int64_t, data_type> data_tuple;       // instructions, cycles, data
+    typedef MacTierra::TimeSeries<data_type> series_type;
     
     static u_int64_t getInstructions(const data_tuple& data)    { return boost::tuples::get<0>(data); }
     static u_int64_t getSlicerCycles(const data_tuple& data)    { return boost::tuples::get<1>(data); }
     static T getData(const data_tuple& data)                    { return boost::tuples::get<2>(data); }
     
-    virtual u_int32_t   dataCount() const { return mData.size(); }
+    TypedSimpleDataLogger()
+    : mDataValid(false)
+    {
+    }
+
+    virtual u_int32_t   dataCount() const { return data().size(); }
 
+    // The whole run, in at most maxDataCount points, each the mean of the samples it covers
+    // and stamped with the time of the last of them.
     // engine needs to be locked while using this data
-    const std::vector<data_tuple>& data() const { return mData; }
+    const std::vector<data_tuple>& data() const
+    {
+        if (!mDataValid)
+            updateData();
+        return mData;
+    }
+
+    // For min/max envelopes, or queries over part of the run.
+    const series_type& series() const { return mSeries; }
     
     data_type maxValue() const { return mMaxValue; }
 
-    virtual u_int64_t minInstructions() const { return mData.size() > 0 ? getInstructions(mData[0]): 0; }
-    virtual u_int64_t maxInstructions() const { return mData.size() > 0 ? getInstructions(mData[mData.size() - 1]) : 0; }
+    virtual u_int64_t minInstructions() const { return mSeries.total().mFirstInstructions; }
+    virtual u_int64_t maxInstructions() const { return mSeries.total().mLastInstructions; }
 
-    virtual u_int64_t minSlicerCycles() const { return mData.size() > 0 ? getSlicerCycles(mData[0]): 0; }
-    virtual u_int64_t maxSlicerCycles() const { return mData.size() > 0 ? getSlicerCycles(mData[mData.size() - 1]) : 0; }
+    virtual u_int64_t minSlicerCycles() const { return mSeries.total().mFirstCycles; }
+    virtual u_int64_t maxSlicerCycles() const { return mSeries.total().mLastCycles; }
 
 protected:
     
-    virtual void pruneData()
+    virtual void maxDataCountChanged()
     {
-        if (dataCount() > maxDataCount())
-        {
-            // copy to a new vector rather than removing every other entry,
-            // would would be slow
-            std::vector<data_tuple> newData;
-            const size_t dataSize = mData.size();
-            newData.reserve(dataSize / 2);
-
-            for (size_t i = 0; i <= dataSize / 2; ++i)
-                newData.push_back(mData[2 * i]);
-            
-            mData = newData;
-            // now collect half as often
-            mCollectionInterval *= 2;
-        }
+        if (maxDataCount() != UINT_MAX)
+            mSeries.setLevelCapacity(maxDataCount());
+        mDataValid = false;
     }
 
-/*
-    void printData()
+    void updateData() const
     {
-        std::cout << "Data" << std::endl;
-        const size_t dataSize = mData.size();
-        for (size_t i = 0; i < dataSize; ++i)
-        {
-            const data_tuple& curData = mData[i];
-            std::cout << curData.first << "  " << curData.second << std::endl;
-        }
+        typename series_type::BucketVector buckets;
+        mSeries.fullRange(maxDataCount(), buckets);
+
+        mData.clear();
+        mData.reserve(buckets.size());
+        for (typename series_type::BucketVector::const_iterator it = buckets.begin(); it != buckets.end(); ++it)
+            mData.push_back(data_tuple(it->mLastInstructions, it->mLastCycles, it->mean()));
+
+        mDataValid = true;
     }
-*/    
 
     void appendValue(u_int64_t inInstructionCount, u_int64_t inSlicerCycles, data_type inValue)
     {
-        mData.push_back(data_tuple(inInstructionCount, inSlicerCycles, inValue));
+        mSeries.append(inInstructionCount, inSlicerCycles, inValue);
         mMaxValue = std::max(inValue, mMaxValue);
+        mDataValid = false;
     }
     
     virtual void collectorChanged()
@@ -177,14 +180,28 @@ private:
     {
         ar & BOOST_SERIALIZATION_BASE_OBJECT_NVP(SimpleDataLogger);
 
-        ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("data", mData);
+        if (file_version > 0)
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("series", mSeries);
+        else
+        {
+            // version 0 saved every sample as a tuple
+            std::vector<data_tuple> oldData;
+            ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("data", oldData);
+            for (typename std::vector<data_tuple>::const_iterator it = oldData.begin(); it != oldData.end(); ++it)
+                mSeries.append(getInstructions(*it), getSlicerCycles(*it), getData(*it));
+        }
         ar & MT_BOOST_MEMBER_SERIALIZATION_NVP("max_value", mMaxValue);
+        mDataValid = false;
     }
 
 protected:
 
-    std::vector<data_tuple> mData;
+    series_type             mSeries;
     data_type               mMaxValue;
+
+    // cache of data(), rebuilt on demand
+    mutable std::vector<data_tuple> mData;
+    mutable bool            mDataValid;
 };
 
 namespace boost {
@@ -203,6 +220,8 @@ void serialize(Archive & ar, boost::tuple<u_int64_t, u_int64_t, T>& data, const
 
 
 typedef TypedSimpleDataLogger<u_int32_t> SimpleUInt32DataLogger;
+BOOST_CLASS_VERSION(SimpleUInt32DataLogger, 1)
+
 class PopulationSizeLogger : public SimpleUInt32DataLogger
 {
 public:
@@ -227,6 +246,8 @@ private:
 
 
 typedef TypedSimpleDataLogger<double> SimpleDoubleDataLogger;
+BOOST_CLASS_VERSION(SimpleDoubleDataLogger, 1)
+
 class MeanCreatureSizeLogger : public SimpleDoubleDataLogger
 {
 public:
@@ -249,6 +270,32 @@ private:
 };
 
 
+// Mean errors per instruction executed. Computing this exactly means visiting every creature,
+// so this logger will use the collector's population sample if there is one.
+class MeanErrorRateLogger : public SimpleDoubleDataLogger
+{
+public:
+    MeanErrorRateLogger()
+    {
+        mMaxValue = 0;
+    }
+
+    virtual EDataRequirement dataRequirement() const { return kSampledDataAllowed; }
+
+    // collectData is called on the engine thread
+    virtual void collectData(ECollectionType inCollectionType, u_int64_t inInstructionCount, u_int64_t inSlicerCycles, const MacTierra::World* inWorld);
+
+    virtual double maxDoubleValue() const { return static_cast<double>(mMaxValue); }
+
+private:
+    friend class ::boost::serialization::access;
+    template<class Archive> void serialize(Archive& ar, const unsigned int file_version)
+    {
+        ar & BOOST_SERIALIZATION_BASE_OBJECT_NVP(SimpleDoubleDataLogger);
+    }
+};
+
+
 class MaxFitnessDataLogger : public SimpleDoubleDataLogger
 {
 public:
@@ -271,6 +318,8 @@ private:
 };
 
 typedef TypedSimpleDataLogger<std::pair<u_int32_t, u_int32_t> > SimpleFrequencyPairDataLogger;
+BOOST_CLASS_VERSION(SimpleFrequencyPairDataLogger, 1)
+
 class TwoGenotypesFrequencyLogger : public SimpleFrequencyPairDataLogger
 {
 public: